@@ -134,10 +134,15 @@ bool validDateFormat(const string &d) {
     for (size_t i = 0; i < d.size(); ++i) if (i!=4 && i!=7 && !isdigit(d[i])) return false;
     return true;
 }
-int dateToDays(const string &d) { // naive days count Y*360 + M*30 + D for comparison (sufficient for ordering)
+int dateToDays(const string &d) { // days since 1970-01-01 on the proleptic Gregorian calendar
     int y=0,m=0,dd=0;
     sscanf(d.c_str(), "%d-%d-%d", &y, &m, &dd);
-    return y*360 + m*30 + dd;
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + dd - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
 }
 bool rangesOverlap(const string &s1, const string &e1, const string &s2, const string &e2) {
     int a1 = dateToDays(s1), b1 = dateToDays(e1);
@@ -145,6 +150,77 @@ bool rangesOverlap(const string &s1, const string &e1, const string &s2, const s
     return max(a1,a2) <= min(b1,b2);
 }
 
+// ---------- Room availability calendar ----------
+// Per-room stays [start,end] (inclusive day numbers) sorted by start, with a running
+// max of end so "does anything overlap [s,e]" is one binary search. Built once from
+// the CSVs, then kept current by booking and check-out.
+struct HotelRoomCalendar {
+    string type;                 // lower-cased room type
+    vector<pair<int,int>> stays; // sorted by start
+    vector<int> maxEnd;          // maxEnd[i] = max end of stays[0..i]
+};
+unordered_map<string, HotelRoomCalendar> hotelCalendar;
+map<string, vector<string>> hotelRoomsByType; // lower-cased type -> room ids
+bool hotelCalendarReady = false;
+
+string hotel_lower(string s) { transform(s.begin(), s.end(), s.begin(), ::tolower); return s; }
+
+void hotel_calendarAdd(const string &roomId, int s, int e) {
+    HotelRoomCalendar &cal = hotelCalendar[roomId];
+    auto pos = upper_bound(cal.stays.begin(), cal.stays.end(), make_pair(s, e));
+    size_t i = pos - cal.stays.begin();
+    cal.stays.insert(pos, make_pair(s, e));
+    cal.maxEnd.insert(cal.maxEnd.begin() + i, e);
+    for (; i < cal.stays.size(); ++i)
+        cal.maxEnd[i] = max(cal.stays[i].second, i ? cal.maxEnd[i-1] : INT_MIN);
+}
+void hotel_calendarRemove(const string &roomId, int s, int e) {
+    auto it = hotelCalendar.find(roomId);
+    if (it == hotelCalendar.end()) return;
+    HotelRoomCalendar &cal = it->second;
+    auto pos = lower_bound(cal.stays.begin(), cal.stays.end(), make_pair(s, e));
+    if (pos == cal.stays.end() || *pos != make_pair(s, e)) return;
+    size_t i = pos - cal.stays.begin();
+    cal.stays.erase(pos);
+    cal.maxEnd.erase(cal.maxEnd.begin() + i);
+    for (; i < cal.stays.size(); ++i)
+        cal.maxEnd[i] = max(cal.stays[i].second, i ? cal.maxEnd[i-1] : INT_MIN);
+}
+void hotel_buildCalendar() {
+    hotelCalendar.clear();
+    hotelRoomsByType.clear();
+    auto rooms = readCSV(HOTEL_ROOMS_FILE);
+    for (size_t i = 1; i < rooms.size(); ++i) {
+        if (rooms[i].empty() || rooms[i][0].empty()) continue;
+        string type = hotel_lower(rooms[i].size() > 1 ? rooms[i][1] : "");
+        hotelCalendar[rooms[i][0]].type = type;
+        hotelRoomsByType[type].push_back(rooms[i][0]);
+    }
+    auto rows = readCSV(HOTEL_BOOKINGS_FILE);
+    for (size_t i = 1; i < rows.size(); ++i) {
+        if (rows[i].size() < 6 || !validDateFormat(rows[i][3]) || !validDateFormat(rows[i][4])) continue;
+        HotelRoomCalendar &cal = hotelCalendar[rows[i][2]];
+        cal.stays.push_back(make_pair(dateToDays(rows[i][3]), dateToDays(rows[i][4])));
+    }
+    for (auto &kv : hotelCalendar) {
+        HotelRoomCalendar &cal = kv.second;
+        sort(cal.stays.begin(), cal.stays.end());
+        cal.maxEnd.resize(cal.stays.size());
+        for (size_t i = 0; i < cal.stays.size(); ++i)
+            cal.maxEnd[i] = max(cal.stays[i].second, i ? cal.maxEnd[i-1] : INT_MIN);
+    }
+    hotelCalendarReady = true;
+}
+bool hotel_roomFreeDays(const string &roomId, int s, int e) {
+    if (!hotelCalendarReady) hotel_buildCalendar();
+    auto it = hotelCalendar.find(roomId);
+    if (it == hotelCalendar.end()) return true;
+    const HotelRoomCalendar &cal = it->second;
+    // stays starting after e cannot overlap; of the rest, any ending on/after s does
+    size_t n = upper_bound(cal.stays.begin(), cal.stays.end(), make_pair(e, INT_MAX)) - cal.stays.begin();
+    return n == 0 || cal.maxEnd[n-1] < s;
+}
+
 // ---------- Rooms module ----------
 void hotel_addRoom() {
     string id,type,floor,rate,notes;
@@ -154,6 +230,7 @@ void hotel_addRoom() {
     cout << "Rate per night: "; getline(cin, rate);
     cout << "Notes: "; getline(cin, notes);
     appendCSV(HOTEL_ROOMS_FILE, {id,type,floor,rate,"available",notes});
+    if (hotelCalendarReady) { hotelCalendar[id].type = hotel_lower(type); hotelRoomsByType[hotel_lower(type)].push_back(id); }
     cout << "Room added.\n";
 }
 void hotel_viewRooms() {
@@ -237,14 +314,26 @@ void hotel_searchCustomer() {
 
 // ---------- Bookings ----------
 bool roomAvailableForRange(const string &roomId, const string &startDate, const string &endDate) {
-    auto rows = readCSV(HOTEL_BOOKINGS_FILE);
-    for (size_t i = 1; i < rows.size(); ++i) {
-        if (rows[i].size() >= 6 && rows[i][2] == roomId) {
-            string s = rows[i][3], e = rows[i][4];
-            if (rangesOverlap(s,e,startDate,endDate)) return false;
-        }
+    return hotel_roomFreeDays(roomId, dateToDays(startDate), dateToDays(endDate));
+}
+void hotel_findFreeRooms() {
+    string startDate, endDate, type;
+    cout << "Start Date (YYYY-MM-DD): "; getline(cin, startDate);
+    cout << "End Date (YYYY-MM-DD): "; getline(cin, endDate);
+    if (!validDateFormat(startDate) || !validDateFormat(endDate) || dateToDays(endDate) < dateToDays(startDate)) {
+        cout << "Invalid dates.\n"; return;
     }
-    return true;
+    cout << "Type (blank = any): "; getline(cin, type);
+    if (!hotelCalendarReady) hotel_buildCalendar();
+    int s = dateToDays(startDate), e = dateToDays(endDate);
+    string want = hotel_lower(type);
+    int shown = 0;
+    for (auto &kv : hotelRoomsByType) {
+        if (!want.empty() && kv.first != want) continue;
+        for (auto &roomId : kv.second)
+            if (hotel_roomFreeDays(roomId, s, e)) { cout << roomId << " | " << kv.first << "\n"; ++shown; }
+    }
+    if (!shown) cout << "No free rooms for those dates.\n";
 }
 void hotel_bookRoom() {
     string bid, custId, roomId, startDate, endDate, occupants, notes;
@@ -267,6 +356,7 @@ void hotel_bookRoom() {
     if (!foundRoom) { cout << "Room not found.\n"; return; }
     if (!roomAvailableForRange(roomId, startDate, endDate)) { cout << "Room not available for requested dates.\n"; return; }
     appendCSV(HOTEL_BOOKINGS_FILE, {bid, custId, roomId, startDate, endDate, occupants, "booked", notes});
+    hotel_calendarAdd(roomId, dateToDays(startDate), dateToDays(endDate));
     cout << "Booked.\n";
 }
 void hotel_viewBookings() {
@@ -304,6 +394,16 @@ void hotel_checkOut() {
             if (rows[i].size() < 7) rows[i].resize(7);
             if (rows[i][6] != "checked-in") { cout << "Not currently checked-in (status=" << rows[i][6] << ").\n"; break; }
             rows[i][6] = "completed";
+            // early check-out releases the remaining nights
+            string today = nowDate();
+            if (validDateFormat(rows[i][3]) && validDateFormat(rows[i][4]) && dateToDays(today) < dateToDays(rows[i][4])) {
+                int s = dateToDays(rows[i][3]), e = dateToDays(rows[i][4]);
+                if (hotelCalendarReady) {
+                    hotel_calendarRemove(rows[i][2], s, e);
+                    hotel_calendarAdd(rows[i][2], s, max(s, dateToDays(today)));
+                }
+                rows[i][4] = dateToDays(today) < s ? rows[i][3] : today;
+            }
             overwriteCSV(HOTEL_BOOKINGS_FILE, rows);
             cout << "Checked-out.\n";
             break;
@@ -621,6 +721,7 @@ void hotel_loadSampleData() {
     };
     overwriteCSV(HOTEL_EVENTS_FILE, events);
 
+    hotelCalendarReady = false; // rebuilt from the new CSVs on next query
     cout << "Hotel sample data loaded successfully!\n";
 }
 
@@ -648,7 +749,7 @@ void hotel_customerMenu() {
 }
 void hotel_bookingMenu() {
     while (true) {
-        cout << "\nBooking Menu\n1.Book Room\n2.View Bookings\n3.Check-in\n4.Check-out\n5.Generate Bill\n6.View Bills\n7.Back\nChoice: ";
+        cout << "\nBooking Menu\n1.Book Room\n2.View Bookings\n3.Check-in\n4.Check-out\n5.Generate Bill\n6.View Bills\n7.Find Free Rooms\n8.Back\nChoice: ";
         string c; getline(cin, c);
         if (c == "1") hotel_bookRoom();
         else if (c == "2") hotel_viewBookings();
@@ -656,6 +757,7 @@ void hotel_bookingMenu() {
         else if (c == "4") hotel_checkOut();
         else if (c == "5") hotel_generateBill();
         else if (c == "6") hotel_viewBills();
+        else if (c == "7") hotel_findFreeRooms();
         else return;
     }
 }
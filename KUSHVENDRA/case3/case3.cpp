@@ -3,16 +3,23 @@
 // Compile: g++ -std=gnu++17 power_stations_avl.cpp -O2 -o power_stations_avl
 
 #include <bits/stdc++.h>
+#include "../../Manthan/city_dict.h"
 using namespace std;
 
+// ---------- Station Status ----------
+// Statuses are kept as small integer codes; unknown values from the CSV are
+// interned after these and written back unchanged.
+enum StationStatus { STATION_ACTIVE, STATION_OVERLOADED, STATION_UNDERUTILIZED };
+CityDict stationStatuses = cityDictMake({"active", "overloaded", "underutilized"});
+
 // ---------- Station Structure ----------
 struct Station {
     string id;
     string name;
     string location;
-    string status;
     int capacity = 0;
     int load = 0;
+    CityCode status = STATION_ACTIVE;
 };
 
 // ---------- Filenames ----------
@@ -343,7 +350,7 @@ void loadStationsFromCSV() {
         s.location = cols[2];
         try { s.capacity = stoi(cols[3]); } catch(...) { s.capacity = 0; }
         try { s.load = stoi(cols[4]); } catch(...) { s.load = 0; }
-        s.status = cols[5].empty() ? "active" : cols[5];
+        s.status = cols[5].empty() ? (CityCode)STATION_ACTIVE : cityIntern(stationStatuses, cols[5]);
         idRoot = idInsert(idRoot, s.id, s);
         nameRoot = nameInsert(nameRoot, s.name, s.id);
     }
@@ -357,7 +364,7 @@ void saveStationsToCSV() {
     ofstream out(FNAME, ios::trunc);
     out << "id,name,location,capacity,load,status\n";
     for(auto &s : rows) {
-        out << s.id << "," << s.name << "," << s.location << "," << s.capacity << "," << s.load << "," << s.status << "\n";
+        out << s.id << "," << s.name << "," << s.location << "," << s.capacity << "," << s.load << "," << cityDictName(stationStatuses, s.status) << "\n";
     }
     out.close();
 }
@@ -375,9 +382,9 @@ void logLoad(const Station &s) {
 
 // ---------- Business logic (uses AVL ops) ----------
 void updateStatus(Station &s) {
-    if (s.load > s.capacity) s.status = "overloaded";
-    else if (s.capacity > 0 && s.load < s.capacity/4) s.status = "underutilized";
-    else s.status = "active";
+    if (s.load > s.capacity) s.status = STATION_OVERLOADED;
+    else if (s.capacity > 0 && s.load < s.capacity/4) s.status = STATION_UNDERUTILIZED;
+    else s.status = STATION_ACTIVE;
 }
 
 // Add station (insert into both AVLs and save)
@@ -387,7 +394,7 @@ void addStation() {
     cout << "Enter Name: "; getline(cin, s.name);
     cout << "Enter Location: "; getline(cin, s.location);
     cout << "Enter Capacity (MW): "; string tmp; getline(cin,tmp); try{s.capacity = stoi(tmp);}catch(...){s.capacity=0;}
-    s.load = 0; s.status = "active";
+    s.load = 0; s.status = STATION_ACTIVE;
 
     // check duplicate id
     if(idFind(idRoot, s.id)) {
@@ -426,7 +433,7 @@ void viewStations() {
              << setw(12) << s.location 
              << setw(12) << s.capacity 
              << setw(12) << s.load 
-             << setw(15) << s.status << "\n";
+             << setw(15) << cityDictName(stationStatuses, s.status) << "\n";
     }
 }
 
@@ -440,7 +447,7 @@ void searchStation() {
     if(nid) {
         Station &s = nid->st;
         cout << s.id << " | " << s.name << " | " << s.location 
-             << " | Capacity:" << s.capacity << " | Load:" << s.load << " | Status:" << s.status << "\n";
+             << " | Capacity:" << s.capacity << " | Load:" << s.load << " | Status:" << cityDictName(stationStatuses, s.status) << "\n";
         return;
     }
     // try name
@@ -452,7 +459,7 @@ void searchStation() {
             if(sn) {
                 Station &s = sn->st;
                 cout << s.id << " | " << s.name << " | " << s.location 
-                     << " | Capacity:" << s.capacity << " | Load:" << s.load << " | Status:" << s.status << "\n";
+                     << " | Capacity:" << s.capacity << " | Load:" << s.load << " | Status:" << cityDictName(stationStatuses, s.status) << "\n";
             }
         }
         return;
@@ -1,4 +1,5 @@
 #include <bits/stdc++.h>
+#include "../../Manthan/city_dict.h"
 using namespace std;
 
 // ---------- Helper ----------
@@ -7,10 +8,17 @@ int safeStoi(const string &s) {
     catch(...) { return 0; }
 }
 
+// ---------- Station Status ----------
+// Statuses are kept as small integer codes; unknown values from the CSV are
+// interned after these and written back unchanged.
+enum StationStatus { STATION_ACTIVE, STATION_OVERLOADED, STATION_UNDERUTILIZED };
+CityDict stationStatuses = cityDictMake({"active", "overloaded", "underutilized"});
+
 // ---------- Structures ----------
 struct MetroStation {
-    string id, name, location, status;
+    string id, name, location;
     int capacity, daily_ridership;
+    CityCode status;
 };
 
 struct BusRoute {
@@ -56,7 +64,7 @@ void loadStations() {
         if (!getline(ss, s.location, ',')) continue;
         if (!getline(ss, cell, ',')) continue; s.capacity = safeStoi(cell);
         if (!getline(ss, cell, ',')) continue; s.daily_ridership = safeStoi(cell);
-        if (!getline(ss, s.status, ',')) s.status = "active";
+        s.status = getline(ss, cell, ',') ? cityIntern(stationStatuses, cell) : (CityCode)STATION_ACTIVE;
         if (s.id.empty() || s.name.empty()) continue;
         stations.push_back(s);
     }
@@ -80,7 +88,7 @@ void saveStations() {
     out << "id,name,location,capacity,daily_ridership,status\n";
     for (auto &s : stations)
         out << s.id << "," << s.name << "," << s.location << ","
-            << s.capacity << "," << s.daily_ridership << "," << s.status << "\n";
+            << s.capacity << "," << s.daily_ridership << "," << cityDictName(stationStatuses, s.status) << "\n";
     out.close();
 }
 
@@ -145,7 +153,7 @@ void addStation() {
     cout << "Enter Name: "; cin >> s.name;
     cout << "Enter Location: "; cin >> s.location;
     cout << "Enter Capacity: "; cin >> s.capacity;
-    s.daily_ridership = 0; s.status = "active";
+    s.daily_ridership = 0; s.status = STATION_ACTIVE;
     stations.push_back(s);
     saveStations();
     cout << "Station added.\n";
@@ -167,7 +175,7 @@ void viewStations() {
     cout << string(64,'-') << "\n";
     for(auto &s : stations)
         cout << left << setw(5) << s.id << setw(12) << s.name << setw(12) << s.location
-             << setw(10) << s.capacity << setw(15) << s.daily_ridership << setw(10) << s.status << "\n";
+             << setw(10) << s.capacity << setw(15) << s.daily_ridership << setw(10) << cityDictName(stationStatuses, s.status) << "\n";
 }
 
 void addRoute() {
@@ -229,7 +237,7 @@ void searchStation() {
         cout << s.id << " | " << s.name << " | " << s.location
              << " | Capacity: " << s.capacity
              << " | Daily Ridership: " << s.daily_ridership
-             << " | " << s.status << "\n";
+             << " | " << cityDictName(stationStatuses, s.status) << "\n";
     }
 }
 
@@ -63,9 +63,6 @@ struct Shop {
     ItemNode *root;
 };
 
-Shop mallShops[MALL_MAX_SHOPS];
-int shopCount = 0;
-
 // =====================================================
 // STAFF SYSTEM
 // =====================================================
@@ -77,9 +74,6 @@ struct Staff {
     int salary;
 };
 
-Staff staffList[MALL_MAX_STAFF];
-int staffCount = 0;
-
 // =====================================================
 // CLEANING LOG
 // =====================================================
@@ -89,8 +83,17 @@ struct CleanEvent {
     string note;
 };
 
-CleanEvent cleanLog[MALL_MAX_CLEAN];
-int cleanCount = 0;
+// =====================================================
+// MODULE CONTEXT
+// =====================================================
+// Created by mallInitModule(); MALL_MAX_* cap the row counts.
+
+struct MallContext {
+    vector<Shop> shops;
+    vector<Staff> staff;
+    vector<CleanEvent> cleanLog;
+};
+MallContext *mallCtx = NULL;
 
 // =====================================================
 // PARKING GRID (BFS)
@@ -144,12 +147,12 @@ ItemBST itemManager;
 // =====================================================
 
 int partitionQuick(int arr[], int l, int r) {
-    int pivot = mallShops[arr[l]].revenue;
+    int pivot = mallCtx->shops[arr[l]].revenue;
     int i = l, j = r + 1;
 
     while (true) {
-        do { i++; } while (i <= r && mallShops[arr[i]].revenue > pivot);
-        do { j--; } while (mallShops[arr[j]].revenue < pivot);
+        do { i++; } while (i <= r && mallCtx->shops[arr[i]].revenue > pivot);
+        do { j--; } while (mallCtx->shops[arr[j]].revenue < pivot);
         if (i >= j) break;
         swap(arr[i], arr[j]);
     }
@@ -211,7 +214,7 @@ int createShopID() {
 }
 
 void addShop() {
-    if (shopCount >= MALL_MAX_SHOPS) {
+    if (mallCtx->shops.size() >= MALL_MAX_SHOPS) {
         cout << "Shop limit reached.\n";
         return;
     }
@@ -226,15 +229,16 @@ void addShop() {
     cout << "Close time (HH:MM): ";
     cin >> cl;
 
-    mallShops[shopCount].id = createShopID();
-    mallShops[shopCount].name = nm;
-    mallShops[shopCount].open_time = timeToMin(op);
-    mallShops[shopCount].close_time = timeToMin(cl);
-    mallShops[shopCount].revenue = 0;
-    mallShops[shopCount].root = NULL;
+    Shop sh = {};
+    sh.id = createShopID();
+    sh.name = nm;
+    sh.open_time = timeToMin(op);
+    sh.close_time = timeToMin(cl);
+    sh.revenue = 0;
+    sh.root = NULL;
+    mallCtx->shops.push_back(sh);
 
-    cout << "Shop added (ID = " << mallShops[shopCount].id << ")\n";
-    shopCount++;
+    cout << "Shop added (ID = " << sh.id << ")\n";
 }
 
 void addItemToShop() {
@@ -243,8 +247,8 @@ void addItemToShop() {
     cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < shopCount; i++)
-        if (mallShops[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->shops.size(); i++)
+        if (mallCtx->shops[i].id == id) idx = i;
 
     if (idx == -1) { cout << "Shop not found.\n"; return; }
 
@@ -259,25 +263,25 @@ void addItemToShop() {
     cout << "Stock: ";
     cin >> stock;
 
-    mallShops[idx].root = itemManager.insertNode(
-        mallShops[idx].root, name, price, stock
+    mallCtx->shops[idx].root = itemManager.insertNode(
+        mallCtx->shops[idx].root, name, price, stock
     );
 
     cout << "Item added!\n";
 }
 
 void showAllShops() {
-    if (shopCount == 0) { cout << "No shops.\n"; return; }
-
-    for (int i = 0; i < shopCount; i++) {
-        cout << "\n----------- SHOP " << mallShops[i].id << " -----------\n";
-        cout << "Name: " << mallShops[i].name << "\n";
-        cout << "Time: " << minToTime(mallShops[i].open_time)
-             << " - " << minToTime(mallShops[i].close_time) << "\n";
-        cout << "Revenue: " << mallShops[i].revenue << "\n";
+    if (mallCtx->shops.empty()) { cout << "No shops.\n"; return; }
+
+    for (size_t i = 0; i < mallCtx->shops.size(); i++) {
+        cout << "\n----------- SHOP " << mallCtx->shops[i].id << " -----------\n";
+        cout << "Name: " << mallCtx->shops[i].name << "\n";
+        cout << "Time: " << minToTime(mallCtx->shops[i].open_time)
+             << " - " << minToTime(mallCtx->shops[i].close_time) << "\n";
+        cout << "Revenue: " << mallCtx->shops[i].revenue << "\n";
         cout << "Items:\n";
-        if (!mallShops[i].root) cout << "  (empty)\n";
-        else itemManager.inorder(mallShops[i].root);
+        if (!mallCtx->shops[i].root) cout << "  (empty)\n";
+        else itemManager.inorder(mallCtx->shops[i].root);
     }
 }
 
@@ -287,15 +291,15 @@ void simulateCustomer() {
     cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < shopCount; i++)
-        if (mallShops[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->shops.size(); i++)
+        if (mallCtx->shops[i].id == id) idx = i;
 
-    if (idx == -1 || !mallShops[idx].root) {
+    if (idx == -1 || !mallCtx->shops[idx].root) {
         cout << "Invalid shop or no items.\n";
         return;
     }
 
-    ItemNode *cur = mallShops[idx].root;
+    ItemNode *cur = mallCtx->shops[idx].root;
     while (cur->left) cur = cur->left;
 
     if (cur->stock <= 0) { cout << "Out of stock.\n"; return; }
@@ -304,23 +308,24 @@ void simulateCustomer() {
     qty = min(qty, cur->stock);
 
     cur->stock -= qty;
-    mallShops[idx].revenue += qty * cur->price;
+    mallCtx->shops[idx].revenue += qty * cur->price;
 
     cout << "Sold " << qty << " of " << cur->name << "\n";
 }
 
 void sortShopsByRevenue() {
-    if (shopCount == 0) { cout << "No shops.\n"; return; }
+    if (mallCtx->shops.empty()) { cout << "No shops.\n"; return; }
 
-    int arr[MALL_MAX_SHOPS];
+    int shopCount = mallCtx->shops.size();
+    vector<int> arr(shopCount);
     for (int i = 0; i < shopCount; i++) arr[i] = i;
 
-    quickSortShops(arr, 0, shopCount - 1);
+    quickSortShops(arr.data(), 0, shopCount - 1);
 
     cout << "\n--- Shops sorted (high → low revenue) ---\n";
-    for (int i = 0; i < shopCount; i++) {
-        cout << mallShops[arr[i]].name
-             << " | Rs " << mallShops[arr[i]].revenue << "\n";
+    for (size_t i = 0; i < mallCtx->shops.size(); i++) {
+        cout << mallCtx->shops[arr[i]].name
+             << " | Rs " << mallCtx->shops[arr[i]].revenue << "\n";
     }
 }
 
@@ -329,30 +334,31 @@ void sortShopsByRevenue() {
 // =====================================================
 
 void addStaff() {
-    if (staffCount >= MALL_MAX_STAFF) {
+    if (mallCtx->staff.size() >= MALL_MAX_STAFF) {
         cout << "Staff limit reached.\n";
         return;
     }
 
     cin.ignore();
+    Staff st = {};
     cout << "Staff name: ";
-    getline(cin, staffList[staffCount].name);
+    getline(cin, st.name);
     cout << "Role: ";
-    getline(cin, staffList[staffCount].role);
+    getline(cin, st.role);
     cout << "Salary: ";
-    cin >> staffList[staffCount].salary;
+    cin >> st.salary;
 
-    staffList[staffCount].id = staffCount + 1;
-    staffCount++;
+    st.id = mallCtx->staff.size() + 1;
+    mallCtx->staff.push_back(st);
     cout << "Staff added.\n";
 }
 
 void showStaff() {
-    for (int i = 0; i < staffCount; i++) {
-        cout << staffList[i].id << ") "
-             << staffList[i].name << " - "
-             << staffList[i].role << " - Rs "
-             << staffList[i].salary << "\n";
+    for (size_t i = 0; i < mallCtx->staff.size(); i++) {
+        cout << mallCtx->staff[i].id << ") "
+             << mallCtx->staff[i].name << " - "
+             << mallCtx->staff[i].role << " - Rs "
+             << mallCtx->staff[i].salary << "\n";
     }
 }
 
@@ -361,20 +367,17 @@ void deleteStaff() {
     int id; cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < staffCount; i++)
-        if (staffList[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->staff.size(); i++)
+        if (mallCtx->staff[i].id == id) idx = i;
 
     if (idx == -1) { cout << "Staff not found.\n"; return; }
 
-    for (int i = idx; i < staffCount - 1; i++)
-        staffList[i] = staffList[i + 1];
-
-    staffCount--;
+    mallCtx->staff.erase(mallCtx->staff.begin() + idx);
     cout << "Staff removed.\n";
 }
 
 void scheduleCleaner() {
-    if (cleanCount >= MALL_MAX_CLEAN) {
+    if (mallCtx->cleanLog.size() >= MALL_MAX_CLEAN) {
         cout << "Cleaner log full.\n";
         return;
     }
@@ -387,15 +390,13 @@ void scheduleCleaner() {
     cout << "Note: ";
     getline(cin, note);
 
-    cleanLog[cleanCount].time = timeToMin(t);
-    cleanLog[cleanCount].note = note;
-    cleanCount++;
+    mallCtx->cleanLog.push_back({ timeToMin(t), note });
 }
 
 void showCleanLog() {
-    for (int i = 0; i < cleanCount; i++)
-        cout << minToTime(cleanLog[i].time)
-             << " - " << cleanLog[i].note << "\n";
+    for (size_t i = 0; i < mallCtx->cleanLog.size(); i++)
+        cout << minToTime(mallCtx->cleanLog[i].time)
+             << " - " << mallCtx->cleanLog[i].note << "\n";
 }
 
 // =====================================================
@@ -419,26 +420,39 @@ int splitCSV(const string &line, string out[], int maxCols) {
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int countRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 int loadShopsCSV(const string &f) {
     ifstream in(f);
     if (!in.is_open()) { cout << "ERROR loading " << f << "\n"; return 0; }
 
+    mallCtx->shops.reserve(mallCtx->shops.size() + min(countRows(in), MALL_MAX_SHOPS));
     string line; getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
-        if (shopCount >= MALL_MAX_SHOPS) break;
+        if (mallCtx->shops.size() >= MALL_MAX_SHOPS) break;
         string c[5];
         if (splitCSV(line, c, 5) < 4) continue;
 
-        mallShops[shopCount].id = createShopID();
-        mallShops[shopCount].name = c[0];
-        mallShops[shopCount].open_time = timeToMin(c[1]);
-        mallShops[shopCount].close_time = timeToMin(c[2]);
-        mallShops[shopCount].revenue = toInt(c[3]);
-        mallShops[shopCount].root = NULL;
+        Shop sh = {};
+        sh.id = createShopID();
+        sh.name = c[0];
+        sh.open_time = timeToMin(c[1]);
+        sh.close_time = timeToMin(c[2]);
+        sh.revenue = toInt(c[3]);
+        sh.root = NULL;
+        mallCtx->shops.push_back(sh);
 
-        shopCount++; loaded++;
+        loaded++;
     }
     cout << "Loaded " << loaded << " shops.\n";
     return loaded;
@@ -456,11 +470,11 @@ int loadItemsCSV(const string &f) {
         if (splitCSV(line, c, 5) < 4) continue;
         int id = toInt(c[0]);
 
-        for (int i = 0; i < shopCount; i++)
-            if (mallShops[i].id == id)
-                mallShops[i].root =
+        for (size_t i = 0; i < mallCtx->shops.size(); i++)
+            if (mallCtx->shops[i].id == id)
+                mallCtx->shops[i].root =
                     itemManager.insertNode(
-                        mallShops[i].root,
+                        mallCtx->shops[i].root,
                         c[1], toInt(c[2]), toInt(c[3])
                     );
         loaded++;
@@ -473,17 +487,18 @@ int loadStaffCSV(const string &f) {
     ifstream in(f);
     if (!in.is_open()) { cout << "ERROR loading " << f << "\n"; return 0; }
 
+    mallCtx->staff.reserve(mallCtx->staff.size() + min(countRows(in), MALL_MAX_STAFF));
     string line; getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
-        if (staffCount >= MALL_MAX_STAFF) break;
+        if (mallCtx->staff.size() >= MALL_MAX_STAFF) break;
         string c[5];
         if (splitCSV(line, c, 5) < 3) continue;
 
-        staffList[staffCount++] = {
-            staffCount + 1, c[0], c[1], toInt(c[2])
-        };
+        mallCtx->staff.push_back({
+            (int)mallCtx->staff.size() + 1, c[0], c[1], toInt(c[2])
+        });
         loaded++;
     }
     cout << "Loaded " << loaded << " staff.\n";
@@ -568,7 +583,7 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
     string patt = pattern;
     transform(patt.begin(), patt.end(), patt.begin(), ::tolower);
 
-    for (int s = 0; s < shopCount; s++) {
+    for (size_t s = 0; s < mallCtx->shops.size(); s++) {
         function<void(ItemNode*)> dfs = [&](ItemNode *node) {
             if (!node) return;
 
@@ -579,8 +594,8 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
 
             if (kmpSearch(item, patt)) {
                 results.push_back({
-                    mallShops[s].id,
-                    mallShops[s].name,
+                    mallCtx->shops[s].id,
+                    mallCtx->shops[s].name,
                     node->name,
                     node->price,
                     node->stock
@@ -590,7 +605,7 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
             dfs(node->right);
         };
 
-        dfs(mallShops[s].root);
+        dfs(mallCtx->shops[s].root);
     }
 
     return results;
@@ -655,7 +670,13 @@ void showMenu() {
     cout << "Enter choice: ";
 }
 
+void mallInitModule() {
+    if (mallCtx) return; // state is kept across visits to the menu
+    mallCtx = new MallContext();
+}
+
 void mallSystem() {
+    mallInitModule();
     srand(time(NULL));
     int choice;
     while (true) {
@@ -699,6 +720,9 @@ void mallSystem() {
 #include <functional>
 #include <cstring> // for strncpy
 #include <limits>
+#include "../city_date.h"
+#include "../city_dict.h"
+#include "../city_ring.h"
 
 using namespace std;
 
@@ -713,7 +737,7 @@ using namespace std;
 #define THEATRE_MAX_SNACK_ORDERS 20000
 #define THEATRE_MAX_STAFF 2000
 #define THEATRE_MAX_MAINT_LOGS 5000
-#define THEATRE_HASH_SIZE 32749
+#define THEATRE_HASH_MIN 64 // initial booking slots (power of two)
 #define THEATRE_INF 999999
 
 // -------------------- SIMPLE CSV & UTIL HELPERS --------------------
@@ -739,6 +763,17 @@ int theatreSplitCSV(const string &line, string out[], int maxCols) {
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int theatreCountRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line))
+        rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // -------------------- DATA STRUCTS --------------------
 // Movie BST (manual pointers)
 struct TheatreMovie
@@ -749,12 +784,12 @@ struct TheatreMovie
     int duration_minutes;
     double rating;
     string language;
-    string release_date;
+    CityDate release_date;
     TheatreMovie *left;
     TheatreMovie *right;
 };
 
-// Auditorium (array-based seats)
+// Auditorium (row-major seat grid sized rows*cols, seat (r,c) at r*cols+c)
 struct TheatreAuditorium
 {
     int aud_id;
@@ -762,8 +797,8 @@ struct TheatreAuditorium
     int rows;
     int cols;
     int total_seats;
-    char seats[THEATRE_MAX_SEAT_ROWS][THEATRE_MAX_SEAT_COLS]; // 'E','B','X'
-    string seat_type[THEATRE_MAX_SEAT_ROWS][THEATRE_MAX_SEAT_COLS];
+    vector<char> seats; // 'E','B','X'
+    vector<CityCode> seat_type; // theatreSeatTypes code per seat
 };
 
 // Show (array)
@@ -772,8 +807,8 @@ struct TheatreShow
     int show_id;
     int movie_id;
     int aud_id;
-    string start_datetime; // "YYYY-MM-DD HH:MM"
-    string end_datetime;
+    CityDateTime start_datetime; // minutes since epoch, printed as "YYYY-MM-DD HH:MM"
+    CityDateTime end_datetime;
     int base_price;
     int tickets_sold;
     int revenue;
@@ -789,7 +824,7 @@ struct TheatreBooking
     char customer_phone[20];
     int price_paid;
     int status; // 0 cancelled, 1 active
-    char booking_datetime[32];
+    CityDateTime booking_datetime;
 };
 
 // booking hash entry
@@ -821,7 +856,7 @@ struct TheatreSnackOrder
     int item_count;
     int total_price;
     int status; // 0 pending,1 inprogress,2 done
-    char order_datetime[32];
+    CityDateTime order_datetime;
 };
 
 // staff & maintenance
@@ -836,52 +871,45 @@ struct TheatreMaint
 {
     int id;
     int aud_id;
-    string date;
+    CityDate date;
     string task;
     int staff_id;
     int status;
 };
 
-// -------------------- MODULE GLOBALS --------------------
-static TheatreMovie *theatreMovieRoot = NULL;
-static TheatreAuditorium auditoriums[THEATRE_MAX_AUDITORIUMS];
-static int theatreAudCount = 0;
+// seat types seen in auditoriums.csv; "standard" is the default
+static CityDict theatreSeatTypes = cityDictMake({"standard"});
+#define THEATRE_SEAT_STANDARD 0
+
+// -------------------- MODULE CONTEXT --------------------
+// Created by theatreInitModule() on first use; THEATRE_MAX_* cap the row counts.
+struct TheatreContext
+{
+    vector<TheatreAuditorium> auditoriums;
+    vector<TheatreShow> shows;
+    vector<TheatreBookingEntry> bookingHash; // power-of-two slots
+    vector<TheatreSnack> snacks;
+    vector<TheatreSnackOrder> snackQueue;    // ring buffer, grown on demand
+    vector<TheatreStaff> staff;
+    vector<TheatreMaint> maint;
+};
+static TheatreContext *theatreCtx = NULL;
 
-static TheatreShow shows[THEATRE_MAX_SHOWS];
-static int theatreShowCount = 0;
+inline char &theatre_seat(TheatreAuditorium &a, int r, int c) { return a.seats[r * a.cols + c]; }
 
-static TheatreBookingEntry bookingHash[THEATRE_HASH_SIZE];
+// -------------------- MODULE GLOBALS --------------------
+static TheatreMovie *theatreMovieRoot = NULL;
 static int theatreBookingCount = 0;
+static int theatreBookingSlotsUsed = 0; // live + deleted slots, drives rehash
 static int theatreNextBookingId = 50000;
-
-static TheatreSnack snacks[THEATRE_MAX_SNACKS];
-static int theatreSnackCount = 0;
-
-static TheatreSnackOrder snackQueueArr[THEATRE_MAX_SNACK_ORDERS];
 static int snackQueueFront = 0, snackQueueRear = -1, snackQueueCount = 0;
 
-static TheatreStaff theatreStaff[THEATRE_MAX_STAFF];
-static int theatreStaffCount = 0;
-static TheatreMaint theatreMaint[THEATRE_MAX_MAINT_LOGS];
-static int theatreMaintCount = 0;
-
 // auditorium graph for Dijkstra (matrix)
 
 
-// -------------------- SMALL HELPERS --------------------
-static string theatre_now_datetime()
-{
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[64];
-    sprintf(buf, "%04d-%02d-%02d %02d:%02d",
-            tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min);
-    return string(buf);
-}
-
 // -------------------- MOVIE BST FUNCTIONS --------------------
 TheatreMovie *theatreCreateMovieNode(int id, const string &title, const string &genre,
-                                     int duration, double rating, const string &lang, const string &rdate)
+                                     int duration, double rating, const string &lang, CityDate rdate)
 {
     TheatreMovie *m = new TheatreMovie();
     m->movie_id = id;
@@ -937,7 +965,7 @@ void theatreInorderList(TheatreMovie *root)
     theatreInorderList(root->left);
     cout << "ID:" << root->movie_id << " | " << root->title << " | " << root->genre
          << " | " << root->duration_minutes << "min | Rating:" << root->rating
-         << " | " << root->language << " | " << root->release_date << "\n";
+         << " | " << root->language << " | " << cityFormatDate(root->release_date) << "\n";
     theatreInorderList(root->right);
 }
 
@@ -1027,11 +1055,11 @@ void theatre_quickSort_indices(int arr[], int l, int r, IndexCmpFunc cmp)
     }
 }
 
-// comparator for shows by start_datetime (lexicographic compares works for YYYY-MM-DD HH:MM)
+// comparator for shows by start_datetime
 int theatre_cmp_show_start(int Aidx, int Bidx)
 {
-    string A = shows[Aidx].start_datetime;
-    string B = shows[Bidx].start_datetime;
+    CityDateTime A = theatreCtx->shows[Aidx].start_datetime;
+    CityDateTime B = theatreCtx->shows[Bidx].start_datetime;
     if (A < B)
         return -1;
     if (A > B)
@@ -1042,9 +1070,9 @@ int theatre_cmp_show_start(int Aidx, int Bidx)
 // comparator for shows by revenue (desc)
 int theatre_cmp_show_revenue(int Aidx, int Bidx)
 {
-    if (shows[Aidx].revenue > shows[Bidx].revenue)
+    if (theatreCtx->shows[Aidx].revenue > theatreCtx->shows[Bidx].revenue)
         return -1;
-    if (shows[Aidx].revenue < shows[Bidx].revenue)
+    if (theatreCtx->shows[Aidx].revenue < theatreCtx->shows[Bidx].revenue)
         return 1;
     return 0;
 }
@@ -1140,19 +1168,54 @@ bool theatre_kmp_search(const string &text, const string &pat)
 }
 
 // -------------------- BOOKING HASH (open addressing linear probing) --------------------
+// Power-of-two table, rebuilt twice as large (dropping tombstones) once live
+// plus deleted slots pass 70%.
 unsigned int theatre_hash_key(int key)
 {
-    return (unsigned int)(key * 2654435761u) % THEATRE_HASH_SIZE;
+    return (unsigned int)(key * 2654435761u) & (unsigned int)(theatreCtx->bookingHash.size() - 1);
 }
 void theatre_init_booking_hash()
 {
-    for (int i = 0; i < THEATRE_HASH_SIZE; ++i)
+    TheatreBookingEntry e;
+    e.key = -1;
+    e.used = false;
+    e.deleted = false;
+    theatreCtx->bookingHash.assign(THEATRE_HASH_MIN, e);
+    theatreBookingCount = 0;
+    theatreBookingSlotsUsed = 0;
+}
+static void theatre_booking_rehash(size_t slots)
+{
+    vector<TheatreBookingEntry> old;
+    old.swap(theatreCtx->bookingHash);
+    TheatreBookingEntry e;
+    e.key = -1;
+    e.used = false;
+    e.deleted = false;
+    theatreCtx->bookingHash.assign(slots, e);
+    theatreBookingSlotsUsed = theatreBookingCount;
+    unsigned int mask = (unsigned int)(slots - 1);
+    for (size_t i = 0; i < old.size(); ++i)
     {
-        bookingHash[i].used = false;
-        bookingHash[i].deleted = false;
-        bookingHash[i].key = -1;
+        if (!old[i].used || old[i].deleted)
+            continue;
+        unsigned int idx = theatre_hash_key(old[i].key);
+        while (theatreCtx->bookingHash[idx].used)
+            idx = (idx + 1) & mask;
+        theatreCtx->bookingHash[idx] = old[i];
     }
 }
+// Make room for `more` bookings without further rehashing.
+void theatre_booking_reserve(int more)
+{
+    size_t need = (size_t)(theatreBookingSlotsUsed + more) * 10 / 7 + 1;
+    if (need <= theatreCtx->bookingHash.size())
+        return;
+    size_t slots = theatreCtx->bookingHash.size();
+    while (slots < need)
+        slots *= 2;
+    theatre_booking_rehash(slots);
+}
 bool theatre_booking_insert(const TheatreBooking &b)
 {
     if (theatreBookingCount >= THEATRE_MAX_BOOKINGS)
@@ -1160,56 +1223,49 @@ bool theatre_booking_insert(const TheatreBooking &b)
         cout << "Overflow: booking capacity reached!\n";
         return false;
     }
+    if ((size_t)(theatreBookingSlotsUsed + 1) * 10 > theatreCtx->bookingHash.size() * 7)
+        theatre_booking_rehash(theatreCtx->bookingHash.size() * 2);
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(b.booking_id);
-    unsigned int start = idx;
-    while (bookingHash[idx].used && !bookingHash[idx].deleted && bookingHash[idx].key != b.booking_id)
-    {
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-        {
-            cout << "Hash table full!\n";
-            return false;
-        }
-    }
-    bookingHash[idx].used = true;
-    bookingHash[idx].deleted = false;
-    bookingHash[idx].key = b.booking_id;
-    bookingHash[idx].val = b;
+    while (theatreCtx->bookingHash[idx].used && !theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key != b.booking_id)
+        idx = (idx + 1) & mask;
+    if (!theatreCtx->bookingHash[idx].used)
+        theatreBookingSlotsUsed++;
+    theatreCtx->bookingHash[idx].used = true;
+    theatreCtx->bookingHash[idx].deleted = false;
+    theatreCtx->bookingHash[idx].key = b.booking_id;
+    theatreCtx->bookingHash[idx].val = b;
     theatreBookingCount++;
     return true;
 }
 bool theatre_booking_get(int key, TheatreBooking &out)
 {
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(key);
-    unsigned int start = idx;
-    while (bookingHash[idx].used)
+    while (theatreCtx->bookingHash[idx].used)
     {
-        if (!bookingHash[idx].deleted && bookingHash[idx].key == key)
+        if (!theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key == key)
         {
-            out = bookingHash[idx].val;
+            out = theatreCtx->bookingHash[idx].val;
             return true;
         }
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-            break;
+        idx = (idx + 1) & mask;
     }
     return false;
 }
 bool theatre_booking_remove(int key)
 {
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(key);
-    unsigned int start = idx;
-    while (bookingHash[idx].used)
+    while (theatreCtx->bookingHash[idx].used)
     {
-        if (!bookingHash[idx].deleted && bookingHash[idx].key == key)
+        if (!theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key == key)
         {
-            bookingHash[idx].deleted = true;
+            theatreCtx->bookingHash[idx].deleted = true;
             theatreBookingCount--;
             return true;
         }
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-            break;
+        idx = (idx + 1) & mask;
     }
     return false;
 }
@@ -1228,8 +1284,10 @@ bool theatre_enqueue_snack(const TheatreSnackOrder &ord)
         cout << "Overflow: snack queue full!\n";
         return false;
     }
-    snackQueueRear = (snackQueueRear + 1) % THEATRE_MAX_SNACK_ORDERS;
-    snackQueueArr[snackQueueRear] = ord;
+    if (snackQueueCount == (int)theatreCtx->snackQueue.size())
+        cityRingGrow(theatreCtx->snackQueue, snackQueueFront, snackQueueRear, snackQueueCount, THEATRE_MAX_SNACK_ORDERS);
+    snackQueueRear = (snackQueueRear + 1) % (int)theatreCtx->snackQueue.size();
+    theatreCtx->snackQueue[snackQueueRear] = ord;
     snackQueueCount++;
     return true;
 }
@@ -1239,8 +1297,8 @@ TheatreSnackOrder theatre_dequeue_snack()
     empty.order_id = -1;
     if (snackQueueCount == 0)
         return empty;
-    TheatreSnackOrder res = snackQueueArr[snackQueueFront];
-    snackQueueFront = (snackQueueFront + 1) % THEATRE_MAX_SNACK_ORDERS;
+    TheatreSnackOrder res = theatreCtx->snackQueue[snackQueueFront];
+    snackQueueFront = (snackQueueFront + 1) % (int)theatreCtx->snackQueue.size();
     snackQueueCount--;
     return res;
 }
@@ -1277,7 +1335,7 @@ void theatreLoadMoviesCSV(const string &fn)
         int dur = theatreToInt(cols[3]);
         double rating = atof(cols[4].c_str());
         string lang = cols[5];
-        string date = (n >= 7 ? cols[6] : "1970-01-01");
+        CityDate date = (n >= 7 ? cityDate(cols[6]) : 0);
         TheatreMovie *m = theatreCreateMovieNode(id, title, genre, dur, rating, lang, date);
         theatreMovieRoot = theatreInsertMovieNode(theatreMovieRoot, m);
         loaded++;
@@ -1294,6 +1352,7 @@ void theatreLoadAuditoriumsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->auditoriums.reserve(theatreCtx->auditoriums.size() + min(theatreCountRows(in), THEATRE_MAX_AUDITORIUMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -1305,26 +1364,22 @@ void theatreLoadAuditoriumsCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 8);
         if (n < 4)
             continue;
-        if (theatreAudCount >= THEATRE_MAX_AUDITORIUMS)
+        if ((int)theatreCtx->auditoriums.size() >= THEATRE_MAX_AUDITORIUMS)
         {
             cout << "Overflow: auditoriums max reached!\n";
             break;
         }
-        int id = theatreToInt(cols[0]);
-        auditoriums[theatreAudCount].aud_id = id;
-        auditoriums[theatreAudCount].name = cols[1];
-        int r = min(theatreToInt(cols[2]), THEATRE_MAX_SEAT_ROWS);
-        int c = min(theatreToInt(cols[3]), THEATRE_MAX_SEAT_COLS);
-        auditoriums[theatreAudCount].rows = r;
-        auditoriums[theatreAudCount].cols = c;
-        auditoriums[theatreAudCount].total_seats = r * c;
-        for (int i = 0; i < r; ++i)
-            for (int j = 0; j < c; ++j)
-            {
-                auditoriums[theatreAudCount].seats[i][j] = 'E';
-                auditoriums[theatreAudCount].seat_type[i][j] = "standard";
-            }
-        theatreAudCount++;
+        TheatreAuditorium a;
+        a.aud_id = theatreToInt(cols[0]);
+        a.name = cols[1];
+        int r = max(0, min(theatreToInt(cols[2]), THEATRE_MAX_SEAT_ROWS));
+        int c = max(0, min(theatreToInt(cols[3]), THEATRE_MAX_SEAT_COLS));
+        a.rows = r;
+        a.cols = c;
+        a.total_seats = r * c;
+        a.seats.assign(r * c, 'E');
+        a.seat_type.assign(r * c, (n >= 5 && !cols[4].empty()) ? cityIntern(theatreSeatTypes, cols[4]) : (CityCode)THEATRE_SEAT_STANDARD);
+        theatreCtx->auditoriums.push_back(a);
         loaded++;
     }
     
@@ -1340,6 +1395,7 @@ void theatreLoadShowsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->shows.reserve(theatreCtx->shows.size() + min(theatreCountRows(in), THEATRE_MAX_SHOWS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -1351,20 +1407,21 @@ void theatreLoadShowsCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 8);
         if (n < 6)
             continue;
-        if (theatreShowCount >= THEATRE_MAX_SHOWS)
+        if ((int)theatreCtx->shows.size() >= THEATRE_MAX_SHOWS)
         {
             cout << "Overflow: shows max reached!\n";
             break;
         }
-        shows[theatreShowCount].show_id = theatreToInt(cols[0]);
-        shows[theatreShowCount].movie_id = theatreToInt(cols[1]);
-        shows[theatreShowCount].aud_id = theatreToInt(cols[2]);
-        shows[theatreShowCount].start_datetime = cols[3];
-        shows[theatreShowCount].end_datetime = cols[4];
-        shows[theatreShowCount].base_price = theatreToInt(cols[5]);
-        shows[theatreShowCount].tickets_sold = 0;
-        shows[theatreShowCount].revenue = 0;
-        theatreShowCount++;
+        TheatreShow sh;
+        sh.show_id = theatreToInt(cols[0]);
+        sh.movie_id = theatreToInt(cols[1]);
+        sh.aud_id = theatreToInt(cols[2]);
+        sh.start_datetime = cityDateTime(cols[3]);
+        sh.end_datetime = cityDateTime(cols[4]);
+        sh.base_price = theatreToInt(cols[5]);
+        sh.tickets_sold = 0;
+        sh.revenue = 0;
+        theatreCtx->shows.push_back(sh);
         loaded++;
     }
     cout << "Loaded " << loaded << " shows from " << fn << "\n";
@@ -1379,6 +1436,7 @@ void theatreLoadBookingsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatre_booking_reserve(min(theatreCountRows(in), THEATRE_MAX_BOOKINGS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -1401,18 +1459,15 @@ void theatreLoadBookingsCSV(const string &fn)
         b.customer_phone[sizeof(b.customer_phone) - 1] = 0;
         b.price_paid = theatreToInt(cols[5]);
         b.status = theatreToInt(cols[6]);
-        if (n >= 8)
-            strncpy(b.booking_datetime, cols[7].c_str(), sizeof(b.booking_datetime) - 1);
-        else
-            strncpy(b.booking_datetime, theatre_now_datetime().c_str(), sizeof(b.booking_datetime) - 1);
+        b.booking_datetime = (n >= 8 ? cityDateTime(cols[7]) : cityNow());
         theatre_booking_insert(b);
         loaded++;
         // mark seat as booked in auditorium if possible
         int sidx = -1;
-        for (int i = 0; i < theatreShowCount; ++i) if (shows[i].show_id == b.show_id) { sidx = i; break; }
+        for (int i = 0; i < (int)theatreCtx->shows.size(); ++i) if (theatreCtx->shows[i].show_id == b.show_id) { sidx = i; break; }
         if (sidx != -1) {
             int aud_idx = -1;
-            for (int i = 0; i < theatreAudCount; ++i) if (auditoriums[i].aud_id == shows[sidx].aud_id) { aud_idx = i; break; }
+            for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i) if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id) { aud_idx = i; break; }
             if (aud_idx != -1) {
                 int rr, cc;
                 string seatl = string(b.seat_label);
@@ -1425,8 +1480,8 @@ void theatreLoadBookingsCSV(const string &fn)
                     if (colIdx < 0 || colIdx >= a.cols) return false;
                     r = rowIdx; c = colIdx; return true;
                 };
-                if (theatre_parse_seat_label_local(auditoriums[aud_idx], seatl, rr, cc)) {
-                    auditoriums[aud_idx].seats[rr][cc] = (b.status==1 ? 'B' : 'E');
+                if (theatre_parse_seat_label_local(theatreCtx->auditoriums[aud_idx], seatl, rr, cc)) {
+                    theatre_seat(theatreCtx->auditoriums[aud_idx], rr, cc) = (b.status==1 ? 'B' : 'E');
                 }
             }
         }
@@ -1443,6 +1498,7 @@ void theatreLoadStaffCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->staff.reserve(theatreCtx->staff.size() + min(theatreCountRows(in), THEATRE_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -1454,16 +1510,17 @@ void theatreLoadStaffCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 6);
         if (n < 4)
             continue;
-        if (theatreStaffCount >= THEATRE_MAX_STAFF)
+        if ((int)theatreCtx->staff.size() >= THEATRE_MAX_STAFF)
         {
             cout << "Overflow: theatre staff max reached!\n";
             break;
         }
-        theatreStaff[theatreStaffCount].id = theatreToInt(cols[0]);
-        theatreStaff[theatreStaffCount].name = cols[1];
-        theatreStaff[theatreStaffCount].role = cols[2];
-        theatreStaff[theatreStaffCount].salary = theatreToInt(cols[3]);
-        theatreStaffCount++;
+        TheatreStaff st;
+        st.id = theatreToInt(cols[0]);
+        st.name = cols[1];
+        st.role = cols[2];
+        st.salary = theatreToInt(cols[3]);
+        theatreCtx->staff.push_back(st);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -1502,7 +1559,7 @@ void theatreAddMovie()
     getline(cin, lang);
     cout << "Enter release date (YYYY-MM-DD): ";
     getline(cin, date);
-    TheatreMovie *m = theatreCreateMovieNode(id, title, genre, theatreToInt(durS), atof(ratingS.c_str()), lang, date);
+    TheatreMovie *m = theatreCreateMovieNode(id, title, genre, theatreToInt(durS), atof(ratingS.c_str()), lang, cityDate(date));
     theatreMovieRoot = theatreInsertMovieNode(theatreMovieRoot, m);
     cout << "Added movie id " << id << "\n";
 }
@@ -1564,12 +1621,12 @@ void theatreSearchMovie()
 // Add auditorium interactively
 void theatreAddAuditorium()
 {
-    if (theatreAudCount >= THEATRE_MAX_AUDITORIUMS)
+    if ((int)theatreCtx->auditoriums.size() >= THEATRE_MAX_AUDITORIUMS)
     {
         cout << "Overflow: auditoriums limit\n";
         return;
     }
-    int id = 600 + theatreAudCount;
+    int id = 600 + (int)theatreCtx->auditoriums.size();
     string name, rS, cS;
     cout << "Enter auditorium name: ";
     getline(cin, name);
@@ -1577,20 +1634,17 @@ void theatreAddAuditorium()
     getline(cin, rS);
     cout << "Enter cols: ";
     getline(cin, cS);
-    int r = min(theatreToInt(rS), THEATRE_MAX_SEAT_ROWS);
-    int c = min(theatreToInt(cS), THEATRE_MAX_SEAT_COLS);
-    auditoriums[theatreAudCount].aud_id = id;
-    auditoriums[theatreAudCount].name = name;
-    auditoriums[theatreAudCount].rows = r;
-    auditoriums[theatreAudCount].cols = c;
-    auditoriums[theatreAudCount].total_seats = r * c;
-    for (int i = 0; i < r; ++i)
-        for (int j = 0; j < c; ++j)
-        {
-            auditoriums[theatreAudCount].seats[i][j] = 'E';
-            auditoriums[theatreAudCount].seat_type[i][j] = "standard";
-        }
-    theatreAudCount++;
+    int r = max(0, min(theatreToInt(rS), THEATRE_MAX_SEAT_ROWS));
+    int c = max(0, min(theatreToInt(cS), THEATRE_MAX_SEAT_COLS));
+    TheatreAuditorium a;
+    a.aud_id = id;
+    a.name = name;
+    a.rows = r;
+    a.cols = c;
+    a.total_seats = r * c;
+    a.seats.assign(r * c, 'E');
+    a.seat_type.assign(r * c, (CityCode)THEATRE_SEAT_STANDARD);
+    theatreCtx->auditoriums.push_back(a);
     cout << "Added auditorium id " << id << "\n";
 }
 
@@ -1601,8 +1655,8 @@ void theatreViewSeatMap()
     cin >> id;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     int idx = -1;
-    for (int i = 0; i < theatreAudCount; ++i)
-        if (auditoriums[i].aud_id == id)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+        if (theatreCtx->auditoriums[i].aud_id == id)
         {
             idx = i;
             break;
@@ -1612,12 +1666,12 @@ void theatreViewSeatMap()
         cout << "Not found.\n";
         return;
     }
-    TheatreAuditorium &a = auditoriums[idx];
+    TheatreAuditorium &a = theatreCtx->auditoriums[idx];
     cout << "Seat map for " << a.name << " (" << a.rows << "x" << a.cols << ")\n";
     for (int r = 0; r < a.rows; ++r)
     {
         for (int c = 0; c < a.cols; ++c)
-            cout << a.seats[r][c];
+            cout << theatre_seat(a, r, c);
         cout << "\n";
     }
 }
@@ -1650,8 +1704,8 @@ void theatreBookSeat()
     cin >> sid;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     int sidx = -1;
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == sid)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == sid)
         {
             sidx = i;
             break;
@@ -1662,8 +1716,8 @@ void theatreBookSeat()
         return;
     }
     int aud_idx = -1;
-    for (int i = 0; i < theatreAudCount; ++i)
-        if (auditoriums[i].aud_id == shows[sidx].aud_id)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+        if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id)
         {
             aud_idx = i;
             break;
@@ -1677,12 +1731,12 @@ void theatreBookSeat()
     string seat;
     getline(cin, seat);
     int r, c;
-    if (!theatre_parse_seat_label(auditoriums[aud_idx], seat, r, c))
+    if (!theatre_parse_seat_label(theatreCtx->auditoriums[aud_idx], seat, r, c))
     {
         cout << "Invalid seat label\n";
         return;
     }
-    if (auditoriums[aud_idx].seats[r][c] != 'E')
+    if (theatre_seat(theatreCtx->auditoriums[aud_idx], r, c) != 'E')
     {
         cout << "Seat unavailable\n";
         return;
@@ -1702,17 +1756,17 @@ void theatreBookSeat()
     b.customer_name[sizeof(b.customer_name) - 1] = 0;
     strncpy(b.customer_phone, phone.c_str(), sizeof(b.customer_phone) - 1);
     b.customer_phone[sizeof(b.customer_phone) - 1] = 0;
-    b.price_paid = shows[sidx].base_price;
+    b.price_paid = theatreCtx->shows[sidx].base_price;
     b.status = 1;
-    strncpy(b.booking_datetime, theatre_now_datetime().c_str(), sizeof(b.booking_datetime) - 1);
+    b.booking_datetime = cityNow();
     if (!theatre_booking_insert(b))
     {
         cout << "Failed to insert booking.\n";
         return;
     }
-    auditoriums[aud_idx].seats[r][c] = 'B';
-    shows[sidx].tickets_sold++;
-    shows[sidx].revenue += b.price_paid;
+    theatre_seat(theatreCtx->auditoriums[aud_idx], r, c) = 'B';
+    theatreCtx->shows[sidx].tickets_sold++;
+    theatreCtx->shows[sidx].revenue += b.price_paid;
     cout << "Booking done. ID: " << b.booking_id << "\n";
 }
 
@@ -1735,8 +1789,8 @@ void theatreCancelBooking()
     }
     // find show and free seat
     int sidx = -1;
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == b.show_id)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == b.show_id)
         {
             sidx = i;
             break;
@@ -1744,8 +1798,8 @@ void theatreCancelBooking()
     if (sidx != -1)
     {
         int aud_idx = -1;
-        for (int i = 0; i < theatreAudCount; ++i)
-            if (auditoriums[i].aud_id == shows[sidx].aud_id)
+        for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+            if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id)
             {
                 aud_idx = i;
                 break;
@@ -1753,11 +1807,11 @@ void theatreCancelBooking()
         if (aud_idx != -1)
         {
             int rr, cc;
-            if (theatre_parse_seat_label(auditoriums[aud_idx], string(b.seat_label), rr, cc))
+            if (theatre_parse_seat_label(theatreCtx->auditoriums[aud_idx], string(b.seat_label), rr, cc))
             {
-                auditoriums[aud_idx].seats[rr][cc] = 'E';
-                shows[sidx].tickets_sold = max(0, shows[sidx].tickets_sold - 1);
-                shows[sidx].revenue = max(0, shows[sidx].revenue - b.price_paid);
+                theatre_seat(theatreCtx->auditoriums[aud_idx], rr, cc) = 'E';
+                theatreCtx->shows[sidx].tickets_sold = max(0, theatreCtx->shows[sidx].tickets_sold - 1);
+                theatreCtx->shows[sidx].revenue = max(0, theatreCtx->shows[sidx].revenue - b.price_paid);
             }
         }
     }
@@ -1767,26 +1821,26 @@ void theatreCancelBooking()
 
 void theatreListShows()
 {
-    if (theatreShowCount == 0)
+    int showCount = theatreCtx->shows.size();
+    if (showCount == 0)
     {
         cout << "No shows.\n";
         return;
     }
     int idxArr[THEATRE_MAX_SHOWS];
-    for (int i = 0; i < theatreShowCount; ++i)
+    for (int i = 0; i < showCount; ++i)
         idxArr[i] = i;
-    theatre_quickSort_indices(idxArr, 0, theatreShowCount - 1, theatre_cmp_show_start);
+    theatre_quickSort_indices(idxArr, 0, showCount - 1, theatre_cmp_show_start);
     cout << "Shows sorted by start time:\n";
-    for (int i = 0; i < theatreShowCount; ++i)
+    for (int i = 0; i < showCount; ++i)
     {
-        TheatreShow &s = shows[idxArr[i]];
-        cout << s.show_id << " | Movie:" << s.movie_id << " | Aud:" << s.aud_id << " | " << s.start_datetime << " - " << s.end_datetime << " | Price:" << s.base_price << " | Tickets:" << s.tickets_sold << "\n";
+        TheatreShow &s = theatreCtx->shows[idxArr[i]];
+        cout << s.show_id << " | Movie:" << s.movie_id << " | Aud:" << s.aud_id << " | " << cityFormatDateTime(s.start_datetime) << " - " << cityFormatDateTime(s.end_datetime) << " | Price:" << s.base_price << " | Tickets:" << s.tickets_sold << "\n";
     }
 }
 
-bool theatre_check_show_conflict(const string &s1, const string &e1, const string &s2, const string &e2)
+bool theatre_check_show_conflict(CityDateTime s1, CityDateTime e1, CityDateTime s2, CityDateTime e2)
 {
-    // assuming format YYYY-MM-DD HH:MM lexicographical comparisons work
     if (s1 >= e2)
         return false;
     if (s2 >= e1)
@@ -1796,7 +1850,7 @@ bool theatre_check_show_conflict(const string &s1, const string &e1, const strin
 
 void theatreAddShow()
 {
-    if (theatreShowCount >= THEATRE_MAX_SHOWS)
+    if ((int)theatreCtx->shows.size() >= THEATRE_MAX_SHOWS)
     {
         cout << "Overflow: shows limit\n";
         return;
@@ -1808,10 +1862,18 @@ void theatreAddShow()
     getline(cin, mS);
     cout << "Enter auditorium id: ";
     getline(cin, aS);
+    string startS, endS;
     cout << "Enter start datetime (YYYY-MM-DD HH:MM): ";
-    getline(cin, sh.start_datetime);
+    getline(cin, startS);
     cout << "Enter end datetime (YYYY-MM-DD HH:MM): ";
-    getline(cin, sh.end_datetime);
+    getline(cin, endS);
+    sh.start_datetime = cityDateTime(startS);
+    sh.end_datetime = cityDateTime(endS);
+    if (sh.start_datetime == CITY_NO_DATE || sh.end_datetime == CITY_NO_DATE)
+    {
+        cout << "Invalid datetime.\n";
+        return;
+    }
     cout << "Enter base price: ";
     string pS;
     getline(cin, pS);
@@ -1821,12 +1883,12 @@ void theatreAddShow()
     sh.tickets_sold = 0;
     sh.revenue = 0;
     // conflict check
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].aud_id == sh.aud_id)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].aud_id == sh.aud_id)
         {
-            if (theatre_check_show_conflict(sh.start_datetime, sh.end_datetime, shows[i].start_datetime, shows[i].end_datetime))
+            if (theatre_check_show_conflict(sh.start_datetime, sh.end_datetime, theatreCtx->shows[i].start_datetime, theatreCtx->shows[i].end_datetime))
             {
-                cout << "Conflict with show " << shows[i].show_id << " : " << shows[i].start_datetime << " - " << shows[i].end_datetime << "\n";
+                cout << "Conflict with show " << theatreCtx->shows[i].show_id << " : " << cityFormatDateTime(theatreCtx->shows[i].start_datetime) << " - " << cityFormatDateTime(theatreCtx->shows[i].end_datetime) << "\n";
                 cout << "Add anyway? (y/n): ";
                 char c;
                 cin >> c;
@@ -1836,20 +1898,20 @@ void theatreAddShow()
                 break;
             }
         }
-    shows[theatreShowCount++] = sh;
+    theatreCtx->shows.push_back(sh);
     cout << "Show added id " << sh.show_id << "\n";
 }
 
 // Snack functions
 void theatreAddSnack()
 {
-    if (theatreSnackCount >= THEATRE_MAX_SNACKS)
+    if ((int)theatreCtx->snacks.size() >= THEATRE_MAX_SNACKS)
     {
         cout << "Overflow: snacks limit\n";
         return;
     }
-    TheatreSnack &s = snacks[theatreSnackCount];
-    s.snack_id = 8000 + theatreSnackCount + 1;
+    TheatreSnack s;
+    s.snack_id = 8000 + (int)theatreCtx->snacks.size() + 1;
     cout << "Enter snack name: ";
     getline(cin, s.name);
     cout << "Enter category: ";
@@ -1862,18 +1924,18 @@ void theatreAddSnack()
     string t;
     getline(cin, t);
     s.prep_time = theatreToInt(t);
-    theatreSnackCount++;
+    theatreCtx->snacks.push_back(s);
     cout << "Snack added id " << s.snack_id << "\n";
 }
 void theatreListSnacks()
 {
-    if (theatreSnackCount == 0)
+    if (theatreCtx->snacks.empty())
     {
         cout << "No snacks.\n";
         return;
     }
-    for (int i = 0; i < theatreSnackCount; ++i)
-        cout << snacks[i].snack_id << " | " << snacks[i].name << " | " << snacks[i].category << " | Rs " << snacks[i].price << "\n";
+    for (int i = 0; i < (int)theatreCtx->snacks.size(); ++i)
+        cout << theatreCtx->snacks[i].snack_id << " | " << theatreCtx->snacks[i].name << " | " << theatreCtx->snacks[i].category << " | Rs " << theatreCtx->snacks[i].price << "\n";
 }
 void theatreOrderSnack()
 {
@@ -1904,13 +1966,13 @@ void theatreOrderSnack()
             break;
         if (ord.item_count < 10)
             ord.item_ids[ord.item_count++] = sid;
-        for (int i = 0; i < theatreSnackCount; ++i)
-            if (snacks[i].snack_id == sid)
-                ord.total_price += snacks[i].price;
+        for (int i = 0; i < (int)theatreCtx->snacks.size(); ++i)
+            if (theatreCtx->snacks[i].snack_id == sid)
+                ord.total_price += theatreCtx->snacks[i].price;
     }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     ord.status = 0;
-    strncpy(ord.order_datetime, theatre_now_datetime().c_str(), sizeof(ord.order_datetime) - 1);
+    ord.order_datetime = cityNow();
     if (theatre_enqueue_snack(ord))
         cout << "Order queued id " << ord.order_id << " total Rs " << ord.total_price << "\n";
 }
@@ -1941,13 +2003,13 @@ void theatreProcessSnack()
 // Staff & maintenance
 void theatreAddStaff()
 {
-    if (theatreStaffCount >= THEATRE_MAX_STAFF)
+    if ((int)theatreCtx->staff.size() >= THEATRE_MAX_STAFF)
     {
         cout << "Overflow: staff limit\n";
         return;
     }
-    TheatreStaff &s = theatreStaff[theatreStaffCount];
-    s.id = theatreStaffCount + 1;
+    TheatreStaff s;
+    s.id = (int)theatreCtx->staff.size() + 1;
     cout << "Enter name: ";
     getline(cin, s.name);
     cout << "Enter role: ";
@@ -1956,52 +2018,53 @@ void theatreAddStaff()
     string tmp;
     getline(cin, tmp);
     s.salary = theatreToInt(tmp);
-    theatreStaffCount++;
+    theatreCtx->staff.push_back(s);
     cout << "Staff added id " << s.id << "\n";
 }
 void theatreListStaff()
 {
-    if (theatreStaffCount == 0)
+    if (theatreCtx->staff.empty())
     {
         cout << "No staff.\n";
         return;
     }
-    for (int i = 0; i < theatreStaffCount; ++i)
-        cout << theatreStaff[i].id << " | " << theatreStaff[i].name << " | " << theatreStaff[i].role << " | Rs " << theatreStaff[i].salary << "\n";
+    for (int i = 0; i < (int)theatreCtx->staff.size(); ++i)
+        cout << theatreCtx->staff[i].id << " | " << theatreCtx->staff[i].name << " | " << theatreCtx->staff[i].role << " | Rs " << theatreCtx->staff[i].salary << "\n";
 }
 void theatreAddMaint()
 {
-    if (theatreMaintCount >= THEATRE_MAX_MAINT_LOGS)
+    if ((int)theatreCtx->maint.size() >= THEATRE_MAX_MAINT_LOGS)
     {
         cout << "Overflow: maint logs full\n";
         return;
     }
-    TheatreMaint &m = theatreMaint[theatreMaintCount];
-    m.id = theatreMaintCount + 1;
+    TheatreMaint m;
+    m.id = (int)theatreCtx->maint.size() + 1;
     cout << "Enter auditorium id: ";
     string t;
     getline(cin, t);
     m.aud_id = theatreToInt(t);
     cout << "Enter date (YYYY-MM-DD): ";
-    getline(cin, m.date);
+    getline(cin, t);
+    m.date = cityDate(t);
     cout << "Enter task: ";
     getline(cin, m.task);
     cout << "Enter staff id: ";
     getline(cin, t);
     m.staff_id = theatreToInt(t);
     m.status = 0;
-    theatreMaintCount++;
+    theatreCtx->maint.push_back(m);
     cout << "Maintenance logged id " << m.id << "\n";
 }
 void theatreListMaint()
 {
-    if (theatreMaintCount == 0)
+    if (theatreCtx->maint.empty())
     {
         cout << "No maintenance logs.\n";
         return;
     }
-    for (int i = 0; i < theatreMaintCount; ++i)
-        cout << theatreMaint[i].id << " | Aud:" << theatreMaint[i].aud_id << " | " << theatreMaint[i].date << " | " << theatreMaint[i].task << " | Staff:" << theatreMaint[i].staff_id << "\n";
+    for (int i = 0; i < (int)theatreCtx->maint.size(); ++i)
+        cout << theatreCtx->maint[i].id << " | Aud:" << theatreCtx->maint[i].aud_id << " | " << cityFormatDate(theatreCtx->maint[i].date) << " | " << theatreCtx->maint[i].task << " | Staff:" << theatreCtx->maint[i].staff_id << "\n";
 }
 
 // Revenue report per show
@@ -2011,10 +2074,10 @@ void theatreShowRevenue()
     int sid;
     cin >> sid;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == sid)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == sid)
         {
-            cout << "Tickets sold: " << shows[i].tickets_sold << " Revenue: Rs " << shows[i].revenue << "\n";
+            cout << "Tickets sold: " << theatreCtx->shows[i].tickets_sold << " Revenue: Rs " << theatreCtx->shows[i].revenue << "\n";
             return;
         }
     cout << "Show not found.\n";
@@ -2065,10 +2128,12 @@ void theatreShowMenu()
 
 void theatreInitModule()
 {
+    if (theatreCtx)
+        return; // state is kept across visits to the menu
     srand((unsigned int)time(NULL));
+    theatreCtx = new TheatreContext();
     theatre_init_booking_hash();
     theatre_init_snack_queue();
-    
 }
 
 // find bookings by phone substring using BM
@@ -2083,11 +2148,11 @@ void theatreFindBookingByPhone()
         return;
     }
     bool found = false;
-    for (int i = 0; i < THEATRE_HASH_SIZE; ++i)
+    for (size_t i = 0; i < theatreCtx->bookingHash.size(); ++i)
     {
-        if (bookingHash[i].used && !bookingHash[i].deleted)
+        if (theatreCtx->bookingHash[i].used && !theatreCtx->bookingHash[i].deleted)
         {
-            TheatreBooking &b = bookingHash[i].val;
+            TheatreBooking &b = theatreCtx->bookingHash[i].val;
             string phone = string(b.customer_phone);
             string phoneL = phone;
             string patL = pat;
@@ -2107,16 +2172,16 @@ void theatreFindBookingByPhone()
 }
 void theatreListAuditoriums()
 {
-    if (theatreAudCount == 0)
+    if (theatreCtx->auditoriums.empty())
     {
         cout << "No auditoriums available.\n";
         return;
     }
 
     cout << "\n--- AUDITORIUM LIST ---\n";
-    for (int i = 0; i < theatreAudCount; i++)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); i++)
     {
-        TheatreAuditorium &a = auditoriums[i];
+        TheatreAuditorium &a = theatreCtx->auditoriums[i];
         cout << "ID: " << a.aud_id
              << " | Name: " << a.name
              << " | Rows: " << a.rows
@@ -2260,6 +2325,9 @@ void theatreSystem()
 #include <sstream>
 #include <limits>
 #include <functional>
+#include <vector>
+#include <algorithm>
+#include "../city_ring.h"
 using namespace std;
 
 #define HOTEL_MAX_NODES 1200
@@ -2279,8 +2347,6 @@ struct HotelNode {
     string name;
     hotelNodeType type;
 };
-HotelNode hotelNodes[HOTEL_MAX_NODES];
-int hotelNodeCount = 0;
 
 // Room BST
 struct Room {
@@ -2325,12 +2391,6 @@ struct HotelsStaff {
     string role;
     int salary;
 };
-HotelsStaff hotelStaff[HOTEL_MAX_STAFF];
-int hotelStaffCount = 0;
-
-// Floors
-string hotelFloors[HOTEL_MAX_FLOORS];
-int hotelFloorsCount = 0;
 
 // Service Requests
 enum RequestType { REQ_EXTRA_BED, REQ_SHEETS, REQ_ORDER, REQ_HELP, REQ_EMERGENCY };
@@ -2342,17 +2402,27 @@ struct ServiceRequest {
     string details;
     bool completed;
 };
-ServiceRequest serviceQueue[HOTEL_MAX_REQUESTS];
 int serviceFront = 0, serviceRear = -1, serviceCount = 0;
 int hotelNextRequestId = 1;
 
+// --------- Module Context ----------
+// Created by hotel_initModule(); serviceCount counts live entries in the ring.
+struct HotelContext {
+    vector<HotelNode> nodes;
+    vector<HotelsStaff> staff;
+    vector<string> floors;
+    vector<ServiceRequest> serviceQueue; // ring buffer, grown on demand
+};
+HotelContext *hotelCtx = nullptr;
+
 // ------------- Utilities --------------
 int hotel_addNode(const string &name, hotelNodeType t) {
-    for (int i = 0; i < hotelNodeCount; i++)
-        if (hotelNodes[i].name == name)
+    int n = hotelCtx->nodes.size();
+    for (int i = 0; i < n; i++)
+        if (hotelCtx->nodes[i].name == name)
             return i;
-    hotelNodes[hotelNodeCount] = { hotelNodeCount, name, t };
-    return hotelNodeCount++;
+    hotelCtx->nodes.push_back({ n, name, t });
+    return n;
 }
 
 void hotel_safeIgnore() { cin.ignore(numeric_limits<streamsize>::max(), '\n'); }
@@ -2485,16 +2555,18 @@ void hotel_inorderMenu(MenuItem* root) {
 // SERVICE QUEUE
 void hotel_enqueueService(const ServiceRequest &rq) {
     if (serviceCount >= HOTEL_MAX_REQUESTS) { cout << "Queue Full!\n"; return; }
-    serviceRear = (serviceRear + 1) % HOTEL_MAX_REQUESTS;
-    serviceQueue[serviceRear] = rq;
+    if (serviceCount == (int)hotelCtx->serviceQueue.size())
+        cityRingGrow(hotelCtx->serviceQueue, serviceFront, serviceRear, serviceCount, HOTEL_MAX_REQUESTS);
+    serviceRear = (serviceRear + 1) % (int)hotelCtx->serviceQueue.size();
+    hotelCtx->serviceQueue[serviceRear] = rq;
     serviceCount++;
 }
 
 ServiceRequest hotel_dequeueService() {
     ServiceRequest empty; empty.id = -1;
     if (serviceCount == 0) return empty;
-    ServiceRequest r = serviceQueue[serviceFront];
-    serviceFront = (serviceFront + 1) % HOTEL_MAX_REQUESTS;
+    ServiceRequest r = hotelCtx->serviceQueue[serviceFront];
+    serviceFront = (serviceFront + 1) % (int)hotelCtx->serviceQueue.size();
     serviceCount--;
     return r;
 }
@@ -2504,10 +2576,10 @@ void hotel_showServiceQueue() {
     cout << "--- Pending Requests ---\n";
     int idx = serviceFront;
     for (int i = 0; i < serviceCount; i++) {
-        auto &r = serviceQueue[idx];
+        auto &r = hotelCtx->serviceQueue[idx];
         cout << "ID:" << r.id << " Guest:" << r.guestId << " Room:" << r.roomNo
              << " Details:" << r.details << "\n";
-        idx = (idx + 1) % HOTEL_MAX_REQUESTS;
+        idx = (idx + 1) % (int)hotelCtx->serviceQueue.size();
     }
 }
 
@@ -2525,18 +2597,31 @@ int hotel_splitCSV(const string &line, string out[], int maxCols) {
     return c;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int hotel_countRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // CSV LOADERS
 void hotel_loadFloorsCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    int rows = min(hotel_countRows(in), HOTEL_MAX_FLOORS);
+    hotelCtx->floors.reserve(hotelCtx->floors.size() + rows);
+    hotelCtx->nodes.reserve(hotelCtx->nodes.size() + rows);
     string line;
     getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
         if (line.empty()) continue;
-        hotelFloors[hotelFloorsCount++] = line;
+        hotelCtx->floors.push_back(line);
         hotel_addNode(line, HOTEL_FLOOR);
         loaded++;
     }
@@ -2547,6 +2632,7 @@ void hotel_loadRoomsCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    hotelCtx->nodes.reserve(hotelCtx->nodes.size() + min(hotel_countRows(in), HOTEL_MAX_ROOMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -2592,6 +2678,7 @@ void hotel_loadStaffCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    hotelCtx->staff.reserve(hotelCtx->staff.size() + min(hotel_countRows(in), HOTEL_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -2601,10 +2688,9 @@ void hotel_loadStaffCSV(const string &fn) {
         int n = hotel_splitCSV(line, c, 4);
         if (n < 3) continue;
 
-        hotelStaff[hotelStaffCount] = {
-            hotelStaffCount + 1, c[0], c[1], hotel_toInt(c[2])
-        };
-        hotelStaffCount++;
+        hotelCtx->staff.push_back({
+            (int)hotelCtx->staff.size() + 1, c[0], c[1], hotel_toInt(c[2])
+        });
         loaded++;
     }
     cout << "Loaded " << loaded << " staff.\n";
@@ -2653,9 +2739,9 @@ void hotel_showGuests() { hotel_inorderGuests(hotelGuestRoot); }
 void hotel_showMenuItems() { hotel_inorderMenu(hotelMenuRoot); }
 
 void hotel_showNodes() {
-    cout << "\n--- HOTEL NODES (" << hotelNodeCount << ") ---\n";
-    for (int i = 0; i < hotelNodeCount; i++)
-        cout << i << ": " << hotelNodes[i].name << " | Type=" << hotelNodes[i].type << "\n";
+    cout << "\n--- HOTEL NODES (" << hotelCtx->nodes.size() << ") ---\n";
+    for (size_t i = 0; i < hotelCtx->nodes.size(); i++)
+        cout << i << ": " << hotelCtx->nodes[i].name << " | Type=" << hotelCtx->nodes[i].type << "\n";
 }
 
 // Staff
@@ -2666,8 +2752,7 @@ void hotel_addStaffInteractive() {
     cout << "Salary: "; int sal; cin >> sal;
     hotel_safeIgnore();
 
-    hotelStaff[hotelStaffCount] = { hotelStaffCount + 1, nm, role, sal };
-    hotelStaffCount++;
+    hotelCtx->staff.push_back({ (int)hotelCtx->staff.size() + 1, nm, role, sal });
     cout << "Staff added.\n";
 }
 
@@ -2675,7 +2760,7 @@ void hotel_addStaffInteractive() {
 void hotel_addFloorInteractive() {
     hotel_safeIgnore();
     cout << "Enter floor name: "; string f; getline(cin, f);
-    hotelFloors[hotelFloorsCount++] = f;
+    hotelCtx->floors.push_back(f);
     hotel_addNode(f, HOTEL_FLOOR);
     cout << "Floor added.\n";
 }
@@ -2805,10 +2890,11 @@ void hotel_viewGuestBillInteractive() {
 void hotel_sortGuestsByBalanceInteractive() {
     if (hotelGuestCount == 0) { cout << "No guests.\n"; return; }
 
-    Guest* arr[HOTEL_MAX_GUESTS];
+    vector<Guest*> arr;
+    arr.reserve(hotelGuestCount);
     int idx = 0;
 
-    function<void(Guest*)> collect = [&](Guest* r){ if (!r) return; collect(r->left); arr[idx++] = r; collect(r->right); };
+    function<void(Guest*)> collect = [&](Guest* r){ if (!r) return; collect(r->left); arr.push_back(r); idx++; collect(r->right); };
     collect(hotelGuestRoot);
 
     function<void(int,int)> qs = [&](int L, int R){
@@ -2866,8 +2952,14 @@ void hotel_showMenu() {
     cout << "Enter choice: ";
 }
 
+void hotel_initModule() {
+    if (hotelCtx) return; // state is kept across visits to the menu
+    hotelCtx = new HotelContext();
+}
+
 // MAIN HOTEL CONTROLLER
 void hotelSystem() {
+    hotel_initModule();
     int choice;
     while (true) {
         hotel_showMenu();
@@ -2907,14 +2999,13 @@ void hotelSystem() {
 // Minimal helper functions included: toInt, splitCSV.
 
 #include <bits/stdc++.h>
+#include "../city_date.h"
 using namespace std;
 
-#define HOSPITAL_MAX_PATIENTS 2000
 #define HOSPITAL_MAX_STAFF 500
 #define HOSPITAL_MAX_ROOMS 500
 #define HOSPITAL_MAX_BEDS 2000
-#define HOSPITAL_MAX_APPOINTS 2000
-#define HOSPITAL_HASH_SIZE 32749
+#define HOSPITAL_HASH_MIN 64 // initial patient index slots (power of two)
 #define HOSPITAL_INF 999999
 
 // ---------- Helper utilities (simple) ----------
@@ -2953,17 +3044,37 @@ int hospitalSplitCSV(const string &line, string out[], int maxCols)
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int hospitalCountRows(ifstream &in)
+{
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
+// ---------- Cold text arena ----------
+// Names, addresses, notes and remarks live back to back in one char buffer
+// (hospitalCtx->arena); records keep a 4-byte offset, so scans over
+// ids/status/dates touch only the small hot rows. Offset 0 is the shared empty string. Text is never
+// edited in place: an update appends the new value and repoints the record.
+// Pointers from hospital_str() are only valid until the next append.
+typedef uint32_t HospitalText;
+
 // ---------- Entities ----------
 struct HospitalPatient
 {
     int patient_id;
-    char name[128];
     int age;
-    char gender[16];
-    char contact[32];
-    char address[256];
     int status; // 0 registered, 1 admitted, 3 discharged
-    char notes[512];
+    // cold text (hospital_str)
+    HospitalText name;    // max 127
+    HospitalText gender;  // max 15
+    HospitalText contact; // max 31
+    HospitalText address; // max 255
+    HospitalText notes;   // max 511
     // minimal: more fields can be added
 };
 
@@ -2986,6 +3097,8 @@ struct HospitalRoom
     int capacity;
     int occupied;
     int bedStartIdx;
+    int bedCount; // beds created; below capacity once HOSPITAL_MAX_BEDS is reached
+    int ward; // index into wardNames, -1 if too many room types
 };
 
 struct HospitalBed
@@ -2994,6 +3107,8 @@ struct HospitalBed
     int roomID;
     bool occupied;
     int patientID; // -1 if empty
+    int roomIdx;   // row in rooms
+    int ward;      // copy of the room's ward
 };
 
 // Appointment is now unified: general / surgery / lab test
@@ -3003,136 +3118,358 @@ struct HospitalAppointment
     int type; // 1 = general, 2 = surgery, 3 = lab test
     int patientID;
     int doctorID;
-    char date[16]; // YYYY-MM-DD
-    char time[6];  // HH:MM
+    CityDate date; // days since 1970-01-01
+    int time;      // minutes after midnight, -1 if unset
     int duration;  // minutes
-    int status;    // 0 booked,1 done,2 cancelled
+    int status;    // 0 booked,1 done,2 cancelled,3 waiting for a slot
 
     // surgery-specific (optional, set when type==2)
     int OTroomID;
     int durationMins; // surgery duration
-    char anesthesiaType[32];
+    HospitalText anesthesiaType; // max 31
 
     // lab-specific (optional, set when type==3)
-    char testType[64];
-    char resultDate[16];
-    char resultSummary[256];
+    HospitalText testType; // max 63
+    CityDate resultDate; // CITY_NO_DATE until results arrive
+    HospitalText resultSummary; // max 255
+
+    HospitalText remarks; // max 255
+};
+
+// one booked interval of a resource calendar day (see below)
+struct HospitalSlot
+{
+    int start, end; // minutes after midnight, [start,end)
+    int apptID;
+    int reach;
+};
+
+#define HOSPITAL_BED_WORDS ((HOSPITAL_MAX_BEDS + 63) / 64)
+#define HOSPITAL_MAX_WARDS 32
+
+// free-bed bitset (see the bed allocation index below)
+struct HospitalBedSet
+{
+    uint64_t summary;
+    uint64_t words[HOSPITAL_BED_WORDS];
+};
 
-    char remarks[256];
+// ---------- Module context ----------
+// Created by hospitalInitModule(); HOSPITAL_MAX_* cap the staff, rooms and beds.
+struct HospitalContext
+{
+    vector<char> arena; // cold text, offset 0 is the shared empty string
+    vector<HospitalPatient> patients; // canonical patient table
+    vector<HospitalStaff> staff;
+    vector<HospitalRoom> rooms;
+    vector<HospitalBed> beds;
+    vector<HospitalAppointment> appts;
+    HospitalBedSet freeBeds;
+    HospitalBedSet wardFree[HOSPITAL_MAX_WARDS];
+    int wardBeds[HOSPITAL_MAX_WARDS];
+    vector<string> wardNames;
+    unordered_map<int, int> roomIndex;  // roomID -> row in rooms
+    unordered_map<int, int> patientBed; // patient_id -> bed index
+    vector<int> patientHash;
+    map<long long, vector<HospitalSlot> > calendar;
+    unordered_map<string, int> labIds;
 };
+static HospitalContext *hospitalCtx = NULL;
 
 // ---------- Module globals ----------
-static HospitalPatient hospitalPatients[HOSPITAL_MAX_PATIENTS];
-static int hospitalPatientCount = 0;
 static int hospitalNextPatientID = 9000;
-
-static HospitalStaff hospitalStaff[HOSPITAL_MAX_STAFF];
-static int hospitalStaffCount = 0;
 static int hospitalNextStaffID = 7000;
+static int hospitalNextApptID = 21000;
+static int hospitalPatientHashCount = 0;
 
-static HospitalRoom hospitalRooms[HOSPITAL_MAX_ROOMS];
-static int hospitalRoomCount = 0;
-static HospitalBed hospitalBeds[HOSPITAL_MAX_BEDS];
-static int hospitalBedCount = 0;
+// Appends s (cut to maxLen-1 bytes, like the old fixed char fields).
+HospitalText hospital_text(const string &s, size_t maxLen)
+{
+    size_t n = min(s.size(), maxLen - 1);
+    if (n == 0) return 0;
+    HospitalText off = (HospitalText)hospitalCtx->arena.size();
+    hospitalCtx->arena.insert(hospitalCtx->arena.end(), s.begin(), s.begin() + n);
+    hospitalCtx->arena.push_back('\0');
+    return off;
+}
+inline const char *hospital_str(HospitalText t) { return &hospitalCtx->arena[t]; }
 
-static HospitalAppointment hospitalAppts[HOSPITAL_MAX_APPOINTS];
-static int hospitalApptCount = 0;
-static int hospitalNextApptID = 21000;
+// ---------- Bed allocation index ----------
+// Free beds are kept as bitsets over bed index: one for the whole hospital
+// (a room's beds are contiguous, so a room lookup scans only its own words)
+// and one per ward, where a ward is a room type such as ICU or General.
+// A summary word marks the non-empty 64-bed words, so the first free bed of
+// a ward is two count-trailing-zeros. Occupancy is total minus popcount.
+static_assert(HOSPITAL_BED_WORDS <= 64, "bed summary must fit one word");
 
-// ---------- Hash table for patients (by patient_id) ----------
-struct HospitalPatientHashEntry
+static void hospital_bedset_set(HospitalBedSet &s, int b)
 {
-    int key;
-    HospitalPatient val;
-    bool used;
-    bool deleted;
-};
-static HospitalPatientHashEntry hospitalPatientHash[HOSPITAL_HASH_SIZE];
-static int hospitalPatientHashCount = 0;
+    s.words[b >> 6] |= 1ULL << (b & 63);
+    s.summary |= 1ULL << (b >> 6);
+}
+static void hospital_bedset_clear(HospitalBedSet &s, int b)
+{
+    s.words[b >> 6] &= ~(1ULL << (b & 63));
+    if (!s.words[b >> 6]) s.summary &= ~(1ULL << (b >> 6));
+}
+static int hospital_bedset_first(const HospitalBedSet &s)
+{
+    if (!s.summary) return -1;
+    int w = __builtin_ctzll(s.summary);
+    return (w << 6) | __builtin_ctzll(s.words[w]);
+}
+// First set bit in [lo, hi), or -1; hi is clamped to the beds that exist.
+static int hospital_bedset_first_in(const HospitalBedSet &s, int lo, int hi)
+{
+    if (hi > (int)hospitalCtx->beds.size()) hi = hospitalCtx->beds.size();
+    for (int w = lo >> 6; w <= (hi - 1) >> 6 && lo < hi; ++w)
+    {
+        uint64_t m = s.words[w];
+        if (w == lo >> 6) m &= ~0ULL << (lo & 63);
+        if (m)
+        {
+            int b = (w << 6) | __builtin_ctzll(m);
+            return b < hi ? b : -1;
+        }
+    }
+    return -1;
+}
+static int hospital_bedset_count(const HospitalBedSet &s)
+{
+    int n = 0;
+    for (uint64_t m = s.summary; m; m &= m - 1)
+        n += __builtin_popcountll(s.words[__builtin_ctzll(m)]);
+    return n;
+}
+// Ward id for a room type (case-insensitive), creating it if asked; -1 if unknown/full.
+static int hospital_ward_id(const string &type, bool create)
+{
+    string key = type;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = tolower((unsigned char)key[i]);
+    for (size_t w = 0; w < hospitalCtx->wardNames.size(); ++w)
+    {
+        string name = hospitalCtx->wardNames[w];
+        for (size_t i = 0; i < name.size(); ++i) name[i] = tolower((unsigned char)name[i]);
+        if (name == key) return w;
+    }
+    int w = hospitalCtx->wardNames.size();
+    if (!create || w >= HOSPITAL_MAX_WARDS) return -1;
+    hospitalCtx->wardNames.push_back(type);
+    return w;
+}
+static void hospital_bed_occupy(int b, int pid)
+{
+    HospitalBed &bd = hospitalCtx->beds[b];
+    bd.occupied = true;
+    bd.patientID = pid;
+    hospitalCtx->rooms[bd.roomIdx].occupied++;
+    hospital_bedset_clear(hospitalCtx->freeBeds, b);
+    if (bd.ward >= 0) hospital_bedset_clear(hospitalCtx->wardFree[bd.ward], b);
+    hospitalCtx->patientBed[pid] = b;
+}
+static void hospital_bed_release(int b)
+{
+    HospitalBed &bd = hospitalCtx->beds[b];
+    hospitalCtx->patientBed.erase(bd.patientID);
+    bd.occupied = false;
+    bd.patientID = -1;
+    hospitalCtx->rooms[bd.roomIdx].occupied--;
+    hospital_bedset_set(hospitalCtx->freeBeds, b);
+    if (bd.ward >= 0) hospital_bedset_set(hospitalCtx->wardFree[bd.ward], b);
+}
+
+// ---------- Hash index for patients (patient_id -> row) ----------
+// Slots hold row+1 into patients (0 = empty), so the table stays a
+// few bytes per patient and every lookup reads the one canonical record.
+// Linear probing over a power-of-two table, rehashed at 70% load.
 
 unsigned int hospital_hash_key_int(int key)
 {
-    return (unsigned int)(key * 2654435761u) % HOSPITAL_HASH_SIZE;
+    return (unsigned int)(key * 2654435761u) & (unsigned int)(hospitalCtx->patientHash.size() - 1);
 }
-void hospital_init_patient_hash()
+static void hospital_patient_hash_place(int row)
+{
+    int key = hospitalCtx->patients[row].patient_id;
+    unsigned int mask = (unsigned int)(hospitalCtx->patientHash.size() - 1);
+    unsigned int idx = hospital_hash_key_int(key);
+    while (hospitalCtx->patientHash[idx] && hospitalCtx->patients[hospitalCtx->patientHash[idx] - 1].patient_id != key)
+        idx = (idx + 1) & mask;
+    if (!hospitalCtx->patientHash[idx]) hospitalPatientHashCount++;
+    hospitalCtx->patientHash[idx] = row + 1; // a repeated ID points at the newest row
+}
+void hospital_patient_hash_insert(int row)
 {
-    for (int i = 0; i < HOSPITAL_HASH_SIZE; ++i)
+    if ((size_t)(hospitalPatientHashCount + 1) * 10 > hospitalCtx->patientHash.size() * 7)
     {
-        hospitalPatientHash[i].used = false;
-        hospitalPatientHash[i].deleted = false;
-        hospitalPatientHash[i].key = -1;
+        vector<int> old;
+        old.swap(hospitalCtx->patientHash);
+        hospitalCtx->patientHash.assign(old.size() * 2, 0);
+        hospitalPatientHashCount = 0;
+        for (size_t i = 0; i < old.size(); ++i)
+            if (old[i]) hospital_patient_hash_place(old[i] - 1);
     }
+    hospital_patient_hash_place(row);
+}
+// (Re)builds the index over whatever rows are already in the table.
+void hospital_init_patient_hash()
+{
+    hospitalCtx->patientHash.assign(HOSPITAL_HASH_MIN, 0);
     hospitalPatientHashCount = 0;
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); ++i)
+        hospital_patient_hash_insert(i);
 }
-bool hospital_patient_hash_insert(const HospitalPatient &p)
+// Returns the stored record (edits are seen by every caller) or NULL.
+HospitalPatient *hospital_patient_find(int key)
 {
-    if (hospitalPatientHashCount >= HOSPITAL_MAX_PATIENTS) return false;
-    unsigned int idx = hospital_hash_key_int(p.patient_id);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used && !hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key != p.patient_id)
+    unsigned int mask = (unsigned int)(hospitalCtx->patientHash.size() - 1);
+    unsigned int idx = hospital_hash_key_int(key);
+    while (hospitalCtx->patientHash[idx])
     {
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) return false;
+        HospitalPatient &p = hospitalCtx->patients[hospitalCtx->patientHash[idx] - 1];
+        if (p.patient_id == key) return &p;
+        idx = (idx + 1) & mask;
     }
-    hospitalPatientHash[idx].used = true;
-    hospitalPatientHash[idx].deleted = false;
-    hospitalPatientHash[idx].key = p.patient_id;
-    hospitalPatientHash[idx].val = p;
-    hospitalPatientHashCount++;
-    return true;
+    return NULL;
 }
-bool hospital_patient_hash_get(int key, HospitalPatient &out)
+// Appends to the canonical table and indexes the new row.
+void hospital_add_patient_row(const HospitalPatient &p)
 {
-    unsigned int idx = hospital_hash_key_int(key);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used)
+    hospitalCtx->patients.push_back(p);
+    hospital_patient_hash_insert((int)hospitalCtx->patients.size() - 1);
+}
+
+// ---------- Resource calendar (doctor / OT room / lab bench) ----------
+// Booked intervals per (resource, day), sorted by start minute. CSV data may
+// already overlap, so each slot also carries `reach`, the latest end among it
+// and every earlier slot of that day; reach never decreases, which lets both
+// the conflict check and the free-slot search start with one binary search.
+// Lab tests hold one bench per test type (interned to an id on first use).
+// Cancelled and still-waiting appointments hold nothing.
+#define HOSPITAL_RES_DOCTOR 0
+#define HOSPITAL_RES_OT 1
+#define HOSPITAL_RES_LAB 2
+#define HOSPITAL_DAY_OPEN (8 * 60)   // free-slot searches start here
+#define HOSPITAL_DAY_CLOSE (20 * 60) // ... and must finish by here
+#define HOSPITAL_SLOT_SEARCH_DAYS 30
+
+
+static long long hospital_res_key(int kind, int id, CityDate d)
+{
+    return ((long long)kind << 56) | ((long long)(id & 0xFFFFFF) << 32) | (unsigned)d;
+}
+static const char *hospital_res_name(long long key)
+{
+    int kind = (int)(key >> 56);
+    return kind == HOSPITAL_RES_DOCTOR ? "Doctor" : (kind == HOSPITAL_RES_OT ? "OT room" : "Lab");
+}
+static int hospital_lab_id(const char *testType, bool create)
+{
+    if (!testType[0]) return -1;
+    unordered_map<string, int>::iterator it = hospitalCtx->labIds.find(testType);
+    if (it != hospitalCtx->labIds.end()) return it->second;
+    if (!create) return -1;
+    int id = (int)hospitalCtx->labIds.size();
+    hospitalCtx->labIds[testType] = id;
+    return id;
+}
+// Minutes the appointment occupies its resources.
+int hospital_appt_length(const HospitalAppointment &a)
+{
+    return (a.type == 2 && a.durationMins > 0) ? a.durationMins : a.duration;
+}
+// Calendar keys the appointment needs on day d; returns how many.
+static int hospital_appt_resources(const HospitalAppointment &a, CityDate d, long long keys[3])
+{
+    int n = 0;
+    keys[n++] = hospital_res_key(HOSPITAL_RES_DOCTOR, a.doctorID, d);
+    if (a.type == 2 && a.OTroomID > 0) keys[n++] = hospital_res_key(HOSPITAL_RES_OT, a.OTroomID, d);
+    int lab = (a.type == 3 ? hospital_lab_id(hospital_str(a.testType), true) : -1);
+    if (lab >= 0) keys[n++] = hospital_res_key(HOSPITAL_RES_LAB, lab, d);
+    return n;
+}
+// First slot whose reach passes t (every earlier slot ends by t).
+static size_t hospital_slot_after(const vector<HospitalSlot> &v, int t)
+{
+    return upper_bound(v.begin(), v.end(), t, [](int x, const HospitalSlot &s) { return x < s.reach; }) - v.begin();
+}
+// Returns true if the appointment overlapped something already booked.
+bool hospital_calendar_add(const HospitalAppointment &a)
+{
+    int len = hospital_appt_length(a);
+    if (a.status == 2 || a.status == 3 || a.time < 0 || len <= 0 || a.date == CITY_NO_DATE) return false;
+    long long keys[3];
+    int nk = hospital_appt_resources(a, a.date, keys);
+    bool clash = false;
+    for (int k = 0; k < nk; ++k)
     {
-        if (!hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key == key)
+        vector<HospitalSlot> &v = hospitalCtx->calendar[keys[k]];
+        size_t i = hospital_slot_after(v, a.time);
+        if (i < v.size() && v[i].start < a.time + len) clash = true;
+        size_t pos = lower_bound(v.begin(), v.end(), a.time, [](const HospitalSlot &s, int x) { return s.start <= x; }) - v.begin();
+        HospitalSlot s = {a.time, a.time + len, a.apptID, 0};
+        v.insert(v.begin() + pos, s);
+        for (size_t j = pos; j < v.size(); ++j)
         {
-            out = hospitalPatientHash[idx].val;
-            return true;
+            int r = max(v[j].end, j ? v[j - 1].reach : 0);
+            if (j > pos && r == v[j].reach) break;
+            v[j].reach = r;
         }
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) break;
     }
-    return false;
+    return clash;
 }
-bool hospital_patient_hash_remove(int key)
+// Any booked slot overlapping [st,en) on this resource-day, else NULL.
+const HospitalSlot *hospital_calendar_conflict(long long key, int st, int en)
 {
-    unsigned int idx = hospital_hash_key_int(key);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used)
+    map<long long, vector<HospitalSlot> >::const_iterator it = hospitalCtx->calendar.find(key);
+    if (it == hospitalCtx->calendar.end()) return NULL;
+    const vector<HospitalSlot> &v = it->second;
+    size_t i = hospital_slot_after(v, st);
+    return (i < v.size() && v[i].start < en) ? &v[i] : NULL;
+}
+// Earliest t' >= t with [t', t'+len) free on this resource-day and ending by
+// `close`, or -1.
+int hospital_earliest_free(long long key, int t, int len, int close)
+{
+    map<long long, vector<HospitalSlot> >::const_iterator it = hospitalCtx->calendar.find(key);
+    if (it != hospitalCtx->calendar.end())
     {
-        if (!hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key == key)
-        {
-            hospitalPatientHash[idx].deleted = true;
-            hospitalPatientHashCount--;
-            return true;
-        }
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) break;
+        const vector<HospitalSlot> &v = it->second;
+        for (size_t i = hospital_slot_after(v, t); i < v.size() && v[i].start < t + len; ++i)
+            if (v[i].end > t) t = v[i].end;
     }
-    return false;
+    return t + len <= close ? t : -1;
 }
-
-// ---------- Date/time helpers ----------
-static string hospital_now_date()
+// Earliest start >= t at which every key is free for len minutes. Each pass
+// only moves t forward, so the loop settles on the first common gap.
+int hospital_common_free(const long long keys[], int nk, int t, int len, int close)
 {
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[32];
-    sprintf(buf, "%04d-%02d-%02d", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday);
-    return string(buf);
+    for (bool moved = true; moved;)
+    {
+        moved = false;
+        for (int k = 0; k < nk; ++k)
+        {
+            int t2 = hospital_earliest_free(keys[k], t, len, close);
+            if (t2 < 0) return -1;
+            if (t2 != t) { t = t2; moved = true; }
+        }
+    }
+    return t;
 }
-static string hospital_now_time()
+// Earliest (day, time) from `from`/`t` on where the appointment fits inside
+// clinic hours; returns false if nothing within HOSPITAL_SLOT_SEARCH_DAYS.
+bool hospital_find_slot(const HospitalAppointment &a, CityDate from, int t, CityDate &day, int &start)
 {
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[16];
-    sprintf(buf, "%02d:%02d", tm->tm_hour, tm->tm_min);
-    return string(buf);
+    int len = hospital_appt_length(a);
+    if (len <= 0) return false;
+    for (int d = 0; d < HOSPITAL_SLOT_SEARCH_DAYS; ++d, t = HOSPITAL_DAY_OPEN)
+    {
+        long long keys[3];
+        int nk = hospital_appt_resources(a, from + d, keys);
+        int s = hospital_common_free(keys, nk, max(t, HOSPITAL_DAY_OPEN), len, HOSPITAL_DAY_CLOSE);
+        if (s >= 0) { day = from + d; start = s; return true; }
+    }
+    return false;
 }
-
 // ---------- CSV loaders & generators ----------
 void hospitalLoadPatientsCSV(const string &fn)
 {
@@ -3147,20 +3484,17 @@ void hospitalLoadPatientsCSV(const string &fn)
         string cols[8];
         int n =hospitalSplitCSV(line, cols, 8);
         if (n < 2) continue;
-        if (hospitalPatientCount >= HOSPITAL_MAX_PATIENTS) break;
         HospitalPatient p;
         p.patient_id = hospitalToInt(cols[0]);
         if (p.patient_id == 0) p.patient_id = ++hospitalNextPatientID;
-        strncpy(p.name, cols[1].c_str(), sizeof(p.name) - 1); p.name[sizeof(p.name)-1]=0;
+        p.name = hospital_text(cols[1], 128);
         p.age = (n>=3? hospitalToInt(cols[2]):0);
-        strncpy(p.gender,(n>=4?cols[3].c_str():""),sizeof(p.gender)-1);
-        strncpy(p.contact,(n>=5?cols[4].c_str():""),sizeof(p.contact)-1);
-        strncpy(p.address,(n>=6?cols[5].c_str():""),sizeof(p.address)-1);
+        p.gender = (n>=4? hospital_text(cols[3], 16):0);
+        p.contact = (n>=5? hospital_text(cols[4], 32):0);
+        p.address = (n>=6? hospital_text(cols[5], 256):0);
         p.status = (n>=7? hospitalToInt(cols[6]):0);
-        strncpy(p.notes,(n>=8?cols[7].c_str():""),sizeof(p.notes)-1);
-        hospitalPatients[hospitalPatientCount] = p;
-        hospitalPatientCount++;
-        hospital_patient_hash_insert(p);
+        p.notes = (n>=8? hospital_text(cols[7], 512):0);
+        hospital_add_patient_row(p);
         loaded++;
     }
     cout << "Loaded " << loaded << " patients from " << fn << "\n";
@@ -3170,6 +3504,7 @@ void hospitalLoadStaffCSV(const string &fn)
 {
     ifstream in(fn.c_str());
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
+    hospitalCtx->staff.reserve(hospitalCtx->staff.size() + min(hospitalCountRows(in), HOSPITAL_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -3179,7 +3514,7 @@ void hospitalLoadStaffCSV(const string &fn)
         string cols[8];
         int n = hospitalSplitCSV(line, cols, 8);
         if (n < 2) continue;
-        if (hospitalStaffCount >= HOSPITAL_MAX_STAFF) break;
+        if ((int)hospitalCtx->staff.size() >= HOSPITAL_MAX_STAFF) break;
         HospitalStaff s;
         s.id =  hospitalToInt(cols[0]); if (s.id == 0) s.id = ++hospitalNextStaffID;
         strncpy(s.name, cols[1].c_str(), sizeof(s.name)-1); s.name[sizeof(s.name)-1]=0;
@@ -3189,7 +3524,7 @@ void hospitalLoadStaffCSV(const string &fn)
         s.salary = (n>=6? hospitalToInt(cols[5]):0);
         strncpy(s.contact, (n>=7?cols[6].c_str():""), sizeof(s.contact)-1);
         strncpy(s.specialty, (n>=8?cols[7].c_str():""), sizeof(s.specialty)-1);
-        hospitalStaff[hospitalStaffCount++] = s;
+        hospitalCtx->staff.push_back(s);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -3199,6 +3534,7 @@ void hospitalLoadRoomsCSV(const string &fn)
 {
     ifstream in(fn.c_str());
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
+    hospitalCtx->rooms.reserve(hospitalCtx->rooms.size() + min(hospitalCountRows(in), HOSPITAL_MAX_ROOMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -3208,23 +3544,37 @@ void hospitalLoadRoomsCSV(const string &fn)
         string cols[6];
         int n = hospitalSplitCSV(line, cols, 6);
         if (n < 3) continue;
-        if (hospitalRoomCount >= HOSPITAL_MAX_ROOMS) break;
+        if ((int)hospitalCtx->rooms.size() >= HOSPITAL_MAX_ROOMS) break;
         HospitalRoom r;
         r.roomID =  hospitalToInt(cols[0]);
         strncpy(r.type, cols[1].c_str(), sizeof(r.type)-1); r.type[sizeof(r.type)-1]=0;
         r.capacity =  hospitalToInt(cols[2]);
         r.occupied = 0;
-        r.bedStartIdx = hospitalBedCount;
-        for (int b = 0; b < r.capacity && hospitalBedCount < HOSPITAL_MAX_BEDS; ++b)
+        r.bedStartIdx = hospitalCtx->beds.size();
+        r.ward = hospital_ward_id(r.type, true);
+        for (int b = 0; b < r.capacity && (int)hospitalCtx->beds.size() < HOSPITAL_MAX_BEDS; ++b)
         {
+            int idx = hospitalCtx->beds.size();
             HospitalBed bd;
-            bd.bedID = hospitalBedCount + 10000;
+            bd.bedID = idx + 10000;
             bd.roomID = r.roomID;
             bd.occupied = false;
             bd.patientID = -1;
-            hospitalBeds[hospitalBedCount++] = bd;
+            bd.roomIdx = hospitalCtx->rooms.size();
+            bd.ward = r.ward;
+            hospital_bedset_set(hospitalCtx->freeBeds, idx);
+            if (r.ward >= 0)
+            {
+                hospital_bedset_set(hospitalCtx->wardFree[r.ward], idx);
+                hospitalCtx->wardBeds[r.ward]++;
+            }
+            hospitalCtx->beds.push_back(bd);
         }
-        hospitalRooms[hospitalRoomCount++] = r;
+        r.bedCount = (int)hospitalCtx->beds.size() - r.bedStartIdx;
+        if (r.bedCount < r.capacity)
+            cout << "Bed limit reached: room " << r.roomID << " has " << r.bedCount << " of " << r.capacity << " beds\n";
+        hospitalCtx->roomIndex[r.roomID] = hospitalCtx->rooms.size();
+        hospitalCtx->rooms.push_back(r);
         loaded++;
     }
     cout << "Loaded " << loaded << " rooms from " << fn << "\n";
@@ -3238,36 +3588,38 @@ void hospitalLoadAppointmentsCSV(const string &fn)
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
     string line;
     getline(in, line);
-    int loaded = 0;
+    int loaded = 0, clashes = 0;
     while (getline(in, line))
     {
         if (line.size() < 2) continue;
         string cols[20];
         int n = hospitalSplitCSV(line, cols, 20);
         if (n < 6) continue;
-        if (hospitalApptCount >= HOSPITAL_MAX_APPOINTS) break;
         HospitalAppointment a;
         a.apptID = hospitalToInt(cols[0]); if (a.apptID == 0) a.apptID = ++hospitalNextApptID;
         a.type =  hospitalToInt(cols[1]);
         a.patientID =  hospitalToInt(cols[2]);
         a.doctorID =  hospitalToInt(cols[3]);
-        strncpy(a.date, cols[4].c_str(), sizeof(a.date)-1); a.date[sizeof(a.date)-1]=0;
-        strncpy(a.time, cols[5].c_str(), sizeof(a.time)-1); a.time[sizeof(a.time)-1]=0;
+        a.date = cityDate(cols[4]);
+        a.time = cityTime(cols[5]);
         a.duration = (n>=7? hospitalToInt(cols[6]):15);
         a.status = (n>=8? hospitalToInt(cols[7]):0);
-        if (n >= 9) strncpy(a.remarks, cols[8].c_str(), sizeof(a.remarks)-1); else strncpy(a.remarks,"",sizeof(a.remarks)-1);
+        a.remarks = (n >= 9 ? hospital_text(cols[8], 256) : 0);
         // surgery fields
         a.OTroomID = (n>=10? hospitalToInt(cols[9]):-1);
         a.durationMins = (n>=11? hospitalToInt(cols[10]):0);
-        if (n >= 12) strncpy(a.anesthesiaType, cols[11].c_str(), sizeof(a.anesthesiaType)-1); else strncpy(a.anesthesiaType,"",sizeof(a.anesthesiaType)-1);
+        a.anesthesiaType = (n >= 12 ? hospital_text(cols[11], 32) : 0);
         // lab fields
-        if (n >= 13) strncpy(a.testType, cols[12].c_str(), sizeof(a.testType)-1); else strncpy(a.testType,"",sizeof(a.testType)-1);
-        if (n >= 14) strncpy(a.resultDate, cols[13].c_str(), sizeof(a.resultDate)-1); else strncpy(a.resultDate,"",sizeof(a.resultDate)-1);
-        if (n >= 15) strncpy(a.resultSummary, cols[14].c_str(), sizeof(a.resultSummary)-1); else strncpy(a.resultSummary,"",sizeof(a.resultSummary)-1);
-        hospitalAppts[hospitalApptCount++] = a;
+        a.testType = (n >= 13 ? hospital_text(cols[12], 64) : 0);
+        a.resultDate = (n >= 14 ? cityDate(cols[13]) : CITY_NO_DATE);
+        a.resultSummary = (n >= 15 ? hospital_text(cols[14], 256) : 0);
+        if (a.time < 0 && a.status == 0) a.status = 3; // no time yet: waiting list
+        hospitalCtx->appts.push_back(a);
+        if (hospital_calendar_add(a)) clashes++;
         loaded++;
     }
     cout << "Loaded " << loaded << " appointments from " << fn << "\n";
+    if (clashes) cout << "Warning: " << clashes << " loaded appointments overlap an earlier booking.\n";
 }
 
 // Lab CSV loader ONLY — used to update lab results (no interactive updating).
@@ -3288,34 +3640,34 @@ void hospitalLoadLabsCSV(const string &fn)
         int apptID =  hospitalToInt(cols[0]);
         int pid =  hospitalToInt(cols[1]);
         string testType = (n>=3?cols[2]:"");
-        string resDate = (n>=4?cols[3]:"");
+        CityDate resDate = (n>=4?cityDate(cols[3]):CITY_NO_DATE);
         string resSummary = (n>=5?cols[4]:"");
         // Prefer matching by apptID if provided (>0), else match by patientID + testType (first not-done)
         bool found = false;
         if (apptID > 0)
         {
-            for (int i = 0; i < hospitalApptCount; ++i)
+            for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
             {
-                if (hospitalAppts[i].apptID == apptID && hospitalAppts[i].type == 3)
+                if (hospitalCtx->appts[i].apptID == apptID && hospitalCtx->appts[i].type == 3)
                 {
-                    if (!testType.empty()) strncpy(hospitalAppts[i].testType, testType.c_str(), sizeof(hospitalAppts[i].testType)-1);
-                    if (!resDate.empty()) strncpy(hospitalAppts[i].resultDate, resDate.c_str(), sizeof(hospitalAppts[i].resultDate)-1);
-                    if (!resSummary.empty()) strncpy(hospitalAppts[i].resultSummary, resSummary.c_str(), sizeof(hospitalAppts[i].resultSummary)-1);
+                    if (!testType.empty()) hospitalCtx->appts[i].testType = hospital_text(testType, 64);
+                    if (resDate != CITY_NO_DATE) hospitalCtx->appts[i].resultDate = resDate;
+                    if (!resSummary.empty()) hospitalCtx->appts[i].resultSummary = hospital_text(resSummary, 256);
                     updated++; found = true; break;
                 }
             }
         }
         if (!found && pid > 0)
         {
-            for (int i = 0; i < hospitalApptCount; ++i)
+            for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
             {
-                if (hospitalAppts[i].patientID == pid && hospitalAppts[i].type == 3)
+                if (hospitalCtx->appts[i].patientID == pid && hospitalCtx->appts[i].type == 3)
                 {
                     // Use additional matching: testType if specified
-                    if (!testType.empty() && strlen(hospitalAppts[i].testType) > 0 && string(hospitalAppts[i].testType) != testType) continue;
-                    if (!testType.empty()) strncpy(hospitalAppts[i].testType, testType.c_str(), sizeof(hospitalAppts[i].testType)-1);
-                    if (!resDate.empty()) strncpy(hospitalAppts[i].resultDate, resDate.c_str(), sizeof(hospitalAppts[i].resultDate)-1);
-                    if (!resSummary.empty()) strncpy(hospitalAppts[i].resultSummary, resSummary.c_str(), sizeof(hospitalAppts[i].resultSummary)-1);
+                    if (!testType.empty() && hospitalCtx->appts[i].testType && testType != hospital_str(hospitalCtx->appts[i].testType)) continue;
+                    if (!testType.empty()) hospitalCtx->appts[i].testType = hospital_text(testType, 64);
+                    if (resDate != CITY_NO_DATE) hospitalCtx->appts[i].resultDate = resDate;
+                    if (!resSummary.empty()) hospitalCtx->appts[i].resultSummary = hospital_text(resSummary, 256);
                     updated++; found = true; break;
                 }
             }
@@ -3332,34 +3684,27 @@ int hospital_createApptID() { return ++hospitalNextApptID; }
 // Add a new patient (ER or OPD)
 void hospitalAddPatient()
 {
-    if (hospitalPatientCount >= HOSPITAL_MAX_PATIENTS)
-    {
-        cout << "Overflow: patients capacity reached!\n";
-        return;
-    }
     HospitalPatient p;
     p.patient_id = hospital_createPatientID();
     cout << "Enter name: ";
     string tmp;
     getline(cin, tmp);
-    strncpy(p.name, tmp.c_str(), sizeof(p.name) - 1); p.name[sizeof(p.name)-1]=0;
+    p.name = hospital_text(tmp, 128);
     cout << "Enter age: ";
     getline(cin, tmp);
     p.age =  hospitalToInt(tmp);
     cout << "Enter gender: ";
     getline(cin, tmp);
-    strncpy(p.gender, tmp.c_str(), sizeof(p.gender) - 1); p.gender[sizeof(p.gender)-1]=0;
+    p.gender = hospital_text(tmp, 16);
     cout << "Enter contact: ";
     getline(cin, tmp);
-    strncpy(p.contact, tmp.c_str(), sizeof(p.contact) - 1); p.contact[sizeof(p.contact)-1]=0;
+    p.contact = hospital_text(tmp, 32);
     cout << "Enter address: ";
     getline(cin, tmp);
-    strncpy(p.address, tmp.c_str(), sizeof(p.address) - 1); p.address[sizeof(p.address)-1]=0;
+    p.address = hospital_text(tmp, 256);
     p.status = 0;
-    strncpy(p.notes, "", sizeof(p.notes)-1);
-    hospitalPatients[hospitalPatientCount] = p;
-    hospitalPatientCount++;
-    hospital_patient_hash_insert(p);
+    p.notes = 0;
+    hospital_add_patient_row(p);
     cout << "Patient registered. ID: " << p.patient_id << "\n";
 }
 
@@ -3370,30 +3715,34 @@ void hospitalAdmitPatient()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    HospitalPatient p;
-    if (!hospital_patient_hash_get(pid, p)) { cout << "Patient not found.\n"; return; }
-    cout << "Enter roomID to admit into: ";
-    int rid;
-    if (!(cin >> rid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    unordered_map<int, int>::iterator cur = hospitalCtx->patientBed.find(pid);
+    if (cur != hospitalCtx->patientBed.end()) { cout << "Patient already in bed " << hospitalCtx->beds[cur->second].bedID << "\n"; return; }
+    cout << "Enter roomID or ward type (e.g. ICU) to admit into: ";
+    string target;
+    getline(cin, target);
     int bedIdx = -1;
-    for (int i = 0; i < hospitalBedCount; i++)
-        if (hospitalBeds[i].roomID == rid && !hospitalBeds[i].occupied)
-        {
-            bedIdx = i; break;
-        }
-    if (bedIdx == -1) { cout << "No free bed in room " << rid << "\n"; return; }
-    hospitalBeds[bedIdx].occupied = true;
-    hospitalBeds[bedIdx].patientID = pid;
-    for (int i = 0; i < hospitalPatientCount; i++)
-        if (hospitalPatients[i].patient_id == pid)
+    if (!target.empty() && isdigit((unsigned char)target[0]))
+    {
+        int rid = hospitalToInt(target);
+        unordered_map<int, int>::iterator rit = hospitalCtx->roomIndex.find(rid);
+        if (rit != hospitalCtx->roomIndex.end())
         {
-            hospitalPatients[i].status = 1; // admitted
-            hospital_patient_hash_remove(pid);
-            hospital_patient_hash_insert(hospitalPatients[i]);
-            break;
+            const HospitalRoom &r = hospitalCtx->rooms[rit->second];
+            bedIdx = hospital_bedset_first_in(hospitalCtx->freeBeds, r.bedStartIdx, r.bedStartIdx + r.bedCount);
         }
-    cout << "Admitted patient " << pid << " to bed " << hospitalBeds[bedIdx].bedID << "\n";
+        if (bedIdx == -1) { cout << "No free bed in room " << rid << "\n"; return; }
+    }
+    else
+    {
+        int w = hospital_ward_id(target, false);
+        if (w >= 0) bedIdx = hospital_bedset_first(hospitalCtx->wardFree[w]);
+        if (bedIdx == -1) { cout << "No free bed in ward " << target << "\n"; return; }
+    }
+    hospital_bed_occupy(bedIdx, pid);
+    p->status = 1; // admitted
+    cout << "Admitted patient " << pid << " to bed " << hospitalCtx->beds[bedIdx].bedID << " (room " << hospitalCtx->beds[bedIdx].roomID << ")\n";
 }
 
 // Discharge patient
@@ -3403,33 +3752,35 @@ void hospitalDischargePatient()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    for (int i = 0; i < hospitalPatientCount; i++)
+    HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    unordered_map<int, int>::iterator cur = hospitalCtx->patientBed.find(pid);
+    if (cur != hospitalCtx->patientBed.end()) hospital_bed_release(cur->second);
+    p->status = 3;
+    cout << "Patient " << pid << " discharged.\n";
+}
+
+// Ward occupancy from the free-bed bitsets
+void hospitalWardDashboard()
+{
+    if (hospitalCtx->beds.empty()) { cout << "No rooms loaded.\n"; return; }
+    cout << "\n========= WARD OCCUPANCY =========\n";
+    int totalBeds = hospitalCtx->beds.size();
+    int totalFree = hospital_bedset_count(hospitalCtx->freeBeds);
+    for (int w = 0; w < (int)hospitalCtx->wardNames.size(); ++w)
     {
-        if (hospitalPatients[i].patient_id == pid)
-        {
-            for (int b = 0; b < hospitalBedCount; b++)
-            {
-                if (hospitalBeds[b].patientID == pid)
-                {
-                    hospitalBeds[b].patientID = -1;
-                    hospitalBeds[b].occupied = false;
-                    break;
-                }
-            }
-            hospitalPatients[i].status = 3;
-            hospital_patient_hash_remove(pid);
-            hospital_patient_hash_insert(hospitalPatients[i]);
-            cout << "Patient " << pid << " discharged.\n";
-            return;
-        }
+        int beds = hospitalCtx->wardBeds[w];
+        int occ = beds - hospital_bedset_count(hospitalCtx->wardFree[w]);
+        cout << left << setw(12) << hospitalCtx->wardNames[w] << right << " Beds:" << setw(4) << beds << " | Occupied:" << setw(4) << occ
+             << " | Free:" << setw(4) << beds - occ << " | " << (beds ? occ * 100 / beds : 0) << "%\n";
     }
-    cout << "Patient not found.\n";
+    cout << "Total beds: " << totalBeds << " | Occupied: " << totalBeds - totalFree << " | Free: " << totalFree << "\n";
 }
 
 // Add staff
 void hospitalAddStaffInteractive()
 {
-    if (hospitalStaffCount >= HOSPITAL_MAX_STAFF) { cout << "Overflow: staff capacity reached!\n"; return; }
+    if ((int)hospitalCtx->staff.size() >= HOSPITAL_MAX_STAFF) { cout << "Overflow: staff capacity reached!\n"; return; }
     HospitalStaff s;
     s.id = hospital_createStaffID();
     cout << "Enter name: ";
@@ -3444,16 +3795,16 @@ void hospitalAddStaffInteractive()
     cout << "Enter salary: "; getline(cin, tmp); s.salary =  hospitalToInt(tmp);
     cout << "Enter contact: "; getline(cin, tmp); strncpy(s.contact, tmp.c_str(), sizeof(s.contact)-1);
     cout << "Enter specialty (if doctor): "; getline(cin, tmp); strncpy(s.specialty, tmp.c_str(), sizeof(s.specialty)-1);
-    hospitalStaff[hospitalStaffCount++] = s;
+    hospitalCtx->staff.push_back(s);
     cout << "Staff added ID " << s.id << "\n";
 }
 
 void hospitalListStaff()
 {
-    if (hospitalStaffCount == 0) { cout << "No staff.\n"; return; }
-    for (int i = 0; i < hospitalStaffCount; i++)
+    if (hospitalCtx->staff.empty()) { cout << "No staff.\n"; return; }
+    for (int i = 0; i < (int)hospitalCtx->staff.size(); i++)
     {
-        cout << hospitalStaff[i].id << " | " << hospitalStaff[i].name << " | " << hospitalStaff[i].role << " | Dept:" << hospitalStaff[i].department << " | Sal:" << hospitalStaff[i].salary << "\n";
+        cout << hospitalCtx->staff[i].id << " | " << hospitalCtx->staff[i].name << " | " << hospitalCtx->staff[i].role << " | Dept:" << hospitalCtx->staff[i].department << " | Sal:" << hospitalCtx->staff[i].salary << "\n";
     }
 }
 
@@ -3466,13 +3817,13 @@ void hospitalSearchPatientByName()
     if (pat.empty()) { cout << "Empty.\n"; return; }
     string patL = pat; for (size_t i = 0; i < patL.size(); ++i) patL[i] = tolower((unsigned char)patL[i]);
     bool found = false;
-    for (int i = 0; i < hospitalPatientCount; i++)
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); i++)
     {
-        string name = hospitalPatients[i].name;
+        string name = hospital_str(hospitalCtx->patients[i].name);
         string nameL = name; for (size_t k = 0; k < nameL.size(); ++k) nameL[k] = tolower((unsigned char)nameL[k]);
         if (nameL.find(patL) != string::npos)
         {
-            cout << "Found ID:" << hospitalPatients[i].patient_id << " | " << hospitalPatients[i].name << " | Age:" << hospitalPatients[i].age << " | Status:" << hospitalPatients[i].status << "\n";
+            cout << "Found ID:" << hospitalCtx->patients[i].patient_id << " | " << hospital_str(hospitalCtx->patients[i].name) << " | Age:" << hospitalCtx->patients[i].age << " | Status:" << hospitalCtx->patients[i].status << "\n";
             found = true;
         }
     }
@@ -3486,15 +3837,14 @@ void hospitalSearchPatientByIDInteractive()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    HospitalPatient p;
-    if (!hospital_patient_hash_get(pid, p)) { cout << "Patient not found.\n"; return; }
-    cout << "Patient: " << p.patient_id << " | " << p.name << " | Age:" << p.age << " | Gender:" << p.gender << " | Contact:" << p.contact << " | Status:" << p.status << "\n";
+    const HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    cout << "Patient: " << p->patient_id << " | " << hospital_str(p->name) << " | Age:" << p->age << " | Gender:" << hospital_str(p->gender) << " | Contact:" << hospital_str(p->contact) << " | Status:" << p->status << "\n";
 }
 
 // ---------- Merged Booking: Appointment / Surgery / Lab ----------
 void hospitalBookAppointmentInteractive()
 {
-    if (hospitalApptCount >= HOSPITAL_MAX_APPOINTS) { cout << "Overflow: appointments limit\n"; return; }
     HospitalAppointment a;
     a.apptID = hospital_createApptID();
     cout << "Select booking type: (1) General Checkup  (2) Surgery  (3) Lab Test\n";
@@ -3506,77 +3856,162 @@ void hospitalBookAppointmentInteractive()
     a.type = t;
     cout << "Enter patient ID: "; getline(cin, tmp); a.patientID =  hospitalToInt(tmp);
     cout << "Enter doctor ID: "; getline(cin, tmp); a.doctorID =  hospitalToInt(tmp);
-    cout << "Enter date (YYYY-MM-DD): "; getline(cin, tmp); strncpy(a.date, tmp.c_str(), sizeof(a.date)-1); a.date[sizeof(a.date)-1]=0;
-    cout << "Enter time (HH:MM): "; getline(cin, tmp); strncpy(a.time, tmp.c_str(), sizeof(a.time)-1); a.time[sizeof(a.time)-1]=0;
+    cout << "Enter date (YYYY-MM-DD): "; getline(cin, tmp); a.date = cityDate(tmp);
+    if (a.date == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    cout << "Enter time (HH:MM): "; getline(cin, tmp); a.time = cityTime(tmp);
+    if (a.time < 0) { cout << "Invalid time.\n"; return; }
     cout << "Enter duration minutes (typical): "; getline(cin, tmp); a.duration =  hospitalToInt(tmp);
     a.status = 0;
-    strncpy(a.remarks, "", sizeof(a.remarks)-1);
+    a.remarks = 0;
     // If surgery, collect optional surgery details
     if (a.type == 2)
     {
         cout << "Enter OT room ID (optional, -1 if none): "; getline(cin, tmp); a.OTroomID =  hospitalToInt(tmp);
         cout << "Enter expected surgery duration (minutes): "; getline(cin, tmp); a.durationMins =  hospitalToInt(tmp);
-        cout << "Enter anesthesia type: "; getline(cin, tmp); strncpy(a.anesthesiaType, tmp.c_str(), sizeof(a.anesthesiaType)-1); a.anesthesiaType[sizeof(a.anesthesiaType)-1]=0;
+        cout << "Enter anesthesia type: "; getline(cin, tmp); a.anesthesiaType = hospital_text(tmp, 32);
     }
     else
     {
-        a.OTroomID = -1; a.durationMins = 0; strncpy(a.anesthesiaType,"",sizeof(a.anesthesiaType)-1);
+        a.OTroomID = -1; a.durationMins = 0; a.anesthesiaType = 0;
     }
     // If lab, collect test type (results are loaded from CSV only later)
     if (a.type == 3)
     {
-        cout << "Enter test type: "; getline(cin, tmp); strncpy(a.testType, tmp.c_str(), sizeof(a.testType)-1); a.testType[sizeof(a.testType)-1]=0;
-        strncpy(a.resultDate, "", sizeof(a.resultDate)-1);
-        strncpy(a.resultSummary, "", sizeof(a.resultSummary)-1);
+        cout << "Enter test type: "; getline(cin, tmp); a.testType = hospital_text(tmp, 64);
+        a.resultDate = CITY_NO_DATE;
+        a.resultSummary = 0;
     }
     else
     {
-        strncpy(a.testType,"",sizeof(a.testType)-1);
-        strncpy(a.resultDate,"",sizeof(a.resultDate)-1);
-        strncpy(a.resultSummary,"",sizeof(a.resultSummary)-1);
-    }
-    hospitalAppts[hospitalApptCount++] = a;
-    cout << "Appointment booked ID " << a.apptID << " (type " << a.type << ")\n";
+        a.testType = 0;
+        a.resultDate = CITY_NO_DATE;
+        a.resultSummary = 0;
+    }
+    // Doctor, OT room and lab bench must all be free for the whole slot
+    long long keys[3];
+    int nk = hospital_appt_resources(a, a.date, keys);
+    int len = hospital_appt_length(a);
+    for (int k = 0; k < nk && len > 0; ++k)
+    {
+        const HospitalSlot *c = hospital_calendar_conflict(keys[k], a.time, a.time + len);
+        if (!c) continue;
+        cout << "Conflict: " << hospital_res_name(keys[k]) << " busy " << cityFormatTime(c->start) << "-" << cityFormatTime(c->end) << " (appointment " << c->apptID << ").\n";
+        CityDate day;
+        int st;
+        bool found = hospital_find_slot(a, a.date, a.time, day, st);
+        if (found)
+            cout << "Earliest free slot: " << cityFormatDate(day) << " " << cityFormatTime(st) << ". Book it? (y = yes, w = waiting list, other = cancel): ";
+        else
+            cout << "No free slot in the next " << HOSPITAL_SLOT_SEARCH_DAYS << " days. (w = waiting list, other = cancel): ";
+        getline(cin, tmp);
+        char ans = tmp.empty() ? 0 : (char)tolower((unsigned char)tmp[0]);
+        if (ans == 'y' && found) { a.date = day; a.time = st; }
+        else if (ans == 'w') { a.time = -1; a.status = 3; }
+        else { cout << "Booking cancelled.\n"; return; }
+        break;
+    }
+    hospitalCtx->appts.push_back(a);
+    hospital_calendar_add(a);
+    if (a.status == 3)
+        cout << "Appointment " << a.apptID << " added to the waiting list for " << cityFormatDate(a.date) << "\n";
+    else
+        cout << "Appointment booked ID " << a.apptID << " (type " << a.type << ") at " << cityFormatDate(a.date) << " " << cityFormatTime(a.time) << "\n";
+}
+
+// Earliest free slot for one doctor
+void hospitalFindFreeSlotInteractive()
+{
+    HospitalAppointment a;
+    string tmp;
+    a.type = 1;
+    cout << "Enter doctor ID: "; getline(cin, tmp); a.doctorID = hospitalToInt(tmp);
+    cout << "Enter length (minutes): "; getline(cin, tmp); a.duration = hospitalToInt(tmp);
+    if (a.duration <= 0) { cout << "Invalid length.\n"; return; }
+    cout << "Not before date (YYYY-MM-DD): "; getline(cin, tmp);
+    CityDate from = cityDate(tmp);
+    if (from == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    cout << "Not before time (HH:MM, blank = opening): "; getline(cin, tmp);
+    int t = tmp.empty() ? HOSPITAL_DAY_OPEN : cityTime(tmp);
+    if (t < 0) { cout << "Invalid time.\n"; return; }
+    CityDate day;
+    int st;
+    if (hospital_find_slot(a, from, t, day, st))
+        cout << "Doctor " << a.doctorID << " is free " << cityFormatDate(day) << " " << cityFormatTime(st) << "-" << cityFormatTime(st + a.duration) << "\n";
+    else
+        cout << "No free slot in the next " << HOSPITAL_SLOT_SEARCH_DAYS << " days.\n";
+}
+
+// Pack one day's waiting list into free slots, longest appointments first
+// (they are the hardest to fit). Anything that does not fit stays waiting.
+void hospitalScheduleWaitingList()
+{
+    cout << "Enter date to schedule (YYYY-MM-DD): ";
+    string tmp;
+    getline(cin, tmp);
+    CityDate d = cityDate(tmp);
+    if (d == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    vector<int> wait;
+    for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
+        if (hospitalCtx->appts[i].status == 3 && hospitalCtx->appts[i].date == d) wait.push_back(i);
+    if (wait.empty()) { cout << "Nobody waiting for " << tmp << ".\n"; return; }
+    stable_sort(wait.begin(), wait.end(), [](int x, int y) { return hospital_appt_length(hospitalCtx->appts[x]) > hospital_appt_length(hospitalCtx->appts[y]); });
+    int placed = 0;
+    for (size_t w = 0; w < wait.size(); ++w)
+    {
+        HospitalAppointment &a = hospitalCtx->appts[wait[w]];
+        int len = hospital_appt_length(a);
+        if (len <= 0) continue;
+        long long keys[3];
+        int nk = hospital_appt_resources(a, d, keys);
+        int st = hospital_common_free(keys, nk, HOSPITAL_DAY_OPEN, len, HOSPITAL_DAY_CLOSE);
+        if (st < 0) continue;
+        a.time = st;
+        a.status = 0;
+        hospital_calendar_add(a);
+        cout << "  " << a.apptID << " -> " << cityFormatTime(st) << "-" << cityFormatTime(st + len) << " (Doctor " << a.doctorID << ")\n";
+        placed++;
+    }
+    cout << "Scheduled " << placed << " of " << wait.size() << " waiting appointments; " << (int)wait.size() - placed << " still waiting.\n";
 }
 
 // List appointments
 void hospitalListAppointments()
 {
-    if (hospitalApptCount == 0) { cout << "No appointments.\n"; return; }
+    if (hospitalCtx->appts.empty()) { cout << "No appointments.\n"; return; }
     cout << "Appointments:\n";
-    for (int i = 0; i < hospitalApptCount; ++i)
+    for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
     {
-        HospitalAppointment &a = hospitalAppts[i];
+        HospitalAppointment &a = hospitalCtx->appts[i];
         string tstr = (a.type==1?"General":(a.type==2?"Surgery":"Lab"));
-        cout << a.apptID << " | " << tstr << " | Patient:" << a.patientID << " | Doctor:" << a.doctorID << " | " << a.date << " " << a.time << " | Dur:" << a.duration << " | Status:" << a.status;
+        cout << a.apptID << " | " << tstr << " | Patient:" << a.patientID << " | Doctor:" << a.doctorID << " | " << cityFormatDate(a.date) << " " << cityFormatTime(a.time) << " | Dur:" << a.duration << " | Status:" << a.status;
         if (a.type == 2)
-            cout << " | OT:" << a.OTroomID << " | SurgDur:" << a.durationMins << " | Anesth:" << a.anesthesiaType;
+            cout << " | OT:" << a.OTroomID << " | SurgDur:" << a.durationMins << " | Anesth:" << hospital_str(a.anesthesiaType);
         if (a.type == 3)
-            cout << " | Test:" << a.testType << " | ResultDate:" << a.resultDate << " | ResultSummary:" << a.resultSummary;
-        if (strlen(a.remarks) > 0) cout << " | Remarks:" << a.remarks;
+            cout << " | Test:" << hospital_str(a.testType) << " | ResultDate:" << cityFormatDate(a.resultDate) << " | ResultSummary:" << hospital_str(a.resultSummary);
+        if (a.remarks) cout << " | Remarks:" << hospital_str(a.remarks);
         cout << "\n";
     }
 }
 void hospitalShowAllPatients()
 {
-    if (hospitalPatientCount == 0)
+    if (hospitalCtx->patients.empty())
     {
         cout << "No patients found.\n";
         return;
     }
 
     cout << "\n=========== ALL PATIENTS ==========\n";
-    for (int i = 0; i < hospitalPatientCount; i++)
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); i++)
     {
-        HospitalPatient &p = hospitalPatients[i];
+        HospitalPatient &p = hospitalCtx->patients[i];
         cout << "ID: " << p.patient_id
-             << " | Name: " << p.name
+             << " | Name: " << hospital_str(p.name)
              << " | Age: " << p.age
-             << " | Gender: " << p.gender
-             << " | Contact: " << p.contact
+             << " | Gender: " << hospital_str(p.gender)
+             << " | Contact: " << hospital_str(p.contact)
              << " | Status: " << p.status
-             << "\nAddress: " << p.address
-             << "\nNotes: " << p.notes
+             << "\nAddress: " << hospital_str(p.address)
+             << "\nNotes: " << hospital_str(p.notes)
              << "\n------------------------------------\n";
     }
 }
@@ -3618,6 +4053,9 @@ void hospitalShowMenu()
     cout << "14. Load labs CSV (labs.csv)  (updates lab results only)\n";
     cout << "15. Load All CSV\n";
     cout << "16. Show All Patients\n";
+    cout << "17. Find Earliest Free Slot for Doctor\n";
+    cout << "18. Schedule Waiting List for a Day\n";
+    cout << "19. Ward Occupancy Dashboard\n";
     cout << " 0. Return to MAIN MENU\n";
     cout << "====================================\n";
     cout << "Enter choice: ";
@@ -3625,8 +4063,11 @@ void hospitalShowMenu()
 
 void hospitalInitModule()
 {
+    if (hospitalCtx)
+        return; // state is kept across visits to the menu
+    hospitalCtx = new HospitalContext(); // bitsets and ward totals start zeroed
+    hospitalCtx->arena.push_back('\0');
     hospital_init_patient_hash();
-    // other arrays are default-initialized by static storage
 }
 
 // hospitalSystem (entry)
@@ -3663,6 +4104,9 @@ void hospitalSystem()
         case 14: hospitalLoadLabsCSV("labs.csv"); break;
         case 15: hospitalLoadAllData();break;
         case 16: hospitalShowAllPatients();break;
+        case 17: hospitalFindFreeSlotInteractive(); break;
+        case 18: hospitalScheduleWaitingList(); break;
+        case 19: hospitalWardDashboard(); break;
 
         case 0: cout << "Returning to main menu...\n"; return;
         default: cout << "Invalid choice.\n";
@@ -3673,6 +4117,12 @@ void hospitalSystem()
 #include <fstream>
 #include <string>
 #include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "../city_date.h"
+#include "../city_dict.h"
 using namespace std;
 
 /* ===================== CONFIG ===================== */
@@ -3688,6 +4138,16 @@ using namespace std;
 static int toInteger(const string &s){ try{return stoi(s);}catch(...){return 0;} }
 static double toDouble(const string &s){ try{return stod(s);}catch(...){return 0.0;} }
 
+/* data rows in a CSV (header excluded); rewinds the stream */
+static int communityCountRows(ifstream &in){
+    int rows=0;
+    string line;
+    while(getline(in,line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows>0 ? rows-1 : 0;
+}
+
 static int communitysplitCSV(const string &line, string out[], int maxCols){
     int col = 0;
     string cur = "";
@@ -3703,35 +4163,142 @@ static int communitysplitCSV(const string &line, string out[], int maxCols){
     return col;
 }
 
-static bool timeOverlap(const string &d1,const string &s1,const string &e1,
-                        const string &d2,const string &s2,const string &e2){
-    if(d1 != d2) return false;
-    string a=d1+" "+s1, b=d1+" "+e1, c=d2+" "+s2, d=d2+" "+e2;
-    return (a < d && c < b);
+/* dates are day numbers, times minutes after midnight */
+static bool timeOverlap(CityDate d1,int s1,int e1,CityDate d2,int s2,int e2){
+    return (d1==d2) & (s1<e2) & (s2<e1);
 }
 
 /* ===================== STRUCTS ===================== */
-struct communityMember{ int id,age,active; string name,phone,email,mtype,join_date,address; };
-struct communityStaff{ int id,active; double salary; string name,role,phone,email,join_date; };
+struct communityMember{ int id,age,active; CityDate join_date; string name,phone,email,mtype,address; };
+struct communityStaff{ int id,active; double salary; CityDate join_date; string name,role,phone,email; };
 struct communityFacility{ int id,capacity,active; double price; string name,type,location,from,to; };
-struct communityEquipment{ int id,qty_total,qty_avail; string name,cond,last_maint; };
-struct communityEvent{ int id,org_member,facility,expected; double revenue; string title,date,start,end,status; };
-struct communityBooking{ int id,event_id,member_id,facility_id; double total; string date,start,end,status; };
-struct communityRevenue{ int id,src_id; double amount; string src,date,desc; };
-struct communityExpense{ int id,related; double amount; string date,vendor,desc,type; };
-
-/* ===================== GLOBAL ARRAYS ===================== */
-static communityMember members[MAX_MEMBERS]; int memberCount=0;
-static communityStaff staffs[MAX_STAFF]; int staffCounts=0;
-static communityFacility facilities[MAX_FACILITIES]; int facilityCount=0;
-static communityEquipment equipmentArr[MAX_EQUIPMENT]; int equipmentCount=0;
-static communityEvent eventsArr[MAX_EVENTS]; int eventCount=0;
-static communityBooking bookings[MAX_BOOKINGS]; int bookingCount=0;
-static communityRevenue revenues[MAX_TXN]; int revenueCount=0;
-static communityExpense expenses[MAX_TXN]; int expenseCount=0;
+struct communityEquipment{ int id,qty_total,qty_avail; CityDate last_maint; string name,cond; };
+struct communityEvent{ int id,org_member,facility,expected,start,end; CityDate date; double revenue; string title; CityCode status; };
+struct communityBooking{ int id,event_id,member_id,facility_id,start,end; CityDate date; double total; CityCode status; };
+struct communityRevenue{ int id,src_id; CityDate date; double amount; string src,desc; };
+struct communityExpense{ int id,related; CityDate date; double amount; string vendor,desc,type; };
+
+/* ===================== STATUS CODES =====================
+   Event and booking status are interned (city_dict.h); the seeded values
+   below have fixed codes, others from the CSVs are added as they appear. */
+static CityDict communityEventStatus = cityDictMake({"scheduled","approved","pending"});
+static CityDict communityBookingStatus = cityDictMake({"paid","partial","unpaid"});
+#define COMMUNITY_EVENT_SCHEDULED 0
+#define COMMUNITY_BOOKING_PAID 0
+
+/* ===================== MODULE CONTEXT =====================
+   Created by communityInitModule(); MAX_* cap what the add menus accept. */
+struct CommunityContext{
+    vector<communityMember> members;
+    vector<communityStaff> staffs;
+    vector<communityFacility> facilities;
+    vector<communityEquipment> equipmentArr;
+    vector<communityEvent> eventsArr;
+    vector<communityBooking> bookings;
+    vector<communityRevenue> revenues;
+    vector<communityExpense> expenses;
+};
+static CommunityContext *communityCtx = NULL;
+
+/* ===================== BOOKING CALENDAR =====================
+   Accepted bookings per (facility, day), sorted by start minute.
+   Slots within one day never overlap (every insert is checked first),
+   so a conflict can only be with the neighbours of the insert point.
+   Slots carry the booking id, not the array index, because communityCtx->bookings[]
+   is re-ordered by the sort menu.
+   Bookings whose end is not after their start are empty and not indexed. */
+struct communitySlot{ int start,end,id; };
+static map<long long, vector<communitySlot> > communityCalendar;
+
+static long long communityDayKey(int fac,CityDate d){ return ((long long)fac<<32) | (unsigned)d; }
+
+static size_t communitySlotPos(const vector<communitySlot> &v,int st){
+    return lower_bound(v.begin(),v.end(),st,[](const communitySlot &a,int x){ return a.start<x; })-v.begin();
+}
+
+static void communityCalendarAdd(const communityBooking &b){
+    if(b.end<=b.start) return;
+    vector<communitySlot> &v=communityCalendar[communityDayKey(b.facility_id,b.date)];
+    communitySlot sl={b.start,b.end,b.id};
+    v.insert(v.begin()+communitySlotPos(v,b.start),sl);
+}
+
+/* ===================== DATE INDEXES =====================
+   Row indices of communityCtx->bookings[] and communityCtx->revenues[] ordered by date, so range
+   reports seek to the first day and stop after the last. Ties keep
+   insertion order. communityCtx->bookings[] is re-ordered by the sort menu, which
+   rebuilds its index. */
+struct communityDateRow{ CityDate date; int row; };
+static vector<communityDateRow> communityBookingsByDate, communityRevenueByDate;
+
+static bool communityDateLess(const communityDateRow &a,const communityDateRow &b){ return a.date<b.date; }
+
+static size_t communityDateSeek(const vector<communityDateRow> &v,CityDate d){
+    communityDateRow k={d,0};
+    return lower_bound(v.begin(),v.end(),k,communityDateLess)-v.begin();
+}
+
+static void communityDateIndexAdd(vector<communityDateRow> &v,CityDate d,int row){
+    communityDateRow k={d,row};
+    v.insert(upper_bound(v.begin(),v.end(),k,communityDateLess),k);
+}
+
+static void communityIndexBookingDates(){
+    int n=communityCtx->bookings.size();
+    communityBookingsByDate.resize(n);
+    for(int i=0;i<n;i++){ communityBookingsByDate[i].date=communityCtx->bookings[i].date; communityBookingsByDate[i].row=i; }
+    stable_sort(communityBookingsByDate.begin(),communityBookingsByDate.end(),communityDateLess);
+}
+
+static void communityIndexRevenueDates(){
+    int n=communityCtx->revenues.size();
+    communityRevenueByDate.resize(n);
+    for(int i=0;i<n;i++){ communityRevenueByDate[i].date=communityCtx->revenues[i].date; communityRevenueByDate[i].row=i; }
+    stable_sort(communityRevenueByDate.begin(),communityRevenueByDate.end(),communityDateLess);
+}
+
+/* ===================== EVENT LEDGER =====================
+   event_id -> its revenue and expense rows (indices into communityCtx->revenues[] /
+   communityCtx->expenses[], which are never re-ordered). Booking revenue is resolved
+   through booking_id -> event_id; rows for a booking not seen yet wait
+   in communityPendingRevenue until that booking is added. */
+struct communityEventLedger{ vector<int> rev,exp; };
+static unordered_map<int,int> communityBookingEvent;
+static unordered_map<int,communityEventLedger> communityLedger;
+static unordered_map<int,vector<int> > communityPendingRevenue;
+
+static void communityLedgerAddRevenue(int row){
+    communityRevenue &r=communityCtx->revenues[row];
+    if(r.src=="event"){ communityLedger[r.src_id].rev.push_back(row); return; }
+    if(r.src!="booking") return;
+    unordered_map<int,int>::const_iterator it=communityBookingEvent.find(r.src_id);
+    if(it!=communityBookingEvent.end()) communityLedger[it->second].rev.push_back(row);
+    else communityPendingRevenue[r.src_id].push_back(row);
+}
+
+static void communityLedgerAddExpense(int row){
+    communityLedger[communityCtx->expenses[row].related].exp.push_back(row);
+}
+
+static void communityLedgerAddBooking(const communityBooking &b){
+    communityBookingEvent[b.id]=b.event_id;
+    unordered_map<int,vector<int> >::iterator it=communityPendingRevenue.find(b.id);
+    if(it==communityPendingRevenue.end()) return;
+    vector<int> &rev=communityLedger[b.event_id].rev;
+    rev.insert(rev.end(),it->second.begin(),it->second.end());
+    communityPendingRevenue.erase(it);
+}
+
+static void communityRebuildLedger(){
+    communityBookingEvent.clear(); communityLedger.clear(); communityPendingRevenue.clear();
+    communityBookingEvent.reserve(communityCtx->bookings.size());
+    for(size_t i=0;i<communityCtx->bookings.size();i++) communityLedgerAddBooking(communityCtx->bookings[i]);
+    for(size_t i=0;i<communityCtx->revenues.size();i++) communityLedgerAddRevenue(i);
+    for(size_t i=0;i<communityCtx->expenses.size();i++) communityLedgerAddExpense(i);
+}
 
 /* ===================== FORWARD DEFS ===================== */
-bool communityCheckBookingOverlap(int fac,const string &d,const string &st,const string &en);
+bool communityCheckBookingOverlap(int fac,CityDate d,int st,int en);
 void communityBulkFindOverlaps();
 void communityMainMenu();
 
@@ -3754,166 +4321,177 @@ static void printHeader(const string cols[], const int w[], int n){
 
 /* ============================================================
    ======================= LOADERS =============================
-   (Each loader resets its own count)
+   (Each loader replaces its own table)
    ============================================================ */
 
 void communityLoadMembersCSV(const string &fn){
-    memberCount = 0;
+    communityCtx->members.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->members.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[9]; int n = communitysplitCSV(line,c,9);
         if(n<2) continue;
-        communityMember &m = members[memberCount];
+        communityMember m;
         m.id=toInteger(c[0]); m.name=c[1]; m.age=(n>2?toInteger(c[2]):0);
         m.phone=c[3]; m.email=c[4]; m.mtype=c[5];
-        m.join_date=c[6]; m.address=c[7]; m.active=toInteger(c[8]);
-        if(m.id!=0) memberCount++;
+        m.join_date=cityDate(c[6]); m.address=c[7]; m.active=toInteger(c[8]);
+        if(m.id!=0) communityCtx->members.push_back(m);
     }
-    cout<<"Loaded "<<memberCount<<" members\n";
+    cout<<"Loaded "<<communityCtx->members.size()<<" members\n";
 }
 
 void communityLoadStaffCSV(const string &fn){
-    staffCounts = 0;
+    communityCtx->staffs.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->staffs.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[8]; int n=communitysplitCSV(line,c,8);
         if(n<2) continue;
-        communityStaff &s = staffs[staffCounts];
+        communityStaff s;
         s.id=toInteger(c[0]); s.name=c[1]; s.role=c[2];
         s.phone=c[3]; s.email=c[4];
-        s.salary=(n>5?toDouble(c[5]):0); s.join_date=c[6];
+        s.salary=(n>5?toDouble(c[5]):0); s.join_date=cityDate(c[6]);
         s.active=(n>7?toInteger(c[7]):1);
-        if(s.id!=0) staffCounts++;
+        if(s.id!=0) communityCtx->staffs.push_back(s);
     }
-    cout<<"Loaded "<<staffCounts<<" staff\n";
+    cout<<"Loaded "<<communityCtx->staffs.size()<<" staff\n";
 }
 
 void communityLoadFacilitiesCSV(const string &fn){
-    facilityCount = 0;
+    communityCtx->facilities.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->facilities.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[9]; int n=communitysplitCSV(line,c,9);
-        communityFacility &f=facilities[facilityCount];
+        communityFacility f;
         f.id=toInteger(c[0]); f.name=c[1]; f.type=c[2];
         f.capacity=toInteger(c[3]); f.price=toDouble(c[4]);
         f.location=c[5]; f.from=c[6]; f.to=c[7];
         f.active=(n>8?toInteger(c[8]):1);
-        if(f.id!=0) facilityCount++;
+        if(f.id!=0) communityCtx->facilities.push_back(f);
     }
-    cout<<"Loaded "<<facilityCount<<" facilities\n";
+    cout<<"Loaded "<<communityCtx->facilities.size()<<" facilities\n";
 }
 
 void communityLoadEquipmentCSV(const string &fn){
-    equipmentCount = 0;
+    communityCtx->equipmentArr.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->equipmentArr.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[6]; int n=communitysplitCSV(line,c,6);
-        communityEquipment &e = equipmentArr[equipmentCount];
+        communityEquipment e;
         e.id=toInteger(c[0]); e.name=c[1];
         e.qty_total=toInteger(c[2]);
         e.qty_avail=toInteger(c[3]);
-        e.cond=c[4]; e.last_maint=c[5];
-        if(e.id!=0) equipmentCount++;
+        e.cond=c[4]; e.last_maint=cityDate(c[5]);
+        if(e.id!=0) communityCtx->equipmentArr.push_back(e);
     }
-    cout<<"Loaded "<<equipmentCount<<" equipment\n";
+    cout<<"Loaded "<<communityCtx->equipmentArr.size()<<" equipment\n";
 }
 
 void communityLoadEventsCSV(const string &fn){
-    eventCount=0;
+    communityCtx->eventsArr.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->eventsArr.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[10]; communitysplitCSV(l,c,10);
-        communityEvent &e = eventsArr[eventCount];
+        communityEvent e;
         e.id=toInteger(c[0]); e.title=c[1];
         e.org_member=toInteger(c[2]); e.facility=toInteger(c[3]);
-        e.date=c[4]; e.start=c[5]; e.end=c[6];
+        e.date=cityDate(c[4]); e.start=cityTime(c[5]); e.end=cityTime(c[6]);
         e.expected=toInteger(c[7]); e.revenue=toDouble(c[8]);
-        e.status=c[9];
-        if(e.id!=0) eventCount++;
+        e.status=cityIntern(communityEventStatus,c[9]);
+        if(e.id!=0) communityCtx->eventsArr.push_back(e);
     }
-    cout<<"Loaded "<<eventCount<<" events\n";
+    cout<<"Loaded "<<communityCtx->eventsArr.size()<<" events\n";
 }
 
-bool communityCheckBookingOverlap(int fac,const string &d,const string &st,const string &en){
-    for(int i=0;i<bookingCount;i++){
-        communityBooking &b=bookings[i];
-        if(b.facility_id==fac && b.date==d){
-            if(timeOverlap(d,st,en,b.date,b.start,b.end))
-                return true;
-        }
-    }
+bool communityCheckBookingOverlap(int fac,CityDate d,int st,int en){
+    if(en<=st) return false;
+    map<long long, vector<communitySlot> >::const_iterator it=communityCalendar.find(communityDayKey(fac,d));
+    if(it==communityCalendar.end()) return false;
+    const vector<communitySlot> &v=it->second;
+    size_t i=communitySlotPos(v,st);
+    if(i<v.size() && timeOverlap(d,st,en,d,v[i].start,v[i].end)) return true;
+    if(i>0 && timeOverlap(d,st,en,d,v[i-1].start,v[i-1].end)) return true;
     return false;
 }
 
 void communityLoadBookingsCSV(const string &fn){
-    bookingCount=0;
+    communityCtx->bookings.clear();
+    communityCalendar.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->bookings.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[9]; communitysplitCSV(l,c,9);
         communityBooking b;
         b.id=toInteger(c[0]); b.event_id=toInteger(c[1]);
         b.member_id=toInteger(c[2]); b.facility_id=toInteger(c[3]);
-        b.date=c[4]; b.start=c[5]; b.end=c[6];
-        b.total=toDouble(c[7]); b.status=c[8];
+        b.date=cityDate(c[4]); b.start=cityTime(c[5]); b.end=cityTime(c[6]);
+        b.total=toDouble(c[7]); b.status=cityIntern(communityBookingStatus,c[8]);
         if(b.id==0) continue;
 
         if(communityCheckBookingOverlap(b.facility_id,b.date,b.start,b.end)){
             cout<<"Skip overlap booking "<<b.id<<"\n"; 
             continue;
         }
-        bookings[bookingCount++] = b;
+        communityCalendarAdd(b);
+        communityCtx->bookings.push_back(b);
     }
-    cout<<"Loaded "<<bookingCount<<" bookings\n";
+    communityIndexBookingDates();
+    cout<<"Loaded "<<communityCtx->bookings.size()<<" bookings\n";
 }
 
 void communityLoadRevenueCSV(const string &fn){
-    revenueCount=0;
+    communityCtx->revenues.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->revenues.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[6]; communitysplitCSV(l,c,6);
-        communityRevenue &r = revenues[revenueCount];
+        communityRevenue r;
         r.id=toInteger(c[0]); r.src=c[1]; r.src_id=toInteger(c[2]);
-        r.date=c[3]; r.amount=toDouble(c[4]); r.desc=c[5];
-        if(r.id!=0) revenueCount++;
+        r.date=cityDate(c[3]); r.amount=toDouble(c[4]); r.desc=c[5];
+        if(r.id!=0) communityCtx->revenues.push_back(r);
     }
-    cout<<"Loaded "<<revenueCount<<" revenue rows\n";
+    communityIndexRevenueDates();
+    cout<<"Loaded "<<communityCtx->revenues.size()<<" revenue rows\n";
 }
 
 void communityLoadExpensesCSV(const string &fn){
-    expenseCount=0;
+    communityCtx->expenses.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->expenses.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[7]; communitysplitCSV(l,c,7);
-        communityExpense &e=expenses[expenseCount];
+        communityExpense e;
         e.id=toInteger(c[0]); e.related=toInteger(c[1]);
-        e.date=c[2]; e.amount=toDouble(c[3]);
+        e.date=cityDate(c[2]); e.amount=toDouble(c[3]);
         e.vendor=c[4]; e.desc=c[5]; e.type=c[6];
-        if(e.id!=0) expenseCount++;
+        if(e.id!=0) communityCtx->expenses.push_back(e);
     }
-    cout<<"Loaded "<<expenseCount<<" expenses\n";
+    cout<<"Loaded "<<communityCtx->expenses.size()<<" expenses\n";
 }
 
 /* Load ALL */
 void communityLoadAllCSVsFromFolder(const string &p){
     string x=p;
     if(!x.empty() && x.back()!='/' && x.back()!='\\') x.push_back('/');
-    memberCount=staffCounts=facilityCount=equipmentCount=eventCount=bookingCount=revenueCount=expenseCount=0;
     communityLoadMembersCSV(x+"communityMembers.csv");
     communityLoadStaffCSV(x+"communityStaff.csv");
     communityLoadFacilitiesCSV(x+"communityFacilities.csv");
@@ -3922,6 +4500,7 @@ void communityLoadAllCSVsFromFolder(const string &p){
     communityLoadBookingsCSV(x+"communityBookings.csv");
     communityLoadRevenueCSV(x+"communityRevenue.csv");
     communityLoadExpensesCSV(x+"communityExpenses.csv");
+    communityRebuildLedger();
 }
 
 /* ============================================================
@@ -3929,24 +4508,26 @@ void communityLoadAllCSVsFromFolder(const string &p){
    ============================================================ */
 
 static void swapB(communityBooking &a,communityBooking &b){ communityBooking t=a; a=b; b=t; }
-static string bk(const communityBooking &b){ return b.date+" "+b.start; }
+static long long bk(const communityBooking &b){ return (long long)b.date*CITY_MINUTES_PER_DAY+b.start; }
 
 int partB(int l,int r){
-    string p=bk(bookings[l]);
+    long long p=bk(communityCtx->bookings[l]);
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && bk(bookings[i])<p);
-        do{j--;} while(j>=l && bk(bookings[j])>p);
+        do{i++;} while(i<=r && bk(communityCtx->bookings[i])<p);
+        do{j--;} while(j>=l && bk(communityCtx->bookings[j])>p);
         if(i>=j) break;
-        swapB(bookings[i],bookings[j]);
+        swapB(communityCtx->bookings[i],communityCtx->bookings[j]);
     }
-    swapB(bookings[l],bookings[j]);
+    swapB(communityCtx->bookings[l],communityCtx->bookings[j]);
     return j;
 }
 void qsortB(int l,int r){ if(l<r){ int s=partB(l,r); qsortB(l,s-1); qsortB(s+1,r);} }
 
 void communitySortBookings(){
-    if(bookingCount>1) qsortB(0,bookingCount-1);
+    int n=communityCtx->bookings.size();
+    if(n>1) qsortB(0,n-1);
+    communityIndexBookingDates();
     cout<<"Bookings sorted\n";
 }
 
@@ -3954,44 +4535,58 @@ void communitySortBookings(){
 static void swapF(communityFacility &a,communityFacility &b){ communityFacility t=a;a=b;b=t; }
 
 int partFP(int l,int r){
-    double p=facilities[l].price;
+    double p=communityCtx->facilities[l].price;
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && facilities[i].price<p);
-        do{j--;} while(j>=l && facilities[j].price>p);
+        do{i++;} while(i<=r && communityCtx->facilities[i].price<p);
+        do{j--;} while(j>=l && communityCtx->facilities[j].price>p);
         if(i>=j) break;
-        swapF(facilities[i],facilities[j]);
+        swapF(communityCtx->facilities[i],communityCtx->facilities[j]);
     }
-    swapF(facilities[l],facilities[j]);
+    swapF(communityCtx->facilities[l],communityCtx->facilities[j]);
     return j;
 }
 void qsortFP(int l,int r){ if(l<r){ int s=partFP(l,r); qsortFP(l,s-1); qsortFP(s+1,r);} }
-void communitySortFacilitiesByPrice(){ if(facilityCount>1) qsortFP(0,facilityCount-1); }
+void communitySortFacilitiesByPrice(){ int n=communityCtx->facilities.size(); if(n>1) qsortFP(0,n-1); }
 
 int partFC(int l,int r){
-    int p=facilities[l].capacity;
+    int p=communityCtx->facilities[l].capacity;
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && facilities[i].capacity<p);
-        do{j--;} while(j>=l && facilities[j].capacity>p);
+        do{i++;} while(i<=r && communityCtx->facilities[i].capacity<p);
+        do{j--;} while(j>=l && communityCtx->facilities[j].capacity>p);
         if(i>=j) break;
-        swapF(facilities[i],facilities[j]);
+        swapF(communityCtx->facilities[i],communityCtx->facilities[j]);
     }
-    swapF(facilities[l],facilities[j]);
+    swapF(communityCtx->facilities[l],communityCtx->facilities[j]);
     return j;
 }
 void qsortFC(int l,int r){ if(l<r){ int s=partFC(l,r); qsortFC(l,s-1); qsortFC(s+1,r);} }
-void communitySortFacilitiesByCapacity(){ if(facilityCount>1) qsortFC(0,facilityCount-1); }
+void communitySortFacilitiesByCapacity(){ int n=communityCtx->facilities.size(); if(n>1) qsortFC(0,n-1); }
 
+/* Sweep line over all bookings: order by (facility, day, start), then each
+   booking is paired with every later one that starts before it ends.
+   O(n log n + k) for k overlapping pairs; does not touch communityCtx->bookings[] order. */
 void communityBulkFindOverlaps(){
-    communitySortBookings();
-    for(int i=1;i<bookingCount;i++){
-        communityBooking &a=bookings[i-1], &b=bookings[i];
-        if(a.facility_id==b.facility_id && a.date==b.date){
-            if(timeOverlap(a.date,a.start,a.end,b.date,b.start,b.end))
-                cout<<"Overlap: "<<a.id<<" <-> "<<b.id<<" ("<<a.date<<")\n";
+    struct Iv{ long long key; int start,end,idx; };
+    vector<Iv> iv;
+    int n=communityCtx->bookings.size();
+    iv.reserve(n);
+    for(int i=0;i<n;i++){
+        communityBooking &b=communityCtx->bookings[i];
+        if(b.end<=b.start) continue;
+        Iv x={communityDayKey(b.facility_id,b.date),b.start,b.end,i};
+        iv.push_back(x);
+    }
+    sort(iv.begin(),iv.end(),[](const Iv &a,const Iv &b){ return a.key!=b.key ? a.key<b.key : a.start<b.start; });
+    int found=0;
+    for(size_t i=0;i<iv.size();i++)
+        for(size_t j=i+1;j<iv.size() && iv[j].key==iv[i].key && iv[j].start<iv[i].end;j++){
+            communityBooking &a=communityCtx->bookings[iv[i].idx], &b=communityCtx->bookings[iv[j].idx];
+            cout<<"Overlap: "<<a.id<<" <-> "<<b.id<<" ("<<cityFormatDate(a.date)<<")\n";
+            found++;
         }
-    }
+    cout<<found<<" overlapping pair(s)\n";
 }
 
 /* ============================================================
@@ -3999,35 +4594,39 @@ void communityBulkFindOverlaps(){
    ============================================================ */
 
 void addMember(){
-    if(memberCount>=MAX_MEMBERS){ cout<<"Full\n"; return; }
-    communityMember &m=members[memberCount];
+    if((int)communityCtx->members.size()>=MAX_MEMBERS){ cout<<"Full\n"; return; }
+    communityMember m;
     cout<<"ID: "; cin>>m.id; cin.ignore();
     cout<<"Name: "; getline(cin,m.name);
     cout<<"Age: "; cin>>m.age; cin.ignore();
     cout<<"Phone: "; getline(cin,m.phone);
     cout<<"Email: "; getline(cin,m.email);
     cout<<"Type: "; getline(cin,m.mtype);
-    cout<<"Join Date: "; getline(cin,m.join_date);
+    string jd;
+    cout<<"Join Date: "; getline(cin,jd); m.join_date=cityDate(jd);
     cout<<"Address: "; getline(cin,m.address);
-    m.active=1; memberCount++;
+    m.active=1;
+    communityCtx->members.push_back(m);
 }
 
 void addStaffs(){
-    if(staffCounts>=MAX_STAFF){ cout<<"Full\n"; return; }
-    communityStaff &s=staffs[staffCounts];
+    if((int)communityCtx->staffs.size()>=MAX_STAFF){ cout<<"Full\n"; return; }
+    communityStaff s;
     cout<<"ID: "; cin>>s.id; cin.ignore();
     cout<<"Name: "; getline(cin,s.name);
     cout<<"Role: "; getline(cin,s.role);
     cout<<"Phone: "; getline(cin,s.phone);
     cout<<"Email: "; getline(cin,s.email);
     cout<<"Salary: "; cin>>s.salary; cin.ignore();
-    cout<<"Join Date: "; getline(cin,s.join_date);
-    s.active=1; staffCounts++;
+    string jd;
+    cout<<"Join Date: "; getline(cin,jd); s.join_date=cityDate(jd);
+    s.active=1;
+    communityCtx->staffs.push_back(s);
 }
 
 void addFacility(){
-    if(facilityCount>=MAX_FACILITIES){ cout<<"Full\n"; return; }
-    communityFacility &f=facilities[facilityCount];
+    if((int)communityCtx->facilities.size()>=MAX_FACILITIES){ cout<<"Full\n"; return; }
+    communityFacility f;
     cout<<"ID: "; cin>>f.id; cin.ignore();
     cout<<"Name: "; getline(cin,f.name);
     cout<<"Type: "; getline(cin,f.type);
@@ -4036,92 +4635,113 @@ void addFacility(){
     cout<<"Location: "; getline(cin,f.location);
     cout<<"From: "; getline(cin,f.from);
     cout<<"To: "; getline(cin,f.to);
-    f.active=1; facilityCount++;
+    f.active=1;
+    communityCtx->facilities.push_back(f);
 }
 
 void addEquipment(){
-    if(equipmentCount>=MAX_EQUIPMENT){ cout<<"Full\n"; return; }
-    communityEquipment &e=equipmentArr[equipmentCount];
+    if((int)communityCtx->equipmentArr.size()>=MAX_EQUIPMENT){ cout<<"Full\n"; return; }
+    communityEquipment e;
     cout<<"ID: "; cin>>e.id; cin.ignore();
     cout<<"Name: "; getline(cin,e.name);
     cout<<"Total Qty: "; cin>>e.qty_total; cin.ignore();
     cout<<"Available Qty: "; cin>>e.qty_avail; cin.ignore();
     cout<<"Cond: "; getline(cin,e.cond);
-    cout<<"Last Maint: "; getline(cin,e.last_maint);
-    equipmentCount++;
+    string lm;
+    cout<<"Last Maint: "; getline(cin,lm); e.last_maint=cityDate(lm);
+    communityCtx->equipmentArr.push_back(e);
 }
 
 void addEvent(){
-    if(eventCount>=MAX_EVENTS){ cout<<"Full\n"; return; }
-    communityEvent &ev=eventsArr[eventCount];
+    if((int)communityCtx->eventsArr.size()>=MAX_EVENTS){ cout<<"Full\n"; return; }
+    communityEvent ev;
     cout<<"ID: "; cin>>ev.id; cin.ignore();
     cout<<"Title: "; getline(cin,ev.title);
     cout<<"Org Member: "; cin>>ev.org_member;
     cout<<"Facility: "; cin>>ev.facility; cin.ignore();
-    cout<<"Date: "; getline(cin,ev.date);
-    cout<<"Start: "; getline(cin,ev.start);
-    cout<<"End: "; getline(cin,ev.end);
+    string d,st,en;
+    cout<<"Date: "; getline(cin,d);
+    cout<<"Start: "; getline(cin,st);
+    cout<<"End: "; getline(cin,en);
+    ev.date=cityDate(d); ev.start=cityTime(st); ev.end=cityTime(en);
     cout<<"Expected: "; cin>>ev.expected;
     cout<<"Revenue Est: "; cin>>ev.revenue; cin.ignore();
-    ev.status="scheduled";
-    eventCount++;
+    ev.status=COMMUNITY_EVENT_SCHEDULED;
+    communityCtx->eventsArr.push_back(ev);
 }
 
 void addBooking(){
-    if(bookingCount>=MAX_BOOKINGS){ cout<<"Full\n"; return; }
+    if((int)communityCtx->bookings.size()>=MAX_BOOKINGS){ cout<<"Full\n"; return; }
     communityBooking b;
     cout<<"ID: "; cin>>b.id;
     cout<<"Event: "; cin>>b.event_id;
     cout<<"Member: "; cin>>b.member_id;
     cout<<"Facility: "; cin>>b.facility_id; cin.ignore();
-    cout<<"Date: "; getline(cin,b.date);
-    cout<<"Start: "; getline(cin,b.start);
-    cout<<"End: "; getline(cin,b.end);
+    string d,st,en;
+    cout<<"Date: "; getline(cin,d);
+    cout<<"Start: "; getline(cin,st);
+    cout<<"End: "; getline(cin,en);
+    b.date=cityDate(d); b.start=cityTime(st); b.end=cityTime(en);
+    if(b.date==CITY_NO_DATE || b.start<0 || b.end<0){
+        cout<<"Bad date/time\n"; return;
+    }
 
     if(communityCheckBookingOverlap(b.facility_id,b.date,b.start,b.end)){
         cout<<"Overlap rejected\n"; return;
     }
 
     cout<<"Total: "; cin>>b.total; cin.ignore();
-    cout<<"Status: "; getline(cin,b.status);
+    cout<<"Status: "; string status; getline(cin,status); b.status=cityIntern(communityBookingStatus,status);
 
-    bookings[bookingCount++] = b;
+    communityCalendarAdd(b);
+    communityLedgerAddBooking(b);
+    communityDateIndexAdd(communityBookingsByDate,b.date,communityCtx->bookings.size());
+    communityCtx->bookings.push_back(b);
 
-if(b.status == "paid" && revenueCount < MAX_TXN){
-    revenues[revenueCount].id = revenueCount;
-    revenues[revenueCount].src = "booking";
-    revenues[revenueCount].src_id = b.id;
-    revenues[revenueCount].date = b.date;
-    revenues[revenueCount].amount = b.total;
-    revenues[revenueCount].desc = "auto";
-    revenueCount++;
+if(b.status == COMMUNITY_BOOKING_PAID && communityCtx->revenues.size() < MAX_TXN){
+    int row = communityCtx->revenues.size();
+    communityRevenue r;
+    r.id = row;
+    r.src = "booking";
+    r.src_id = b.id;
+    r.date = b.date;
+    r.amount = b.total;
+    r.desc = "auto";
+    communityCtx->revenues.push_back(r);
+    communityLedgerAddRevenue(row);
+    communityDateIndexAdd(communityRevenueByDate,b.date,row);
 }
 
 }
 
 void addRevenue(){
-    if(revenueCount>=MAX_TXN){ cout<<"Full\n"; return; }
-    communityRevenue &r=revenues[revenueCount];
+    if((int)communityCtx->revenues.size()>=MAX_TXN){ cout<<"Full\n"; return; }
+    communityRevenue r;
     cout<<"ID: "; cin>>r.id; cin.ignore();
     cout<<"Source: "; getline(cin,r.src);
     cout<<"Source ID: "; cin>>r.src_id; cin.ignore();
-    cout<<"Date: "; getline(cin,r.date);
+    string d;
+    cout<<"Date: "; getline(cin,d); r.date=cityDate(d);
     cout<<"Amount: "; cin>>r.amount; cin.ignore();
     cout<<"Desc: "; getline(cin,r.desc);
-    revenueCount++;
+    communityCtx->revenues.push_back(r);
+    communityLedgerAddRevenue(communityCtx->revenues.size()-1);
+    communityDateIndexAdd(communityRevenueByDate,r.date,communityCtx->revenues.size()-1);
 }
 
 void addExpense(){
-    if(expenseCount>=MAX_TXN){ cout<<"Full\n"; return; }
-    communityExpense &e=expenses[expenseCount];
+    if((int)communityCtx->expenses.size()>=MAX_TXN){ cout<<"Full\n"; return; }
+    communityExpense e;
     cout<<"ID: "; cin>>e.id;
     cout<<"Related Event: "; cin>>e.related; cin.ignore();
-    cout<<"Date: "; getline(cin,e.date);
+    string d;
+    cout<<"Date: "; getline(cin,d); e.date=cityDate(d);
     cout<<"Amount: "; cin>>e.amount; cin.ignore();
     cout<<"Vendor: "; getline(cin,e.vendor);
     cout<<"Desc: "; getline(cin,e.desc);
     cout<<"Type: "; getline(cin,e.type);
-    expenseCount++;
+    communityCtx->expenses.push_back(e);
+    communityLedgerAddExpense(communityCtx->expenses.size()-1);
 }
 
 /* ============================================================
@@ -4132,9 +4752,9 @@ void listMembers(){
     const string c[]={"ID","Name","Phone","Email","Type","Join"};
     int w[]={5,16,12,20,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<memberCount;i++){
-        communityMember &m=members[i];
-        cout<<setw(w[0])<<m.id<<" | "<<setw(w[1])<<m.name<<" | "<<setw(w[2])<<m.phone<<" | "<<setw(w[3])<<m.email<<" | "<<setw(w[4])<<m.mtype<<" | "<<setw(w[5])<<m.join_date<<"\n";
+    for(size_t i=0;i<communityCtx->members.size();i++){
+        communityMember &m=communityCtx->members[i];
+        cout<<setw(w[0])<<m.id<<" | "<<setw(w[1])<<m.name<<" | "<<setw(w[2])<<m.phone<<" | "<<setw(w[3])<<m.email<<" | "<<setw(w[4])<<m.mtype<<" | "<<setw(w[5])<<cityFormatDate(m.join_date)<<"\n";
     }
 }
 
@@ -4142,9 +4762,9 @@ void listStaff(){
     const string c[]={"ID","Name","Role","Phone","Salary","Join"};
     int w[]={5,16,12,12,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<staffCounts;i++){
-        communityStaff &s=staffs[i];
-        cout<<setw(w[0])<<s.id<<" | "<<setw(w[1])<<s.name<<" | "<<setw(w[2])<<s.role<<" | "<<setw(w[3])<<s.phone<<" | "<<setw(w[4])<<s.salary<<" | "<<setw(w[5])<<s.join_date<<"\n";
+    for(size_t i=0;i<communityCtx->staffs.size();i++){
+        communityStaff &s=communityCtx->staffs[i];
+        cout<<setw(w[0])<<s.id<<" | "<<setw(w[1])<<s.name<<" | "<<setw(w[2])<<s.role<<" | "<<setw(w[3])<<s.phone<<" | "<<setw(w[4])<<s.salary<<" | "<<setw(w[5])<<cityFormatDate(s.join_date)<<"\n";
     }
 }
 
@@ -4152,8 +4772,8 @@ void listFacilities(){
     const string c[]={"ID","Name","Type","Cap","Price","Location"};
     int w[]={5,16,10,6,10,14};
     printHeader(c,w,6);
-    for(int i=0;i<facilityCount;i++){
-        communityFacility &f=facilities[i];
+    for(size_t i=0;i<communityCtx->facilities.size();i++){
+        communityFacility &f=communityCtx->facilities[i];
         cout<<setw(w[0])<<f.id<<" | "<<setw(w[1])<<f.name<<" | "<<setw(w[2])<<f.type<<" | "<<setw(w[3])<<f.capacity<<" | "<<setw(w[4])<<f.price<<" | "<<setw(w[5])<<f.location<<"\n";
     }
 }
@@ -4162,9 +4782,9 @@ void listEquipment(){
     const string c[]={"ID","Name","Total","Avail","Cond","LastMaint"};
     int w[]={5,16,7,7,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<equipmentCount;i++){
-        communityEquipment &e=equipmentArr[i];
-        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.name<<" | "<<setw(w[2])<<e.qty_total<<" | "<<setw(w[3])<<e.qty_avail<<" | "<<setw(w[4])<<e.cond<<" | "<<setw(w[5])<<e.last_maint<<"\n";
+    for(size_t i=0;i<communityCtx->equipmentArr.size();i++){
+        communityEquipment &e=communityCtx->equipmentArr[i];
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.name<<" | "<<setw(w[2])<<e.qty_total<<" | "<<setw(w[3])<<e.qty_avail<<" | "<<setw(w[4])<<e.cond<<" | "<<setw(w[5])<<cityFormatDate(e.last_maint)<<"\n";
     }
 }
 
@@ -4172,10 +4792,10 @@ void listEvents(){
     const string c[]={"ID","Title","Fac","Date","Start","End","Exp","Rev","Status"};
     int w[]={5,16,5,12,7,7,6,10,10};
     printHeader(c,w,9);
-    for(int i=0;i<eventCount;i++){
-        communityEvent &e=eventsArr[i];
-        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<e.facility<<" | "<<setw(w[3])<<e.date<<" | "
-            <<setw(w[4])<<e.start<<" | "<<setw(w[5])<<e.end<<" | "<<setw(w[6])<<e.expected<<" | "<<setw(w[7])<<e.revenue<<" | "<<setw(w[8])<<e.status<<"\n";
+    for(size_t i=0;i<communityCtx->eventsArr.size();i++){
+        communityEvent &e=communityCtx->eventsArr[i];
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<e.facility<<" | "<<setw(w[3])<<cityFormatDate(e.date)<<" | "
+            <<setw(w[4])<<cityFormatTime(e.start)<<" | "<<setw(w[5])<<cityFormatTime(e.end)<<" | "<<setw(w[6])<<e.expected<<" | "<<setw(w[7])<<e.revenue<<" | "<<setw(w[8])<<cityDictName(communityEventStatus,e.status)<<"\n";
     }
 }
 
@@ -4183,10 +4803,10 @@ void listBookings(){
     const string c[]={"ID","Event","Member","Facility","Date","Start","End","Amt","Status"};
     int w[]={5,7,7,8,12,7,7,10,10};
     printHeader(c,w,9);
-    for(int i=0;i<bookingCount;i++){
-        communityBooking &b=bookings[i];
+    for(size_t i=0;i<communityCtx->bookings.size();i++){
+        communityBooking &b=communityCtx->bookings[i];
         cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "<<setw(w[3])<<b.facility_id<<" | "
-            <<setw(w[4])<<b.date<<" | "<<setw(w[5])<<b.start<<" | "<<setw(w[6])<<b.end<<" | "<<setw(w[7])<<b.total<<" | "<<setw(w[8])<<b.status<<"\n";
+            <<setw(w[4])<<cityFormatDate(b.date)<<" | "<<setw(w[5])<<cityFormatTime(b.start)<<" | "<<setw(w[6])<<cityFormatTime(b.end)<<" | "<<setw(w[7])<<b.total<<" | "<<setw(w[8])<<cityDictName(communityBookingStatus,b.status)<<"\n";
     }
 }
 
@@ -4194,40 +4814,59 @@ void listBookings(){
    ======================== FINANCE ============================
    ============================================================ */
 
+static void eventTotals(int eid,double &R,double &E){
+    R=E=0;
+    unordered_map<int,communityEventLedger>::const_iterator it=communityLedger.find(eid);
+    if(it==communityLedger.end()) return;
+    for(size_t i=0;i<it->second.rev.size();i++) R+=communityCtx->revenues[it->second.rev[i]].amount;
+    for(size_t i=0;i<it->second.exp.size();i++) E+=communityCtx->expenses[it->second.exp[i]].amount;
+}
+
 void eventPnL(int eid){
-    double R=0,E=0;
-    for(int i=0;i<revenueCount;i++){
-        communityRevenue &r=revenues[i];
-        if(r.src=="booking"){
-            for(int j=0;j<bookingCount;j++)
-                if(bookings[j].id==r.src_id && bookings[j].event_id==eid)
-                    R+=r.amount;
-        }
-        else if(r.src=="event" && r.src_id==eid)
-            R+=r.amount;
-    }
-    for(int i=0;i<expenseCount;i++)
-        if(expenses[i].related==eid) E+=expenses[i].amount;
+    double R,E;
+    eventTotals(eid,R,E);
     cout<<"P&L for event "<<eid<<" = "<<(R-E)<<" (Rev: "<<R<<"  Exp: "<<E<<")\n";
 }
 
+/* every event in one pass over the ledger: O(events + revenue + expense rows) */
+void allEventsPnL(){
+    const string c[]={"ID","Title","Revenue","Expense","P&L"};
+    int w[]={5,16,12,12,12};
+    printHeader(c,w,5);
+    double TR=0,TE=0;
+    for(size_t i=0;i<communityCtx->eventsArr.size();i++){
+        communityEvent &e=communityCtx->eventsArr[i];
+        double R,E;
+        eventTotals(e.id,R,E);
+        TR+=R; TE+=E;
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<R<<" | "<<setw(w[3])<<E<<" | "<<setw(w[4])<<(R-E)<<"\n";
+    }
+    cout<<"Season total = "<<(TR-TE)<<" (Rev: "<<TR<<"  Exp: "<<TE<<")\n";
+}
+
 void monthlyRevenue(const string &m){
+    CityDate lo,hi;
+    if(!cityPrefixRange(m,lo,hi)){ cout<<"Bad month\n"; return; }
     double t=0; 
-    for(int i=0;i<revenueCount;i++)
-        if(revenues[i].date.rfind(m,0)==0) t+=revenues[i].amount;
+    const vector<communityDateRow> &v=communityRevenueByDate;
+    for(size_t i=communityDateSeek(v,lo);i<v.size() && v[i].date<hi;i++)
+        t+=communityCtx->revenues[v[i].row].amount;
     cout<<"Revenue for "<<m<<" = "<<t<<"\n";
 }
 
 void bookingsRange(const string &f,const string &t){
     const string c[]={"ID","Event","Mem","Fac","Date","Start","End","Amt"};
     int w[]={5,6,6,6,12,7,7,10};
+    /* "to" is inclusive, so a month or year prefix covers the whole period */
+    CityDate lo,hi,tlo,thi;
+    if(!cityPrefixRange(f,lo,hi) || !cityPrefixRange(t,tlo,thi)){ cout<<"Bad date\n"; return; }
     printHeader(c,w,8);
-    for(int i=0;i<bookingCount;i++){
-        communityBooking &b=bookings[i];
-        if(b.date>=f && b.date<=t)
-            cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "
-                <<setw(w[3])<<b.facility_id<<" | "<<setw(w[4])<<b.date<<" | "<<setw(w[5])<<b.start<<" | "
-                <<setw(w[6])<<b.end<<" | "<<setw(w[7])<<b.total<<"\n";
+    const vector<communityDateRow> &v=communityBookingsByDate;
+    for(size_t i=communityDateSeek(v,lo);i<v.size() && v[i].date<thi;i++){
+        communityBooking &b=communityCtx->bookings[v[i].row];
+        cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "
+            <<setw(w[3])<<b.facility_id<<" | "<<setw(w[4])<<cityFormatDate(b.date)<<" | "<<setw(w[5])<<cityFormatTime(b.start)<<" | "
+            <<setw(w[6])<<cityFormatTime(b.end)<<" | "<<setw(w[7])<<b.total<<"\n";
     }
 }
 
@@ -4235,7 +4874,13 @@ void bookingsRange(const string &f,const string &t){
    ========================= MAIN MENU =========================
    ============================================================ */
 
+void communityInitModule(){
+    if(communityCtx) return; // state is kept across visits to the menu
+    communityCtx = new CommunityContext();
+}
+
 void communitySystem(){
+    communityInitModule();
     while(true){
         cout<<"\n==== COMMUNITY CENTRE ====\n"
             <<"1. Members\n"
@@ -4269,7 +4914,7 @@ void communitySystem(){
             else if(s==3) listStaff();
             else if(s==4){
                 double total=0;
-                for(int i=0;i<staffCounts;i++) total+=staffs[i].salary;
+                for(size_t i=0;i<communityCtx->staffs.size();i++) total+=communityCtx->staffs[i].salary;
                 cout<<"Total payroll = "<<total<<"\n";
             }
             break;
@@ -4299,7 +4944,7 @@ void communitySystem(){
             cout<<"1=LoadEvts 2=LoadBkng 3=AddEvt 4=AddBkng 5=ListEvts 6=ListBkng 7=Sort 8=Overlap\nChoice: ";
             int s; cin>>s; cin.ignore();
             if(s==1) communityLoadEventsCSV("communityEvents.csv");
-            else if(s==2) communityLoadBookingsCSV("communityBookings.csv");
+            else if(s==2){ communityLoadBookingsCSV("communityBookings.csv"); communityRebuildLedger(); }
             else if(s==3) addEvent();
             else if(s==4) addBooking();
             else if(s==5) listEvents();
@@ -4310,11 +4955,12 @@ void communitySystem(){
         }
 
         case 6:{
-            cout<<"1=AddRevenue 2=AddExpense 3=EventPnL\nChoice: ";
+            cout<<"1=AddRevenue 2=AddExpense 3=EventPnL 4=AllEventsPnL\nChoice: ";
             int s; cin>>s; cin.ignore();
             if(s==1) addRevenue();
             else if(s==2) addExpense();
             else if(s==3){ int id; cout<<"Event id: "; cin>>id; eventPnL(id); }
+            else if(s==4) allEventsPnL();
             break;
         }
 
@@ -4344,20 +4990,49 @@ void communitySystem(){
 #include <sstream>
 #include <string>
 #include <limits>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <bitset>
+#include <unordered_map>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 #define ATM_MAX_ACCOUNTS 2000
-#define ATM_MAX_TRANSACTIONS 20000
 #define ATM_MAX_CASH 10
 #define ATM_MAX_RATES 50
+#define ATM_RATE_RETAIN 4 // replaced rate tables kept alive before one is freed
 #define ATM_PIN_ATTEMPT_LIMIT 3
 #define ATM_MAX_WITHDRAW_PER_TXN 20000
 #define ATM_MAX_DEPOSIT_PER_TXN 200000
 #define ATM_DAILY_LIMIT 50000
 #define ATM_INTL_FEE 0.02
+#define ATM_ACC_HASH_SIZE 4099 // prime, > 2 * ATM_MAX_ACCOUNTS
+#define ATM_NOTE_UNIT 50 // every denomination is a multiple of this
+#define ATM_PAY_UNITS (ATM_MAX_WITHDRAW_PER_TXN / ATM_NOTE_UNIT)
+#define ATM_DENOMS 5
+#define ATM_LEDGER_FILE "atm_ledger.bin"
 
 struct ATMAccount {
     string number, name, type, currency, cardCountry;
+    int cur=-1; // interned currency id, see atmInternCurrency
     int pin=0, locked=0, wrongPin=0;
     double balance=0, dayWithdraw=0, limit=0;
 };
@@ -4371,6 +5046,10 @@ struct ATMTransaction {
 struct ATMCash {
     string atmID, location;
     int n2000=0, n500=0, n200=0, n100=0, n50=0;
+    // bit k set = k*ATM_NOTE_UNIT is payable exactly from the notes on hand;
+    // clear payableReady whenever the counts are changed from outside dispense()
+    bitset<ATM_PAY_UNITS + 1> payable;
+    bool payableReady=false;
 };
 
 struct ATMRate {
@@ -4378,26 +5057,152 @@ struct ATMRate {
     double toINR=1.0;
 };
 
-ATMAccount ACC[ATM_MAX_ACCOUNTS];
-ATMTransaction TX[ATM_MAX_TRANSACTIONS];
-ATMCash CASH[ATM_MAX_CASH];
-ATMRate RATE[ATM_MAX_RATES];
+// Created by atmInitModule(); ATM_MAX_* cap the row counts. Accounts are only
+// added from the admin menu or a load, never while the stress test runs.
+struct ATMContext {
+    vector<ATMAccount> acc;
+    // one lock per account slot guards balance/dayWithdraw/locked while ATMs
+    // run concurrently; a deque so growing it never moves a mutex
+    deque<mutex> accLock;
+    // account number -> acc index + 1 (0 = empty), linear probing; accounts are never removed
+    vector<int> accHash;
+    vector<ATMCash> cash;
+};
+static ATMContext *atmCtx = NULL;
+
+vector<ATMTransaction> TX; // CSV history + everything logged since; never capped
 
-int accCnt = 0, txCnt = 0, cashCnt = 0, rateCnt = 0;
 bool dataLoaded = false;
 
+// guards TX
+static mutex atmTxLock;
+
+static unsigned atmHashStr(const string &s){
+    unsigned h = 2166136261u;
+    for(size_t i=0;i<s.size();i++){ h ^= (unsigned char)s[i]; h *= 16777619u; }
+    return h;
+}
+
+static void atmIndexAcc(int i){
+    unsigned k = atmHashStr(atmCtx->acc[i].number) % ATM_ACC_HASH_SIZE;
+    while(atmCtx->accHash[k] != 0){
+        if(atmCtx->acc[atmCtx->accHash[k]-1].number == atmCtx->acc[i].number) return; // keep first, like the old scan
+        k = (k + 1) % ATM_ACC_HASH_SIZE;
+    }
+    atmCtx->accHash[k] = i + 1;
+}
+
+static void atmRebuildAccIndex(){
+    atmCtx->accHash.assign(ATM_ACC_HASH_SIZE, 0);
+    for(size_t i=0;i<atmCtx->acc.size();i++) atmIndexAcc(i);
+}
+
+// appends a to the account table, growing the lock list to match; the caller indexes it
+static void atmAppendAcc(const ATMAccount &a){
+    atmCtx->acc.push_back(a);
+    if(atmCtx->accLock.size() < atmCtx->acc.size()) atmCtx->accLock.emplace_back();
+}
+
+// Lines in a CSV (header included); rewinds the stream.
+static int atmCountLines(ifstream &f){
+    int rows = 0;
+    string line;
+    while(getline(f,line)) rows++;
+    f.clear();
+    f.seekg(0);
+    return rows;
+}
+
 int findAcc(const string &a){
-    for(int i=0;i<accCnt;i++) if(ACC[i].number==a) return i;
+    unsigned k = atmHashStr(a) % ATM_ACC_HASH_SIZE;
+    while(atmCtx->accHash[k] != 0){
+        if(atmCtx->acc[atmCtx->accHash[k]-1].number == a) return atmCtx->accHash[k]-1;
+        k = (k + 1) % ATM_ACC_HASH_SIZE;
+    }
     return -1;
 }
-double getRate(const string &c){
-    for(int i=0;i<rateCnt;i++) if(RATE[i].code==c) return RATE[i].toINR;
-    return 1.0;
+// ---------- currencies & rates ----------
+// Currency codes are interned to ids 0..ATM_MAX_RATES-1 (admin/load time
+// only). Rates live in a flat table indexed by id and published through an
+// atomic pointer: a reload builds a new table and swaps it in, so the
+// transaction path reads rates without taking any lock. Publishers take
+// atmRateLock. A reader holds a table only for one conversion or one
+// settlement batch, so the last ATM_RATE_RETAIN replaced tables are kept
+// for readers still inside one and older ones are freed.
+struct ATMRateTable { double toINR[ATM_MAX_RATES]; };
+
+static unordered_map<string,int> atmCurrencyId;
+static vector<string> atmCurrencyCode;
+static atomic<const ATMRateTable*> atmRateTable(NULL); // NULL = every rate 1.0
+static mutex atmRateLock; // guards atmRetiredRates and serialises publishers
+static vector<const ATMRateTable*> atmRetiredRates;
+
+int atmFindCurrency(const string &code){
+    unordered_map<string,int>::const_iterator it = atmCurrencyId.find(code);
+    return it == atmCurrencyId.end() ? -1 : it->second;
+}
+
+// -1 once ATM_MAX_RATES codes exist; such currencies convert at 1.0
+int atmInternCurrency(const string &code){
+    int id = atmFindCurrency(code);
+    if(id != -1 || (int)atmCurrencyCode.size() >= ATM_MAX_RATES) return id;
+    id = (int)atmCurrencyCode.size();
+    atmCurrencyCode.push_back(code);
+    atmCurrencyId[code] = id;
+    return id;
+}
+
+static const int atmCurINR = atmInternCurrency("INR");
+
+ATMRateTable *atmCopyRates(){
+    ATMRateTable *t = new ATMRateTable;
+    const ATMRateTable *cur = atmRateTable.load(memory_order_acquire);
+    for(int i=0;i<ATM_MAX_RATES;i++) t->toINR[i] = cur ? cur->toINR[i] : 1.0;
+    return t;
+}
+
+// call with atmRateLock held
+static void atmSwapRates(const ATMRateTable *t){
+    const ATMRateTable *old = atmRateTable.exchange(t, memory_order_acq_rel);
+    if(!old) return;
+    atmRetiredRates.push_back(old);
+    if(atmRetiredRates.size() > ATM_RATE_RETAIN){
+        delete atmRetiredRates.front();
+        atmRetiredRates.erase(atmRetiredRates.begin());
+    }
+}
+
+void atmPublishRates(const ATMRateTable *t){
+    lock_guard<mutex> g(atmRateLock);
+    atmSwapRates(t);
 }
+
+// publish a copy of the live table with one rate changed
+void atmUpdateRate(int id, double toINR){
+    lock_guard<mutex> g(atmRateLock);
+    ATMRateTable *t = atmCopyRates();
+    t->toINR[id] = toINR;
+    atmSwapRates(t);
+}
+
+double atmRate(int cur){
+    const ATMRateTable *t = atmRateTable.load(memory_order_acquire);
+    return (t && cur >= 0) ? t->toINR[cur] : 1.0;
+}
+
+double getRate(const string &c){ return atmRate(atmFindCurrency(c)); }
 double toINR(double x,const string &c){ return x * getRate(c); }
 double fromINR(double x,const string &c){ double r = getRate(c); return (r==0? x : x / r); }
 double feeINR(double x){ return x * ATM_INTL_FEE; }
 
+// Batch conversion for settlement: out[i] = inr[i] in currency cur[i].
+// Rates are gathered first so the divide loop is branch-free and vectorises.
+void atmConvertFromINR(const double *inr, const int *cur, double *out, size_t n){
+    const ATMRateTable *t = atmRateTable.load(memory_order_acquire);
+    for(size_t i=0;i<n;i++) out[i] = (t && cur[i] >= 0) ? t->toINR[cur[i]] : 1.0;
+    for(size_t i=0;i<n;i++) out[i] = inr[i] / (out[i] == 0 ? 1.0 : out[i]);
+}
+
 // Safe stoi/stod that return false on invalid input
 bool safe_stoi(const string &s, int &out){
     if(s.empty()) return false;
@@ -4422,7 +5227,8 @@ void loadAccounts(){
     ifstream f("atm_accounts.csv");
     if(!f){ cout<<"Warning: atm_accounts.csv not found -> continuing with empty accounts.\n"; return; }
     string line;
-    accCnt = 0;
+    atmCtx->acc.clear();
+    atmCtx->acc.reserve(min(atmCountLines(f), ATM_MAX_ACCOUNTS));
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -4434,7 +5240,7 @@ void loadAccounts(){
         getline(ss,tmp,','); a.name = trim(tmp);
         getline(ss,tmp,','); if(!safe_stoi(trim(tmp), a.pin)) { continue; }
         getline(ss,tmp,','); a.type = trim(tmp);
-        getline(ss,tmp,','); a.currency = trim(tmp);
+        getline(ss,tmp,','); a.currency = trim(tmp); a.cur = atmInternCurrency(a.currency);
         getline(ss,tmp,','); if(!safe_stod(trim(tmp), a.balance)) { continue; }
         getline(ss,tmp,','); safe_stoi(trim(tmp), a.locked); // optional
         getline(ss,tmp,','); safe_stoi(trim(tmp), a.wrongPin);
@@ -4443,17 +5249,19 @@ void loadAccounts(){
         getline(ss,tmp,','); a.cardCountry = trim(tmp);
 
         if(a.number.empty()) continue;
-        ACC[accCnt++] = a;
-        if(accCnt >= ATM_MAX_ACCOUNTS) break;
+        atmAppendAcc(a);
+        if((int)atmCtx->acc.size() >= ATM_MAX_ACCOUNTS) break;
     }
     f.close();
+    atmRebuildAccIndex();
 }
 
 void loadCash(){
     ifstream f("atm_cash.csv");
     if(!f){ cout<<"Warning: atm_cash.csv not found -> continuing with empty cash.\n"; return; }
     string line;
-    cashCnt = 0;
+    atmCtx->cash.clear();
+    atmCtx->cash.reserve(min(atmCountLines(f), ATM_MAX_CASH));
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -4466,8 +5274,8 @@ void loadCash(){
         if(!getline(ss,tmp,',')) continue; if(!safe_stoi(trim(tmp), c.n100)) c.n100 = 0;
         if(!getline(ss,tmp,',')) continue; if(!safe_stoi(trim(tmp), c.n50)) c.n50 = 0;
         if(c.atmID.empty()) c.atmID = "ATM001";
-        CASH[cashCnt++] = c;
-        if(cashCnt >= ATM_MAX_CASH) break;
+        atmCtx->cash.push_back(c);
+        if((int)atmCtx->cash.size() >= ATM_MAX_CASH) break;
     }
     f.close();
 }
@@ -4476,7 +5284,8 @@ void loadRates(){
     ifstream f("atm_rates.csv");
     if(!f){ cout<<"Warning: atm_rates.csv not found -> continuing with default rates.\n"; return; }
     string line;
-    rateCnt = 0;
+    ATMRateTable *t = new ATMRateTable;
+    for(int i=0;i<ATM_MAX_RATES;i++) t->toINR[i] = 1.0;
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -4485,17 +5294,19 @@ void loadRates(){
         getline(ss,tmp,',');
         if(!safe_stod(trim(tmp), r.toINR)) continue;
         if(r.code.empty()) continue;
-        RATE[rateCnt++] = r;
-        if(rateCnt >= ATM_MAX_RATES) break;
+        int id = atmInternCurrency(r.code);
+        if(id == -1) break;
+        t->toINR[id] = r.toINR;
     }
     f.close();
+    atmPublishRates(t);
 }
 
 void loadTx(){
     ifstream f("atm_transactions.csv");
     if(!f){ cout<<"Warning: atm_transactions.csv not found -> starting with empty transactions.\n"; return; }
     string line;
-    txCnt = 0;
+    TX.clear();
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -4515,73 +5326,508 @@ void loadTx(){
         if(!safe_stod(trim(tmp), t.balAfter)) continue;
         getline(ss,t.remark,','); t.remark = trim(t.remark);
 
-        TX[txCnt++] = t;
-        if(txCnt >= ATM_MAX_TRANSACTIONS) break;
+        TX.push_back(t);
     }
     f.close();
 }
 
+// ---------- durable ledger ----------
+// Append-only file of fixed 128-byte records, each CRC32-checked. Sessions
+// enqueue a record (getting a sequence number) and then wait for it to be
+// durable; whichever waiter finds no flush running writes the whole pending
+// batch and fdatasyncs once, so concurrent sessions share one sync.
+struct ATMLedgerRec {
+    uint32_t crc;      // CRC32 of the bytes after this field
+    uint32_t size;     // sizeof(ATMLedgerRec), guards against format changes
+    uint64_t seq;
+    int64_t timeMs;    // unix epoch milliseconds
+    double amt, balAfter;
+    char acc[24], type[16], atmID[16], remark[32];
+};
+
+struct ATMLedger {
+    int fd = -1;
+    string path;
+    mutex m;
+    condition_variable cv;
+    vector<ATMLedgerRec> pending;      // enqueued, not yet durable (kept across failed flushes)
+    uint64_t nextSeq = 0, durableSeq = 0;
+    long long goodBytes = 0;           // file length up to the last durable record
+    int lastErr = 0;                   // errno of the last failed flush, 0 once one succeeds
+    bool flushing = false, failed = false; // failed = file state unknown, writes stopped
+    long long syncs = 0;
+};
+
+#define ATM_LEDGER_RETRIES 3 // flush attempts per waiter before it reports a delay
+
+// ---------- ledger file I/O (POSIX / Windows) ----------
+// Each call returns 0 or an errno value; interrupted calls and short writes
+// are retried here so callers only see real failures.
+#ifdef _WIN32
+static int atmFileOpen(const string &path, bool append){
+    int flags = _O_BINARY | (append ? (_O_WRONLY | _O_CREAT | _O_APPEND) : _O_RDWR);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+static void atmFileClose(int fd){ _close(fd); }
+static long long atmFileSize(int fd){ return _filelengthi64(fd); }
+static int atmFileWrite(int fd, const char *p, size_t left){
+    while(left > 0){
+        int w = _write(fd, p, (unsigned)min(left, (size_t)1 << 30));
+        if(w < 0) return errno;
+        p += w; left -= (size_t)w;
+    }
+    return 0;
+}
+static int atmFileSync(int fd){ return _commit(fd) == 0 ? 0 : errno; }
+static int atmFileTruncate(int fd, long long size){ return _chsize_s(fd, size); }
+#else
+static int atmFileOpen(const string &path, bool append){
+    int fd;
+    do fd = open(path.c_str(), append ? (O_WRONLY | O_CREAT | O_APPEND) : O_RDWR, 0644);
+    while(fd < 0 && errno == EINTR);
+    return fd;
+}
+static void atmFileClose(int fd){ close(fd); }
+static long long atmFileSize(int fd){
+    struct stat st;
+    return fstat(fd, &st) == 0 ? (long long)st.st_size : -1;
+}
+static int atmFileWrite(int fd, const char *p, size_t left){
+    while(left > 0){
+        ssize_t w = write(fd, p, left);
+        if(w < 0){
+            if(errno == EINTR || errno == EAGAIN) continue;
+            return errno;
+        }
+        p += w; left -= (size_t)w;
+    }
+    return 0;
+}
+static int atmFileSync(int fd){
+    while(fdatasync(fd) != 0)
+        if(errno != EINTR) return errno;
+    return 0;
+}
+static int atmFileTruncate(int fd, long long size){
+    while(ftruncate(fd, (off_t)size) != 0)
+        if(errno != EINTR) return errno;
+    return 0;
+}
+#endif
+
+static ATMLedger atmLedger;                      // the bank's ledger
+static ATMLedger *atmActiveLedger = &atmLedger;  // the stress test swaps in a scratch one
+
+static uint32_t atmCrc32(const void *data, size_t n){
+    static uint32_t table[256];
+    static bool ready = false;
+    if(!ready){
+        for(uint32_t i=0;i<256;i++){
+            uint32_t c = i;
+            for(int k=0;k<8;k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+    const unsigned char *p = (const unsigned char *)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for(size_t i=0;i<n;i++) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+static uint32_t atmRecCrc(const ATMLedgerRec &r){
+    return atmCrc32((const char *)&r + sizeof(r.crc), sizeof(r) - sizeof(r.crc));
+}
+
+static int64_t atmNowMs(){
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static string atmFormatTime(int64_t ms){
+    time_t t = (time_t)(ms / 1000);
+    struct tm tmv;
+#ifdef _WIN32
+    localtime_s(&tmv, &t);
+#else
+    localtime_r(&t, &tmv);
+#endif
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tmv);
+    return string(buf);
+}
+
+static void atmCopyField(char *dst, size_t n, const string &src){
+    memset(dst, 0, n);
+    memcpy(dst, src.data(), min(n - 1, src.size()));
+}
+
+bool atmLedgerOpen(ATMLedger &L, const string &path, uint64_t lastSeq){
+    L.path = path;
+    L.fd = atmFileOpen(path, true);
+    L.nextSeq = L.durableSeq = lastSeq;
+    L.pending.clear();
+    L.goodBytes = L.fd >= 0 ? atmFileSize(L.fd) : 0;
+    L.failed = L.fd < 0 || L.goodBytes < 0;
+    return !L.failed;
+}
+
+bool atmLedgerWait(ATMLedger &L, uint64_t seq);
+
+// flushes anything still pending before closing
+void atmLedgerClose(ATMLedger &L){
+    if(L.fd >= 0 && L.nextSeq > L.durableSeq && !atmLedgerWait(L, L.nextSeq))
+        cout<<"Warning: "<<L.nextSeq - L.durableSeq<<" ledger records could not be written to "<<L.path<<".\n";
+    if(L.fd >= 0) atmFileClose(L.fd);
+    L.fd = -1;
+}
+
+// call with the record's account lock held so file order matches balance order
+uint64_t atmLedgerEnqueue(ATMLedger &L, ATMLedgerRec &r){
+    lock_guard<mutex> g(L.m);
+    r.size = sizeof(ATMLedgerRec);
+    r.seq = ++L.nextSeq;
+    r.crc = atmRecCrc(r);
+    L.pending.push_back(r);
+    return r.seq;
+}
+
+// Block until seq is on disk. A failed write or sync (disk full, I/O error)
+// cuts the file back to its last durable record and puts the batch back at
+// the head of pending, so it is retried by the next flush and never dropped.
+// Returns false if seq is still not durable after ATM_LEDGER_RETRIES
+// attempts, or once the file can no longer be trusted (failed).
+bool atmLedgerWait(ATMLedger &L, uint64_t seq){
+    unique_lock<mutex> lk(L.m);
+    int attempts = 0;
+    while(L.durableSeq < seq){
+        if(L.failed) return false;
+        if(L.flushing){ L.cv.wait(lk); continue; }
+        if(attempts++ == ATM_LEDGER_RETRIES) return false;
+        L.flushing = true;
+        vector<ATMLedgerRec> batch;
+        batch.swap(L.pending);
+        lk.unlock();
+        size_t bytes = batch.size() * sizeof(ATMLedgerRec);
+        int err = atmFileWrite(L.fd, (const char *)batch.data(), bytes);
+        if(err == 0) err = atmFileSync(L.fd);
+        bool lost = err != 0 && atmFileTruncate(L.fd, L.goodBytes) != 0;
+        lk.lock();
+        L.syncs++;
+        if(err == 0){
+            L.goodBytes += (long long)bytes;
+            L.durableSeq = batch.back().seq;
+            if(L.lastErr) cout<<"Ledger: writes to "<<L.path<<" recovered.\n";
+            L.lastErr = 0;
+        } else {
+            batch.insert(batch.end(), L.pending.begin(), L.pending.end());
+            L.pending.swap(batch);
+            if(lost) L.failed = true; // torn tail could not be removed
+            if(lost || err != L.lastErr)
+                cout<<"Ledger: write to "<<L.path<<" failed ("<<strerror(err)<<")"<<(lost ? "; ledger disabled.\n" : "; will retry.\n");
+            L.lastErr = err;
+        }
+        L.flushing = false;
+        L.cv.notify_all();
+    }
+    return true;
+}
+
+// Map the ledger read-only and hand every valid record to fn. A torn or
+// corrupt tail (crash mid-write) ends the replay and is cut off so new
+// records append after the last good one. Returns the last good sequence.
+template <class F>
+uint64_t atmLedgerReplay(const string &path, F fn){
+    int fd = atmFileOpen(path, false);
+    if(fd < 0) return 0;
+    long long size = atmFileSize(fd);
+    uint64_t last = 0;
+    if(size > 0){
+        size_t n = (size_t)size / sizeof(ATMLedgerRec);
+#ifdef _WIN32
+        // no mmap here: read the records into memory instead
+        vector<ATMLedgerRec> buf(n);
+        size_t got = 0, want = n * sizeof(ATMLedgerRec);
+        while(got < want){
+            int r = _read(fd, (char *)buf.data() + got, (unsigned)min(want - got, (size_t)1 << 30));
+            if(r <= 0) break;
+            got += (size_t)r;
+        }
+        n = got / sizeof(ATMLedgerRec);
+        const ATMLedgerRec *rec = buf.data();
+#else
+        void *map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map == MAP_FAILED){ atmFileClose(fd); return 0; }
+        const ATMLedgerRec *rec = (const ATMLedgerRec *)map;
+#endif
+        size_t good = 0;
+        for(; good<n; good++){
+            if(rec[good].size != sizeof(ATMLedgerRec) || rec[good].crc != atmRecCrc(rec[good])) break;
+            fn(rec[good]);
+            last = rec[good].seq;
+        }
+#ifndef _WIN32
+        munmap(map, (size_t)size);
+#endif
+        if((long long)(good * sizeof(ATMLedgerRec)) != size){
+            cout<<"Ledger: dropped corrupt tail after record "<<good<<".\n";
+            if(atmFileTruncate(fd, (long long)(good * sizeof(ATMLedgerRec))) != 0) cout<<"Ledger: truncate failed.\n";
+        }
+    }
+    atmFileClose(fd);
+    return last;
+}
+
+static ATMTransaction atmTxFromRec(const ATMLedgerRec &r){
+    ATMTransaction t;
+    t.acc = r.acc; t.type = r.type; t.amt = r.amt; t.currency = "INR";
+    t.atmID = r.atmID; t.time = atmFormatTime(r.timeMs); t.balAfter = r.balAfter; t.remark = r.remark;
+    return t;
+}
+
+// Replay the ledger over the CSV snapshot: balances take each account's last
+// balAfter, today's withdrawals count against the daily limit again.
+void atmReplayLedger(){
+    string today = atmFormatTime(atmNowMs()).substr(0, 10);
+    long long n = 0;
+    uint64_t last = atmLedgerReplay(ATM_LEDGER_FILE, [&](const ATMLedgerRec &r){
+        ATMTransaction t = atmTxFromRec(r);
+        t.id = (int)TX.size() + 1;
+        TX.push_back(t);
+        n++;
+        int i = findAcc(t.acc);
+        if(i == -1) return;
+        atmCtx->acc[i].balance = r.balAfter;
+        if(t.type == "WITHDRAW" && t.time.compare(0, 10, today) == 0) atmCtx->acc[i].dayWithdraw += r.amt;
+    });
+    atmLedgerClose(atmLedger);
+    if(!atmLedgerOpen(atmLedger, ATM_LEDGER_FILE, last)) cout<<"Warning: cannot open "<<ATM_LEDGER_FILE<<" for append.\n";
+    if(n > 0) cout<<"Replayed "<<n<<" ledger records.\n";
+}
+
 void loadAll(){
     loadAccounts();
     loadCash();
     loadRates();
     loadTx();
+    atmReplayLedger();
     dataLoaded = true;
     cout<<"CSV LOAD COMPLETE. (manual load done)\n";
 }
 
+// Record one transaction in memory and on the active ledger. Call with the
+// account lock held; pass the result to atmLedgerWait once it is released.
+uint64_t atmLogTx(const string &acc,const string &type,double amt,const string &remark,const string &atmID,double balAfter){
+    ATMLedgerRec r;
+    memset(&r, 0, sizeof(r));
+    r.timeMs = atmNowMs();
+    r.amt = amt;
+    r.balAfter = balAfter;
+    atmCopyField(r.acc, sizeof(r.acc), acc);
+    atmCopyField(r.type, sizeof(r.type), type);
+    atmCopyField(r.atmID, sizeof(r.atmID), atmID);
+    atmCopyField(r.remark, sizeof(r.remark), remark);
+    if(atmActiveLedger == &atmLedger){
+        ATMTransaction t = atmTxFromRec(r);
+        lock_guard<mutex> g(atmTxLock);
+        t.id = (int)TX.size() + 1;
+        TX.push_back(t);
+    }
+    return atmLedgerEnqueue(*atmActiveLedger, r);
+}
+
+void atmCommitTx(uint64_t seq){
+    if(!atmLedgerWait(*atmActiveLedger, seq)){
+        if(atmActiveLedger->failed) cout<<"Warning: ledger unavailable; transaction kept in memory only.\n";
+        else cout<<"Warning: ledger write delayed; the transaction stays queued and is retried with the next one.\n";
+    }
+}
+
 void logTx(const string &acc,const string &type,double amt,const string &remark){
-    if(txCnt >= ATM_MAX_TRANSACTIONS) return;
-    ATMTransaction t;
-    t.id = txCnt + 1;
-    t.acc = acc;
-    t.type = type;
-    t.amt = amt;
-    t.currency = "INR";
-    t.atmID = (cashCnt>0 ? CASH[0].atmID : string("ATM001"));
-    t.time = "TODAY";
     int idx = findAcc(acc);
-    t.balAfter = (idx==-1? 0.0 : ACC[idx].balance);
-    t.remark = remark;
-    TX[txCnt++] = t;
+    uint64_t seq;
+    if(idx == -1) seq = atmLogTx(acc, type, amt, remark, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")), 0.0);
+    else {
+        lock_guard<mutex> g(atmCtx->accLock[idx]);
+        seq = atmLogTx(acc, type, amt, remark, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")), atmCtx->acc[idx].balance);
+    }
+    atmCommitTx(seq);
+}
+
+// ---------- exact note dispensing ----------
+static const int atmNoteValue[ATM_DENOMS] = {2000, 500, 200, 100, 50};
+
+static int &atmNotes(ATMCash &c, int d){
+    switch(d){
+        case 0: return c.n2000;
+        case 1: return c.n500;
+        case 2: return c.n200;
+        case 3: return c.n100;
+        default: return c.n50;
+    }
+}
+
+// Bounded-knapsack reachability: each cassette's count is split into
+// 1,2,4,... chunks so the bitset is shifted O(log count) times per note.
+void atmRefreshPayable(ATMCash &c){
+    bitset<ATM_PAY_UNITS + 1> r;
+    r[0] = 1;
+    for(int d=0;d<ATM_DENOMS;d++){
+        int u = atmNoteValue[d] / ATM_NOTE_UNIT;
+        int cnt = min(atmNotes(c,d), ATM_PAY_UNITS / u);
+        for(int k=1; cnt>0; k<<=1){
+            int t = min(k, cnt);
+            r |= r << (t * u);
+            cnt -= t;
+        }
+    }
+    c.payable = r;
+    c.payableReady = true;
+}
+
+bool atmCanDispense(ATMCash &c, int amt){
+    if(amt <= 0 || amt % ATM_NOTE_UNIT != 0 || amt > ATM_MAX_WITHDRAW_PER_TXN) return false;
+    if(!c.payableReady) atmRefreshPayable(c);
+    return c.payable[amt / ATM_NOTE_UNIT];
+}
+
+// Note mix for a payable amount. Taking a note from cassette d costs
+// 1/(notes left in d + 1), so the mix drains the fullest cassettes and
+// spares the nearly empty ones. Min-cost bounded knapsack; the cost is
+// linear in the note count, so each residue class is a sliding-window
+// minimum and the whole plan is O(ATM_DENOMS * units).
+static void atmPlanNotes(ATMCash &c, int units, int take[ATM_DENOMS]){
+    const double INF = 1e18;
+    double dpA[ATM_PAY_UNITS + 1], dpB[ATM_PAY_UNITS + 1];
+    double *dp = dpA, *nd = dpB;
+    int q[ATM_PAY_UNITS + 1];
+    int choice[ATM_DENOMS][ATM_PAY_UNITS + 1];
+    for(int v=0;v<=units;v++) dp[v] = INF;
+    dp[0] = 0;
+    for(int d=0;d<ATM_DENOMS;d++){
+        int u = atmNoteValue[d] / ATM_NOTE_UNIT;
+        int cnt = min(atmNotes(c,d), units / u);
+        double w = 1.0 / (atmNotes(c,d) + 1);
+        for(int r=0;r<u && r<=units;r++){
+            int head = 0, tail = 0;
+            for(int j=0; r + j*u <= units; j++){
+                double key = dp[r + j*u] - j*w;
+                while(tail > head && dp[r + q[tail-1]*u] - q[tail-1]*w >= key) tail--;
+                q[tail++] = j;
+                while(q[head] < j - cnt) head++;
+                int i = q[head];
+                int v = r + j*u;
+                nd[v] = (dp[r + i*u] >= INF) ? INF : dp[r + i*u] + (j - i) * w;
+                choice[d][v] = j - i;
+            }
+        }
+        swap(dp, nd);
+    }
+    for(int d=ATM_DENOMS-1, v=units; d>=0; d--){
+        take[d] = choice[d][v];
+        v -= take[d] * (atmNoteValue[d] / ATM_NOTE_UNIT);
+    }
 }
 
 bool dispense(int amt, ATMCash &c){
-    long long total = (long long)c.n2000*2000 + (long long)c.n500*500 + (long long)c.n200*200 + (long long)c.n100*100 + (long long)c.n50*50;
-    if(total < amt) return false;
-    int r = amt;
-    int a = min(c.n2000, r/2000); r -= a*2000;
-    int b = min(c.n500, r/500); r -= b*500;
-    int d = min(c.n200, r/200); r -= d*200;
-    int e = min(c.n100, r/100); r -= e*100;
-    int f = min(c.n50, r/50); r -= f*50;
-    if(r != 0) return false;
-    c.n2000 -= a; c.n500 -= b; c.n200 -= d; c.n100 -= e; c.n50 -= f;
+    if(amt == 0) return true;
+    if(!atmCanDispense(c, amt)) return false;
+    int take[ATM_DENOMS];
+    atmPlanNotes(c, amt / ATM_NOTE_UNIT, take);
+    for(int d=0;d<ATM_DENOMS;d++) atmNotes(c,d) -= take[d];
+    atmRefreshPayable(c);
     return true;
 }
 
+// Ledger operations shared by the interactive menu and the multi-ATM engine.
+// Each holds only the account's own lock; the ATMCash belongs to the calling ATM.
+enum { ATM_OK, ATM_ERR_LOCKED, ATM_ERR_DAILY, ATM_ERR_FUNDS, ATM_ERR_DISPENSE };
+
+// amount debited from the account for an INR withdrawal of amt
+double atmWithdrawCost(const ATMAccount &a, double amt){
+    if(a.cur == atmCurINR) return amt;
+    double r = atmRate(a.cur);
+    if(r == 0) r = 1.0;
+    return (amt + feeINR(amt)) / r;
+}
+
+int atmWithdrawOn(int i, double amt, ATMCash &c){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        ATMAccount &a = atmCtx->acc[i];
+        if(a.locked) return ATM_ERR_LOCKED;
+        if(a.dayWithdraw + amt > ATM_DAILY_LIMIT) return ATM_ERR_DAILY;
+        double required = atmWithdrawCost(a, amt);
+        if(required > a.balance) return ATM_ERR_FUNDS;
+        if(!dispense((int)amt, c)) return ATM_ERR_DISPENSE;
+        a.balance -= required;
+        a.dayWithdraw += amt;
+        seq = atmLogTx(a.number,"WITHDRAW",amt,"Cash Withdrawal",c.atmID,a.balance);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
+// admin balance edit, logged as an ADJUST of the difference
+int atmAdjustOn(int i, double nb, const string &atmID){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        double old = atmCtx->acc[i].balance;
+        atmCtx->acc[i].balance = nb;
+        seq = atmLogTx(atmCtx->acc[i].number,"ADJUST",nb-old,"Admin balance edit",atmID,nb);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
+// Fields the engine changes, read together under the account's lock for
+// the interactive menus.
+struct ATMAccView { double balance, dayWithdraw; int locked; };
+
+ATMAccView atmViewAcc(int i){
+    lock_guard<mutex> g(atmCtx->accLock[i]);
+    const ATMAccount &a = atmCtx->acc[i];
+    ATMAccView v = { a.balance, a.dayWithdraw, a.locked };
+    return v;
+}
+
+int atmDepositOn(int i, double amt, const string &atmID){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        if(atmCtx->acc[i].locked) return ATM_ERR_LOCKED;
+        atmCtx->acc[i].balance += amt;
+        seq = atmLogTx(atmCtx->acc[i].number,"DEPOSIT",amt,"Cash Deposit",atmID,atmCtx->acc[i].balance);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
 int login(){
     string a; int pin;
     cout<<"Enter Account Number: ";
     if(!(cin>>a)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); return -1; }
     int i = findAcc(a);
     if(i == -1){ cout<<"Not found.\n"; return -1; }
-    if(ACC[i].locked){ cout<<"Locked.\n"; return -1; }
+    if(atmViewAcc(i).locked){ cout<<"Locked.\n"; return -1; }
     cout<<"PIN: ";
     if(!(cin>>pin)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); return -1; }
-    if(pin != ACC[i].pin){
-        ACC[i].wrongPin++;
-        if(ACC[i].wrongPin >= ATM_PIN_ATTEMPT_LIMIT) ACC[i].locked = 1;
-        cout<<"Wrong PIN.\n";
-        return -1;
+    bool ok;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        ATMAccount &a = atmCtx->acc[i];
+        ok = (pin == a.pin);
+        if(ok) a.wrongPin = 0;
+        else if(++a.wrongPin >= ATM_PIN_ATTEMPT_LIMIT) a.locked = 1;
     }
-    ACC[i].wrongPin = 0;
+    if(!ok){ cout<<"Wrong PIN.\n"; return -1; }
     return i;
 }
 
 void checkBal(int i){
-    cout<<"Balance: "<<ACC[i].balance<<" "<<ACC[i].currency<<"\n";
-    logTx(ACC[i].number,"BAL_CHECK",0,"Balance Inquiry");
+    cout<<"Balance: "<<atmViewAcc(i).balance<<" "<<atmCtx->acc[i].currency<<"\n";
+    logTx(atmCtx->acc[i].number,"BAL_CHECK",0,"Balance Inquiry");
 }
 
 void deposit(int i){
@@ -4589,9 +5835,8 @@ void deposit(int i){
     cout<<"Enter deposit amount: ";
     if(!(cin>>amt)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(amt <= 0 || amt > ATM_MAX_DEPOSIT_PER_TXN){ cout<<"Invalid deposit amount.\n"; return; }
-    ACC[i].balance += amt;
-    logTx(ACC[i].number,"DEPOSIT",amt,"Cash Deposit");
-    cout<<"Deposit successful. New balance: "<<ACC[i].balance<<"\n";
+    atmDepositOn(i, amt, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")));
+    cout<<"Deposit successful. New balance: "<<atmViewAcc(i).balance<<"\n";
 }
 
 void withdraw(int i){
@@ -4599,22 +5844,19 @@ void withdraw(int i){
     cout<<"Enter withdrawal amount: ";
     if(!(cin>>amt)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(amt <= 0 || amt > ATM_MAX_WITHDRAW_PER_TXN){ cout<<"Invalid withdrawal amount.\n"; return; }
-    if(ACC[i].dayWithdraw + amt > ATM_DAILY_LIMIT){ cout<<"Daily withdrawal limit exceeded.\n"; return; }
-    double required = amt;
-    if(ACC[i].currency != "INR"){
-        double conv = fromINR(amt, ACC[i].currency);
-        double fee = feeINR(amt);
-        double feeConv = fromINR(fee, ACC[i].currency);
-        required = conv + feeConv;
-        cout<<"International conversion: "<<conv<<" "<<ACC[i].currency<<", fee: "<<feeConv<<" "<<ACC[i].currency<<"\n";
-    }
-    if(required > ACC[i].balance){ cout<<"Insufficient funds after conversion.\n"; return; }
-    if(cashCnt == 0){ cout<<"ATM cash not loaded.\n"; return; }
-    if(!dispense((int)amt, CASH[0])){ cout<<"ATM cannot dispense this amount exactly.\n"; return; }
-    ACC[i].balance -= required;
-    ACC[i].dayWithdraw += amt;
-    logTx(ACC[i].number,"WITHDRAW",amt,"Cash Withdrawal");
-    cout<<"Withdrawal successful. New balance: "<<ACC[i].balance<<"\n";
+    ATMAccView v = atmViewAcc(i);
+    if(v.dayWithdraw + amt > ATM_DAILY_LIMIT){ cout<<"Daily withdrawal limit exceeded.\n"; return; }
+    if(atmCtx->acc[i].currency != "INR"){
+        double conv = fromINR(amt, atmCtx->acc[i].currency);
+        double feeConv = fromINR(feeINR(amt), atmCtx->acc[i].currency);
+        cout<<"International conversion: "<<conv<<" "<<atmCtx->acc[i].currency<<", fee: "<<feeConv<<" "<<atmCtx->acc[i].currency<<"\n";
+    }
+    if(atmWithdrawCost(atmCtx->acc[i], amt) > v.balance){ cout<<"Insufficient funds after conversion.\n"; return; }
+    if(atmCtx->cash.empty()){ cout<<"ATM cash not loaded.\n"; return; }
+    int r = atmWithdrawOn(i, amt, atmCtx->cash[0]);
+    if(r == ATM_ERR_DISPENSE){ cout<<"ATM cannot dispense this amount exactly.\n"; return; }
+    if(r != ATM_OK){ cout<<"Withdrawal refused.\n"; return; }
+    cout<<"Withdrawal successful. New balance: "<<atmViewAcc(i).balance<<"\n";
 }
 
 bool adminLogin(){
@@ -4624,20 +5866,21 @@ bool adminLogin(){
 }
 
 void adminAddAcc(){
-    if(accCnt >= ATM_MAX_ACCOUNTS){ cout<<"Account storage full.\n"; return; }
+    if((int)atmCtx->acc.size() >= ATM_MAX_ACCOUNTS){ cout<<"Account storage full.\n"; return; }
     ATMAccount a;
     cout<<"Enter Account Number: "; cin>>a.number;
     if(findAcc(a.number) != -1){ cout<<"Account already exists.\n"; return; }
     cout<<"Customer Name: "; cin.ignore(); getline(cin, a.name);
     cout<<"PIN (numeric): "; cin>>a.pin;
     cout<<"Account Type (SAVINGS/CURRENT): "; cin>>a.type;
-    cout<<"Currency (INR/USD/EUR): "; cin>>a.currency;
+    cout<<"Currency (INR/USD/EUR): "; cin>>a.currency; a.cur = atmInternCurrency(a.currency);
     cout<<"Initial Balance: "; cin>>a.balance;
     if(a.balance < 0){ cout<<"Balance cannot be negative.\n"; return; }
     cout<<"Withdrawal Limit: "; cin>>a.limit;
     cout<<"Card Country Code: "; cin>>a.cardCountry;
     a.locked = 0; a.wrongPin = 0; a.dayWithdraw = 0;
-    ACC[accCnt++] = a;
+    atmAppendAcc(a);
+    atmIndexAcc(atmCtx->acc.size()-1);
     cout<<"Account created successfully.\n";
 }
 
@@ -4650,13 +5893,13 @@ void adminEditAcc(){
         cout<<"1.Change Name 2.Change PIN 3.Change Type 4.Change Balance 5.Unlock 6.Change Limit 7.Change Currency 0.Done\nChoice: ";
         if(!(cin>>ch)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
         switch(ch){
-            case 1: cin.ignore(); cout<<"New Name: "; getline(cin, ACC[i].name); break;
-            case 2: cout<<"New PIN: "; cin>>ACC[i].pin; break;
-            case 3: cout<<"New Type: "; cin>>ACC[i].type; break;
-            case 4: { double nb; cout<<"New Balance: "; cin>>nb; if(nb < 0) cout<<"Cannot set negative balance.\n"; else ACC[i].balance = nb; break; }
-            case 5: ACC[i].locked = 0; ACC[i].wrongPin = 0; cout<<"Account unlocked.\n"; break;
-            case 6: cout<<"New Withdrawal Limit: "; cin>>ACC[i].limit; break;
-            case 7: cout<<"New Currency: "; cin>>ACC[i].currency; break;
+            case 1: cin.ignore(); cout<<"New Name: "; getline(cin, atmCtx->acc[i].name); break;
+            case 2: cout<<"New PIN: "; cin>>atmCtx->acc[i].pin; break;
+            case 3: cout<<"New Type: "; cin>>atmCtx->acc[i].type; break;
+            case 4: { double nb; cout<<"New Balance: "; cin>>nb; if(nb < 0) cout<<"Cannot set negative balance.\n"; else atmAdjustOn(i, nb, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001"))); break; }
+            case 5: { lock_guard<mutex> g(atmCtx->accLock[i]); atmCtx->acc[i].locked = 0; atmCtx->acc[i].wrongPin = 0; } cout<<"Account unlocked.\n"; break;
+            case 6: cout<<"New Withdrawal Limit: "; cin>>atmCtx->acc[i].limit; break;
+            case 7: cout<<"New Currency: "; cin>>atmCtx->acc[i].currency; atmCtx->acc[i].cur = atmInternCurrency(atmCtx->acc[i].currency); break;
             case 0: break;
             default: cout<<"Invalid option.\n";
         }
@@ -4664,17 +5907,18 @@ void adminEditAcc(){
 }
 
 void adminCash(){
-    if(cashCnt == 0){
-        CASH[0].atmID = "ATM001";
-        CASH[0].location = "MAIN";
-        CASH[0].n2000 = CASH[0].n500 = CASH[0].n200 = CASH[0].n100 = CASH[0].n50 = 0;
-        cashCnt = 1;
+    if(atmCtx->cash.empty()){
+        ATMCash c; // note counts start at 0
+        c.atmID = "ATM001";
+        c.location = "MAIN";
+        atmCtx->cash.push_back(c);
     }
     int a,b,d,e,f;
     cout<<"Enter counts to ADD for 2000 500 200 100 50 (space separated): ";
     if(!(cin>>a>>b>>d>>e>>f)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(a<0||b<0||d<0||e<0||f<0){ cout<<"Cannot add negative notes.\n"; return; }
-    CASH[0].n2000 += a; CASH[0].n500 += b; CASH[0].n200 += d; CASH[0].n100 += e; CASH[0].n50 += f;
+    atmCtx->cash[0].n2000 += a; atmCtx->cash[0].n500 += b; atmCtx->cash[0].n200 += d; atmCtx->cash[0].n100 += e; atmCtx->cash[0].n50 += f;
+    atmCtx->cash[0].payableReady = false;
     cout<<"ATM cash updated.\n";
 }
 
@@ -4683,10 +5927,131 @@ void adminAddRate(){
     cout<<"Enter currency code (e.g. USD): "; cin>>r.code;
     cout<<"Enter rate to INR (e.g. 83): "; cin>>r.toINR;
     if(r.toINR <= 0){ cout<<"Invalid rate.\n"; return; }
-    RATE[rateCnt++] = r;
+    int id = atmInternCurrency(r.code);
+    if(id == -1){ cout<<"Rate table full.\n"; return; }
+    atmUpdateRate(id, r.toINR);
     cout<<"Rate added.\n";
 }
 
+// End-of-day settlement: today's withdrawals, converted in one batch into
+// each account's currency and totalled per currency.
+void atmSettlement(){
+    string today = atmFormatTime(atmNowMs()).substr(0, 10);
+    vector<double> inr;
+    vector<int> cur;
+    {
+        lock_guard<mutex> g(atmTxLock);
+        for(size_t k=0;k<TX.size();k++){
+            if(TX[k].type != "WITHDRAW" || TX[k].time.compare(0, 10, today) != 0) continue;
+            int i = findAcc(TX[k].acc);
+            inr.push_back(TX[k].amt);
+            cur.push_back(i == -1 ? atmCurINR : atmCtx->acc[i].cur);
+        }
+    }
+    vector<double> local(inr.size());
+    atmConvertFromINR(inr.data(), cur.data(), local.data(), inr.size());
+    vector<double> totLocal(atmCurrencyCode.size(), 0.0), totINR(atmCurrencyCode.size(), 0.0);
+    vector<int> cnt(atmCurrencyCode.size(), 0);
+    for(size_t k=0;k<inr.size();k++){
+        int c = cur[k] < 0 ? atmCurINR : cur[k];
+        totLocal[c] += local[k]; totINR[c] += inr[k]; cnt[c]++;
+    }
+    cout<<"Settlement for "<<today<<" ("<<inr.size()<<" withdrawals)\n";
+    for(size_t c=0;c<atmCurrencyCode.size();c++)
+        if(cnt[c] > 0)
+            cout<<atmCurrencyCode[c]<<" | "<<cnt[c]<<" txns | "<<totLocal[c]<<" "<<atmCurrencyCode[c]<<" | "<<totINR[c]<<" INR\n";
+}
+
+// Stress driver: nAtms simulated ATMs, each with its own ATMCash and worker
+// thread, replay random withdrawals/deposits against a hot set of shared
+// accounts. Afterwards every account must equal start + its deposits - its
+// debits, stay non-negative and within the daily limit. Records go to a
+// scratch ledger that is replayed and checked, then deleted; accounts are
+// restored when the run ends.
+void atmStressTest(int nAtms, int opsPerAtm, int hotAccounts){
+    int accCnt = atmCtx->acc.size();
+    if(accCnt == 0 || nAtms <= 0 || opsPerAtm <= 0){ cout<<"Nothing to run (load accounts first).\n"; return; }
+    if(hotAccounts <= 0 || hotAccounts > accCnt) hotAccounts = accCnt;
+    vector<ATMAccount> saved(atmCtx->acc);
+    ATMLedger scratch;
+    string scratchPath = string(ATM_LEDGER_FILE) + ".stress";
+    remove(scratchPath.c_str());
+    if(!atmLedgerOpen(scratch, scratchPath, 0)){ cout<<"Cannot create "<<scratchPath<<"\n"; return; }
+    atmActiveLedger = &scratch;
+
+    vector<ATMCash> atms(nAtms);
+    for(int k=0;k<nAtms;k++){
+        atms[k].atmID = "SIM" + to_string(k+1);
+        atms[k].location = "STRESS";
+        atms[k].n2000 = atms[k].n500 = atms[k].n200 = atms[k].n100 = atms[k].n50 = 1000000;
+    }
+    // per-ATM tallies, merged after the run: net change and INR dispensed
+    vector<vector<double> > delta(nAtms, vector<double>(hotAccounts, 0.0));
+    vector<long long> dispensed(nAtms, 0);
+    atomic<long long> ok(0), refused(0);
+
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> workers;
+    for(int k=0;k<nAtms;k++){
+        workers.push_back(thread([&, k](){
+            unsigned rng = 2463534242u ^ (unsigned)(k * 2654435761u);
+            for(int n=0;n<opsPerAtm;n++){
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                int i = (int)(rng % (unsigned)hotAccounts);
+                double amt = 100.0 * (1 + (int)((rng >> 8) % 50u));
+                int r;
+                if((rng >> 20) % 10u < 7){
+                    double cost = atmWithdrawCost(atmCtx->acc[i], amt);
+                    r = atmWithdrawOn(i, amt, atms[k]);
+                    if(r == ATM_OK){ delta[k][i] -= cost; dispensed[k] += (long long)amt; }
+                } else {
+                    r = atmDepositOn(i, amt, atms[k].atmID);
+                    if(r == ATM_OK) delta[k][i] += amt;
+                }
+                if(r == ATM_OK) ok.fetch_add(1, memory_order_relaxed);
+                else refused.fetch_add(1, memory_order_relaxed);
+            }
+        }));
+    }
+    for(size_t k=0;k<workers.size();k++) workers[k].join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    atmActiveLedger = &atmLedger;
+    atmLedgerClose(scratch);
+
+    // replaying the scratch ledger must reproduce every final balance
+    vector<double> replayed(hotAccounts, 0.0);
+    vector<char> seen(hotAccounts, 0);
+    long long records = 0;
+    atmLedgerReplay(scratchPath, [&](const ATMLedgerRec &r){
+        records++;
+        int i = findAcc(r.acc);
+        if(i >= 0 && i < hotAccounts){ replayed[i] = r.balAfter; seen[i] = 1; }
+    });
+    remove(scratchPath.c_str());
+    int badReplay = 0;
+    for(int i=0;i<hotAccounts;i++)
+        if(seen[i] && fabs(replayed[i] - atmCtx->acc[i].balance) > 1e-6 * (1 + fabs(atmCtx->acc[i].balance))) badReplay++;
+
+    int badBalance = 0, badLimit = 0, badCash = 0;
+    for(int i=0;i<hotAccounts;i++){
+        double expect = saved[i].balance;
+        for(int k=0;k<nAtms;k++) expect += delta[k][i];
+        if(fabs(atmCtx->acc[i].balance - expect) > 1e-6 * (1 + fabs(expect)) || atmCtx->acc[i].balance < -1e-9) badBalance++;
+        if(atmCtx->acc[i].dayWithdraw > ATM_DAILY_LIMIT) badLimit++;
+    }
+    for(int k=0;k<nAtms;k++){
+        long long left = (long long)atms[k].n2000*2000 + (long long)atms[k].n500*500 + (long long)atms[k].n200*200 + (long long)atms[k].n100*100 + (long long)atms[k].n50*50;
+        if(left + dispensed[k] != 1000000LL * 2850) badCash++;
+    }
+    cout<<"ATMs="<<nAtms<<" accounts="<<hotAccounts<<" ok="<<ok.load()<<" refused="<<refused.load()<<"\n";
+    cout<<"Elapsed "<<secs<<"s, "<<(secs > 0 ? (ok.load() + refused.load()) / secs : 0)<<" TPS\n";
+    cout<<"Balance mismatches="<<badBalance<<" daily-limit violations="<<badLimit<<" cash mismatches="<<badCash<<"\n";
+    cout<<"Ledger: "<<records<<" records ("<<(secs > 0 ? records / secs : 0)<<"/s), "<<scratch.syncs<<" syncs, "
+        <<(records != ok.load() ? "RECORD COUNT MISMATCH, " : "")<<"replay mismatches="<<badReplay<<"\n";
+
+    for(int i=0;i<accCnt;i++) atmCtx->acc[i] = saved[i];
+}
+
 void userMenu(int idx){
     while(true){
         int c;
@@ -4703,7 +6068,7 @@ void userMenu(int idx){
 void adminMenu(){
     while(true){
         int c;
-        cout<<"1.Add Account 2.Edit Account 3.Add/Refill Cash 4.Add Rate 5.List Accounts 0.Exit\nChoice: ";
+        cout<<"1.Add Account 2.Edit Account 3.Add/Refill Cash 4.Add Rate 5.List Accounts 6.Stress Test 7.Settlement 8.Reload Rates 0.Exit\nChoice: ";
         if(!(cin>>c)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
         if(c==0){ cout<<"Exiting admin menu.\n"; return; }
         if(c==1) adminAddAcc();
@@ -4711,14 +6076,29 @@ void adminMenu(){
         else if(c==3) adminCash();
         else if(c==4) adminAddRate();
         else if(c==5){
-            for(int i=0;i<accCnt;i++){
-                cout<<ACC[i].number<<" | "<<ACC[i].name<<" | "<<ACC[i].balance<<" "<<ACC[i].currency<<" | "<<(ACC[i].locked?"LOCKED":"OK")<<"\n";
+            for(size_t i=0;i<atmCtx->acc.size();i++){
+                ATMAccView v = atmViewAcc(i);
+                cout<<atmCtx->acc[i].number<<" | "<<atmCtx->acc[i].name<<" | "<<v.balance<<" "<<atmCtx->acc[i].currency<<" | "<<(v.locked?"LOCKED":"OK")<<"\n";
             }
-        } else cout<<"Invalid option.\n";
+        } else if(c==6){
+            int n, ops, hot;
+            cout<<"ATMs, operations per ATM, hot accounts: ";
+            if(!(cin>>n>>ops>>hot)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
+            atmStressTest(n, ops, hot);
+        } else if(c==7) atmSettlement();
+        else if(c==8){ loadRates(); cout<<"Rates reloaded.\n"; }
+        else cout<<"Invalid option.\n";
     }
 }
 
+void atmInitModule(){
+    if(atmCtx) return; // state is kept across visits to the menu
+    atmCtx = new ATMContext();
+    atmCtx->accHash.assign(ATM_ACC_HASH_SIZE, 0);
+}
+
 void atmSystem(){
+    atmInitModule();
     while(true){
         int c;
         cout<<"\nATM SYSTEM - Choose an option\n1.User Login 2.Admin Login 3.Load CSV (Manual) 0.Exit\nChoice: ";
@@ -4734,12 +6114,22 @@ void atmSystem(){
         } else cout<<"Invalid choice.\n";
     }
 }
-// grocery_module.cpp — compact, array-based, load-only, limits preserved, no STL
+// grocery_module.cpp — compact, column-based (SoA) tables that grow with the data
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <cstring>
 #include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <unordered_map>
+#include <cctype>
+#include "../city_date.h"
 using namespace std;
 
 /* EXTERN HELPERS (must exist in mega-project) */
@@ -4748,12 +6138,12 @@ static int grocery_toInt(const string &s);
 static double grocery_toDouble(const string &s);
 
 /* LIMITS */
-#define GROCERY_MAX_ITEMS 2000
-#define GROCERY_MAX_TRANSACTIONS 2000
-#define GROCERY_MAX_STAFF 2000
-#define GROCERY_MAX_ATTENDANCE 2000
 #define GROCERY_MAX_QUEUE 2000
-#define GROCERY_HASH_SIZE 4096
+#define GROCERY_MAX_LANES 64
+#define GROCERY_MAX_CART_LINES 100
+#define GROCERY_LOG_RESERVE_MAX (1 << 20) // log lines reserved ahead of a lane run
+#define GROCERY_HASH_MIN_SIZE 16 // power of two
+#define GROCERY_HASH_MAX_LOAD 70 // percent; table doubles past this
 int grocery_splitCSV(const string &line, string out[], int maxcols)
 {
     int cnt = 0;
@@ -4795,7 +6185,7 @@ struct groceryItem
     int reorder_level;
     string supplier_name;
     int perishable;
-    string expiry_date;
+    CityDate expiry_date;
 };
 
 struct groceryStaff
@@ -4807,143 +6197,755 @@ struct groceryStaff
     int is_active;
 };
 
-struct groceryTransaction
+struct groceryTransaction
+{
+    int txn_id;
+    CityDateTime datetime;
+    int item_id;
+    int qty;
+    double unit_price;
+    double line_total;
+    string cashier_name;
+};
+
+struct groceryAttendance
+{
+    int attendance_id;
+    int staff_id;
+    CityDate date;
+    string clock_in;
+    string clock_out;
+    double hours_worked;
+};
+
+/* TABLES (structure-of-arrays, grow on demand) */
+template <class T>
+static void groceryPermuteColumn(vector<T> &col, const vector<int> &order)
+{
+    vector<T> out;
+    out.reserve(col.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        out.push_back(std::move(col[order[i]]));
+    col.swap(out);
+}
+
+struct groceryItemTable
+{
+    vector<int> item_id;
+    vector<string> name;
+    vector<string> category;
+    vector<double> price;
+    /* stock lives in groceryCheckout.stock, row for row */
+    vector<int> reorder_level;
+    vector<string> supplier_name;
+    vector<int> perishable;
+    vector<CityDate> expiry_date;
+
+    int count() const { return (int)item_id.size(); }
+    void reserve(size_t n)
+    {
+        item_id.reserve(n);
+        name.reserve(n);
+        category.reserve(n);
+        price.reserve(n);
+        reorder_level.reserve(n);
+        supplier_name.reserve(n);
+        perishable.reserve(n);
+        expiry_date.reserve(n);
+    }
+    void push(const groceryItem &it)
+    {
+        item_id.push_back(it.item_id);
+        name.push_back(it.name);
+        category.push_back(it.category);
+        price.push_back(it.price);
+        reorder_level.push_back(it.reorder_level);
+        supplier_name.push_back(it.supplier_name);
+        perishable.push_back(it.perishable);
+        expiry_date.push_back(it.expiry_date);
+    }
+    void erase(int i)
+    {
+        item_id.erase(item_id.begin() + i);
+        name.erase(name.begin() + i);
+        category.erase(category.begin() + i);
+        price.erase(price.begin() + i);
+        reorder_level.erase(reorder_level.begin() + i);
+        supplier_name.erase(supplier_name.begin() + i);
+        perishable.erase(perishable.begin() + i);
+        expiry_date.erase(expiry_date.begin() + i);
+    }
+    /* reorder rows so that new row i is old row order[i] */
+    void permute(const vector<int> &order)
+    {
+        groceryPermuteColumn(item_id, order);
+        groceryPermuteColumn(name, order);
+        groceryPermuteColumn(category, order);
+        groceryPermuteColumn(price, order);
+        groceryPermuteColumn(reorder_level, order);
+        groceryPermuteColumn(supplier_name, order);
+        groceryPermuteColumn(perishable, order);
+        groceryPermuteColumn(expiry_date, order);
+    }
+};
+
+struct groceryStaffTable
+{
+    vector<int> staff_id;
+    vector<string> name;
+    vector<string> role;
+    vector<double> salary;
+    vector<int> is_active;
+
+    int count() const { return (int)staff_id.size(); }
+    void reserve(size_t n)
+    {
+        staff_id.reserve(n);
+        name.reserve(n);
+        role.reserve(n);
+        salary.reserve(n);
+        is_active.reserve(n);
+    }
+    void push(const groceryStaff &s)
+    {
+        staff_id.push_back(s.staff_id);
+        name.push_back(s.name);
+        role.push_back(s.role);
+        salary.push_back(s.salary);
+        is_active.push_back(s.is_active);
+    }
+};
+
+struct groceryTransactionTable
+{
+    vector<int> txn_id;
+    vector<CityDateTime> datetime;
+    vector<int> item_id;
+    vector<int> qty;
+    vector<double> unit_price;
+    vector<double> line_total;
+    vector<string> cashier_name;
+
+    int count() const { return (int)txn_id.size(); }
+    void reserve(size_t n)
+    {
+        txn_id.reserve(n);
+        datetime.reserve(n);
+        item_id.reserve(n);
+        qty.reserve(n);
+        unit_price.reserve(n);
+        line_total.reserve(n);
+        cashier_name.reserve(n);
+    }
+    void push(const groceryTransaction &t)
+    {
+        txn_id.push_back(t.txn_id);
+        datetime.push_back(t.datetime);
+        item_id.push_back(t.item_id);
+        qty.push_back(t.qty);
+        unit_price.push_back(t.unit_price);
+        line_total.push_back(t.line_total);
+        cashier_name.push_back(t.cashier_name);
+    }
+};
+
+struct groceryAttendanceTable
+{
+    vector<int> attendance_id;
+    vector<int> staff_id;
+    vector<CityDate> date;
+    vector<string> clock_in;
+    vector<string> clock_out;
+    vector<double> hours_worked;
+
+    int count() const { return (int)attendance_id.size(); }
+    void reserve(size_t n)
+    {
+        attendance_id.reserve(n);
+        staff_id.reserve(n);
+        date.reserve(n);
+        clock_in.reserve(n);
+        clock_out.reserve(n);
+        hours_worked.reserve(n);
+    }
+    void push(const groceryAttendance &a)
+    {
+        attendance_id.push_back(a.attendance_id);
+        staff_id.push_back(a.staff_id);
+        date.push_back(a.date);
+        clock_in.push_back(a.clock_in);
+        clock_out.push_back(a.clock_out);
+        hours_worked.push_back(a.hours_worked);
+    }
+};
+
+/* GLOBALS */
+groceryItemTable groceryItems;
+groceryStaffTable groceryStaffs;
+groceryTransactionTable groceryTransactions;
+groceryAttendanceTable groceryAttendances;
+
+/* CHECKOUT ENGINE
+   Owns the live stock of every item row as atomic counters, so any number
+   of lanes can commit carts at once. A cart takes all of its lines or none
+   (a failed line puts the earlier ones back). Between open() and close(),
+   committed carts go through a lock-free MPSC queue to one writer thread,
+   which is the only code that appends to groceryTransactions. Item rows are
+   added, removed and reordered only while the engine is closed. */
+struct groceryCartLine
+{
+    int item_idx;
+    int qty;
+};
+
+struct groceryCartRecord
+{
+    int txn_id;
+    CityDateTime datetime;
+    string cashier;
+    vector<groceryCartLine> lines;
+};
+
+/* Vyukov-style MPSC queue: producers swap the head, the single consumer
+   follows next pointers from a dummy tail node. */
+struct groceryTxnQueue
+{
+    struct Node
+    {
+        atomic<Node *> next;
+        groceryCartRecord rec;
+        Node() : next(nullptr) {}
+    };
+    atomic<Node *> head;
+    Node *tail;
+
+    groceryTxnQueue()
+    {
+        Node *stub = new Node();
+        head.store(stub);
+        tail = stub;
+    }
+    ~groceryTxnQueue()
+    {
+        groceryCartRecord tmp;
+        while (pop(tmp))
+        {
+        }
+        delete tail;
+    }
+    void push(groceryCartRecord &&rec)
+    {
+        Node *n = new Node();
+        n->rec = std::move(rec);
+        Node *prev = head.exchange(n, memory_order_acq_rel);
+        prev->next.store(n); // seq_cst: pairs with the writer's sleep check
+    }
+    bool ready() const // consumer thread only
+    {
+        return tail->next.load() != nullptr;
+    }
+    bool pop(groceryCartRecord &out) // consumer thread only
+    {
+        Node *next = tail->next.load(memory_order_acquire);
+        if (!next)
+            return false;
+        out = std::move(next->rec);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+
+/* one stock counter; copyable so the column can grow and be reordered */
+struct groceryStockCell
+{
+    atomic<int> qty;
+    groceryStockCell(int q = 0) : qty(q) {}
+    groceryStockCell(const groceryStockCell &o) : qty(o.qty.load(memory_order_relaxed)) {}
+    groceryStockCell &operator=(const groceryStockCell &o)
+    {
+        qty.store(o.qty.load(memory_order_relaxed), memory_order_relaxed);
+        return *this;
+    }
+};
+
+struct groceryCheckoutEngine
+{
+    vector<groceryStockCell> stock; // by item row, same order as groceryItems
+    vector<long long> sold;         // units written per item row since open()
+    long long linesWritten;
+    groceryTxnQueue queue;
+    thread writer;
+    mutex m;
+    condition_variable wake;
+    atomic<bool> writerWaiting;
+    bool closing;
+
+    groceryCheckoutEngine() : linesWritten(0), writerWaiting(false), closing(false) {}
+
+    /* item rows (engine closed) */
+    void reserve(size_t n) { stock.reserve(n); }
+    void addRow(int qty) { stock.push_back(groceryStockCell(qty)); }
+    void eraseRow(int i) { stock.erase(stock.begin() + i); }
+    void permute(const vector<int> &order) { groceryPermuteColumn(stock, order); }
+
+    int level(int idx) const { return stock[idx].qty.load(memory_order_acquire); }
+    void put(int idx, int qty) { stock[idx].qty.fetch_add(qty, memory_order_acq_rel); }
+
+    /* take qty from one item; never lets the counter go below zero */
+    bool take(int idx, int qty)
+    {
+        atomic<int> &s = stock[idx].qty;
+        int cur = s.load(memory_order_relaxed);
+        while (cur >= qty)
+        {
+            if (s.compare_exchange_weak(cur, cur - qty, memory_order_acq_rel, memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    /* book a sale recorded outside the engine (CSV, manual entry); floors at zero */
+    void deduct(int idx, int qty)
+    {
+        atomic<int> &s = stock[idx].qty;
+        int cur = s.load(memory_order_relaxed);
+        while (!s.compare_exchange_weak(cur, max(cur - qty, 0), memory_order_acq_rel, memory_order_relaxed))
+        {
+        }
+    }
+
+    /* all lines or none */
+    bool commit(const vector<groceryCartLine> &lines)
+    {
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            if (!take(lines[i].item_idx, lines[i].qty))
+            {
+                for (size_t j = 0; j < i; ++j)
+                    put(lines[j].item_idx, lines[j].qty);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* hand a committed cart to the writer; any thread, engine open */
+    void submit(groceryCartRecord &&rec)
+    {
+        queue.push(std::move(rec));
+        if (writerWaiting.load())
+        {
+            lock_guard<mutex> g(m);
+            wake.notify_one();
+        }
+    }
+
+    void open()
+    {
+        sold.assign(stock.size(), 0);
+        linesWritten = 0;
+        closing = false;
+        writer = thread(&groceryCheckoutEngine::writeLoop, this);
+    }
+
+    /* drain the queue and stop the writer; call once no lane will submit again */
+    void close()
+    {
+        {
+            lock_guard<mutex> g(m);
+            closing = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    void writeLoop()
+    {
+        groceryCartRecord rec;
+        while (true)
+        {
+            if (queue.pop(rec))
+            {
+                write(rec);
+                continue;
+            }
+            /* advertise the sleep before the last look at the queue, so a
+               push that misses the flag is seen here instead */
+            unique_lock<mutex> lk(m);
+            writerWaiting.store(true);
+            while (!queue.ready() && !closing)
+                wake.wait(lk);
+            writerWaiting.store(false);
+            if (!queue.ready())
+                return; // closing and drained
+        }
+    }
+
+    void write(const groceryCartRecord &rec)
+    {
+        for (size_t k = 0; k < rec.lines.size(); ++k)
+        {
+            int idx = rec.lines[k].item_idx;
+            groceryTransaction t;
+            t.txn_id = rec.txn_id;
+            t.datetime = rec.datetime;
+            t.item_id = groceryItems.item_id[idx];
+            t.qty = rec.lines[k].qty;
+            t.unit_price = groceryItems.price[idx];
+            t.line_total = t.qty * t.unit_price;
+            t.cashier_name = rec.cashier;
+            groceryTransactions.push(t);
+            sold[idx] += t.qty;
+        }
+        linesWritten += (long long)rec.lines.size();
+    }
+};
+
+groceryCheckoutEngine groceryCheckout;
+
+/* HASH TABLE (open addressing, linear probing, power-of-two, grows past load factor) */
+vector<int> groceryHashKeys; // 0 = empty (assumes no item has id 0)
+vector<int> groceryHashIdx;  // index in groceryItems or -1
+int groceryHashUsed = 0;
+
+static inline int groceryHashFunc(int key, int mask)
+{
+    unsigned int k = (unsigned int)key;
+    k ^= (k >> 16);
+    k *= 0x7feb352dU;
+    k ^= (k >> 15);
+    return (int)(k & (unsigned int)mask);
+}
+
+/* place without growing; table must have a free slot */
+static void groceryHashPlace(int key, int idx)
+{
+    int mask = (int)groceryHashIdx.size() - 1;
+    int pos = groceryHashFunc(key, mask);
+    while (groceryHashIdx[pos] != -1 && groceryHashKeys[pos] != key)
+        pos = (pos + 1) & mask;
+    if (groceryHashIdx[pos] == -1)
+        groceryHashUsed++;
+    groceryHashKeys[pos] = key;
+    groceryHashIdx[pos] = idx;
+}
+
+/* size the table for n keys and re-insert the current ones */
+void groceryHashReserve(int n)
+{
+    size_t cap = GROCERY_HASH_MIN_SIZE;
+    while ((size_t)n * 100 >= cap * GROCERY_HASH_MAX_LOAD)
+        cap <<= 1;
+    if (cap <= groceryHashIdx.size())
+        return;
+    vector<int> oldKeys, oldIdx;
+    oldKeys.swap(groceryHashKeys);
+    oldIdx.swap(groceryHashIdx);
+    groceryHashKeys.assign(cap, 0);
+    groceryHashIdx.assign(cap, -1);
+    groceryHashUsed = 0;
+    for (size_t i = 0; i < oldIdx.size(); ++i)
+        if (oldIdx[i] != -1)
+            groceryHashPlace(oldKeys[i], oldIdx[i]);
+}
+
+void groceryInitHash()
+{
+    groceryHashKeys.assign(GROCERY_HASH_MIN_SIZE, 0);
+    groceryHashIdx.assign(GROCERY_HASH_MIN_SIZE, -1);
+    groceryHashUsed = 0;
+}
+
+void groceryHashInsert(int key, int idx)
+{
+    if (groceryHashIdx.empty())
+        groceryInitHash();
+    groceryHashReserve(groceryHashUsed + 1);
+    groceryHashPlace(key, idx);
+}
+
+int groceryHashFind(int key)
+{
+    if (groceryHashIdx.empty())
+        return -1;
+    int mask = (int)groceryHashIdx.size() - 1;
+    int pos = groceryHashFunc(key, mask);
+    while (groceryHashIdx[pos] != -1)
+    {
+        if (groceryHashKeys[pos] == key)
+            return groceryHashIdx[pos];
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+void groceryRebuildHash()
+{
+    groceryInitHash();
+    groceryHashReserve(groceryItems.count());
+    for (int i = 0; i < groceryItems.count(); ++i)
+        groceryHashPlace(groceryItems.item_id[i], i);
+}
+
+/* QUICK SORT (by stock_qty) - first-element pivot, sorts a row-index array */
+void swapIdx(int &a, int &b)
+{
+    int t = a;
+    a = b;
+    b = t;
+}
+
+int partitionByStock(int A[], const int stock[], int l, int r)
+{
+    int p = stock[A[l]];
+    int i = l, j = r + 1;
+    while (1)
+    {
+        while (++i <= r && stock[A[i]] < p)
+        {
+        }
+        while (--j >= l && stock[A[j]] > p)
+        {
+        }
+        if (i >= j)
+            break;
+        swapIdx(A[i], A[j]);
+    }
+    swapIdx(A[l], A[j]);
+    return j;
+}
+
+void quickSortByStock(int A[], const int stock[], int l, int r)
+{
+    if (l < r)
+    {
+        int s = partitionByStock(A, stock, l, r);
+        quickSortByStock(A, stock, l, s - 1);
+        quickSortByStock(A, stock, s + 1, r);
+    }
+}
+
+void grocerySortItemsByStock()
 {
-    int txn_id;
-    string datetime;
-    int item_id;
-    int qty;
-    double unit_price;
-    double line_total;
-    string cashier_name;
-};
+    int n = groceryItems.count();
+    if (n == 0)
+        return;
+    vector<int> order(n), levels(n);
+    for (int i = 0; i < n; ++i)
+    {
+        order[i] = i;
+        levels[i] = groceryCheckout.level(i);
+    }
+    quickSortByStock(&order[0], &levels[0], 0, n - 1);
+    groceryItems.permute(order);
+    groceryCheckout.permute(order);
+    groceryRebuildHash();
+}
 
-struct groceryAttendance
+/* NAME INDEX
+   Case-folded keys (the full name plus every later word of it) kept in a
+   sorted vector for exact and prefix lookups, and a SymSpell-style deletion
+   dictionary (each key with one character removed) for edit-distance-1
+   matches. Entries hold item ids, so row moves (remove, sort) never stale it. */
+struct groceryNameKey
 {
-    int attendance_id;
-    int staff_id;
-    string date;
-    string clock_in;
-    string clock_out;
-    double hours_worked;
+    string key;
+    int item_id;
+    bool operator<(const groceryNameKey &o) const
+    {
+        return key < o.key || (key == o.key && item_id < o.item_id);
+    }
 };
 
-/* GLOBALS */
-groceryItem groceryItems[GROCERY_MAX_ITEMS];
-int groceryItemCount = 0;
-
-groceryStaff groceryStaffs[GROCERY_MAX_STAFF];
-int groceryStaffCount = 0;
+vector<groceryNameKey> groceryNameKeys;
+unordered_map<string, vector<int>> groceryNameDeletes;
 
-groceryTransaction groceryTransactions[GROCERY_MAX_TRANSACTIONS];
-int groceryTransactionCount = 0;
+static string groceryFold(const string &s)
+{
+    string out = s;
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = (char)tolower((unsigned char)out[i]);
+    return out;
+}
 
-groceryAttendance groceryAttendances[GROCERY_MAX_ATTENDANCE];
-int groceryAttendanceCount = 0;
+/* full folded name, then each word after the first */
+static vector<string> groceryNameKeysOf(const string &name)
+{
+    vector<string> keys;
+    string f = groceryFold(name);
+    if (f.empty())
+        return keys;
+    keys.push_back(f);
+    for (size_t i = 1; i < f.size(); ++i)
+        if (f[i - 1] == ' ' && f[i] != ' ')
+            keys.push_back(f.substr(i));
+    return keys;
+}
 
-/* HASH TABLE (open addressing, linear probing) */
-int groceryHashKeys[GROCERY_HASH_SIZE]; // 0 = empty (assumes no item has id 0)
-int groceryHashIdx[GROCERY_HASH_SIZE];  // index in groceryItems or -1
+static void groceryNameDeletesAdd(const string &key, int id)
+{
+    for (size_t i = 0; i < key.size(); ++i)
+        groceryNameDeletes[key.substr(0, i) + key.substr(i + 1)].push_back(id);
+}
 
-void groceryInitHash()
+static void groceryNameDeletesRemove(const string &key, int id)
 {
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
+    for (size_t i = 0; i < key.size(); ++i)
     {
-        groceryHashKeys[i] = 0;
-        groceryHashIdx[i] = -1;
+        unordered_map<string, vector<int>>::iterator e = groceryNameDeletes.find(key.substr(0, i) + key.substr(i + 1));
+        if (e == groceryNameDeletes.end())
+            continue;
+        vector<int> &ids = e->second;
+        for (size_t j = 0; j < ids.size(); ++j)
+            if (ids[j] == id)
+            {
+                ids[j] = ids.back();
+                ids.pop_back();
+                break;
+            }
+        if (ids.empty())
+            groceryNameDeletes.erase(e);
     }
 }
 
-static inline int groceryHashFunc(int key)
+void groceryNameIndexBuild()
 {
-    unsigned int k = (unsigned int)key;
-    k ^= (k >> 16);
-    k *= 0x7feb352dU;
-    k ^= (k >> 15);
-    return (int)(k & (GROCERY_HASH_SIZE - 1));
+    groceryNameKeys.clear();
+    groceryNameDeletes.clear();
+    groceryNameKeys.reserve(groceryItems.count() * 2);
+    for (int i = 0; i < groceryItems.count(); ++i)
+    {
+        vector<string> keys = groceryNameKeysOf(groceryItems.name[i]);
+        for (size_t k = 0; k < keys.size(); ++k)
+        {
+            groceryNameKey nk = {keys[k], groceryItems.item_id[i]};
+            groceryNameKeys.push_back(nk);
+            groceryNameDeletesAdd(keys[k], nk.item_id);
+        }
+    }
+    sort(groceryNameKeys.begin(), groceryNameKeys.end());
 }
 
-void groceryHashInsert(int key, int idx)
+void groceryNameIndexAdd(int item_id, const string &name)
 {
-    int h = groceryHashFunc(key);
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
+    vector<string> keys = groceryNameKeysOf(name);
+    for (size_t k = 0; k < keys.size(); ++k)
     {
-        int pos = (h + i) & (GROCERY_HASH_SIZE - 1);
-        if (groceryHashIdx[pos] == -1 || groceryHashKeys[pos] == key)
-        {
-            groceryHashKeys[pos] = key;
-            groceryHashIdx[pos] = idx;
-            return;
-        }
+        groceryNameKey nk = {keys[k], item_id};
+        groceryNameKeys.insert(lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), nk), nk);
+        groceryNameDeletesAdd(keys[k], item_id);
     }
 }
 
-int groceryHashFind(int key)
+void groceryNameIndexRemove(int item_id, const string &name)
 {
-    int h = groceryHashFunc(key);
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
+    vector<string> keys = groceryNameKeysOf(name);
+    for (size_t k = 0; k < keys.size(); ++k)
     {
-        int pos = (h + i) & (GROCERY_HASH_SIZE - 1);
-        if (groceryHashIdx[pos] == -1)
-            return -1;
-        if (groceryHashKeys[pos] == key)
-            return groceryHashIdx[pos];
+        groceryNameKey nk = {keys[k], item_id};
+        vector<groceryNameKey>::iterator p = lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), nk);
+        if (p != groceryNameKeys.end() && p->key == nk.key && p->item_id == item_id)
+            groceryNameKeys.erase(p);
+        groceryNameDeletesRemove(keys[k], item_id);
     }
-    return -1;
 }
 
-/* QUICK SORT (by stock_qty) - first-element pivot */
-void swapItem(groceryItem &a, groceryItem &b)
+/* [lo,hi) range of groceryNameKeys whose key starts with the folded prefix */
+static void groceryNamePrefixRange(const string &folded, int &lo, int &hi)
 {
-    groceryItem t = a;
-    a = b;
-    b = t;
+    groceryNameKey from = {folded, -2147483647 - 1};
+    vector<groceryNameKey>::iterator a = lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), from);
+    vector<groceryNameKey>::iterator b = a;
+    while (b != groceryNameKeys.end() && b->key.compare(0, folded.size(), folded) == 0)
+        b++;
+    lo = (int)(a - groceryNameKeys.begin());
+    hi = (int)(b - groceryNameKeys.begin());
 }
 
-int partitionByStock(groceryItem A[], int l, int r)
+/* Levenshtein distance <= 1 */
+static bool groceryWithinOneEdit(const string &a, const string &b)
 {
-    int p = A[l].stock_qty;
-    int i = l, j = r + 1;
-    while (1)
+    size_t n = a.size(), m = b.size();
+    if (n > m + 1 || m > n + 1)
+        return false;
+    size_t i = 0;
+    while (i < n && i < m && a[i] == b[i])
+        i++;
+    if (n == m)
+        return a.compare(i + (i < n), string::npos, b, i + (i < m), string::npos) == 0;
+    if (n > m)
+        return a.compare(i + 1, string::npos, b, i, string::npos) == 0;
+    return a.compare(i, string::npos, b, i + 1, string::npos) == 0;
+}
+
+static void groceryNameCollect(const string &key, const string &q, vector<int> &ids)
+{
+    int lo, hi;
+    groceryNamePrefixRange(key, lo, hi);
+    for (int i = lo; i < hi && groceryNameKeys[i].key == key; ++i)
+        if (groceryWithinOneEdit(groceryNameKeys[i].key, q))
+            ids.push_back(groceryNameKeys[i].item_id);
+    unordered_map<string, vector<int>>::const_iterator e = groceryNameDeletes.find(key);
+    if (e == groceryNameDeletes.end())
+        return;
+    for (size_t j = 0; j < e->second.size(); ++j)
     {
-        while (++i <= r && A[i].stock_qty < p)
-        {
-        }
-        while (--j >= l && A[j].stock_qty > p)
-        {
-        }
-        if (i >= j)
-            break;
-        swapItem(A[i], A[j]);
+        int idx = groceryHashFind(e->second[j]);
+        if (idx == -1)
+            continue;
+        vector<string> keys = groceryNameKeysOf(groceryItems.name[idx]);
+        for (size_t k = 0; k < keys.size(); ++k)
+            if (groceryWithinOneEdit(keys[k], q))
+            {
+                ids.push_back(e->second[j]);
+                break;
+            }
     }
-    swapItem(A[l], A[j]);
-    return j;
 }
 
-void quickSortByStock(groceryItem A[], int l, int r)
+/* item ids whose name (or a word of it) is within one edit of the query */
+void groceryNameFuzzy(const string &query, vector<int> &ids)
 {
-    if (l < r)
-    {
-        int s = partitionByStock(A, l, r);
-        quickSortByStock(A, l, s - 1);
-        quickSortByStock(A, s + 1, r);
-    }
+    ids.clear();
+    string q = groceryFold(query);
+    if (q.empty())
+        return;
+    groceryNameCollect(q, q, ids);
+    for (size_t i = 0; i < q.size(); ++i)
+        groceryNameCollect(q.substr(0, i) + q.substr(i + 1), q, ids);
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
 }
 
-/* NAME SEARCH: use simple substring (string::find) to keep code small and reliable */
+/* NAME SEARCH: exact, then prefix, then one-typo match; returns row index */
 int groceryFindItemByName(const string &pattern)
 {
-    if (pattern.empty())
+    string q = groceryFold(pattern);
+    if (q.empty())
         return -1;
-    for (int i = 0; i < groceryItemCount; ++i)
-    {
-        if (groceryItems[i].name.find(pattern) != string::npos)
-            return i;
-    }
-    return -1;
+    int lo, hi;
+    groceryNamePrefixRange(q, lo, hi);
+    if (lo < hi)
+        return groceryHashFind(groceryNameKeys[lo].item_id); // exact key sorts first in its prefix range
+    vector<int> ids;
+    groceryNameFuzzy(q, ids);
+    return ids.empty() ? -1 : groceryHashFind(ids[0]);
 }
 
 /* CSV LOADERS (LOAD ONLY) */
+/* count data rows (header excluded) and rewind, so each loader can reserve once */
+static int groceryCountRows(ifstream &in)
+{
+    int rows = 0;
+    string line;
+    while (getline(in, line))
+        rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 /* Items CSV columns:
    item_id,name,category,price,stock_qty,reorder_level,supplier_name,perishable,expiry_date
 */
@@ -4955,6 +6957,10 @@ void groceryLoadItemsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    int rows = groceryCountRows(in);
+    groceryItems.reserve(groceryItems.count() + rows);
+    groceryCheckout.reserve(groceryItems.count() + rows);
+    groceryHashReserve(groceryItems.count() + rows);
     string line;
     getline(in, line); // skip header if present
     int loaded = 0;
@@ -4966,12 +6972,7 @@ void groceryLoadItemsCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 9);
         if (n < 2)
             continue;
-        if (groceryItemCount >= GROCERY_MAX_ITEMS)
-        {
-            cout << "Items capacity reached\n";
-            break;
-        }
-        groceryItem &it = groceryItems[groceryItemCount];
+        groceryItem it;
         it.item_id = grocery_toInt(cols[0]);
         it.name = cols[1];
         it.category = (n > 2) ? cols[2] : "";
@@ -4980,13 +6981,17 @@ void groceryLoadItemsCSV(const string &fn)
         it.reorder_level = (n > 5) ? grocery_toInt(cols[5]) : 0;
         it.supplier_name = (n > 6) ? cols[6] : "";
         it.perishable = (n > 7) ? grocery_toInt(cols[7]) : 0;
-        it.expiry_date = (n > 8) ? cols[8] : "";
+        it.expiry_date = (n > 8) ? cityDate(cols[8]) : CITY_NO_DATE;
         if (it.item_id == 0 || it.name.empty())
             continue; // skip invalid
-        groceryHashInsert(it.item_id, groceryItemCount);
-        groceryItemCount++;
+        if (groceryHashFind(it.item_id) != -1)
+            continue; // id already loaded
+        groceryHashInsert(it.item_id, groceryItems.count());
+        groceryItems.push(it);
+        groceryCheckout.addRow(it.stock_qty);
         loaded++;
     }
+    groceryNameIndexBuild();
     cout << "Loaded " << loaded << " items from " << fn << "\n";
     in.close();
 }
@@ -5000,6 +7005,7 @@ void groceryLoadStaffCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryStaffs.reserve(groceryStaffs.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -5011,20 +7017,15 @@ void groceryLoadStaffCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 3);
         if (n < 1)
             continue;
-        if (groceryStaffCount >= GROCERY_MAX_STAFF)
-        {
-            cout << "Staff capacity reached\n";
-            break;
-        }
-        groceryStaff &s = groceryStaffs[groceryStaffCount];
-        s.staff_id = groceryStaffCount + 1;
+        groceryStaff s;
+        s.staff_id = groceryStaffs.count() + 1;
         s.name = cols[0];
         s.role = (n > 1) ? cols[1] : "";
         s.salary = (n > 2) ? grocery_toDouble(cols[2]) : 0.0;
         s.is_active = 1;
         if (s.name.empty())
             continue;
-        groceryStaffCount++;
+        groceryStaffs.push(s);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -5042,6 +7043,7 @@ void groceryLoadTransactionsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryTransactions.reserve(groceryTransactions.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -5053,14 +7055,9 @@ void groceryLoadTransactionsCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 7);
         if (n < 2)
             continue;
-        if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-        {
-            cout << "Transactions capacity reached\n";
-            break;
-        }
-        groceryTransaction &t = groceryTransactions[groceryTransactionCount];
+        groceryTransaction t;
         t.txn_id = grocery_toInt(cols[0]);
-        t.datetime = (n > 1) ? cols[1] : "";
+        t.datetime = (n > 1) ? cityDateTime(cols[1]) : CITY_NO_DATE;
         t.item_id = (n > 2) ? grocery_toInt(cols[2]) : 0;
         t.qty = (n > 3) ? grocery_toInt(cols[3]) : 0;
         t.unit_price = (n > 4) ? grocery_toDouble(cols[4]) : 0.0;
@@ -5068,16 +7065,12 @@ void groceryLoadTransactionsCSV(const string &fn)
         t.cashier_name = (n > 6) ? cols[6] : "";
         if (t.txn_id == 0)
             continue;
-        groceryTransactionCount++;
+        groceryTransactions.push(t);
         loaded++;
         // deduct stock if item exists
         int idx = groceryHashFind(t.item_id);
         if (idx != -1)
-        {
-            groceryItems[idx].stock_qty -= t.qty;
-            if (groceryItems[idx].stock_qty < 0)
-                groceryItems[idx].stock_qty = 0;
-        }
+            groceryCheckout.deduct(idx, t.qty);
     }
     cout << "Loaded " << loaded << " transactions from " << fn << "\n";
     in.close();
@@ -5094,6 +7087,7 @@ void groceryLoadAttendanceCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryAttendances.reserve(groceryAttendances.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -5105,21 +7099,16 @@ void groceryLoadAttendanceCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 6);
         if (n < 2)
             continue;
-        if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-        {
-            cout << "Attendance capacity reached\n";
-            break;
-        }
-        groceryAttendance &a = groceryAttendances[groceryAttendanceCount];
+        groceryAttendance a;
         a.attendance_id = grocery_toInt(cols[0]);
         a.staff_id = (n > 1) ? grocery_toInt(cols[1]) : 0;
-        a.date = (n > 2) ? cols[2] : "";
+        a.date = (n > 2) ? cityDate(cols[2]) : CITY_NO_DATE;
         a.clock_in = (n > 3) ? cols[3] : "";
         a.clock_out = (n > 4) ? cols[4] : "";
         a.hours_worked = (n > 5) ? grocery_toDouble(cols[5]) : 0.0;
         if (a.attendance_id == 0)
             continue;
-        groceryAttendanceCount++;
+        groceryAttendances.push(a);
         loaded++;
     }
     cout << "Loaded " << loaded << " attendance rows from " << fn << "\n";
@@ -5129,12 +7118,7 @@ void groceryLoadAttendanceCSV(const string &fn)
 /* MANUAL OPERATIONS */
 void groceryAddItemManual()
 {
-    if (groceryItemCount >= GROCERY_MAX_ITEMS)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryItem &it = groceryItems[groceryItemCount];
+    groceryItem it;
     cout << "Enter item_id: ";
     cin >> it.item_id;
     cin.ignore();
@@ -5157,14 +7141,23 @@ void groceryAddItemManual()
     cin >> it.perishable;
     cin.ignore();
     cout << "Expiry date (YYYY-MM-DD or empty): ";
-    getline(cin, it.expiry_date);
+    string expiry;
+    getline(cin, expiry);
+    it.expiry_date = cityDate(expiry);
     if (it.item_id == 0 || it.name.empty())
     {
         cout << "Invalid item, not added.\n";
         return;
     }
-    groceryHashInsert(it.item_id, groceryItemCount);
-    groceryItemCount++;
+    if (groceryHashFind(it.item_id) != -1)
+    {
+        cout << "Item id " << it.item_id << " already exists, not added.\n";
+        return;
+    }
+    groceryHashInsert(it.item_id, groceryItems.count());
+    groceryItems.push(it);
+    groceryCheckout.addRow(it.stock_qty);
+    groceryNameIndexAdd(it.item_id, it.name);
     cout << "Item added.\n";
 }
 
@@ -5184,8 +7177,8 @@ void groceryRestockItem()
     cin >> add;
     cin.ignore();
     if (add > 0)
-        groceryItems[idx].stock_qty += add;
-    cout << "New stock: " << groceryItems[idx].stock_qty << "\n";
+        groceryCheckout.put(idx, add);
+    cout << "New stock: " << groceryCheckout.level(idx) << "\n";
 }
 
 void groceryRemoveItem()
@@ -5200,57 +7193,61 @@ void groceryRemoveItem()
         cout << "Not found.\n";
         return;
     }
-    for (int i = idx + 1; i < groceryItemCount; ++i)
-        groceryItems[i - 1] = groceryItems[i];
-    groceryItemCount--;
-    groceryInitHash();
-    for (int i = 0; i < groceryItemCount; ++i)
-        groceryHashInsert(groceryItems[i].item_id, i);
+    groceryNameIndexRemove(id, groceryItems.name[idx]);
+    groceryItems.erase(idx);
+    groceryCheckout.eraseRow(idx);
+    groceryRebuildHash();
     cout << "Removed.\n";
 }
 
 void groceryListItems()
 {
-    cout << "Items (" << groceryItemCount << "):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-    {
-        groceryItem &it = groceryItems[i];
-        cout << it.item_id << "," << it.name << "," << it.category << "," << it.price << "," << it.stock_qty << "\n";
-    }
+    const groceryItemTable &it = groceryItems;
+    cout << "Items (" << it.count() << "):\n";
+    for (int i = 0; i < it.count(); ++i)
+        cout << it.item_id[i] << "," << it.name[i] << "," << it.category[i] << "," << it.price[i] << "," << groceryCheckout.level(i) << "\n";
 }
 
 void grocerySearchItemInteractive()
 {
-    cout << "Enter substring: ";
+    cout << "Enter name or prefix: ";
     string pat;
     getline(cin, pat);
+    int lo, hi;
+    groceryNamePrefixRange(groceryFold(pat), lo, hi);
+    vector<int> ids;
+    for (int i = lo; i < hi; ++i)
+        ids.push_back(groceryNameKeys[i].item_id);
+    if (ids.empty())
+        groceryNameFuzzy(pat, ids);
+    else
+    {
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    }
     cout << "Matches:\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-        if (groceryItems[i].name.find(pat) != string::npos)
-            cout << groceryItems[i].item_id << "," << groceryItems[i].name << "," << groceryItems[i].stock_qty << "," << groceryItems[i].price << "\n";
+    for (size_t k = 0; k < ids.size(); ++k)
+    {
+        int i = groceryHashFind(ids[k]);
+        if (i != -1)
+            cout << groceryItems.item_id[i] << "," << groceryItems.name[i] << "," << groceryCheckout.level(i) << "," << groceryItems.price[i] << "\n";
+    }
 }
 
 void groceryLowStockReport()
 {
     cout << "Low stock (<= reorder):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-    {
-        groceryItem &it = groceryItems[i];
-        if (it.stock_qty <= it.reorder_level)
-            cout << it.item_id << "," << it.name << "," << it.stock_qty << "," << it.reorder_level << "\n";
-    }
+    const groceryItemTable &it = groceryItems;
+    for (int i = 0; i < it.count(); ++i)
+        if (groceryCheckout.level(i) <= it.reorder_level[i])
+            cout << it.item_id[i] << "," << it.name[i] << "," << groceryCheckout.level(i) << "," << it.reorder_level[i] << "\n";
 }
 
 /* STAFF */
 void groceryAddStaffManual()
 {
-    if (groceryStaffCount >= GROCERY_MAX_STAFF)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryStaff &s = groceryStaffs[groceryStaffCount];
-    s.staff_id = groceryStaffCount + 1;
+    groceryStaff s;
+    s.staff_id = groceryStaffs.count() + 1;
     cout << "Enter name: ";
     getline(cin, s.name);
     cout << "Enter role: ";
@@ -5264,7 +7261,7 @@ void groceryAddStaffManual()
         cout << "Invalid.\n";
         return;
     }
-    groceryStaffCount++;
+    groceryStaffs.push(s);
     cout << "Staff added id=" << s.staff_id << "\n";
 }
 
@@ -5274,10 +7271,10 @@ void groceryFireStaff()
     int id;
     cin >> id;
     cin.ignore();
-    for (int i = 0; i < groceryStaffCount; ++i)
-        if (groceryStaffs[i].staff_id == id)
+    for (int i = 0; i < groceryStaffs.count(); ++i)
+        if (groceryStaffs.staff_id[i] == id)
         {
-            groceryStaffs[i].is_active = 0;
+            groceryStaffs.is_active[i] = 0;
             cout << "Marked inactive\n";
             return;
         }
@@ -5286,38 +7283,33 @@ void groceryFireStaff()
 
 void groceryListStaff()
 {
-    cout << "Staff (" << groceryStaffCount << "):\n";
-    for (int i = 0; i < groceryStaffCount; ++i)
-    {
-        groceryStaff &s = groceryStaffs[i];
-        cout << s.staff_id << "," << s.name << "," << s.role << "," << s.salary << "," << s.is_active << "\n";
-    }
+    const groceryStaffTable &s = groceryStaffs;
+    cout << "Staff (" << s.count() << "):\n";
+    for (int i = 0; i < s.count(); ++i)
+        cout << s.staff_id[i] << "," << s.name[i] << "," << s.role[i] << "," << s.salary[i] << "," << s.is_active[i] << "\n";
 }
 
 void grocerySalaryReport()
 {
     double tot = 0.0;
-    for (int i = 0; i < groceryStaffCount; ++i)
-        tot += groceryStaffs[i].salary;
+    for (int i = 0; i < groceryStaffs.count(); ++i)
+        tot += groceryStaffs.salary[i];
     cout << "Total payroll = " << tot << "\n";
 }
 
 /* ATTENDANCE */
 void groceryAddAttendanceManual()
 {
-    if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryAttendance &a = groceryAttendances[groceryAttendanceCount];
+    groceryAttendance a;
     cout << "Enter attendance_id: ";
     cin >> a.attendance_id;
     cout << "Enter staff_id: ";
     cin >> a.staff_id;
     cin.ignore();
     cout << "Date (YYYY-MM-DD): ";
-    getline(cin, a.date);
+    string date;
+    getline(cin, date);
+    a.date = cityDate(date);
     cout << "Clock in (HH:MM): ";
     getline(cin, a.clock_in);
     cout << "Clock out (HH:MM or empty): ";
@@ -5332,28 +7324,26 @@ void groceryAddAttendanceManual()
         double hrs = (h2 + m2 / 60.0) - (h1 + m1 / 60.0);
         a.hours_worked = hrs < 0 ? 0.0 : hrs;
     }
-    groceryAttendanceCount++;
+    groceryAttendances.push(a);
     cout << "Attendance added.\n";
 }
 
 void groceryClockIn()
 {
-    if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryAttendance &a = groceryAttendances[groceryAttendanceCount++];
-    a.attendance_id = groceryAttendanceCount;
+    groceryAttendance a;
+    a.attendance_id = groceryAttendances.count() + 1;
     cout << "Staff_id: ";
     cin >> a.staff_id;
     cin.ignore();
     cout << "Date: ";
-    getline(cin, a.date);
+    string date;
+    getline(cin, date);
+    a.date = cityDate(date);
     cout << "Clock in: ";
     getline(cin, a.clock_in);
     a.clock_out = "";
     a.hours_worked = 0.0;
+    groceryAttendances.push(a);
     cout << "Clock-in recorded.\n";
 }
 
@@ -5364,23 +7354,24 @@ void groceryClockOut()
     cin >> sid;
     cin.ignore();
     cout << "Date: ";
-    string date;
-    getline(cin, date);
+    string dateText;
+    getline(cin, dateText);
+    CityDate date = cityDate(dateText);
     cout << "Clock out (HH:MM): ";
     string co;
     getline(cin, co);
-    for (int i = groceryAttendanceCount - 1; i >= 0; --i)
+    groceryAttendanceTable &a = groceryAttendances;
+    for (int i = a.count() - 1; i >= 0; --i)
     {
-        groceryAttendance &a = groceryAttendances[i];
-        if (a.staff_id == sid && a.date == date && a.clock_out.empty())
+        if (a.staff_id[i] == sid && a.date[i] == date && a.clock_out[i].empty())
         {
-            a.clock_out = co;
+            a.clock_out[i] = co;
             int h1 = 0, m1 = 0, h2 = 0, m2 = 0;
-            sscanf(a.clock_in.c_str(), "%d:%d", &h1, &m1);
+            sscanf(a.clock_in[i].c_str(), "%d:%d", &h1, &m1);
             sscanf(co.c_str(), "%d:%d", &h2, &m2);
             double hrs = (h2 + m2 / 60.0) - (h1 + m1 / 60.0);
-            a.hours_worked = hrs < 0 ? 0.0 : hrs;
-            cout << "Clock-out recorded. Hours = " << a.hours_worked << "\n";
+            a.hours_worked[i] = hrs < 0 ? 0.0 : hrs;
+            cout << "Clock-out recorded. Hours = " << a.hours_worked[i] << "\n";
             return;
         }
     }
@@ -5389,28 +7380,23 @@ void groceryClockOut()
 
 void groceryViewAttendance()
 {
-    cout << "Attendance (" << groceryAttendanceCount << "):\n";
-    for (int i = 0; i < groceryAttendanceCount; ++i)
-    {
-        groceryAttendance &a = groceryAttendances[i];
-        cout << a.attendance_id << "," << a.staff_id << "," << a.date << "," << a.clock_in << "," << a.clock_out << "," << a.hours_worked << "\n";
-    }
+    const groceryAttendanceTable &a = groceryAttendances;
+    cout << "Attendance (" << a.count() << "):\n";
+    for (int i = 0; i < a.count(); ++i)
+        cout << a.attendance_id[i] << "," << a.staff_id[i] << "," << cityFormatDate(a.date[i]) << "," << a.clock_in[i] << "," << a.clock_out[i] << "," << a.hours_worked[i] << "\n";
 }
 
 /* TRANSACTIONS / POS (cart-mode) */
 void groceryAddTransactionManual()
 {
-    if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryTransaction &t = groceryTransactions[groceryTransactionCount];
+    groceryTransaction t;
     cout << "txn_id: ";
     cin >> t.txn_id;
     cin.ignore();
-    cout << "datetime: ";
-    getline(cin, t.datetime);
+    cout << "datetime (YYYY-MM-DD HH:MM): ";
+    string datetime;
+    getline(cin, datetime);
+    t.datetime = cityDateTime(datetime);
     cout << "item_id: ";
     cin >> t.item_id;
     cin.ignore();
@@ -5423,14 +7409,10 @@ void groceryAddTransactionManual()
     t.line_total = t.qty * t.unit_price;
     cout << "cashier_name: ";
     getline(cin, t.cashier_name);
-    groceryTransactionCount++;
+    groceryTransactions.push(t);
     int idx = groceryHashFind(t.item_id);
     if (idx != -1)
-    {
-        groceryItems[idx].stock_qty -= t.qty;
-        if (groceryItems[idx].stock_qty < 0)
-            groceryItems[idx].stock_qty = 0;
-    }
+        groceryCheckout.deduct(idx, t.qty);
     cout << "Transaction added.\n";
 }
 
@@ -5440,9 +7422,10 @@ void groceryStartSale()
     int txn_base;
     cin >> txn_base;
     cin.ignore();
-    cout << "datetime: ";
-    string datetime;
-    getline(cin, datetime);
+    cout << "datetime (YYYY-MM-DD HH:MM): ";
+    string datetimeText;
+    getline(cin, datetimeText);
+    CityDateTime datetime = cityDateTime(datetimeText);
     cout << "cashier: ";
     string cashier;
     getline(cin, cashier);
@@ -5455,14 +7438,15 @@ void groceryStartSale()
         cout << "No items.\n";
         return;
     }
+    /* the cart is built here and committed whole through the checkout engine,
+       the same path the lanes use */
+    groceryCartRecord cart;
+    cart.txn_id = txn_base;
+    cart.datetime = datetime;
+    cart.cashier = cashier;
     double sale_total = 0.0;
     for (int i = 0; i < n; ++i)
     {
-        if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-        {
-            cout << "Transactions full\n";
-            break;
-        }
         cout << "Item " << (i + 1) << " id OR name: ";
         string ident;
         getline(cin, ident);
@@ -5472,8 +7456,8 @@ void groceryStartSale()
             cout << "Not found. Skip.\n";
             continue;
         }
-        groceryItem &it = groceryItems[idx];
-        cout << "Found: " << it.item_id << "," << it.name << "," << it.price << ", stock=" << it.stock_qty << "\n";
+        groceryItemTable &it = groceryItems;
+        cout << "Found: " << it.item_id[idx] << "," << it.name[idx] << "," << it.price[idx] << ", stock=" << groceryCheckout.level(idx) << "\n";
         cout << "qty: ";
         int q;
         cin >> q;
@@ -5483,30 +7467,42 @@ void groceryStartSale()
             cout << "Skip.\n";
             continue;
         }
-        if (it.stock_qty < q)
+        int avail = groceryCheckout.level(idx);
+        for (size_t k = 0; k < cart.lines.size(); ++k)
+            if (cart.lines[k].item_idx == idx)
+                avail -= cart.lines[k].qty;
+        if (avail < q)
         {
-            cout << "Insufficient stock avail=" << it.stock_qty << ". Proceed? (1=yes): ";
+            if (avail <= 0)
+            {
+                cout << "Out of stock. Skip.\n";
+                continue;
+            }
+            cout << "Insufficient stock avail=" << avail << ". Sell " << avail << " instead? (1=yes): ";
             int p;
             cin >> p;
             cin.ignore();
             if (!p)
                 continue;
+            q = avail;
+        }
+        groceryCartLine ln;
+        ln.item_idx = idx;
+        ln.qty = q;
+        cart.lines.push_back(ln);
+        sale_total += q * it.price[idx];
+        cout << "Added: " << it.item_id[idx] << "," << q << "," << q * it.price[idx] << "\n";
+    }
+    if (!cart.lines.empty())
+    {
+        if (!groceryCheckout.commit(cart.lines))
+        {
+            cout << "Stock changed during the sale; nothing sold.\n";
+            return;
         }
-        groceryTransaction gt;
-        gt.txn_id = txn_base;
-        gt.datetime = datetime;
-        gt.item_id = it.item_id;
-        gt.qty = q;
-        gt.unit_price = it.price;
-        gt.line_total = q * it.price;
-        gt.cashier_name = cashier;
-        if (groceryTransactionCount < GROCERY_MAX_TRANSACTIONS)
-            groceryTransactions[groceryTransactionCount++] = gt;
-        it.stock_qty -= q;
-        if (it.stock_qty < 0)
-            it.stock_qty = 0;
-        sale_total += gt.line_total;
-        cout << "Added: " << gt.item_id << "," << gt.qty << "," << gt.line_total << "\n";
+        groceryCheckout.open();
+        groceryCheckout.submit(std::move(cart));
+        groceryCheckout.close();
     }
     cout << "Sale complete. Total=" << sale_total << "\n";
 }
@@ -5546,9 +7542,9 @@ void grocerySimulateQueue()
             {
                 int tid = q[front++ % GROCERY_MAX_QUEUE];
                 cout << "Processing " << tid << "\n";
-                for (int i = 0; i < groceryTransactionCount; ++i)
-                    if (groceryTransactions[i].txn_id == tid)
-                        cout << "Line: " << groceryTransactions[i].item_id << "," << groceryTransactions[i].qty << "," << groceryTransactions[i].line_total << "\n";
+                for (int i = 0; i < groceryTransactions.count(); ++i)
+                    if (groceryTransactions.txn_id[i] == tid)
+                        cout << "Line: " << groceryTransactions.item_id[i] << "," << groceryTransactions.qty[i] << "," << groceryTransactions.line_total[i] << "\n";
             }
         }
         else if (c == 3)
@@ -5563,65 +7559,167 @@ void grocerySimulateQueue()
     }
 }
 
-void groceryViewTransactions()
+/* drive nLanes threads through groceryCheckout, each committing cartsPerLane random carts of up to maxLines lines */
+void groceryCheckoutLoadTest(int nLanes, int cartsPerLane, int maxLines)
 {
-    cout << "Transactions (" << groceryTransactionCount << "):\n";
-    for (int i = 0; i < groceryTransactionCount; ++i)
+    int nItems = groceryItems.count();
+    if (nItems == 0 || nLanes <= 0 || cartsPerLane <= 0 || maxLines <= 0)
+    {
+        cout << "Nothing to run (load items first).\n";
+        return;
+    }
+    if (nLanes > GROCERY_MAX_LANES || maxLines > GROCERY_MAX_CART_LINES)
+    {
+        cout << "At most " << GROCERY_MAX_LANES << " lanes and " << GROCERY_MAX_CART_LINES << " lines per cart.\n";
+        return;
+    }
+    vector<long long> before(nItems);
+    for (int i = 0; i < nItems; ++i)
+        before[i] = groceryCheckout.level(i);
+
+    int txnBase = 0;
+    for (int i = 0; i < groceryTransactions.count(); ++i)
+        if (groceryTransactions.txn_id[i] > txnBase)
+            txnBase = groceryTransactions.txn_id[i];
+    atomic<int> nextTxn(txnBase + 1);
+    atomic<long long> committed(0), rejected(0);
+    CityDateTime datetime = cityNow();
+    double expectLines = (double)nLanes * cartsPerLane * (maxLines + 1) / 2;
+    groceryTransactions.reserve(groceryTransactions.count() + (size_t)min(expectLines, (double)GROCERY_LOG_RESERVE_MAX));
+
+    groceryCheckout.open();
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> lanes;
+    for (int l = 0; l < nLanes; ++l)
     {
-        groceryTransaction &t = groceryTransactions[i];
-        cout << t.txn_id << "," << t.datetime << "," << t.item_id << "," << t.qty << "," << t.unit_price << "," << t.line_total << "," << t.cashier_name << "\n";
+        lanes.push_back(thread([&, l]() {
+            string cashier = "Lane " + to_string(l + 1);
+            unsigned int rng = 2463534242u ^ (unsigned int)(l * 2654435761u);
+            for (int c = 0; c < cartsPerLane; ++c)
+            {
+                groceryCartRecord rec;
+                rec.datetime = datetime;
+                rec.cashier = cashier;
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                int n = 1 + (int)(rng % (unsigned int)maxLines);
+                for (int k = 0; k < n; ++k)
+                {
+                    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                    groceryCartLine ln;
+                    ln.item_idx = (int)(rng % (unsigned int)nItems);
+                    ln.qty = 1 + (int)((rng >> 16) % 3u);
+                    rec.lines.push_back(ln);
+                }
+                if (!groceryCheckout.commit(rec.lines))
+                {
+                    rejected.fetch_add(1, memory_order_relaxed);
+                    continue;
+                }
+                rec.txn_id = nextTxn.fetch_add(1, memory_order_relaxed);
+                committed.fetch_add(1, memory_order_relaxed);
+                groceryCheckout.submit(std::move(rec));
+            }
+        }));
+    }
+    for (size_t l = 0; l < lanes.size(); ++l)
+        lanes[l].join();
+    groceryCheckout.close();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    /* oversell check: no counter below zero, and every unit taken was written to the log */
+    long long violations = 0;
+    for (int i = 0; i < nItems; ++i)
+    {
+        int after = groceryCheckout.level(i);
+        if (after < 0 || before[i] - groceryCheckout.sold[i] != after)
+            violations++;
     }
+
+    cout << "Lanes=" << nLanes << " committed=" << committed.load() << " rejected(out of stock)=" << rejected.load()
+         << " lines=" << groceryCheckout.linesWritten << "\n";
+    cout << "Elapsed " << secs << "s, " << (secs > 0 ? committed.load() / secs : 0.0) << " sales/sec\n";
+    cout << "Oversell violations: " << violations << "\n";
+}
+
+void groceryViewTransactions()
+{
+    const groceryTransactionTable &t = groceryTransactions;
+    cout << "Transactions (" << t.count() << "):\n";
+    for (int i = 0; i < t.count(); ++i)
+        cout << t.txn_id[i] << "," << cityFormatDateTime(t.datetime[i]) << "," << t.item_id[i] << "," << t.qty[i] << "," << t.unit_price[i] << "," << t.line_total[i] << "," << t.cashier_name[i] << "\n";
 }
 
 void groceryItemSalesReport()
 {
     cout << "Item sales (id,name,total_qty,total_revenue):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
+    /* one pass over transactions, bucketed by item row through the id hash */
+    vector<int> totq(groceryItems.count(), 0);
+    vector<double> totr(groceryItems.count(), 0.0);
+    const groceryTransactionTable &t = groceryTransactions;
+    for (int j = 0; j < t.count(); ++j)
     {
-        int id = groceryItems[i].item_id;
-        int totq = 0;
-        double totr = 0.0;
-        for (int j = 0; j < groceryTransactionCount; ++j)
-            if (groceryTransactions[j].item_id == id)
-            {
-                totq += groceryTransactions[j].qty;
-                totr += groceryTransactions[j].line_total;
-            }
-        if (totq > 0)
-            cout << id << "," << groceryItems[i].name << "," << totq << "," << totr << "\n";
+        int idx = groceryHashFind(t.item_id[j]);
+        if (idx == -1)
+            continue;
+        totq[idx] += t.qty[j];
+        totr[idx] += t.line_total[j];
     }
+    for (int i = 0; i < groceryItems.count(); ++i)
+        if (totq[i] > 0)
+            cout << groceryItems.item_id[i] << "," << groceryItems.name[i] << "," << totq[i] << "," << totr[i] << "\n";
 }
 
-void groceryDailySales(const string &datePrefix)
+/* revenue of transactions in [from,to) minutes; plain integer compares so the loop vectorises */
+static double grocerySalesBetween(CityDateTime from, CityDateTime to)
 {
+    const CityDateTime *dt = groceryTransactions.datetime.data();
+    const double *amt = groceryTransactions.line_total.data();
+    int n = groceryTransactions.count();
     double total = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
-        if (groceryTransactions[i].datetime.rfind(datePrefix, 0) == 0)
-            total += groceryTransactions[i].line_total;
-    cout << "Sales " << datePrefix << " = " << total << "\n";
+    for (int i = 0; i < n; ++i)
+        total += (dt[i] >= from && dt[i] < to) ? amt[i] : 0.0;
+    return total;
+}
+
+/* "YYYY", "YYYY-MM" or "YYYY-MM-DD" -> minute range; false if not a date prefix */
+static bool groceryPrefixMinutes(const string &prefix, CityDateTime &from, CityDateTime &to)
+{
+    CityDate lo, hi;
+    return cityPrefixRange(prefix, lo, hi) && cityDayMinutes(lo, from) && cityDayMinutes(hi, to);
+}
+
+void groceryDailySales(const string &datePrefix)
+{
+    CityDateTime from, to;
+    if (!groceryPrefixMinutes(datePrefix, from, to))
+    {
+        cout << "Invalid date.\n";
+        return;
+    }
+    cout << "Sales " << datePrefix << " = " << grocerySalesBetween(from, to) << "\n";
 }
 
 void groceryMonthlySales(const string &monthPrefix)
 {
-    double total = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
-        if (groceryTransactions[i].datetime.rfind(monthPrefix, 0) == 0)
-            total += groceryTransactions[i].line_total;
-    cout << "Monthly " << monthPrefix << " = " << total << "\n";
+    CityDateTime from, to;
+    if (!groceryPrefixMinutes(monthPrefix, from, to))
+    {
+        cout << "Invalid month.\n";
+        return;
+    }
+    cout << "Monthly " << monthPrefix << " = " << grocerySalesBetween(from, to) << "\n";
 }
 
 void groceryProfitReport(const string &datePrefix)
 {
-    double revenue = 0.0, cogs = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
+    CityDateTime from = INT32_MIN, to = INT32_MAX;
+    if (!datePrefix.empty() && !groceryPrefixMinutes(datePrefix, from, to))
     {
-        groceryTransaction &t = groceryTransactions[i];
-        if (datePrefix.empty() || t.datetime.rfind(datePrefix, 0) == 0)
-        {
-            revenue += t.line_total;
-            cogs += t.line_total * 0.7;
-        }
+        cout << "Invalid date prefix.\n";
+        return;
     }
+    double revenue = grocerySalesBetween(from, to);
+    double cogs = revenue * 0.7;
     cout << "Profit (" << (datePrefix.empty() ? "ALL" : datePrefix) << ") rev=" << revenue << " cogs=" << cogs << " profit=" << revenue - cogs << "\n";
 }
 
@@ -5637,8 +7735,8 @@ void groceryLoadAllCSVsFromFolder()
 /* MAIN MENU */
 void grocerySystem()
 {
-    groceryInitHash();
-
+    /* the item hash is built by the first insert and kept in step with the
+       rows after that, so re-entering the menu must not reset it */
     while (true)
     {
         cout << "\n--- Grocery Store Menu ---\n";
@@ -5693,8 +7791,7 @@ void grocerySystem()
                 groceryLowStockReport();
                 break;
             case 8:
-                if (groceryItemCount > 0)
-                    quickSortByStock(groceryItems, 0, groceryItemCount - 1);
+                grocerySortItemsByStock();
                 cout << "Sorted by stock.\n";
                 break;
             default:
@@ -5707,7 +7804,7 @@ void grocerySystem()
         case 2:
         {
             cout << "1:LoadTransactionsCSV 2:AddTransactionManual 3:StartSale "
-                    "4:SimulateQueue 5:ViewTransactions 6:ItemSalesReport\nChoice: ";
+                    "4:SimulateQueue 5:ViewTransactions 6:ItemSalesReport 7:LaneLoadTest\nChoice: ";
             int s;
             cin >> s;
             cin.ignore();
@@ -5734,6 +7831,19 @@ void grocerySystem()
             case 6:
                 groceryItemSalesReport();
                 break;
+            case 7:
+            {
+                int lanes, carts, lines;
+                cout << "Lanes: ";
+                cin >> lanes;
+                cout << "Carts per lane: ";
+                cin >> carts;
+                cout << "Max lines per cart: ";
+                cin >> lines;
+                cin.ignore();
+                groceryCheckoutLoadTest(lanes, carts, lines);
+                break;
+            }
             default:
                 cout << "Invalid\n";
             }
@@ -5923,14 +8033,15 @@ struct PharmacySale
     char date[15];
 };
 
-// ---------- GLOBAL STORAGE ----------
-PharmacyMedicine pharmacyMeds[PHARMACY_MAX_MEDICINES];
-PharmacySupplier pharmacySuppliers[PHARMACY_MAX_SUPPLIERS];
-PharmacySale pharmacySales[PHARMACY_MAX_SALES];
-
-int pharmacyMedCount = 0;
-int pharmacySupplierCount = 0;
-int pharmacySaleCount = 0;
+// ---------- MODULE CONTEXT ----------
+// Created by pharmacyInitModule(); PHARMACY_MAX_* cap the row counts.
+struct PharmacyContext
+{
+    vector<PharmacyMedicine> meds;
+    vector<PharmacySupplier> suppliers;
+    vector<PharmacySale> sales;
+};
+static PharmacyContext *pharmacyCtx = NULL;
 
 // ---------- CSV SPLIT ----------
 int pharmacySplitCSV(const string &line, string out[], int maxCols)
@@ -5943,6 +8054,18 @@ int pharmacySplitCSV(const string &line, string out[], int maxCols)
     return count;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int pharmacyCountRows(ifstream &fin)
+{
+    int rows = 0;
+    string line;
+    while (getline(fin, line))
+        rows++;
+    fin.clear();
+    fin.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------- LOAD CSV ----------
 void pharmacyLoadMedicinesCSV(const string &file)
 {
@@ -5953,33 +8076,35 @@ void pharmacyLoadMedicinesCSV(const string &file)
         return;
     }
 
+    pharmacyCtx->meds.reserve(pharmacyCtx->meds.size() + min(pharmacyCountRows(fin), PHARMACY_MAX_MEDICINES));
     string line, col[6];
     getline(fin, line);
     while (getline(fin, line))
     {
-        if (pharmacyMedCount >= PHARMACY_MAX_MEDICINES)
+        if (pharmacyCtx->meds.size() >= PHARMACY_MAX_MEDICINES)
             break;
         int n = pharmacySplitCSV(line, col, 6);
         if (n < 6)
             continue;
 
-        PharmacyMedicine &m = pharmacyMeds[pharmacyMedCount++];
+        PharmacyMedicine m = {};
         m.id = stoi(col[0]);
         strncpy(m.name, col[1].c_str(), 49);
         strncpy(m.category, col[2].c_str(), 29);
         m.stock = stoi(col[3]);
         m.price = stod(col[4]);
         strncpy(m.expiry, col[5].c_str(), 14);
+        pharmacyCtx->meds.push_back(m);
     }
     fin.close();
-    cout << "Loaded Medicines: " << pharmacyMedCount << "\n";
+    cout << "Loaded Medicines: " << pharmacyCtx->meds.size() << "\n";
 }
 
 // ---------- UTIL ----------
 int pharmacyFindMedicine(int id)
 {
-    for (int i = 0; i < pharmacyMedCount; i++)
-        if (pharmacyMeds[i].id == id)
+    for (int i = 0; i < (int)pharmacyCtx->meds.size(); i++)
+        if (pharmacyCtx->meds[i].id == id)
             return i;
     return -1;
 }
@@ -5987,13 +8112,13 @@ int pharmacyFindMedicine(int id)
 // ---------- MANUAL ADD MEDICINE ----------
 void pharmacyAddMedicineManual()
 {
-    if (pharmacyMedCount >= PHARMACY_MAX_MEDICINES)
+    if (pharmacyCtx->meds.size() >= PHARMACY_MAX_MEDICINES)
     {
         cout << "Medicine storage full\n";
         return;
     }
 
-    PharmacyMedicine &m = pharmacyMeds[pharmacyMedCount++];
+    PharmacyMedicine m = {};
 
     cout << "Medicine ID: ";
     cin >> m.id;
@@ -6014,6 +8139,7 @@ void pharmacyAddMedicineManual()
     cout << "Expiry (MM/YYYY): ";
     cin >> m.expiry;
 
+    pharmacyCtx->meds.push_back(m);
     cout << "Medicine added successfully\n";
 }
 
@@ -6021,9 +8147,9 @@ void pharmacyAddMedicineManual()
 void pharmacyListMedicines()
 {
     cout << "\nID   Name            Stock   Price\n";
-    for (int i = 0; i < pharmacyMedCount; i++)
+    for (size_t i = 0; i < pharmacyCtx->meds.size(); i++)
     {
-        PharmacyMedicine &m = pharmacyMeds[i];
+        PharmacyMedicine &m = pharmacyCtx->meds[i];
         cout << m.id << "  " << m.name
              << "  " << m.stock
              << "  " << m.price << "\n";
@@ -6047,28 +8173,36 @@ void pharmacyManualSale()
     cout << "Quantity to sell: ";
     cin >> qty;
 
-    PharmacyMedicine &m = pharmacyMeds[idx];
+    PharmacyMedicine &m = pharmacyCtx->meds[idx];
     if (qty <= 0 || qty > m.stock)
     {
         cout << "Invalid quantity / insufficient stock\n";
         return;
     }
 
+    if (pharmacyCtx->sales.size() >= PHARMACY_MAX_SALES)
+    {
+        cout << "Sales log full\n";
+        return;
+    }
+
     m.stock -= qty;
 
-    PharmacySale &s = pharmacySales[pharmacySaleCount++];
-    s.saleID = pharmacySaleCount;
+    PharmacySale s = {};
+    s.saleID = pharmacyCtx->sales.size() + 1;
     s.medID = id;
     s.qty = qty;
     s.total = qty * m.price;
     strcpy(s.date, "2025");
+    pharmacyCtx->sales.push_back(s);
 
     cout << "Sale completed | Bill: " << s.total << "\n";
 }
 
 // ---------- AUTO SIMULATE SALES ----------
 void pharmacyAutoSimulateSales() {
-    if (pharmacyMedCount == 0) {
+    int medCount = pharmacyCtx->meds.size();
+    if (medCount == 0) {
         cout << "No medicines available\n";
         return;
     }
@@ -6083,15 +8217,19 @@ void pharmacyAutoSimulateSales() {
 
     int completed = 0;
 
-    for (int i = 0; i < customers && pharmacySaleCount < PHARMACY_MAX_SALES; i++) {
+    for (int i = 0; i < customers; i++) {
+        if (pharmacyCtx->sales.size() >= PHARMACY_MAX_SALES) {
+            cout << "Sales log full\n";
+            break;
+        }
 
         // Try limited attempts to find in-stock medicine
         int attempts = 0;
         int idx = -1;
 
-        while (attempts < pharmacyMedCount) {
-            int r = rand() % pharmacyMedCount;
-            if (pharmacyMeds[r].stock > 0) {
+        while (attempts < medCount) {
+            int r = rand() % medCount;
+            if (pharmacyCtx->meds[r].stock > 0) {
                 idx = r;
                 break;
             }
@@ -6103,19 +8241,20 @@ void pharmacyAutoSimulateSales() {
             break;
         }
 
-        PharmacyMedicine &m = pharmacyMeds[idx];
+        PharmacyMedicine &m = pharmacyCtx->meds[idx];
 
         int qty = (rand() % 5) + 1;  // 1–5 units
         if (qty > m.stock) qty = m.stock;
 
         m.stock -= qty;
 
-        PharmacySale &s = pharmacySales[pharmacySaleCount++];
-        s.saleID = pharmacySaleCount;
+        PharmacySale s = {};
+        s.saleID = pharmacyCtx->sales.size() + 1;
         s.medID = m.id;
         s.qty = qty;
         s.total = qty * m.price;
         strcpy(s.date, "2025");
+        pharmacyCtx->sales.push_back(s);
 
         cout << "Customer " << (i + 1)
              << " bought " << qty
@@ -6136,10 +8275,10 @@ void pharmacyAutoSimulateSales() {
 void pharmacyLowStockReport()
 {
     cout << "\n--- LOW STOCK (<10) ---\n";
-    for (int i = 0; i < pharmacyMedCount; i++)
-        if (pharmacyMeds[i].stock < 10)
-            cout << pharmacyMeds[i].name
-                 << " | Stock: " << pharmacyMeds[i].stock << "\n";
+    for (size_t i = 0; i < pharmacyCtx->meds.size(); i++)
+        if (pharmacyCtx->meds[i].stock < 10)
+            cout << pharmacyCtx->meds[i].name
+                 << " | Stock: " << pharmacyCtx->meds[i].stock << "\n";
 }
 void pharmacyLoadSuppliersCSV(const string &file)
 {
@@ -6150,34 +8289,36 @@ void pharmacyLoadSuppliersCSV(const string &file)
         return;
     }
 
+    pharmacyCtx->suppliers.reserve(pharmacyCtx->suppliers.size() + min(pharmacyCountRows(fin), PHARMACY_MAX_SUPPLIERS));
     string line, col[3];
     getline(fin, line); // header
 
     while (getline(fin, line))
     {
-        if (pharmacySupplierCount >= PHARMACY_MAX_SUPPLIERS)
+        if (pharmacyCtx->suppliers.size() >= PHARMACY_MAX_SUPPLIERS)
             break;
         int n = pharmacySplitCSV(line, col, 3);
         if (n < 3)
             continue;
 
-        PharmacySupplier &s = pharmacySuppliers[pharmacySupplierCount++];
+        PharmacySupplier s = {};
         s.id = stoi(col[0]);
         strncpy(s.name, col[1].c_str(), 49);
         strncpy(s.contact, col[2].c_str(), 29);
+        pharmacyCtx->suppliers.push_back(s);
     }
     fin.close();
 
-    cout << "Loaded Suppliers: " << pharmacySupplierCount << "\n";
+    cout << "Loaded Suppliers: " << pharmacyCtx->suppliers.size() << "\n";
 }
 void pharmacyListSuppliers()
 {
     cout << "\nID   Supplier Name        Contact\n";
-    for (int i = 0; i < pharmacySupplierCount; i++)
+    for (size_t i = 0; i < pharmacyCtx->suppliers.size(); i++)
     {
-        cout << pharmacySuppliers[i].id << "   "
-             << pharmacySuppliers[i].name << "   "
-             << pharmacySuppliers[i].contact << "\n";
+        cout << pharmacyCtx->suppliers[i].id << "   "
+             << pharmacyCtx->suppliers[i].name << "   "
+             << pharmacyCtx->suppliers[i].contact << "\n";
     }
 }
 
@@ -6189,8 +8330,16 @@ void pharmacyLoadAll()
 }
 
 // ---------- MENU ----------
+void pharmacyInitModule()
+{
+    if (pharmacyCtx)
+        return; // state is kept across visits to the menu
+    pharmacyCtx = new PharmacyContext();
+}
+
 void pharmacySystem()
 {
+    pharmacyInitModule();
     int ch, n;
     while (1)
     {
@@ -6274,11 +8423,16 @@ struct FPOrderItem {
     int qty;
 };
 
-// ---------------- GLOBAL STORAGE ----------------
-FPVendor vendors[FP_MAX_VENDORS]; int vendorCount = 0;
-FPItem items[FP_MAX_ITEMS]; int itemCount = 0;
-FPOrder orders[FP_MAX_ORDERS]; int orderCount = 0;
-FPOrderItem orderItems[FP_MAX_ORDERITEMS]; int orderItemCount = 0;
+// ---------------- MODULE CONTEXT ----------------
+// Created by foodPharmaInitModule(); FP_MAX_* cap the row counts.
+struct FPContext {
+    vector<FPVendor> vendors;
+    vector<FPItem> items;
+    vector<FPOrder> orders;
+    vector<FPOrderItem> orderItems;
+};
+FPContext *fpCtx = NULL;
+
 int foodPharmaDijkstra(int src, int dest);
 
 
@@ -6294,6 +8448,16 @@ int foodPharmaSplitCSV(const string &line, string out[], int max) {
     return i;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int foodPharmaCountRows(ifstream &fin) {
+    int rows = 0;
+    string line;
+    while (getline(fin, line)) rows++;
+    fin.clear();
+    fin.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------------- GRAPH LOADER ----------------
 bool foodPharmaLoadGraph(const string &file) {
     ifstream fin(file);
@@ -6318,19 +8482,20 @@ bool foodPharmaLoadOrders(const string &file) {
     if (!fin) return false;
 
     string line, c[6];
-    orderCount = 0;
+    fpCtx->orders.clear();
+    fpCtx->orders.reserve(min(foodPharmaCountRows(fin), FP_MAX_ORDERS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->orders.size() < FP_MAX_ORDERS) {
         foodPharmaSplitCSV(line, c, 6);
-        orders[orderCount].id = stoi(c[0]);
-        strncpy(orders[orderCount].customer, c[1].c_str(), 49);
-        strncpy(orders[orderCount].address, c[2].c_str(), 99);
-        orders[orderCount].locationNode = stoi(c[3]);
-        strncpy(orders[orderCount].status, c[4].c_str(), 19);
-        orders[orderCount].distance =
-            foodPharmaDijkstra(0, orders[orderCount].locationNode);
-        orderCount++;
+        FPOrder o = {};
+        o.id = stoi(c[0]);
+        strncpy(o.customer, c[1].c_str(), 49);
+        strncpy(o.address, c[2].c_str(), 99);
+        o.locationNode = stoi(c[3]);
+        strncpy(o.status, c[4].c_str(), 19);
+        o.distance = foodPharmaDijkstra(0, o.locationNode);
+        fpCtx->orders.push_back(o);
     }
     return true;
 }
@@ -6339,15 +8504,17 @@ bool foodPharmaLoadOrderItems(const string &file) {
     if (!fin) return false;
 
     string line, c[4];
-    orderItemCount = 0;
+    fpCtx->orderItems.clear();
+    fpCtx->orderItems.reserve(min(foodPharmaCountRows(fin), FP_MAX_ORDERITEMS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->orderItems.size() < FP_MAX_ORDERITEMS) {
         foodPharmaSplitCSV(line, c, 4);
-        orderItems[orderItemCount].orderId = stoi(c[0]);
-        orderItems[orderItemCount].itemId = stoi(c[1]);
-        orderItems[orderItemCount].qty = stoi(c[2]);
-        orderItemCount++;
+        FPOrderItem oi = {};
+        oi.orderId = stoi(c[0]);
+        oi.itemId = stoi(c[1]);
+        oi.qty = stoi(c[2]);
+        fpCtx->orderItems.push_back(oi);
     }
     return true;
 }
@@ -6383,15 +8550,17 @@ bool foodPharmaLoadVendors(const string &file) {
     if (!fin) return false;
 
     string line, c[5];
-    vendorCount = 0;
+    fpCtx->vendors.clear();
+    fpCtx->vendors.reserve(min(foodPharmaCountRows(fin), FP_MAX_VENDORS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->vendors.size() < FP_MAX_VENDORS) {
         foodPharmaSplitCSV(line, c, 5);
-        vendors[vendorCount].id = stoi(c[0]);
-        strncpy(vendors[vendorCount].name, c[1].c_str(), 49);
-        strncpy(vendors[vendorCount].type, c[2].c_str(), 9);
-        vendorCount++;
+        FPVendor v = {};
+        v.id = stoi(c[0]);
+        strncpy(v.name, c[1].c_str(), 49);
+        strncpy(v.type, c[2].c_str(), 9);
+        fpCtx->vendors.push_back(v);
     }
     return true;
 }
@@ -6402,16 +8571,18 @@ bool foodPharmaLoadItems(const string &file) {
     if (!fin) return false;
 
     string line, c[6];
-    itemCount = 0;
+    fpCtx->items.clear();
+    fpCtx->items.reserve(min(foodPharmaCountRows(fin), FP_MAX_ITEMS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->items.size() < FP_MAX_ITEMS) {
         foodPharmaSplitCSV(line, c, 6);
-        items[itemCount].id = stoi(c[0]);
-        items[itemCount].vendorId = stoi(c[1]);
-        strncpy(items[itemCount].name, c[2].c_str(), 49);
-        items[itemCount].price = stod(c[3]);
-        itemCount++;
+        FPItem it = {};
+        it.id = stoi(c[0]);
+        it.vendorId = stoi(c[1]);
+        strncpy(it.name, c[2].c_str(), 49);
+        it.price = stod(c[3]);
+        fpCtx->items.push_back(it);
     }
     return true;
 }
@@ -6421,12 +8592,12 @@ void foodPharmaLoadALL() {
     cout << "\n--- LOADING FOODPHARMA CSV DATA ---\n";
 
     if (foodPharmaLoadVendors("foodpharma_vendors.csv"))
-        cout << " Vendors loaded: " << vendorCount << "\n";
+        cout << " Vendors loaded: " << fpCtx->vendors.size() << "\n";
     else
         cout << " Vendors CSV missing\n";
 
     if (foodPharmaLoadItems("foodpharma_items.csv"))
-        cout << " Items loaded: " << itemCount << "\n";
+        cout << " Items loaded: " << fpCtx->items.size() << "\n";
     else
         cout << " Items CSV missing\n";
 
@@ -6436,12 +8607,12 @@ void foodPharmaLoadALL() {
         cout << " Graph CSV missing\n";
 
     if (foodPharmaLoadOrders("foodpharma_orders.csv"))
-        cout << " Orders loaded: " << orderCount << "\n";
+        cout << " Orders loaded: " << fpCtx->orders.size() << "\n";
     else
         cout << " Orders CSV not found (optional)\n";
 
     if (foodPharmaLoadOrderItems("foodpharma_orderitems.csv"))
-        cout << " Order items loaded: " << orderItemCount << "\n";
+        cout << " Order items loaded: " << fpCtx->orderItems.size() << "\n";
     else
         cout << " Order items CSV not found (optional)\n";
 
@@ -6452,43 +8623,55 @@ void foodPharmaLoadALL() {
 // ---------------- SHOW FUNCTIONS ----------------
 void foodPharmaShowVendors() {
     cout << "\n--- VENDORS ---\n";
-    for (int i = 0; i < vendorCount; i++)
-        cout << vendors[i].id << " | " << vendors[i].name
-             << " | " << vendors[i].type << "\n";
+    for (size_t i = 0; i < fpCtx->vendors.size(); i++)
+        cout << fpCtx->vendors[i].id << " | " << fpCtx->vendors[i].name
+             << " | " << fpCtx->vendors[i].type << "\n";
 }
 
 void foodPharmaShowItems() {
     cout << "\n--- ITEMS ---\n";
-    for (int i = 0; i < itemCount; i++)
-        cout << items[i].id << " | Vendor " << items[i].vendorId
-             << " | " << items[i].name
-             << " | Rs" << items[i].price << "\n";
+    for (size_t i = 0; i < fpCtx->items.size(); i++)
+        cout << fpCtx->items[i].id << " | Vendor " << fpCtx->items[i].vendorId
+             << " | " << fpCtx->items[i].name
+             << " | Rs" << fpCtx->items[i].price << "\n";
 }
 
 // ---------------- MANUAL ADD ----------------
 void foodPharmaAddVendor() {
-    FPVendor &v = vendors[vendorCount];
+    if (fpCtx->vendors.size() >= FP_MAX_VENDORS) {
+        cout << "Vendor storage full\n";
+        return;
+    }
+    FPVendor v = {};
     cout << "Vendor ID: "; cin >> v.id;
     cin.ignore();
     cout << "Name: "; cin.getline(v.name, 50);
     cout << "Type (FOOD/PHARMA): "; cin.getline(v.type, 10);
-    vendorCount++;
+    fpCtx->vendors.push_back(v);
 }
 
 void foodPharmaAddItem() {
-    FPItem &i = items[itemCount];
+    if (fpCtx->items.size() >= FP_MAX_ITEMS) {
+        cout << "Item storage full\n";
+        return;
+    }
+    FPItem i = {};
     cout << "Item ID: "; cin >> i.id;
     cout << "Vendor ID: "; cin >> i.vendorId;
     cin.ignore();
     cout << "Name: "; cin.getline(i.name, 50);
     cout << "Price: "; cin >> i.price;
-    itemCount++;
+    fpCtx->items.push_back(i);
 }
 
 // ---------------- ORDER FUNCTIONS ----------------
 void foodPharmaCreateOrder() {
-    FPOrder &o = orders[orderCount];
-    o.id = orderCount + 1;
+    if (fpCtx->orders.size() >= FP_MAX_ORDERS) {
+        cout << "Order storage full\n";
+        return;
+    }
+    FPOrder o = {};
+    o.id = fpCtx->orders.size() + 1;
 
     cin.ignore();
     cout << "Customer Name: "; cin.getline(o.customer, 50);
@@ -6500,14 +8683,18 @@ void foodPharmaCreateOrder() {
 
     int more = 1;
     while (more) {
-        FPOrderItem &oi = orderItems[orderItemCount];
+        if (fpCtx->orderItems.size() >= FP_MAX_ORDERITEMS) {
+            cout << "Order item storage full\n";
+            break;
+        }
+        FPOrderItem oi = {};
         oi.orderId = o.id;
         cout << "Item ID: "; cin >> oi.itemId;
         cout << "Qty: "; cin >> oi.qty;
-        orderItemCount++;
+        fpCtx->orderItems.push_back(oi);
         cout << "Add more items? (1/0): "; cin >> more;
     }
-    orderCount++;
+    fpCtx->orders.push_back(o);
 }
 
 void foodPharmaCompleteOrder() {
@@ -6515,9 +8702,9 @@ void foodPharmaCompleteOrder() {
     cout << "Enter Order ID to complete: ";
     cin >> oid;
 
-    for (int i = 0; i < orderCount; i++) {
-        if (orders[i].id == oid) {
-            strcpy(orders[i].status, "COMPLETED");
+    for (size_t i = 0; i < fpCtx->orders.size(); i++) {
+        if (fpCtx->orders[i].id == oid) {
+            strcpy(fpCtx->orders[i].status, "COMPLETED");
             cout << "Order marked COMPLETED\n";
             return;
         }
@@ -6526,16 +8713,18 @@ void foodPharmaCompleteOrder() {
 }
 
 void foodPharmaRemoveCompletedOrders() {
-    for (int i = 0; i < orderCount; i++) {
-        if (strcmp(orders[i].status, "COMPLETED") == 0) {
+    for (int i = 0; i < (int)fpCtx->orders.size(); i++) {
+        if (strcmp(fpCtx->orders[i].status, "COMPLETED") == 0) {
             // remove order items
-            for (int j = 0; j < orderItemCount; j++) {
-                if (orderItems[j].orderId == orders[i].id) {
-                    orderItems[j] = orderItems[--orderItemCount];
+            for (int j = 0; j < (int)fpCtx->orderItems.size(); j++) {
+                if (fpCtx->orderItems[j].orderId == fpCtx->orders[i].id) {
+                    fpCtx->orderItems[j] = fpCtx->orderItems.back();
+                    fpCtx->orderItems.pop_back();
                     j--;
                 }
             }
-            orders[i] = orders[--orderCount];
+            fpCtx->orders[i] = fpCtx->orders.back();
+            fpCtx->orders.pop_back();
             i--;
         }
     }
@@ -6544,14 +8733,20 @@ void foodPharmaRemoveCompletedOrders() {
 
 // ---------------- DISPLAY ORDERS ----------------
 void foodPharmaShowOrders() {
-    for (int i = 0; i < orderCount; i++)
-        cout << orders[i].id << " | " << orders[i].customer
-             << " | " << orders[i].status
-             << " | Dist: " << orders[i].distance << "\n";
+    for (size_t i = 0; i < fpCtx->orders.size(); i++)
+        cout << fpCtx->orders[i].id << " | " << fpCtx->orders[i].customer
+             << " | " << fpCtx->orders[i].status
+             << " | Dist: " << fpCtx->orders[i].distance << "\n";
 }
 
 // ---------------- MENU ----------------
+void foodPharmaInitModule() {
+    if (fpCtx) return; // state is kept across visits to the menu
+    fpCtx = new FPContext();
+}
+
 void foodpharmaSystem() {
+    foodPharmaInitModule();
     int ch; string path;
     do {
         cout << "\n--- FOOD & PHARMACY DELIVERY ---\n";
@@ -6584,6 +8779,9 @@ void foodpharmaSystem() {
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "../city_dict.h"
 using namespace std;
 
 // ---------------- CONFIG ----------------
@@ -6603,7 +8801,7 @@ struct SpaCustomer {
 struct SpaStaff {
     int id;
     string name;
-    string role;       // Therapist / Receptionist / Manager
+    CityCode role;     // spaRoles: Therapist / Receptionist / Manager
     string specialty;  // For therapists
     int available;     // 1 = free, 0 = busy
 };
@@ -6621,28 +8819,36 @@ struct SpaAppointment {
     int serviceId;
     int staffId;
     string timeSlot;
-    string status; // Booked / InProgress / Completed
+    CityCode status; // spaApptStatus: Booked / InProgress / Completed
 };
 
 struct SpaBill {
     int id;
     int appointmentId;
     double amount;
-    string status; // Pending / Paid
+    CityCode status; // spaBillStatus: Pending / Paid
 };
 
-// ---------------- STORAGE ----------------
-SpaCustomer customers[SPA_MAX_CUSTOMERS];
-SpaStaff staff[SPA_MAX_STAFF];
-SpaService services[SPA_MAX_SERVICES];
-SpaAppointment appointments[SPA_MAX_APPOINTMENTS];
-SpaBill bills[SPA_MAX_BILLS];
-
-int customerCount = 0;
-int spastaffCount = 0;
-int spaserviceCount = 0;
-int appointmentCount = 0;
-int billCount = 0;
+// ---------------- STATUS / ROLE CODES ----------------
+// Interned with city_dict.h: the seeded values have the fixed codes below,
+// anything else found in the CSVs is appended on load.
+CityDict spaRoles = cityDictMake({"Therapist", "Receptionist", "Manager"});
+CityDict spaApptStatus = cityDictMake({"Booked", "InProgress", "Completed"});
+CityDict spaBillStatus = cityDictMake({"Pending", "Paid"});
+enum { SPA_THERAPIST, SPA_RECEPTIONIST, SPA_MANAGER };
+enum { SPA_BOOKED, SPA_IN_PROGRESS, SPA_COMPLETED };
+enum { SPA_BILL_PENDING, SPA_BILL_PAID };
+
+// ---------------- MODULE CONTEXT ----------------
+// Created by spaInitModule(); SPA_MAX_* cap the row counts.
+struct SpaContext {
+    vector<SpaCustomer> customers;
+    vector<SpaStaff> staff;
+    vector<SpaService> services;
+    vector<SpaAppointment> appointments;
+    vector<SpaBill> bills;
+};
+SpaContext *spaCtx = NULL;
 
 // ---------------- CSV HELPER ----------------
 int spaSplitCSV(const string &line, string out[], int maxCols) {
@@ -6654,15 +8860,27 @@ int spaSplitCSV(const string &line, string out[], int maxCols) {
     return i;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int spaCountRows(ifstream &f) {
+    int rows = 0;
+    string line;
+    while (getline(f, line))
+        rows++;
+    f.clear();
+    f.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------------- LOAD CSVs ----------------
 void spaLoadCustomers() {
     ifstream f("spa_customers.csv");
     if (!f) return;
     string line, c[4];
+    spaCtx->customers.reserve(spaCtx->customers.size() + min(spaCountRows(f), SPA_MAX_CUSTOMERS));
     getline(f, line);
-    while (getline(f, line) && customerCount < SPA_MAX_CUSTOMERS) {
+    while (getline(f, line) && spaCtx->customers.size() < SPA_MAX_CUSTOMERS) {
         spaSplitCSV(line, c, 4);
-        customers[customerCount++] = {stoi(c[0]), c[1], c[2]};
+        spaCtx->customers.push_back({stoi(c[0]), c[1], c[2]});
     }
 }
 
@@ -6670,12 +8888,13 @@ void spaLoadStaff() {
     ifstream f("spa_staff.csv");
     if (!f) return;
     string line, c[6];
+    spaCtx->staff.reserve(spaCtx->staff.size() + min(spaCountRows(f), SPA_MAX_STAFF));
     getline(f, line);
-    while (getline(f, line) && spastaffCount < SPA_MAX_STAFF) {
+    while (getline(f, line) && spaCtx->staff.size() < SPA_MAX_STAFF) {
         spaSplitCSV(line, c, 6);
-        staff[spastaffCount++] = {
-            stoi(c[0]), c[1], c[2], c[3], stoi(c[4])
-        };
+        spaCtx->staff.push_back({
+            stoi(c[0]), c[1], cityIntern(spaRoles, c[2]), c[3], stoi(c[4])
+        });
     }
 }
 
@@ -6683,12 +8902,13 @@ void spaLoadServices() {
     ifstream f("spa_services.csv");
     if (!f) return;
     string line, c[5];
+    spaCtx->services.reserve(spaCtx->services.size() + min(spaCountRows(f), SPA_MAX_SERVICES));
     getline(f, line);
-    while (getline(f, line) &&  spaserviceCount < SPA_MAX_SERVICES) {
+    while (getline(f, line) && spaCtx->services.size() < SPA_MAX_SERVICES) {
         spaSplitCSV(line, c, 5);
-        services[ spaserviceCount++] = {
+        spaCtx->services.push_back({
             stoi(c[0]), c[1], stoi(c[2]), stod(c[3])
-        };
+        });
     }
 }
 
@@ -6696,33 +8916,34 @@ void spaLoadAppointments() {
     ifstream f("spa_appointments.csv");
     if (!f) return;
     string line, c[6];
+    spaCtx->appointments.reserve(spaCtx->appointments.size() + min(spaCountRows(f), SPA_MAX_APPOINTMENTS));
     getline(f, line);
-    while (getline(f, line) && appointmentCount < SPA_MAX_APPOINTMENTS) {
+    while (getline(f, line) && spaCtx->appointments.size() < SPA_MAX_APPOINTMENTS) {
         spaSplitCSV(line, c, 6);
-        appointments[appointmentCount++] = {
+        spaCtx->appointments.push_back({
             stoi(c[0]), stoi(c[1]), stoi(c[2]),
-            stoi(c[3]), c[4], c[5]
-        };
+            stoi(c[3]), c[4], cityIntern(spaApptStatus, c[5])
+        });
     }
 }
 string spaGetCustomerName(int id) {
-    for (int i = 0; i < customerCount; i++)
-        if (customers[i].id == id)
-            return customers[i].name;
+    for (int i = 0; i < (int)spaCtx->customers.size(); i++)
+        if (spaCtx->customers[i].id == id)
+            return spaCtx->customers[i].name;
     return "Unknown";
 }
 
 string spaGetStaffName(int id) {
-    for (int i = 0; i < spastaffCount; i++)
-        if (staff[i].id == id)
-            return staff[i].name;
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++)
+        if (spaCtx->staff[i].id == id)
+            return spaCtx->staff[i].name;
     return "Unassigned";
 }
 
 string spaGetServiceName(int id) {
-    for (int i = 0; i <  spaserviceCount; i++)
-        if (services[i].id == id)
-            return services[i].name;
+    for (int i = 0; i < (int)spaCtx->services.size(); i++)
+        if (spaCtx->services[i].id == id)
+            return spaCtx->services[i].name;
     return "Unknown";
 }
 
@@ -6734,40 +8955,42 @@ void spaLoadAll() {
     spaLoadAppointments();
 
     cout << "\nLoaded:\n";
-    cout << customerCount << " customers\n";
-    cout << spastaffCount << " staff\n";
-    cout <<  spaserviceCount << " services\n";
-    cout << appointmentCount << " appointments\n";
+    cout << spaCtx->customers.size() << " customers\n";
+    cout << spaCtx->staff.size() << " staff\n";
+    cout << spaCtx->services.size() << " services\n";
+    cout << spaCtx->appointments.size() << " appointments\n";
 }
 
 // ---------------- STAFF MANAGEMENT ----------------
 void spaListStaff() {
     cout << "\n--- STAFF LIST ---\n";
-    for (int i = 0; i < spastaffCount; i++) {
-        cout << "ID:" << staff[i].id
-             << " | " << staff[i].name
-             << " | Role:" << staff[i].role
-             << " | Spec:" << staff[i].specialty
-             << " | " << (staff[i].available ? "Available" : "Busy") << "\n";
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++) {
+        cout << "ID:" << spaCtx->staff[i].id
+             << " | " << spaCtx->staff[i].name
+             << " | Role:" << cityDictName(spaRoles, spaCtx->staff[i].role)
+             << " | Spec:" << spaCtx->staff[i].specialty
+             << " | " << (spaCtx->staff[i].available ? "Available" : "Busy") << "\n";
     }
 }
 
 void spaAddStaff() {
-    if (spastaffCount >= SPA_MAX_STAFF) return;
+    if (spaCtx->staff.size() >= SPA_MAX_STAFF) return;
 
-    SpaStaff &s = staff[spastaffCount];
-    s.id = spastaffCount + 1;
+    SpaStaff s;
+    s.id = spaCtx->staff.size() + 1;
 
     cout << "Name: ";
     cin.ignore();
     getline(cin, s.name);
     cout << "Role: ";
-    getline(cin, s.role);
+    string role;
+    getline(cin, role);
+    s.role = cityIntern(spaRoles, role);
     cout << "Specialty: ";
     getline(cin, s.specialty);
 
     s.available = 1;
-    spastaffCount++;
+    spaCtx->staff.push_back(s);
 
     cout << "Staff added\n";
 }
@@ -6777,10 +9000,10 @@ void spaRemoveStaff() {
     cout << "Staff ID to remove: ";
     cin >> id;
 
-    for (int i = 0; i < spastaffCount; i++) {
-        if (staff[i].id == id) {
-            staff[i] = staff[spastaffCount- 1];
-            spastaffCount--;
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++) {
+        if (spaCtx->staff[i].id == id) {
+            spaCtx->staff[i] = spaCtx->staff.back();
+            spaCtx->staff.pop_back();
             cout << "Staff removed\n";
             return;
         }
@@ -6790,8 +9013,10 @@ void spaRemoveStaff() {
 
 // ---------------- APPOINTMENTS ----------------
 void spaBookAppointment() {
-    SpaAppointment &a = appointments[appointmentCount];
-    a.id = appointmentCount + 1;
+    if (spaCtx->appointments.size() >= SPA_MAX_APPOINTMENTS) return;
+
+    SpaAppointment a;
+    a.id = spaCtx->appointments.size() + 1;
 
     cout << "Customer ID: ";
     cin >> a.customerId;
@@ -6801,8 +9026,8 @@ void spaBookAppointment() {
     cin >> a.timeSlot;
 
     a.staffId = -1;
-    a.status = "Booked";
-    appointmentCount++;
+    a.status = SPA_BOOKED;
+    spaCtx->appointments.push_back(a);
 
     cout << "Appointment booked\n";
 }
@@ -6812,22 +9037,22 @@ void spaAssignStaff() {
     cout << "Appointment ID: ";
     cin >> aid;
 
-    for (int i = 0; i < appointmentCount; i++) {
-        if (appointments[i].id == aid &&
-            appointments[i].status == "Booked") {
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        if (spaCtx->appointments[i].id == aid &&
+            spaCtx->appointments[i].status == SPA_BOOKED) {
 
-            for (int s = 0; s < spastaffCount; s++) {
-                if (staff[s].available &&
-                    staff[s].role == "Therapist") {
+            for (int s = 0; s < (int)spaCtx->staff.size(); s++) {
+                if (spaCtx->staff[s].available &&
+                    spaCtx->staff[s].role == SPA_THERAPIST) {
 
-                    appointments[i].staffId = staff[s].id;
-                    appointments[i].status = "InProgress";
-                    staff[s].available = 0;
+                    spaCtx->appointments[i].staffId = spaCtx->staff[s].id;
+                    spaCtx->appointments[i].status = SPA_IN_PROGRESS;
+                    spaCtx->staff[s].available = 0;
 
                     cout << "Assigning "
-                         << spaGetStaffName(staff[s].id)
+                         << spaGetStaffName(spaCtx->staff[s].id)
                          << " to "
-                         << spaGetCustomerName(appointments[i].customerId)
+                         << spaGetCustomerName(spaCtx->appointments[i].customerId)
                          << "\n";
 
                     return;
@@ -6844,26 +9069,30 @@ void spaCompleteAppointment() {
     cout << "Appointment ID: ";
     cin >> aid;
 
-    for (int i = 0; i < appointmentCount; i++) {
-        if (appointments[i].id == aid &&
-            appointments[i].status == "InProgress") {
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        if (spaCtx->appointments[i].id == aid &&
+            spaCtx->appointments[i].status == SPA_IN_PROGRESS) {
 
-            appointments[i].status = "Completed";
+            spaCtx->appointments[i].status = SPA_COMPLETED;
 
-            for (int s = 0; s < spastaffCount; s++)
-                if (staff[s].id == appointments[i].staffId)
-                    staff[s].available = 1;
+            for (int s = 0; s < (int)spaCtx->staff.size(); s++)
+                if (spaCtx->staff[s].id == spaCtx->appointments[i].staffId)
+                    spaCtx->staff[s].available = 1;
 
-            SpaBill &b = bills[billCount];
-            b.id = billCount + 1;
+            if (spaCtx->bills.size() >= SPA_MAX_BILLS) {
+                cout << "Completed; bill storage full\n";
+                return;
+            }
+            SpaBill b = {};
+            b.id = spaCtx->bills.size() + 1;
             b.appointmentId = aid;
-            b.status = "Pending";
+            b.status = SPA_BILL_PENDING;
 
-            for (int j = 0; j <  spaserviceCount; j++)
-                if (services[j].id == appointments[i].serviceId)
-                    b.amount = services[j].price;
+            for (int j = 0; j < (int)spaCtx->services.size(); j++)
+                if (spaCtx->services[j].id == spaCtx->appointments[i].serviceId)
+                    b.amount = spaCtx->services[j].price;
 
-            billCount++;
+            spaCtx->bills.push_back(b);
             cout << "Completed & billed\n";
             return;
         }
@@ -6874,18 +9103,24 @@ void spaCompleteAppointment() {
 // ---------------- LIST APPOINTMENTS ----------------
 void spaListAppointments() {
     cout << "\n--- APPOINTMENTS ---\n";
-    for (int i = 0; i < appointmentCount; i++) {
-        cout << "ApptID:" << appointments[i].id
-             << " | Customer: " << spaGetCustomerName(appointments[i].customerId)
-             << " | Service: " << spaGetServiceName(appointments[i].serviceId)
-             << " | Staff: " << spaGetStaffName(appointments[i].staffId)
-             << " | [" << appointments[i].status << "]\n";
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        cout << "ApptID:" << spaCtx->appointments[i].id
+             << " | Customer: " << spaGetCustomerName(spaCtx->appointments[i].customerId)
+             << " | Service: " << spaGetServiceName(spaCtx->appointments[i].serviceId)
+             << " | Staff: " << spaGetStaffName(spaCtx->appointments[i].staffId)
+             << " | [" << cityDictName(spaApptStatus, spaCtx->appointments[i].status) << "]\n";
     }
 }
 
 
 // ---------------- MENU ----------------
+void spaInitModule() {
+    if (spaCtx) return; // state is kept across visits to the menu
+    spaCtx = new SpaContext();
+}
+
 void spaMenu() {
+    spaInitModule();
     int ch;
     do {
         cout << "\n==== SPA MANAGEMENT ====\n";
@@ -63,9 +63,6 @@ struct Shop {
     ItemNode *root;
 };
 
-Shop mallShops[MALL_MAX_SHOPS];
-int shopCount = 0;
-
 // =====================================================
 // STAFF SYSTEM
 // =====================================================
@@ -77,9 +74,6 @@ struct Staff {
     int salary;
 };
 
-Staff staffList[MALL_MAX_STAFF];
-int staffCount = 0;
-
 // =====================================================
 // CLEANING LOG
 // =====================================================
@@ -89,8 +83,17 @@ struct CleanEvent {
     string note;
 };
 
-CleanEvent cleanLog[MALL_MAX_CLEAN];
-int cleanCount = 0;
+// =====================================================
+// MODULE CONTEXT
+// =====================================================
+// Created by mallInitModule(); MALL_MAX_* cap the row counts.
+
+struct MallContext {
+    vector<Shop> shops;
+    vector<Staff> staff;
+    vector<CleanEvent> cleanLog;
+};
+MallContext *mallCtx = NULL;
 
 // =====================================================
 // PARKING GRID (BFS)
@@ -144,12 +147,12 @@ ItemBST itemManager;
 // =====================================================
 
 int partitionQuick(int arr[], int l, int r) {
-    int pivot = mallShops[arr[l]].revenue;
+    int pivot = mallCtx->shops[arr[l]].revenue;
     int i = l, j = r + 1;
 
     while (true) {
-        do { i++; } while (i <= r && mallShops[arr[i]].revenue > pivot);
-        do { j--; } while (mallShops[arr[j]].revenue < pivot);
+        do { i++; } while (i <= r && mallCtx->shops[arr[i]].revenue > pivot);
+        do { j--; } while (mallCtx->shops[arr[j]].revenue < pivot);
         if (i >= j) break;
         swap(arr[i], arr[j]);
     }
@@ -211,7 +214,7 @@ int createShopID() {
 }
 
 void addShop() {
-    if (shopCount >= MALL_MAX_SHOPS) {
+    if (mallCtx->shops.size() >= MALL_MAX_SHOPS) {
         cout << "Shop limit reached.\n";
         return;
     }
@@ -226,15 +229,16 @@ void addShop() {
     cout << "Close time (HH:MM): ";
     cin >> cl;
 
-    mallShops[shopCount].id = createShopID();
-    mallShops[shopCount].name = nm;
-    mallShops[shopCount].open_time = timeToMin(op);
-    mallShops[shopCount].close_time = timeToMin(cl);
-    mallShops[shopCount].revenue = 0;
-    mallShops[shopCount].root = NULL;
+    Shop sh = {};
+    sh.id = createShopID();
+    sh.name = nm;
+    sh.open_time = timeToMin(op);
+    sh.close_time = timeToMin(cl);
+    sh.revenue = 0;
+    sh.root = NULL;
+    mallCtx->shops.push_back(sh);
 
-    cout << "Shop added (ID = " << mallShops[shopCount].id << ")\n";
-    shopCount++;
+    cout << "Shop added (ID = " << sh.id << ")\n";
 }
 
 void addItemToShop() {
@@ -243,8 +247,8 @@ void addItemToShop() {
     cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < shopCount; i++)
-        if (mallShops[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->shops.size(); i++)
+        if (mallCtx->shops[i].id == id) idx = i;
 
     if (idx == -1) { cout << "Shop not found.\n"; return; }
 
@@ -259,25 +263,25 @@ void addItemToShop() {
     cout << "Stock: ";
     cin >> stock;
 
-    mallShops[idx].root = itemManager.insertNode(
-        mallShops[idx].root, name, price, stock
+    mallCtx->shops[idx].root = itemManager.insertNode(
+        mallCtx->shops[idx].root, name, price, stock
     );
 
     cout << "Item added!\n";
 }
 
 void showAllShops() {
-    if (shopCount == 0) { cout << "No shops.\n"; return; }
-
-    for (int i = 0; i < shopCount; i++) {
-        cout << "\n----------- SHOP " << mallShops[i].id << " -----------\n";
-        cout << "Name: " << mallShops[i].name << "\n";
-        cout << "Time: " << minToTime(mallShops[i].open_time)
-             << " - " << minToTime(mallShops[i].close_time) << "\n";
-        cout << "Revenue: " << mallShops[i].revenue << "\n";
+    if (mallCtx->shops.empty()) { cout << "No shops.\n"; return; }
+
+    for (size_t i = 0; i < mallCtx->shops.size(); i++) {
+        cout << "\n----------- SHOP " << mallCtx->shops[i].id << " -----------\n";
+        cout << "Name: " << mallCtx->shops[i].name << "\n";
+        cout << "Time: " << minToTime(mallCtx->shops[i].open_time)
+             << " - " << minToTime(mallCtx->shops[i].close_time) << "\n";
+        cout << "Revenue: " << mallCtx->shops[i].revenue << "\n";
         cout << "Items:\n";
-        if (!mallShops[i].root) cout << "  (empty)\n";
-        else itemManager.inorder(mallShops[i].root);
+        if (!mallCtx->shops[i].root) cout << "  (empty)\n";
+        else itemManager.inorder(mallCtx->shops[i].root);
     }
 }
 
@@ -287,15 +291,15 @@ void simulateCustomer() {
     cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < shopCount; i++)
-        if (mallShops[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->shops.size(); i++)
+        if (mallCtx->shops[i].id == id) idx = i;
 
-    if (idx == -1 || !mallShops[idx].root) {
+    if (idx == -1 || !mallCtx->shops[idx].root) {
         cout << "Invalid shop or no items.\n";
         return;
     }
 
-    ItemNode *cur = mallShops[idx].root;
+    ItemNode *cur = mallCtx->shops[idx].root;
     while (cur->left) cur = cur->left;
 
     if (cur->stock <= 0) { cout << "Out of stock.\n"; return; }
@@ -304,23 +308,24 @@ void simulateCustomer() {
     qty = min(qty, cur->stock);
 
     cur->stock -= qty;
-    mallShops[idx].revenue += qty * cur->price;
+    mallCtx->shops[idx].revenue += qty * cur->price;
 
     cout << "Sold " << qty << " of " << cur->name << "\n";
 }
 
 void sortShopsByRevenue() {
-    if (shopCount == 0) { cout << "No shops.\n"; return; }
+    if (mallCtx->shops.empty()) { cout << "No shops.\n"; return; }
 
-    int arr[MALL_MAX_SHOPS];
+    int shopCount = mallCtx->shops.size();
+    vector<int> arr(shopCount);
     for (int i = 0; i < shopCount; i++) arr[i] = i;
 
-    quickSortShops(arr, 0, shopCount - 1);
+    quickSortShops(arr.data(), 0, shopCount - 1);
 
     cout << "\n--- Shops sorted (high → low revenue) ---\n";
-    for (int i = 0; i < shopCount; i++) {
-        cout << mallShops[arr[i]].name
-             << " | Rs " << mallShops[arr[i]].revenue << "\n";
+    for (size_t i = 0; i < mallCtx->shops.size(); i++) {
+        cout << mallCtx->shops[arr[i]].name
+             << " | Rs " << mallCtx->shops[arr[i]].revenue << "\n";
     }
 }
 
@@ -329,30 +334,31 @@ void sortShopsByRevenue() {
 // =====================================================
 
 void addStaff() {
-    if (staffCount >= MALL_MAX_STAFF) {
+    if (mallCtx->staff.size() >= MALL_MAX_STAFF) {
         cout << "Staff limit reached.\n";
         return;
     }
 
     cin.ignore();
+    Staff st = {};
     cout << "Staff name: ";
-    getline(cin, staffList[staffCount].name);
+    getline(cin, st.name);
     cout << "Role: ";
-    getline(cin, staffList[staffCount].role);
+    getline(cin, st.role);
     cout << "Salary: ";
-    cin >> staffList[staffCount].salary;
+    cin >> st.salary;
 
-    staffList[staffCount].id = staffCount + 1;
-    staffCount++;
+    st.id = mallCtx->staff.size() + 1;
+    mallCtx->staff.push_back(st);
     cout << "Staff added.\n";
 }
 
 void showStaff() {
-    for (int i = 0; i < staffCount; i++) {
-        cout << staffList[i].id << ") "
-             << staffList[i].name << " - "
-             << staffList[i].role << " - Rs "
-             << staffList[i].salary << "\n";
+    for (size_t i = 0; i < mallCtx->staff.size(); i++) {
+        cout << mallCtx->staff[i].id << ") "
+             << mallCtx->staff[i].name << " - "
+             << mallCtx->staff[i].role << " - Rs "
+             << mallCtx->staff[i].salary << "\n";
     }
 }
 
@@ -361,20 +367,17 @@ void deleteStaff() {
     int id; cin >> id;
 
     int idx = -1;
-    for (int i = 0; i < staffCount; i++)
-        if (staffList[i].id == id) idx = i;
+    for (size_t i = 0; i < mallCtx->staff.size(); i++)
+        if (mallCtx->staff[i].id == id) idx = i;
 
     if (idx == -1) { cout << "Staff not found.\n"; return; }
 
-    for (int i = idx; i < staffCount - 1; i++)
-        staffList[i] = staffList[i + 1];
-
-    staffCount--;
+    mallCtx->staff.erase(mallCtx->staff.begin() + idx);
     cout << "Staff removed.\n";
 }
 
 void scheduleCleaner() {
-    if (cleanCount >= MALL_MAX_CLEAN) {
+    if (mallCtx->cleanLog.size() >= MALL_MAX_CLEAN) {
         cout << "Cleaner log full.\n";
         return;
     }
@@ -387,15 +390,13 @@ void scheduleCleaner() {
     cout << "Note: ";
     getline(cin, note);
 
-    cleanLog[cleanCount].time = timeToMin(t);
-    cleanLog[cleanCount].note = note;
-    cleanCount++;
+    mallCtx->cleanLog.push_back({ timeToMin(t), note });
 }
 
 void showCleanLog() {
-    for (int i = 0; i < cleanCount; i++)
-        cout << minToTime(cleanLog[i].time)
-             << " - " << cleanLog[i].note << "\n";
+    for (size_t i = 0; i < mallCtx->cleanLog.size(); i++)
+        cout << minToTime(mallCtx->cleanLog[i].time)
+             << " - " << mallCtx->cleanLog[i].note << "\n";
 }
 
 // =====================================================
@@ -419,26 +420,39 @@ int splitCSV(const string &line, string out[], int maxCols) {
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int countRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 int loadShopsCSV(const string &f) {
     ifstream in(f);
     if (!in.is_open()) { cout << "ERROR loading " << f << "\n"; return 0; }
 
+    mallCtx->shops.reserve(mallCtx->shops.size() + min(countRows(in), MALL_MAX_SHOPS));
     string line; getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
-        if (shopCount >= MALL_MAX_SHOPS) break;
+        if (mallCtx->shops.size() >= MALL_MAX_SHOPS) break;
         string c[5];
         if (splitCSV(line, c, 5) < 4) continue;
 
-        mallShops[shopCount].id = createShopID();
-        mallShops[shopCount].name = c[0];
-        mallShops[shopCount].open_time = timeToMin(c[1]);
-        mallShops[shopCount].close_time = timeToMin(c[2]);
-        mallShops[shopCount].revenue = toInt(c[3]);
-        mallShops[shopCount].root = NULL;
+        Shop sh = {};
+        sh.id = createShopID();
+        sh.name = c[0];
+        sh.open_time = timeToMin(c[1]);
+        sh.close_time = timeToMin(c[2]);
+        sh.revenue = toInt(c[3]);
+        sh.root = NULL;
+        mallCtx->shops.push_back(sh);
 
-        shopCount++; loaded++;
+        loaded++;
     }
     cout << "Loaded " << loaded << " shops.\n";
     return loaded;
@@ -456,11 +470,11 @@ int loadItemsCSV(const string &f) {
         if (splitCSV(line, c, 5) < 4) continue;
         int id = toInt(c[0]);
 
-        for (int i = 0; i < shopCount; i++)
-            if (mallShops[i].id == id)
-                mallShops[i].root =
+        for (size_t i = 0; i < mallCtx->shops.size(); i++)
+            if (mallCtx->shops[i].id == id)
+                mallCtx->shops[i].root =
                     itemManager.insertNode(
-                        mallShops[i].root,
+                        mallCtx->shops[i].root,
                         c[1], toInt(c[2]), toInt(c[3])
                     );
         loaded++;
@@ -473,17 +487,18 @@ int loadStaffCSV(const string &f) {
     ifstream in(f);
     if (!in.is_open()) { cout << "ERROR loading " << f << "\n"; return 0; }
 
+    mallCtx->staff.reserve(mallCtx->staff.size() + min(countRows(in), MALL_MAX_STAFF));
     string line; getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
-        if (staffCount >= MALL_MAX_STAFF) break;
+        if (mallCtx->staff.size() >= MALL_MAX_STAFF) break;
         string c[5];
         if (splitCSV(line, c, 5) < 3) continue;
 
-        staffList[staffCount++] = {
-            staffCount + 1, c[0], c[1], toInt(c[2])
-        };
+        mallCtx->staff.push_back({
+            (int)mallCtx->staff.size() + 1, c[0], c[1], toInt(c[2])
+        });
         loaded++;
     }
     cout << "Loaded " << loaded << " staff.\n";
@@ -568,7 +583,7 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
     string patt = pattern;
     transform(patt.begin(), patt.end(), patt.begin(), ::tolower);
 
-    for (int s = 0; s < shopCount; s++) {
+    for (size_t s = 0; s < mallCtx->shops.size(); s++) {
         function<void(ItemNode*)> dfs = [&](ItemNode *node) {
             if (!node) return;
 
@@ -579,8 +594,8 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
 
             if (kmpSearch(item, patt)) {
                 results.push_back({
-                    mallShops[s].id,
-                    mallShops[s].name,
+                    mallCtx->shops[s].id,
+                    mallCtx->shops[s].name,
                     node->name,
                     node->price,
                     node->stock
@@ -590,7 +605,7 @@ vector<SearchResult> searchItemInMall(const string &pattern) {
             dfs(node->right);
         };
 
-        dfs(mallShops[s].root);
+        dfs(mallCtx->shops[s].root);
     }
 
     return results;
@@ -655,7 +670,13 @@ void showMenu() {
     cout << "Enter choice: ";
 }
 
+void mallInitModule() {
+    if (mallCtx) return; // state is kept across visits to the menu
+    mallCtx = new MallContext();
+}
+
 void mallSystem() {
+    mallInitModule();
     srand(time(NULL));
     int choice;
     while (true) {
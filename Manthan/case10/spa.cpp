@@ -7,6 +7,9 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include "../city_dict.h"
 using namespace std;
 
 // ---------------- CONFIG ----------------
@@ -26,7 +29,7 @@ struct SpaCustomer {
 struct SpaStaff {
     int id;
     string name;
-    string role;       // Therapist / Receptionist / Manager
+    CityCode role;     // spaRoles: Therapist / Receptionist / Manager
     string specialty;  // For therapists
     int available;     // 1 = free, 0 = busy
 };
@@ -44,28 +47,36 @@ struct SpaAppointment {
     int serviceId;
     int staffId;
     string timeSlot;
-    string status; // Booked / InProgress / Completed
+    CityCode status; // spaApptStatus: Booked / InProgress / Completed
 };
 
 struct SpaBill {
     int id;
     int appointmentId;
     double amount;
-    string status; // Pending / Paid
+    CityCode status; // spaBillStatus: Pending / Paid
 };
 
-// ---------------- STORAGE ----------------
-SpaCustomer customers[SPA_MAX_CUSTOMERS];
-SpaStaff staff[SPA_MAX_STAFF];
-SpaService services[SPA_MAX_SERVICES];
-SpaAppointment appointments[SPA_MAX_APPOINTMENTS];
-SpaBill bills[SPA_MAX_BILLS];
-
-int customerCount = 0;
-int staffCount = 0;
-int serviceCount = 0;
-int appointmentCount = 0;
-int billCount = 0;
+// ---------------- STATUS / ROLE CODES ----------------
+// Interned with city_dict.h: the seeded values have the fixed codes below,
+// anything else found in the CSVs is appended on load.
+CityDict spaRoles = cityDictMake({"Therapist", "Receptionist", "Manager"});
+CityDict spaApptStatus = cityDictMake({"Booked", "InProgress", "Completed"});
+CityDict spaBillStatus = cityDictMake({"Pending", "Paid"});
+enum { SPA_THERAPIST, SPA_RECEPTIONIST, SPA_MANAGER };
+enum { SPA_BOOKED, SPA_IN_PROGRESS, SPA_COMPLETED };
+enum { SPA_BILL_PENDING, SPA_BILL_PAID };
+
+// ---------------- MODULE CONTEXT ----------------
+// Created by spaInitModule(); SPA_MAX_* cap the row counts.
+struct SpaContext {
+    vector<SpaCustomer> customers;
+    vector<SpaStaff> staff;
+    vector<SpaService> services;
+    vector<SpaAppointment> appointments;
+    vector<SpaBill> bills;
+};
+SpaContext *spaCtx = NULL;
 
 // ---------------- CSV HELPER ----------------
 int splitCSV(const string &line, string out[], int maxCols) {
@@ -77,15 +88,27 @@ int splitCSV(const string &line, string out[], int maxCols) {
     return i;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int spaCountRows(ifstream &f) {
+    int rows = 0;
+    string line;
+    while (getline(f, line))
+        rows++;
+    f.clear();
+    f.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------------- LOAD CSVs ----------------
 void spaLoadCustomers() {
     ifstream f("spa_customers.csv");
     if (!f) return;
     string line, c[4];
+    spaCtx->customers.reserve(spaCtx->customers.size() + min(spaCountRows(f), SPA_MAX_CUSTOMERS));
     getline(f, line);
-    while (getline(f, line) && customerCount < SPA_MAX_CUSTOMERS) {
+    while (getline(f, line) && spaCtx->customers.size() < SPA_MAX_CUSTOMERS) {
         splitCSV(line, c, 4);
-        customers[customerCount++] = {stoi(c[0]), c[1], c[2]};
+        spaCtx->customers.push_back({stoi(c[0]), c[1], c[2]});
     }
 }
 
@@ -93,12 +116,13 @@ void spaLoadStaff() {
     ifstream f("spa_staff.csv");
     if (!f) return;
     string line, c[6];
+    spaCtx->staff.reserve(spaCtx->staff.size() + min(spaCountRows(f), SPA_MAX_STAFF));
     getline(f, line);
-    while (getline(f, line) && staffCount < SPA_MAX_STAFF) {
+    while (getline(f, line) && spaCtx->staff.size() < SPA_MAX_STAFF) {
         splitCSV(line, c, 6);
-        staff[staffCount++] = {
-            stoi(c[0]), c[1], c[2], c[3], stoi(c[4])
-        };
+        spaCtx->staff.push_back({
+            stoi(c[0]), c[1], cityIntern(spaRoles, c[2]), c[3], stoi(c[4])
+        });
     }
 }
 
@@ -106,12 +130,13 @@ void spaLoadServices() {
     ifstream f("spa_services.csv");
     if (!f) return;
     string line, c[5];
+    spaCtx->services.reserve(spaCtx->services.size() + min(spaCountRows(f), SPA_MAX_SERVICES));
     getline(f, line);
-    while (getline(f, line) && serviceCount < SPA_MAX_SERVICES) {
+    while (getline(f, line) && spaCtx->services.size() < SPA_MAX_SERVICES) {
         splitCSV(line, c, 5);
-        services[serviceCount++] = {
+        spaCtx->services.push_back({
             stoi(c[0]), c[1], stoi(c[2]), stod(c[3])
-        };
+        });
     }
 }
 
@@ -119,33 +144,34 @@ void spaLoadAppointments() {
     ifstream f("spa_appointments.csv");
     if (!f) return;
     string line, c[6];
+    spaCtx->appointments.reserve(spaCtx->appointments.size() + min(spaCountRows(f), SPA_MAX_APPOINTMENTS));
     getline(f, line);
-    while (getline(f, line) && appointmentCount < SPA_MAX_APPOINTMENTS) {
+    while (getline(f, line) && spaCtx->appointments.size() < SPA_MAX_APPOINTMENTS) {
         splitCSV(line, c, 6);
-        appointments[appointmentCount++] = {
+        spaCtx->appointments.push_back({
             stoi(c[0]), stoi(c[1]), stoi(c[2]),
-            stoi(c[3]), c[4], c[5]
-        };
+            stoi(c[3]), c[4], cityIntern(spaApptStatus, c[5])
+        });
     }
 }
 string spaGetCustomerName(int id) {
-    for (int i = 0; i < customerCount; i++)
-        if (customers[i].id == id)
-            return customers[i].name;
+    for (int i = 0; i < (int)spaCtx->customers.size(); i++)
+        if (spaCtx->customers[i].id == id)
+            return spaCtx->customers[i].name;
     return "Unknown";
 }
 
 string spaGetStaffName(int id) {
-    for (int i = 0; i < staffCount; i++)
-        if (staff[i].id == id)
-            return staff[i].name;
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++)
+        if (spaCtx->staff[i].id == id)
+            return spaCtx->staff[i].name;
     return "Unassigned";
 }
 
 string spaGetServiceName(int id) {
-    for (int i = 0; i < serviceCount; i++)
-        if (services[i].id == id)
-            return services[i].name;
+    for (int i = 0; i < (int)spaCtx->services.size(); i++)
+        if (spaCtx->services[i].id == id)
+            return spaCtx->services[i].name;
     return "Unknown";
 }
 
@@ -157,40 +183,42 @@ void spaLoadAll() {
     spaLoadAppointments();
 
     cout << "\nLoaded:\n";
-    cout << customerCount << " customers\n";
-    cout << staffCount << " staff\n";
-    cout << serviceCount << " services\n";
-    cout << appointmentCount << " appointments\n";
+    cout << spaCtx->customers.size() << " customers\n";
+    cout << spaCtx->staff.size() << " staff\n";
+    cout << spaCtx->services.size() << " services\n";
+    cout << spaCtx->appointments.size() << " appointments\n";
 }
 
 // ---------------- STAFF MANAGEMENT ----------------
 void spaListStaff() {
     cout << "\n--- STAFF LIST ---\n";
-    for (int i = 0; i < staffCount; i++) {
-        cout << "ID:" << staff[i].id
-             << " | " << staff[i].name
-             << " | Role:" << staff[i].role
-             << " | Spec:" << staff[i].specialty
-             << " | " << (staff[i].available ? "Available" : "Busy") << "\n";
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++) {
+        cout << "ID:" << spaCtx->staff[i].id
+             << " | " << spaCtx->staff[i].name
+             << " | Role:" << cityDictName(spaRoles, spaCtx->staff[i].role)
+             << " | Spec:" << spaCtx->staff[i].specialty
+             << " | " << (spaCtx->staff[i].available ? "Available" : "Busy") << "\n";
     }
 }
 
 void spaAddStaff() {
-    if (staffCount >= SPA_MAX_STAFF) return;
+    if (spaCtx->staff.size() >= SPA_MAX_STAFF) return;
 
-    SpaStaff &s = staff[staffCount];
-    s.id = staffCount + 1;
+    SpaStaff s;
+    s.id = spaCtx->staff.size() + 1;
 
     cout << "Name: ";
     cin.ignore();
     getline(cin, s.name);
     cout << "Role: ";
-    getline(cin, s.role);
+    string role;
+    getline(cin, role);
+    s.role = cityIntern(spaRoles, role);
     cout << "Specialty: ";
     getline(cin, s.specialty);
 
     s.available = 1;
-    staffCount++;
+    spaCtx->staff.push_back(s);
 
     cout << "Staff added\n";
 }
@@ -200,10 +228,10 @@ void spaRemoveStaff() {
     cout << "Staff ID to remove: ";
     cin >> id;
 
-    for (int i = 0; i < staffCount; i++) {
-        if (staff[i].id == id) {
-            staff[i] = staff[staffCount - 1];
-            staffCount--;
+    for (int i = 0; i < (int)spaCtx->staff.size(); i++) {
+        if (spaCtx->staff[i].id == id) {
+            spaCtx->staff[i] = spaCtx->staff.back();
+            spaCtx->staff.pop_back();
             cout << "Staff removed\n";
             return;
         }
@@ -213,8 +241,10 @@ void spaRemoveStaff() {
 
 // ---------------- APPOINTMENTS ----------------
 void spaBookAppointment() {
-    SpaAppointment &a = appointments[appointmentCount];
-    a.id = appointmentCount + 1;
+    if (spaCtx->appointments.size() >= SPA_MAX_APPOINTMENTS) return;
+
+    SpaAppointment a;
+    a.id = spaCtx->appointments.size() + 1;
 
     cout << "Customer ID: ";
     cin >> a.customerId;
@@ -224,8 +254,8 @@ void spaBookAppointment() {
     cin >> a.timeSlot;
 
     a.staffId = -1;
-    a.status = "Booked";
-    appointmentCount++;
+    a.status = SPA_BOOKED;
+    spaCtx->appointments.push_back(a);
 
     cout << "Appointment booked\n";
 }
@@ -235,22 +265,22 @@ void spaAssignStaff() {
     cout << "Appointment ID: ";
     cin >> aid;
 
-    for (int i = 0; i < appointmentCount; i++) {
-        if (appointments[i].id == aid &&
-            appointments[i].status == "Booked") {
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        if (spaCtx->appointments[i].id == aid &&
+            spaCtx->appointments[i].status == SPA_BOOKED) {
 
-            for (int s = 0; s < staffCount; s++) {
-                if (staff[s].available &&
-                    staff[s].role == "Therapist") {
+            for (int s = 0; s < (int)spaCtx->staff.size(); s++) {
+                if (spaCtx->staff[s].available &&
+                    spaCtx->staff[s].role == SPA_THERAPIST) {
 
-                    appointments[i].staffId = staff[s].id;
-                    appointments[i].status = "InProgress";
-                    staff[s].available = 0;
+                    spaCtx->appointments[i].staffId = spaCtx->staff[s].id;
+                    spaCtx->appointments[i].status = SPA_IN_PROGRESS;
+                    spaCtx->staff[s].available = 0;
 
                     cout << "Assigning "
-                         << spaGetStaffName(staff[s].id)
+                         << spaGetStaffName(spaCtx->staff[s].id)
                          << " to "
-                         << spaGetCustomerName(appointments[i].customerId)
+                         << spaGetCustomerName(spaCtx->appointments[i].customerId)
                          << "\n";
 
                     return;
@@ -267,26 +297,30 @@ void spaCompleteAppointment() {
     cout << "Appointment ID: ";
     cin >> aid;
 
-    for (int i = 0; i < appointmentCount; i++) {
-        if (appointments[i].id == aid &&
-            appointments[i].status == "InProgress") {
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        if (spaCtx->appointments[i].id == aid &&
+            spaCtx->appointments[i].status == SPA_IN_PROGRESS) {
 
-            appointments[i].status = "Completed";
+            spaCtx->appointments[i].status = SPA_COMPLETED;
 
-            for (int s = 0; s < staffCount; s++)
-                if (staff[s].id == appointments[i].staffId)
-                    staff[s].available = 1;
+            for (int s = 0; s < (int)spaCtx->staff.size(); s++)
+                if (spaCtx->staff[s].id == spaCtx->appointments[i].staffId)
+                    spaCtx->staff[s].available = 1;
 
-            SpaBill &b = bills[billCount];
-            b.id = billCount + 1;
+            if (spaCtx->bills.size() >= SPA_MAX_BILLS) {
+                cout << "Completed; bill storage full\n";
+                return;
+            }
+            SpaBill b = {};
+            b.id = spaCtx->bills.size() + 1;
             b.appointmentId = aid;
-            b.status = "Pending";
+            b.status = SPA_BILL_PENDING;
 
-            for (int j = 0; j < serviceCount; j++)
-                if (services[j].id == appointments[i].serviceId)
-                    b.amount = services[j].price;
+            for (int j = 0; j < (int)spaCtx->services.size(); j++)
+                if (spaCtx->services[j].id == spaCtx->appointments[i].serviceId)
+                    b.amount = spaCtx->services[j].price;
 
-            billCount++;
+            spaCtx->bills.push_back(b);
             cout << "Completed & billed\n";
             return;
         }
@@ -297,18 +331,24 @@ void spaCompleteAppointment() {
 // ---------------- LIST APPOINTMENTS ----------------
 void spaListAppointments() {
     cout << "\n--- APPOINTMENTS ---\n";
-    for (int i = 0; i < appointmentCount; i++) {
-        cout << "ApptID:" << appointments[i].id
-             << " | Customer: " << spaGetCustomerName(appointments[i].customerId)
-             << " | Service: " << spaGetServiceName(appointments[i].serviceId)
-             << " | Staff: " << spaGetStaffName(appointments[i].staffId)
-             << " | [" << appointments[i].status << "]\n";
+    for (int i = 0; i < (int)spaCtx->appointments.size(); i++) {
+        cout << "ApptID:" << spaCtx->appointments[i].id
+             << " | Customer: " << spaGetCustomerName(spaCtx->appointments[i].customerId)
+             << " | Service: " << spaGetServiceName(spaCtx->appointments[i].serviceId)
+             << " | Staff: " << spaGetStaffName(spaCtx->appointments[i].staffId)
+             << " | [" << cityDictName(spaApptStatus, spaCtx->appointments[i].status) << "]\n";
     }
 }
 
 
 // ---------------- MENU ----------------
+void spaInitModule() {
+    if (spaCtx) return; // state is kept across visits to the menu
+    spaCtx = new SpaContext();
+}
+
 void spaMenu() {
+    spaInitModule();
     int ch;
     do {
         cout << "\n==== SPA MANAGEMENT ====\n";
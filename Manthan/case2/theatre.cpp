@@ -11,6 +11,9 @@
 #include <functional>
 #include <cstring> // for strncpy
 #include <limits>
+#include "../city_date.h"
+#include "../city_dict.h"
+#include "../city_ring.h"
 
 using namespace std;
 
@@ -25,7 +28,7 @@ using namespace std;
 #define THEATRE_MAX_SNACK_ORDERS 20000
 #define THEATRE_MAX_STAFF 2000
 #define THEATRE_MAX_MAINT_LOGS 5000
-#define THEATRE_HASH_SIZE 32749
+#define THEATRE_HASH_MIN 64 // initial booking slots (power of two)
 #define THEATRE_INF 999999
 
 // -------------------- SIMPLE CSV & UTIL HELPERS --------------------
@@ -51,6 +54,17 @@ int theatreSplitCSV(const string &line, string out[], int maxCols) {
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int theatreCountRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line))
+        rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // -------------------- DATA STRUCTS --------------------
 // Movie BST (manual pointers)
 struct TheatreMovie
@@ -61,12 +75,12 @@ struct TheatreMovie
     int duration_minutes;
     double rating;
     string language;
-    string release_date;
+    CityDate release_date;
     TheatreMovie *left;
     TheatreMovie *right;
 };
 
-// Auditorium (array-based seats)
+// Auditorium (row-major seat grid sized rows*cols, seat (r,c) at r*cols+c)
 struct TheatreAuditorium
 {
     int aud_id;
@@ -74,8 +88,8 @@ struct TheatreAuditorium
     int rows;
     int cols;
     int total_seats;
-    char seats[THEATRE_MAX_SEAT_ROWS][THEATRE_MAX_SEAT_COLS]; // 'E','B','X'
-    string seat_type[THEATRE_MAX_SEAT_ROWS][THEATRE_MAX_SEAT_COLS];
+    vector<char> seats; // 'E','B','X'
+    vector<CityCode> seat_type; // theatreSeatTypes code per seat
 };
 
 // Show (array)
@@ -84,8 +98,8 @@ struct TheatreShow
     int show_id;
     int movie_id;
     int aud_id;
-    string start_datetime; // "YYYY-MM-DD HH:MM"
-    string end_datetime;
+    CityDateTime start_datetime; // minutes since epoch, printed as "YYYY-MM-DD HH:MM"
+    CityDateTime end_datetime;
     int base_price;
     int tickets_sold;
     int revenue;
@@ -101,7 +115,7 @@ struct TheatreBooking
     char customer_phone[20];
     int price_paid;
     int status; // 0 cancelled, 1 active
-    char booking_datetime[32];
+    CityDateTime booking_datetime;
 };
 
 // booking hash entry
@@ -133,7 +147,7 @@ struct TheatreSnackOrder
     int item_count;
     int total_price;
     int status; // 0 pending,1 inprogress,2 done
-    char order_datetime[32];
+    CityDateTime order_datetime;
 };
 
 // staff & maintenance
@@ -148,52 +162,45 @@ struct TheatreMaint
 {
     int id;
     int aud_id;
-    string date;
+    CityDate date;
     string task;
     int staff_id;
     int status;
 };
 
-// -------------------- MODULE GLOBALS --------------------
-static TheatreMovie *theatreMovieRoot = NULL;
-static TheatreAuditorium auditoriums[THEATRE_MAX_AUDITORIUMS];
-static int theatreAudCount = 0;
+// seat types seen in auditoriums.csv; "standard" is the default
+static CityDict theatreSeatTypes = cityDictMake({"standard"});
+#define THEATRE_SEAT_STANDARD 0
+
+// -------------------- MODULE CONTEXT --------------------
+// Created by theatreInitModule() on first use; THEATRE_MAX_* cap the row counts.
+struct TheatreContext
+{
+    vector<TheatreAuditorium> auditoriums;
+    vector<TheatreShow> shows;
+    vector<TheatreBookingEntry> bookingHash; // power-of-two slots
+    vector<TheatreSnack> snacks;
+    vector<TheatreSnackOrder> snackQueue;    // ring buffer, grown on demand
+    vector<TheatreStaff> staff;
+    vector<TheatreMaint> maint;
+};
+static TheatreContext *theatreCtx = NULL;
 
-static TheatreShow shows[THEATRE_MAX_SHOWS];
-static int theatreShowCount = 0;
+inline char &theatre_seat(TheatreAuditorium &a, int r, int c) { return a.seats[r * a.cols + c]; }
 
-static TheatreBookingEntry bookingHash[THEATRE_HASH_SIZE];
+// -------------------- MODULE GLOBALS --------------------
+static TheatreMovie *theatreMovieRoot = NULL;
 static int theatreBookingCount = 0;
+static int theatreBookingSlotsUsed = 0; // live + deleted slots, drives rehash
 static int theatreNextBookingId = 50000;
-
-static TheatreSnack snacks[THEATRE_MAX_SNACKS];
-static int theatreSnackCount = 0;
-
-static TheatreSnackOrder snackQueueArr[THEATRE_MAX_SNACK_ORDERS];
 static int snackQueueFront = 0, snackQueueRear = -1, snackQueueCount = 0;
 
-static TheatreStaff theatreStaff[THEATRE_MAX_STAFF];
-static int theatreStaffCount = 0;
-static TheatreMaint theatreMaint[THEATRE_MAX_MAINT_LOGS];
-static int theatreMaintCount = 0;
-
 // auditorium graph for Dijkstra (matrix)
 
 
-// -------------------- SMALL HELPERS --------------------
-static string theatre_now_datetime()
-{
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[64];
-    sprintf(buf, "%04d-%02d-%02d %02d:%02d",
-            tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min);
-    return string(buf);
-}
-
 // -------------------- MOVIE BST FUNCTIONS --------------------
 TheatreMovie *theatreCreateMovieNode(int id, const string &title, const string &genre,
-                                     int duration, double rating, const string &lang, const string &rdate)
+                                     int duration, double rating, const string &lang, CityDate rdate)
 {
     TheatreMovie *m = new TheatreMovie();
     m->movie_id = id;
@@ -249,7 +256,7 @@ void theatreInorderList(TheatreMovie *root)
     theatreInorderList(root->left);
     cout << "ID:" << root->movie_id << " | " << root->title << " | " << root->genre
          << " | " << root->duration_minutes << "min | Rating:" << root->rating
-         << " | " << root->language << " | " << root->release_date << "\n";
+         << " | " << root->language << " | " << cityFormatDate(root->release_date) << "\n";
     theatreInorderList(root->right);
 }
 
@@ -339,11 +346,11 @@ void theatre_quickSort_indices(int arr[], int l, int r, IndexCmpFunc cmp)
     }
 }
 
-// comparator for shows by start_datetime (lexicographic compares works for YYYY-MM-DD HH:MM)
+// comparator for shows by start_datetime
 int theatre_cmp_show_start(int Aidx, int Bidx)
 {
-    string A = shows[Aidx].start_datetime;
-    string B = shows[Bidx].start_datetime;
+    CityDateTime A = theatreCtx->shows[Aidx].start_datetime;
+    CityDateTime B = theatreCtx->shows[Bidx].start_datetime;
     if (A < B)
         return -1;
     if (A > B)
@@ -354,9 +361,9 @@ int theatre_cmp_show_start(int Aidx, int Bidx)
 // comparator for shows by revenue (desc)
 int theatre_cmp_show_revenue(int Aidx, int Bidx)
 {
-    if (shows[Aidx].revenue > shows[Bidx].revenue)
+    if (theatreCtx->shows[Aidx].revenue > theatreCtx->shows[Bidx].revenue)
         return -1;
-    if (shows[Aidx].revenue < shows[Bidx].revenue)
+    if (theatreCtx->shows[Aidx].revenue < theatreCtx->shows[Bidx].revenue)
         return 1;
     return 0;
 }
@@ -452,19 +459,54 @@ bool theatre_kmp_search(const string &text, const string &pat)
 }
 
 // -------------------- BOOKING HASH (open addressing linear probing) --------------------
+// Power-of-two table, rebuilt twice as large (dropping tombstones) once live
+// plus deleted slots pass 70%.
 unsigned int theatre_hash_key(int key)
 {
-    return (unsigned int)(key * 2654435761u) % THEATRE_HASH_SIZE;
+    return (unsigned int)(key * 2654435761u) & (unsigned int)(theatreCtx->bookingHash.size() - 1);
 }
 void theatre_init_booking_hash()
 {
-    for (int i = 0; i < THEATRE_HASH_SIZE; ++i)
+    TheatreBookingEntry e;
+    e.key = -1;
+    e.used = false;
+    e.deleted = false;
+    theatreCtx->bookingHash.assign(THEATRE_HASH_MIN, e);
+    theatreBookingCount = 0;
+    theatreBookingSlotsUsed = 0;
+}
+static void theatre_booking_rehash(size_t slots)
+{
+    vector<TheatreBookingEntry> old;
+    old.swap(theatreCtx->bookingHash);
+    TheatreBookingEntry e;
+    e.key = -1;
+    e.used = false;
+    e.deleted = false;
+    theatreCtx->bookingHash.assign(slots, e);
+    theatreBookingSlotsUsed = theatreBookingCount;
+    unsigned int mask = (unsigned int)(slots - 1);
+    for (size_t i = 0; i < old.size(); ++i)
     {
-        bookingHash[i].used = false;
-        bookingHash[i].deleted = false;
-        bookingHash[i].key = -1;
+        if (!old[i].used || old[i].deleted)
+            continue;
+        unsigned int idx = theatre_hash_key(old[i].key);
+        while (theatreCtx->bookingHash[idx].used)
+            idx = (idx + 1) & mask;
+        theatreCtx->bookingHash[idx] = old[i];
     }
 }
+// Make room for `more` bookings without further rehashing.
+void theatre_booking_reserve(int more)
+{
+    size_t need = (size_t)(theatreBookingSlotsUsed + more) * 10 / 7 + 1;
+    if (need <= theatreCtx->bookingHash.size())
+        return;
+    size_t slots = theatreCtx->bookingHash.size();
+    while (slots < need)
+        slots *= 2;
+    theatre_booking_rehash(slots);
+}
 bool theatre_booking_insert(const TheatreBooking &b)
 {
     if (theatreBookingCount >= THEATRE_MAX_BOOKINGS)
@@ -472,56 +514,49 @@ bool theatre_booking_insert(const TheatreBooking &b)
         cout << "Overflow: booking capacity reached!\n";
         return false;
     }
+    if ((size_t)(theatreBookingSlotsUsed + 1) * 10 > theatreCtx->bookingHash.size() * 7)
+        theatre_booking_rehash(theatreCtx->bookingHash.size() * 2);
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(b.booking_id);
-    unsigned int start = idx;
-    while (bookingHash[idx].used && !bookingHash[idx].deleted && bookingHash[idx].key != b.booking_id)
-    {
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-        {
-            cout << "Hash table full!\n";
-            return false;
-        }
-    }
-    bookingHash[idx].used = true;
-    bookingHash[idx].deleted = false;
-    bookingHash[idx].key = b.booking_id;
-    bookingHash[idx].val = b;
+    while (theatreCtx->bookingHash[idx].used && !theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key != b.booking_id)
+        idx = (idx + 1) & mask;
+    if (!theatreCtx->bookingHash[idx].used)
+        theatreBookingSlotsUsed++;
+    theatreCtx->bookingHash[idx].used = true;
+    theatreCtx->bookingHash[idx].deleted = false;
+    theatreCtx->bookingHash[idx].key = b.booking_id;
+    theatreCtx->bookingHash[idx].val = b;
     theatreBookingCount++;
     return true;
 }
 bool theatre_booking_get(int key, TheatreBooking &out)
 {
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(key);
-    unsigned int start = idx;
-    while (bookingHash[idx].used)
+    while (theatreCtx->bookingHash[idx].used)
     {
-        if (!bookingHash[idx].deleted && bookingHash[idx].key == key)
+        if (!theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key == key)
         {
-            out = bookingHash[idx].val;
+            out = theatreCtx->bookingHash[idx].val;
             return true;
         }
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-            break;
+        idx = (idx + 1) & mask;
     }
     return false;
 }
 bool theatre_booking_remove(int key)
 {
+    unsigned int mask = (unsigned int)(theatreCtx->bookingHash.size() - 1);
     unsigned int idx = theatre_hash_key(key);
-    unsigned int start = idx;
-    while (bookingHash[idx].used)
+    while (theatreCtx->bookingHash[idx].used)
     {
-        if (!bookingHash[idx].deleted && bookingHash[idx].key == key)
+        if (!theatreCtx->bookingHash[idx].deleted && theatreCtx->bookingHash[idx].key == key)
         {
-            bookingHash[idx].deleted = true;
+            theatreCtx->bookingHash[idx].deleted = true;
             theatreBookingCount--;
             return true;
         }
-        idx = (idx + 1) % THEATRE_HASH_SIZE;
-        if (idx == start)
-            break;
+        idx = (idx + 1) & mask;
     }
     return false;
 }
@@ -540,8 +575,10 @@ bool theatre_enqueue_snack(const TheatreSnackOrder &ord)
         cout << "Overflow: snack queue full!\n";
         return false;
     }
-    snackQueueRear = (snackQueueRear + 1) % THEATRE_MAX_SNACK_ORDERS;
-    snackQueueArr[snackQueueRear] = ord;
+    if (snackQueueCount == (int)theatreCtx->snackQueue.size())
+        cityRingGrow(theatreCtx->snackQueue, snackQueueFront, snackQueueRear, snackQueueCount, THEATRE_MAX_SNACK_ORDERS);
+    snackQueueRear = (snackQueueRear + 1) % (int)theatreCtx->snackQueue.size();
+    theatreCtx->snackQueue[snackQueueRear] = ord;
     snackQueueCount++;
     return true;
 }
@@ -551,8 +588,8 @@ TheatreSnackOrder theatre_dequeue_snack()
     empty.order_id = -1;
     if (snackQueueCount == 0)
         return empty;
-    TheatreSnackOrder res = snackQueueArr[snackQueueFront];
-    snackQueueFront = (snackQueueFront + 1) % THEATRE_MAX_SNACK_ORDERS;
+    TheatreSnackOrder res = theatreCtx->snackQueue[snackQueueFront];
+    snackQueueFront = (snackQueueFront + 1) % (int)theatreCtx->snackQueue.size();
     snackQueueCount--;
     return res;
 }
@@ -589,7 +626,7 @@ void theatreLoadMoviesCSV(const string &fn)
         int dur = theatreToInt(cols[3]);
         double rating = atof(cols[4].c_str());
         string lang = cols[5];
-        string date = (n >= 7 ? cols[6] : "1970-01-01");
+        CityDate date = (n >= 7 ? cityDate(cols[6]) : 0);
         TheatreMovie *m = theatreCreateMovieNode(id, title, genre, dur, rating, lang, date);
         theatreMovieRoot = theatreInsertMovieNode(theatreMovieRoot, m);
         loaded++;
@@ -606,6 +643,7 @@ void theatreLoadAuditoriumsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->auditoriums.reserve(theatreCtx->auditoriums.size() + min(theatreCountRows(in), THEATRE_MAX_AUDITORIUMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -617,26 +655,22 @@ void theatreLoadAuditoriumsCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 8);
         if (n < 4)
             continue;
-        if (theatreAudCount >= THEATRE_MAX_AUDITORIUMS)
+        if ((int)theatreCtx->auditoriums.size() >= THEATRE_MAX_AUDITORIUMS)
         {
             cout << "Overflow: auditoriums max reached!\n";
             break;
         }
-        int id = theatreToInt(cols[0]);
-        auditoriums[theatreAudCount].aud_id = id;
-        auditoriums[theatreAudCount].name = cols[1];
-        int r = min(theatreToInt(cols[2]), THEATRE_MAX_SEAT_ROWS);
-        int c = min(theatreToInt(cols[3]), THEATRE_MAX_SEAT_COLS);
-        auditoriums[theatreAudCount].rows = r;
-        auditoriums[theatreAudCount].cols = c;
-        auditoriums[theatreAudCount].total_seats = r * c;
-        for (int i = 0; i < r; ++i)
-            for (int j = 0; j < c; ++j)
-            {
-                auditoriums[theatreAudCount].seats[i][j] = 'E';
-                auditoriums[theatreAudCount].seat_type[i][j] = "standard";
-            }
-        theatreAudCount++;
+        TheatreAuditorium a;
+        a.aud_id = theatreToInt(cols[0]);
+        a.name = cols[1];
+        int r = max(0, min(theatreToInt(cols[2]), THEATRE_MAX_SEAT_ROWS));
+        int c = max(0, min(theatreToInt(cols[3]), THEATRE_MAX_SEAT_COLS));
+        a.rows = r;
+        a.cols = c;
+        a.total_seats = r * c;
+        a.seats.assign(r * c, 'E');
+        a.seat_type.assign(r * c, (n >= 5 && !cols[4].empty()) ? cityIntern(theatreSeatTypes, cols[4]) : (CityCode)THEATRE_SEAT_STANDARD);
+        theatreCtx->auditoriums.push_back(a);
         loaded++;
     }
     
@@ -652,6 +686,7 @@ void theatreLoadShowsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->shows.reserve(theatreCtx->shows.size() + min(theatreCountRows(in), THEATRE_MAX_SHOWS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -663,20 +698,21 @@ void theatreLoadShowsCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 8);
         if (n < 6)
             continue;
-        if (theatreShowCount >= THEATRE_MAX_SHOWS)
+        if ((int)theatreCtx->shows.size() >= THEATRE_MAX_SHOWS)
         {
             cout << "Overflow: shows max reached!\n";
             break;
         }
-        shows[theatreShowCount].show_id = theatreToInt(cols[0]);
-        shows[theatreShowCount].movie_id = theatreToInt(cols[1]);
-        shows[theatreShowCount].aud_id = theatreToInt(cols[2]);
-        shows[theatreShowCount].start_datetime = cols[3];
-        shows[theatreShowCount].end_datetime = cols[4];
-        shows[theatreShowCount].base_price = theatreToInt(cols[5]);
-        shows[theatreShowCount].tickets_sold = 0;
-        shows[theatreShowCount].revenue = 0;
-        theatreShowCount++;
+        TheatreShow sh;
+        sh.show_id = theatreToInt(cols[0]);
+        sh.movie_id = theatreToInt(cols[1]);
+        sh.aud_id = theatreToInt(cols[2]);
+        sh.start_datetime = cityDateTime(cols[3]);
+        sh.end_datetime = cityDateTime(cols[4]);
+        sh.base_price = theatreToInt(cols[5]);
+        sh.tickets_sold = 0;
+        sh.revenue = 0;
+        theatreCtx->shows.push_back(sh);
         loaded++;
     }
     cout << "Loaded " << loaded << " shows from " << fn << "\n";
@@ -691,6 +727,7 @@ void theatreLoadBookingsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatre_booking_reserve(min(theatreCountRows(in), THEATRE_MAX_BOOKINGS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -713,18 +750,15 @@ void theatreLoadBookingsCSV(const string &fn)
         b.customer_phone[sizeof(b.customer_phone) - 1] = 0;
         b.price_paid = theatreToInt(cols[5]);
         b.status = theatreToInt(cols[6]);
-        if (n >= 8)
-            strncpy(b.booking_datetime, cols[7].c_str(), sizeof(b.booking_datetime) - 1);
-        else
-            strncpy(b.booking_datetime, theatre_now_datetime().c_str(), sizeof(b.booking_datetime) - 1);
+        b.booking_datetime = (n >= 8 ? cityDateTime(cols[7]) : cityNow());
         theatre_booking_insert(b);
         loaded++;
         // mark seat as booked in auditorium if possible
         int sidx = -1;
-        for (int i = 0; i < theatreShowCount; ++i) if (shows[i].show_id == b.show_id) { sidx = i; break; }
+        for (int i = 0; i < (int)theatreCtx->shows.size(); ++i) if (theatreCtx->shows[i].show_id == b.show_id) { sidx = i; break; }
         if (sidx != -1) {
             int aud_idx = -1;
-            for (int i = 0; i < theatreAudCount; ++i) if (auditoriums[i].aud_id == shows[sidx].aud_id) { aud_idx = i; break; }
+            for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i) if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id) { aud_idx = i; break; }
             if (aud_idx != -1) {
                 int rr, cc;
                 string seatl = string(b.seat_label);
@@ -737,8 +771,8 @@ void theatreLoadBookingsCSV(const string &fn)
                     if (colIdx < 0 || colIdx >= a.cols) return false;
                     r = rowIdx; c = colIdx; return true;
                 };
-                if (theatre_parse_seat_label_local(auditoriums[aud_idx], seatl, rr, cc)) {
-                    auditoriums[aud_idx].seats[rr][cc] = (b.status==1 ? 'B' : 'E');
+                if (theatre_parse_seat_label_local(theatreCtx->auditoriums[aud_idx], seatl, rr, cc)) {
+                    theatre_seat(theatreCtx->auditoriums[aud_idx], rr, cc) = (b.status==1 ? 'B' : 'E');
                 }
             }
         }
@@ -755,6 +789,7 @@ void theatreLoadStaffCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    theatreCtx->staff.reserve(theatreCtx->staff.size() + min(theatreCountRows(in), THEATRE_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -766,16 +801,17 @@ void theatreLoadStaffCSV(const string &fn)
         int n = theatreSplitCSV(line, cols, 6);
         if (n < 4)
             continue;
-        if (theatreStaffCount >= THEATRE_MAX_STAFF)
+        if ((int)theatreCtx->staff.size() >= THEATRE_MAX_STAFF)
         {
             cout << "Overflow: theatre staff max reached!\n";
             break;
         }
-        theatreStaff[theatreStaffCount].id = theatreToInt(cols[0]);
-        theatreStaff[theatreStaffCount].name = cols[1];
-        theatreStaff[theatreStaffCount].role = cols[2];
-        theatreStaff[theatreStaffCount].salary = theatreToInt(cols[3]);
-        theatreStaffCount++;
+        TheatreStaff st;
+        st.id = theatreToInt(cols[0]);
+        st.name = cols[1];
+        st.role = cols[2];
+        st.salary = theatreToInt(cols[3]);
+        theatreCtx->staff.push_back(st);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -814,7 +850,7 @@ void theatreAddMovie()
     getline(cin, lang);
     cout << "Enter release date (YYYY-MM-DD): ";
     getline(cin, date);
-    TheatreMovie *m = theatreCreateMovieNode(id, title, genre, theatreToInt(durS), atof(ratingS.c_str()), lang, date);
+    TheatreMovie *m = theatreCreateMovieNode(id, title, genre, theatreToInt(durS), atof(ratingS.c_str()), lang, cityDate(date));
     theatreMovieRoot = theatreInsertMovieNode(theatreMovieRoot, m);
     cout << "Added movie id " << id << "\n";
 }
@@ -876,12 +912,12 @@ void theatreSearchMovie()
 // Add auditorium interactively
 void theatreAddAuditorium()
 {
-    if (theatreAudCount >= THEATRE_MAX_AUDITORIUMS)
+    if ((int)theatreCtx->auditoriums.size() >= THEATRE_MAX_AUDITORIUMS)
     {
         cout << "Overflow: auditoriums limit\n";
         return;
     }
-    int id = 600 + theatreAudCount;
+    int id = 600 + (int)theatreCtx->auditoriums.size();
     string name, rS, cS;
     cout << "Enter auditorium name: ";
     getline(cin, name);
@@ -889,20 +925,17 @@ void theatreAddAuditorium()
     getline(cin, rS);
     cout << "Enter cols: ";
     getline(cin, cS);
-    int r = min(theatreToInt(rS), THEATRE_MAX_SEAT_ROWS);
-    int c = min(theatreToInt(cS), THEATRE_MAX_SEAT_COLS);
-    auditoriums[theatreAudCount].aud_id = id;
-    auditoriums[theatreAudCount].name = name;
-    auditoriums[theatreAudCount].rows = r;
-    auditoriums[theatreAudCount].cols = c;
-    auditoriums[theatreAudCount].total_seats = r * c;
-    for (int i = 0; i < r; ++i)
-        for (int j = 0; j < c; ++j)
-        {
-            auditoriums[theatreAudCount].seats[i][j] = 'E';
-            auditoriums[theatreAudCount].seat_type[i][j] = "standard";
-        }
-    theatreAudCount++;
+    int r = max(0, min(theatreToInt(rS), THEATRE_MAX_SEAT_ROWS));
+    int c = max(0, min(theatreToInt(cS), THEATRE_MAX_SEAT_COLS));
+    TheatreAuditorium a;
+    a.aud_id = id;
+    a.name = name;
+    a.rows = r;
+    a.cols = c;
+    a.total_seats = r * c;
+    a.seats.assign(r * c, 'E');
+    a.seat_type.assign(r * c, (CityCode)THEATRE_SEAT_STANDARD);
+    theatreCtx->auditoriums.push_back(a);
     cout << "Added auditorium id " << id << "\n";
 }
 
@@ -913,8 +946,8 @@ void theatreViewSeatMap()
     cin >> id;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     int idx = -1;
-    for (int i = 0; i < theatreAudCount; ++i)
-        if (auditoriums[i].aud_id == id)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+        if (theatreCtx->auditoriums[i].aud_id == id)
         {
             idx = i;
             break;
@@ -924,12 +957,12 @@ void theatreViewSeatMap()
         cout << "Not found.\n";
         return;
     }
-    TheatreAuditorium &a = auditoriums[idx];
+    TheatreAuditorium &a = theatreCtx->auditoriums[idx];
     cout << "Seat map for " << a.name << " (" << a.rows << "x" << a.cols << ")\n";
     for (int r = 0; r < a.rows; ++r)
     {
         for (int c = 0; c < a.cols; ++c)
-            cout << a.seats[r][c];
+            cout << theatre_seat(a, r, c);
         cout << "\n";
     }
 }
@@ -962,8 +995,8 @@ void theatreBookSeat()
     cin >> sid;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     int sidx = -1;
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == sid)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == sid)
         {
             sidx = i;
             break;
@@ -974,8 +1007,8 @@ void theatreBookSeat()
         return;
     }
     int aud_idx = -1;
-    for (int i = 0; i < theatreAudCount; ++i)
-        if (auditoriums[i].aud_id == shows[sidx].aud_id)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+        if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id)
         {
             aud_idx = i;
             break;
@@ -989,12 +1022,12 @@ void theatreBookSeat()
     string seat;
     getline(cin, seat);
     int r, c;
-    if (!theatre_parse_seat_label(auditoriums[aud_idx], seat, r, c))
+    if (!theatre_parse_seat_label(theatreCtx->auditoriums[aud_idx], seat, r, c))
     {
         cout << "Invalid seat label\n";
         return;
     }
-    if (auditoriums[aud_idx].seats[r][c] != 'E')
+    if (theatre_seat(theatreCtx->auditoriums[aud_idx], r, c) != 'E')
     {
         cout << "Seat unavailable\n";
         return;
@@ -1014,17 +1047,17 @@ void theatreBookSeat()
     b.customer_name[sizeof(b.customer_name) - 1] = 0;
     strncpy(b.customer_phone, phone.c_str(), sizeof(b.customer_phone) - 1);
     b.customer_phone[sizeof(b.customer_phone) - 1] = 0;
-    b.price_paid = shows[sidx].base_price;
+    b.price_paid = theatreCtx->shows[sidx].base_price;
     b.status = 1;
-    strncpy(b.booking_datetime, theatre_now_datetime().c_str(), sizeof(b.booking_datetime) - 1);
+    b.booking_datetime = cityNow();
     if (!theatre_booking_insert(b))
     {
         cout << "Failed to insert booking.\n";
         return;
     }
-    auditoriums[aud_idx].seats[r][c] = 'B';
-    shows[sidx].tickets_sold++;
-    shows[sidx].revenue += b.price_paid;
+    theatre_seat(theatreCtx->auditoriums[aud_idx], r, c) = 'B';
+    theatreCtx->shows[sidx].tickets_sold++;
+    theatreCtx->shows[sidx].revenue += b.price_paid;
     cout << "Booking done. ID: " << b.booking_id << "\n";
 }
 
@@ -1047,8 +1080,8 @@ void theatreCancelBooking()
     }
     // find show and free seat
     int sidx = -1;
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == b.show_id)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == b.show_id)
         {
             sidx = i;
             break;
@@ -1056,8 +1089,8 @@ void theatreCancelBooking()
     if (sidx != -1)
     {
         int aud_idx = -1;
-        for (int i = 0; i < theatreAudCount; ++i)
-            if (auditoriums[i].aud_id == shows[sidx].aud_id)
+        for (int i = 0; i < (int)theatreCtx->auditoriums.size(); ++i)
+            if (theatreCtx->auditoriums[i].aud_id == theatreCtx->shows[sidx].aud_id)
             {
                 aud_idx = i;
                 break;
@@ -1065,11 +1098,11 @@ void theatreCancelBooking()
         if (aud_idx != -1)
         {
             int rr, cc;
-            if (theatre_parse_seat_label(auditoriums[aud_idx], string(b.seat_label), rr, cc))
+            if (theatre_parse_seat_label(theatreCtx->auditoriums[aud_idx], string(b.seat_label), rr, cc))
             {
-                auditoriums[aud_idx].seats[rr][cc] = 'E';
-                shows[sidx].tickets_sold = max(0, shows[sidx].tickets_sold - 1);
-                shows[sidx].revenue = max(0, shows[sidx].revenue - b.price_paid);
+                theatre_seat(theatreCtx->auditoriums[aud_idx], rr, cc) = 'E';
+                theatreCtx->shows[sidx].tickets_sold = max(0, theatreCtx->shows[sidx].tickets_sold - 1);
+                theatreCtx->shows[sidx].revenue = max(0, theatreCtx->shows[sidx].revenue - b.price_paid);
             }
         }
     }
@@ -1079,26 +1112,26 @@ void theatreCancelBooking()
 
 void theatreListShows()
 {
-    if (theatreShowCount == 0)
+    int showCount = theatreCtx->shows.size();
+    if (showCount == 0)
     {
         cout << "No shows.\n";
         return;
     }
     int idxArr[THEATRE_MAX_SHOWS];
-    for (int i = 0; i < theatreShowCount; ++i)
+    for (int i = 0; i < showCount; ++i)
         idxArr[i] = i;
-    theatre_quickSort_indices(idxArr, 0, theatreShowCount - 1, theatre_cmp_show_start);
+    theatre_quickSort_indices(idxArr, 0, showCount - 1, theatre_cmp_show_start);
     cout << "Shows sorted by start time:\n";
-    for (int i = 0; i < theatreShowCount; ++i)
+    for (int i = 0; i < showCount; ++i)
     {
-        TheatreShow &s = shows[idxArr[i]];
-        cout << s.show_id << " | Movie:" << s.movie_id << " | Aud:" << s.aud_id << " | " << s.start_datetime << " - " << s.end_datetime << " | Price:" << s.base_price << " | Tickets:" << s.tickets_sold << "\n";
+        TheatreShow &s = theatreCtx->shows[idxArr[i]];
+        cout << s.show_id << " | Movie:" << s.movie_id << " | Aud:" << s.aud_id << " | " << cityFormatDateTime(s.start_datetime) << " - " << cityFormatDateTime(s.end_datetime) << " | Price:" << s.base_price << " | Tickets:" << s.tickets_sold << "\n";
     }
 }
 
-bool theatre_check_show_conflict(const string &s1, const string &e1, const string &s2, const string &e2)
+bool theatre_check_show_conflict(CityDateTime s1, CityDateTime e1, CityDateTime s2, CityDateTime e2)
 {
-    // assuming format YYYY-MM-DD HH:MM lexicographical comparisons work
     if (s1 >= e2)
         return false;
     if (s2 >= e1)
@@ -1108,7 +1141,7 @@ bool theatre_check_show_conflict(const string &s1, const string &e1, const strin
 
 void theatreAddShow()
 {
-    if (theatreShowCount >= THEATRE_MAX_SHOWS)
+    if ((int)theatreCtx->shows.size() >= THEATRE_MAX_SHOWS)
     {
         cout << "Overflow: shows limit\n";
         return;
@@ -1120,10 +1153,18 @@ void theatreAddShow()
     getline(cin, mS);
     cout << "Enter auditorium id: ";
     getline(cin, aS);
+    string startS, endS;
     cout << "Enter start datetime (YYYY-MM-DD HH:MM): ";
-    getline(cin, sh.start_datetime);
+    getline(cin, startS);
     cout << "Enter end datetime (YYYY-MM-DD HH:MM): ";
-    getline(cin, sh.end_datetime);
+    getline(cin, endS);
+    sh.start_datetime = cityDateTime(startS);
+    sh.end_datetime = cityDateTime(endS);
+    if (sh.start_datetime == CITY_NO_DATE || sh.end_datetime == CITY_NO_DATE)
+    {
+        cout << "Invalid datetime.\n";
+        return;
+    }
     cout << "Enter base price: ";
     string pS;
     getline(cin, pS);
@@ -1133,12 +1174,12 @@ void theatreAddShow()
     sh.tickets_sold = 0;
     sh.revenue = 0;
     // conflict check
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].aud_id == sh.aud_id)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].aud_id == sh.aud_id)
         {
-            if (theatre_check_show_conflict(sh.start_datetime, sh.end_datetime, shows[i].start_datetime, shows[i].end_datetime))
+            if (theatre_check_show_conflict(sh.start_datetime, sh.end_datetime, theatreCtx->shows[i].start_datetime, theatreCtx->shows[i].end_datetime))
             {
-                cout << "Conflict with show " << shows[i].show_id << " : " << shows[i].start_datetime << " - " << shows[i].end_datetime << "\n";
+                cout << "Conflict with show " << theatreCtx->shows[i].show_id << " : " << cityFormatDateTime(theatreCtx->shows[i].start_datetime) << " - " << cityFormatDateTime(theatreCtx->shows[i].end_datetime) << "\n";
                 cout << "Add anyway? (y/n): ";
                 char c;
                 cin >> c;
@@ -1148,20 +1189,20 @@ void theatreAddShow()
                 break;
             }
         }
-    shows[theatreShowCount++] = sh;
+    theatreCtx->shows.push_back(sh);
     cout << "Show added id " << sh.show_id << "\n";
 }
 
 // Snack functions
 void theatreAddSnack()
 {
-    if (theatreSnackCount >= THEATRE_MAX_SNACKS)
+    if ((int)theatreCtx->snacks.size() >= THEATRE_MAX_SNACKS)
     {
         cout << "Overflow: snacks limit\n";
         return;
     }
-    TheatreSnack &s = snacks[theatreSnackCount];
-    s.snack_id = 8000 + theatreSnackCount + 1;
+    TheatreSnack s;
+    s.snack_id = 8000 + (int)theatreCtx->snacks.size() + 1;
     cout << "Enter snack name: ";
     getline(cin, s.name);
     cout << "Enter category: ";
@@ -1174,18 +1215,18 @@ void theatreAddSnack()
     string t;
     getline(cin, t);
     s.prep_time = theatreToInt(t);
-    theatreSnackCount++;
+    theatreCtx->snacks.push_back(s);
     cout << "Snack added id " << s.snack_id << "\n";
 }
 void theatreListSnacks()
 {
-    if (theatreSnackCount == 0)
+    if (theatreCtx->snacks.empty())
     {
         cout << "No snacks.\n";
         return;
     }
-    for (int i = 0; i < theatreSnackCount; ++i)
-        cout << snacks[i].snack_id << " | " << snacks[i].name << " | " << snacks[i].category << " | Rs " << snacks[i].price << "\n";
+    for (int i = 0; i < (int)theatreCtx->snacks.size(); ++i)
+        cout << theatreCtx->snacks[i].snack_id << " | " << theatreCtx->snacks[i].name << " | " << theatreCtx->snacks[i].category << " | Rs " << theatreCtx->snacks[i].price << "\n";
 }
 void theatreOrderSnack()
 {
@@ -1216,13 +1257,13 @@ void theatreOrderSnack()
             break;
         if (ord.item_count < 10)
             ord.item_ids[ord.item_count++] = sid;
-        for (int i = 0; i < theatreSnackCount; ++i)
-            if (snacks[i].snack_id == sid)
-                ord.total_price += snacks[i].price;
+        for (int i = 0; i < (int)theatreCtx->snacks.size(); ++i)
+            if (theatreCtx->snacks[i].snack_id == sid)
+                ord.total_price += theatreCtx->snacks[i].price;
     }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     ord.status = 0;
-    strncpy(ord.order_datetime, theatre_now_datetime().c_str(), sizeof(ord.order_datetime) - 1);
+    ord.order_datetime = cityNow();
     if (theatre_enqueue_snack(ord))
         cout << "Order queued id " << ord.order_id << " total Rs " << ord.total_price << "\n";
 }
@@ -1253,13 +1294,13 @@ void theatreProcessSnack()
 // Staff & maintenance
 void theatreAddStaff()
 {
-    if (theatreStaffCount >= THEATRE_MAX_STAFF)
+    if ((int)theatreCtx->staff.size() >= THEATRE_MAX_STAFF)
     {
         cout << "Overflow: staff limit\n";
         return;
     }
-    TheatreStaff &s = theatreStaff[theatreStaffCount];
-    s.id = theatreStaffCount + 1;
+    TheatreStaff s;
+    s.id = (int)theatreCtx->staff.size() + 1;
     cout << "Enter name: ";
     getline(cin, s.name);
     cout << "Enter role: ";
@@ -1268,52 +1309,53 @@ void theatreAddStaff()
     string tmp;
     getline(cin, tmp);
     s.salary = theatreToInt(tmp);
-    theatreStaffCount++;
+    theatreCtx->staff.push_back(s);
     cout << "Staff added id " << s.id << "\n";
 }
 void theatreListStaff()
 {
-    if (theatreStaffCount == 0)
+    if (theatreCtx->staff.empty())
     {
         cout << "No staff.\n";
         return;
     }
-    for (int i = 0; i < theatreStaffCount; ++i)
-        cout << theatreStaff[i].id << " | " << theatreStaff[i].name << " | " << theatreStaff[i].role << " | Rs " << theatreStaff[i].salary << "\n";
+    for (int i = 0; i < (int)theatreCtx->staff.size(); ++i)
+        cout << theatreCtx->staff[i].id << " | " << theatreCtx->staff[i].name << " | " << theatreCtx->staff[i].role << " | Rs " << theatreCtx->staff[i].salary << "\n";
 }
 void theatreAddMaint()
 {
-    if (theatreMaintCount >= THEATRE_MAX_MAINT_LOGS)
+    if ((int)theatreCtx->maint.size() >= THEATRE_MAX_MAINT_LOGS)
     {
         cout << "Overflow: maint logs full\n";
         return;
     }
-    TheatreMaint &m = theatreMaint[theatreMaintCount];
-    m.id = theatreMaintCount + 1;
+    TheatreMaint m;
+    m.id = (int)theatreCtx->maint.size() + 1;
     cout << "Enter auditorium id: ";
     string t;
     getline(cin, t);
     m.aud_id = theatreToInt(t);
     cout << "Enter date (YYYY-MM-DD): ";
-    getline(cin, m.date);
+    getline(cin, t);
+    m.date = cityDate(t);
     cout << "Enter task: ";
     getline(cin, m.task);
     cout << "Enter staff id: ";
     getline(cin, t);
     m.staff_id = theatreToInt(t);
     m.status = 0;
-    theatreMaintCount++;
+    theatreCtx->maint.push_back(m);
     cout << "Maintenance logged id " << m.id << "\n";
 }
 void theatreListMaint()
 {
-    if (theatreMaintCount == 0)
+    if (theatreCtx->maint.empty())
     {
         cout << "No maintenance logs.\n";
         return;
     }
-    for (int i = 0; i < theatreMaintCount; ++i)
-        cout << theatreMaint[i].id << " | Aud:" << theatreMaint[i].aud_id << " | " << theatreMaint[i].date << " | " << theatreMaint[i].task << " | Staff:" << theatreMaint[i].staff_id << "\n";
+    for (int i = 0; i < (int)theatreCtx->maint.size(); ++i)
+        cout << theatreCtx->maint[i].id << " | Aud:" << theatreCtx->maint[i].aud_id << " | " << cityFormatDate(theatreCtx->maint[i].date) << " | " << theatreCtx->maint[i].task << " | Staff:" << theatreCtx->maint[i].staff_id << "\n";
 }
 
 // Revenue report per show
@@ -1323,10 +1365,10 @@ void theatreShowRevenue()
     int sid;
     cin >> sid;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    for (int i = 0; i < theatreShowCount; ++i)
-        if (shows[i].show_id == sid)
+    for (int i = 0; i < (int)theatreCtx->shows.size(); ++i)
+        if (theatreCtx->shows[i].show_id == sid)
         {
-            cout << "Tickets sold: " << shows[i].tickets_sold << " Revenue: Rs " << shows[i].revenue << "\n";
+            cout << "Tickets sold: " << theatreCtx->shows[i].tickets_sold << " Revenue: Rs " << theatreCtx->shows[i].revenue << "\n";
             return;
         }
     cout << "Show not found.\n";
@@ -1377,10 +1419,12 @@ void theatreShowMenu()
 
 void theatreInitModule()
 {
+    if (theatreCtx)
+        return; // state is kept across visits to the menu
     srand((unsigned int)time(NULL));
+    theatreCtx = new TheatreContext();
     theatre_init_booking_hash();
     theatre_init_snack_queue();
-    
 }
 
 // find bookings by phone substring using BM
@@ -1395,11 +1439,11 @@ void theatreFindBookingByPhone()
         return;
     }
     bool found = false;
-    for (int i = 0; i < THEATRE_HASH_SIZE; ++i)
+    for (size_t i = 0; i < theatreCtx->bookingHash.size(); ++i)
     {
-        if (bookingHash[i].used && !bookingHash[i].deleted)
+        if (theatreCtx->bookingHash[i].used && !theatreCtx->bookingHash[i].deleted)
         {
-            TheatreBooking &b = bookingHash[i].val;
+            TheatreBooking &b = theatreCtx->bookingHash[i].val;
             string phone = string(b.customer_phone);
             string phoneL = phone;
             string patL = pat;
@@ -1419,16 +1463,16 @@ void theatreFindBookingByPhone()
 }
 void theatreListAuditoriums()
 {
-    if (theatreAudCount == 0)
+    if (theatreCtx->auditoriums.empty())
     {
         cout << "No auditoriums available.\n";
         return;
     }
 
     cout << "\n--- AUDITORIUM LIST ---\n";
-    for (int i = 0; i < theatreAudCount; i++)
+    for (int i = 0; i < (int)theatreCtx->auditoriums.size(); i++)
     {
-        TheatreAuditorium &a = auditoriums[i];
+        TheatreAuditorium &a = theatreCtx->auditoriums[i];
         cout << "ID: " << a.aud_id
              << " | Name: " << a.name
              << " | Rows: " << a.rows
@@ -5,6 +5,9 @@
 #include <sstream>
 #include <limits>
 #include <functional>
+#include <vector>
+#include <algorithm>
+#include "../city_ring.h"
 using namespace std;
 
 #define HOTEL_MAX_NODES 1200
@@ -24,8 +27,6 @@ struct HotelNode {
     string name;
     hotelNodeType type;
 };
-HotelNode hotelNodes[HOTEL_MAX_NODES];
-int hotelNodeCount = 0;
 
 // Room BST
 struct Room {
@@ -70,12 +71,6 @@ struct Staff {
     string role;
     int salary;
 };
-Staff hotelStaff[HOTEL_MAX_STAFF];
-int hotelStaffCount = 0;
-
-// Floors
-string hotelFloors[HOTEL_MAX_FLOORS];
-int hotelFloorsCount = 0;
 
 // Service Requests
 enum RequestType { REQ_EXTRA_BED, REQ_SHEETS, REQ_ORDER, REQ_HELP, REQ_EMERGENCY };
@@ -87,17 +82,27 @@ struct ServiceRequest {
     string details;
     bool completed;
 };
-ServiceRequest serviceQueue[HOTEL_MAX_REQUESTS];
 int serviceFront = 0, serviceRear = -1, serviceCount = 0;
 int hotelNextRequestId = 1;
 
+// --------- Module Context ----------
+// Created by hotel_initModule(); serviceCount counts live entries in the ring.
+struct HotelContext {
+    vector<HotelNode> nodes;
+    vector<Staff> staff;
+    vector<string> floors;
+    vector<ServiceRequest> serviceQueue; // ring buffer, grown on demand
+};
+HotelContext *hotelCtx = nullptr;
+
 // ------------- Utilities --------------
 int hotel_addNode(const string &name, hotelNodeType t) {
-    for (int i = 0; i < hotelNodeCount; i++)
-        if (hotelNodes[i].name == name)
+    int n = hotelCtx->nodes.size();
+    for (int i = 0; i < n; i++)
+        if (hotelCtx->nodes[i].name == name)
             return i;
-    hotelNodes[hotelNodeCount] = { hotelNodeCount, name, t };
-    return hotelNodeCount++;
+    hotelCtx->nodes.push_back({ n, name, t });
+    return n;
 }
 
 void hotel_safeIgnore() { cin.ignore(numeric_limits<streamsize>::max(), '\n'); }
@@ -230,16 +235,18 @@ void hotel_inorderMenu(MenuItem* root) {
 // SERVICE QUEUE
 void hotel_enqueueService(const ServiceRequest &rq) {
     if (serviceCount >= HOTEL_MAX_REQUESTS) { cout << "Queue Full!\n"; return; }
-    serviceRear = (serviceRear + 1) % HOTEL_MAX_REQUESTS;
-    serviceQueue[serviceRear] = rq;
+    if (serviceCount == (int)hotelCtx->serviceQueue.size())
+        cityRingGrow(hotelCtx->serviceQueue, serviceFront, serviceRear, serviceCount, HOTEL_MAX_REQUESTS);
+    serviceRear = (serviceRear + 1) % (int)hotelCtx->serviceQueue.size();
+    hotelCtx->serviceQueue[serviceRear] = rq;
     serviceCount++;
 }
 
 ServiceRequest hotel_dequeueService() {
     ServiceRequest empty; empty.id = -1;
     if (serviceCount == 0) return empty;
-    ServiceRequest r = serviceQueue[serviceFront];
-    serviceFront = (serviceFront + 1) % HOTEL_MAX_REQUESTS;
+    ServiceRequest r = hotelCtx->serviceQueue[serviceFront];
+    serviceFront = (serviceFront + 1) % (int)hotelCtx->serviceQueue.size();
     serviceCount--;
     return r;
 }
@@ -249,10 +256,10 @@ void hotel_showServiceQueue() {
     cout << "--- Pending Requests ---\n";
     int idx = serviceFront;
     for (int i = 0; i < serviceCount; i++) {
-        auto &r = serviceQueue[idx];
+        auto &r = hotelCtx->serviceQueue[idx];
         cout << "ID:" << r.id << " Guest:" << r.guestId << " Room:" << r.roomNo
              << " Details:" << r.details << "\n";
-        idx = (idx + 1) % HOTEL_MAX_REQUESTS;
+        idx = (idx + 1) % (int)hotelCtx->serviceQueue.size();
     }
 }
 
@@ -270,18 +277,31 @@ int hotel_splitCSV(const string &line, string out[], int maxCols) {
     return c;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int hotel_countRows(ifstream &in) {
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // CSV LOADERS
 void hotel_loadFloorsCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    int rows = min(hotel_countRows(in), HOTEL_MAX_FLOORS);
+    hotelCtx->floors.reserve(hotelCtx->floors.size() + rows);
+    hotelCtx->nodes.reserve(hotelCtx->nodes.size() + rows);
     string line;
     getline(in, line);
     int loaded = 0;
 
     while (getline(in, line)) {
         if (line.empty()) continue;
-        hotelFloors[hotelFloorsCount++] = line;
+        hotelCtx->floors.push_back(line);
         hotel_addNode(line, HOTEL_FLOOR);
         loaded++;
     }
@@ -292,6 +312,7 @@ void hotel_loadRoomsCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    hotelCtx->nodes.reserve(hotelCtx->nodes.size() + min(hotel_countRows(in), HOTEL_MAX_ROOMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -337,6 +358,7 @@ void hotel_loadStaffCSV(const string &fn) {
     ifstream in(fn);
     if (!in.is_open()) { cout << "Missing " << fn << "\n"; return; }
 
+    hotelCtx->staff.reserve(hotelCtx->staff.size() + min(hotel_countRows(in), HOTEL_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -346,10 +368,9 @@ void hotel_loadStaffCSV(const string &fn) {
         int n = hotel_splitCSV(line, c, 4);
         if (n < 3) continue;
 
-        hotelStaff[hotelStaffCount] = {
-            hotelStaffCount + 1, c[0], c[1], hotel_toInt(c[2])
-        };
-        hotelStaffCount++;
+        hotelCtx->staff.push_back({
+            (int)hotelCtx->staff.size() + 1, c[0], c[1], hotel_toInt(c[2])
+        });
         loaded++;
     }
     cout << "Loaded " << loaded << " staff.\n";
@@ -398,9 +419,9 @@ void hotel_showGuests() { hotel_inorderGuests(hotelGuestRoot); }
 void hotel_showMenuItems() { hotel_inorderMenu(hotelMenuRoot); }
 
 void hotel_showNodes() {
-    cout << "\n--- HOTEL NODES (" << hotelNodeCount << ") ---\n";
-    for (int i = 0; i < hotelNodeCount; i++)
-        cout << i << ": " << hotelNodes[i].name << " | Type=" << hotelNodes[i].type << "\n";
+    cout << "\n--- HOTEL NODES (" << hotelCtx->nodes.size() << ") ---\n";
+    for (size_t i = 0; i < hotelCtx->nodes.size(); i++)
+        cout << i << ": " << hotelCtx->nodes[i].name << " | Type=" << hotelCtx->nodes[i].type << "\n";
 }
 
 // Staff
@@ -411,8 +432,7 @@ void hotel_addStaffInteractive() {
     cout << "Salary: "; int sal; cin >> sal;
     hotel_safeIgnore();
 
-    hotelStaff[hotelStaffCount] = { hotelStaffCount + 1, nm, role, sal };
-    hotelStaffCount++;
+    hotelCtx->staff.push_back({ (int)hotelCtx->staff.size() + 1, nm, role, sal });
     cout << "Staff added.\n";
 }
 
@@ -420,7 +440,7 @@ void hotel_addStaffInteractive() {
 void hotel_addFloorInteractive() {
     hotel_safeIgnore();
     cout << "Enter floor name: "; string f; getline(cin, f);
-    hotelFloors[hotelFloorsCount++] = f;
+    hotelCtx->floors.push_back(f);
     hotel_addNode(f, HOTEL_FLOOR);
     cout << "Floor added.\n";
 }
@@ -550,10 +570,11 @@ void hotel_viewGuestBillInteractive() {
 void hotel_sortGuestsByBalanceInteractive() {
     if (hotelGuestCount == 0) { cout << "No guests.\n"; return; }
 
-    Guest* arr[HOTEL_MAX_GUESTS];
+    vector<Guest*> arr;
+    arr.reserve(hotelGuestCount);
     int idx = 0;
 
-    function<void(Guest*)> collect = [&](Guest* r){ if (!r) return; collect(r->left); arr[idx++] = r; collect(r->right); };
+    function<void(Guest*)> collect = [&](Guest* r){ if (!r) return; collect(r->left); arr.push_back(r); idx++; collect(r->right); };
     collect(hotelGuestRoot);
 
     function<void(int,int)> qs = [&](int L, int R){
@@ -611,8 +632,14 @@ void hotel_showMenu() {
     cout << "Enter choice: ";
 }
 
+void hotel_initModule() {
+    if (hotelCtx) return; // state is kept across visits to the menu
+    hotelCtx = new HotelContext();
+}
+
 // MAIN HOTEL CONTROLLER
 void hotelSystem() {
+    hotel_initModule();
     int choice;
     while (true) {
         hotel_showMenu();
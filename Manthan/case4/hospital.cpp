@@ -5,14 +5,13 @@
 // Minimal helper functions included: toInt, splitCSV.
 
 #include <bits/stdc++.h>
+#include "../city_date.h"
 using namespace std;
 
-#define HOSPITAL_MAX_PATIENTS 2000
 #define HOSPITAL_MAX_STAFF 500
 #define HOSPITAL_MAX_ROOMS 500
 #define HOSPITAL_MAX_BEDS 2000
-#define HOSPITAL_MAX_APPOINTS 2000
-#define HOSPITAL_HASH_SIZE 32749
+#define HOSPITAL_HASH_MIN 64 // initial patient index slots (power of two)
 #define HOSPITAL_INF 999999
 
 // ---------- Helper utilities (simple) ----------
@@ -51,17 +50,37 @@ int hospitalSplitCSV(const string &line, string out[], int maxCols)
     return col;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int hospitalCountRows(ifstream &in)
+{
+    int rows = 0;
+    string line;
+    while (getline(in, line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
+// ---------- Cold text arena ----------
+// Names, addresses, notes and remarks live back to back in one char buffer
+// (hospitalCtx->arena); records keep a 4-byte offset, so scans over
+// ids/status/dates touch only the small hot rows. Offset 0 is the shared empty string. Text is never
+// edited in place: an update appends the new value and repoints the record.
+// Pointers from hospital_str() are only valid until the next append.
+typedef uint32_t HospitalText;
+
 // ---------- Entities ----------
 struct HospitalPatient
 {
     int patient_id;
-    char name[128];
     int age;
-    char gender[16];
-    char contact[32];
-    char address[256];
     int status; // 0 registered, 1 admitted, 3 discharged
-    char notes[512];
+    // cold text (hospital_str)
+    HospitalText name;    // max 127
+    HospitalText gender;  // max 15
+    HospitalText contact; // max 31
+    HospitalText address; // max 255
+    HospitalText notes;   // max 511
     // minimal: more fields can be added
 };
 
@@ -84,6 +103,8 @@ struct HospitalRoom
     int capacity;
     int occupied;
     int bedStartIdx;
+    int bedCount; // beds created; below capacity once HOSPITAL_MAX_BEDS is reached
+    int ward; // index into wardNames, -1 if too many room types
 };
 
 struct HospitalBed
@@ -92,6 +113,8 @@ struct HospitalBed
     int roomID;
     bool occupied;
     int patientID; // -1 if empty
+    int roomIdx;   // row in rooms
+    int ward;      // copy of the room's ward
 };
 
 // Appointment is now unified: general / surgery / lab test
@@ -101,136 +124,358 @@ struct HospitalAppointment
     int type; // 1 = general, 2 = surgery, 3 = lab test
     int patientID;
     int doctorID;
-    char date[16]; // YYYY-MM-DD
-    char time[6];  // HH:MM
+    CityDate date; // days since 1970-01-01
+    int time;      // minutes after midnight, -1 if unset
     int duration;  // minutes
-    int status;    // 0 booked,1 done,2 cancelled
+    int status;    // 0 booked,1 done,2 cancelled,3 waiting for a slot
 
     // surgery-specific (optional, set when type==2)
     int OTroomID;
     int durationMins; // surgery duration
-    char anesthesiaType[32];
+    HospitalText anesthesiaType; // max 31
 
     // lab-specific (optional, set when type==3)
-    char testType[64];
-    char resultDate[16];
-    char resultSummary[256];
+    HospitalText testType; // max 63
+    CityDate resultDate; // CITY_NO_DATE until results arrive
+    HospitalText resultSummary; // max 255
 
-    char remarks[256];
+    HospitalText remarks; // max 255
 };
 
+// one booked interval of a resource calendar day (see below)
+struct HospitalSlot
+{
+    int start, end; // minutes after midnight, [start,end)
+    int apptID;
+    int reach;
+};
+
+#define HOSPITAL_BED_WORDS ((HOSPITAL_MAX_BEDS + 63) / 64)
+#define HOSPITAL_MAX_WARDS 32
+
+// free-bed bitset (see the bed allocation index below)
+struct HospitalBedSet
+{
+    uint64_t summary;
+    uint64_t words[HOSPITAL_BED_WORDS];
+};
+
+// ---------- Module context ----------
+// Created by hospitalInitModule(); HOSPITAL_MAX_* cap the staff, rooms and beds.
+struct HospitalContext
+{
+    vector<char> arena; // cold text, offset 0 is the shared empty string
+    vector<HospitalPatient> patients; // canonical patient table
+    vector<HospitalStaff> staff;
+    vector<HospitalRoom> rooms;
+    vector<HospitalBed> beds;
+    vector<HospitalAppointment> appts;
+    HospitalBedSet freeBeds;
+    HospitalBedSet wardFree[HOSPITAL_MAX_WARDS];
+    int wardBeds[HOSPITAL_MAX_WARDS];
+    vector<string> wardNames;
+    unordered_map<int, int> roomIndex;  // roomID -> row in rooms
+    unordered_map<int, int> patientBed; // patient_id -> bed index
+    vector<int> patientHash;
+    map<long long, vector<HospitalSlot> > calendar;
+    unordered_map<string, int> labIds;
+};
+static HospitalContext *hospitalCtx = NULL;
+
 // ---------- Module globals ----------
-static HospitalPatient hospitalPatients[HOSPITAL_MAX_PATIENTS];
-static int hospitalPatientCount = 0;
 static int hospitalNextPatientID = 9000;
-
-static HospitalStaff hospitalStaff[HOSPITAL_MAX_STAFF];
-static int hospitalStaffCount = 0;
 static int hospitalNextStaffID = 7000;
+static int hospitalNextApptID = 21000;
+static int hospitalPatientHashCount = 0;
 
-static HospitalRoom hospitalRooms[HOSPITAL_MAX_ROOMS];
-static int hospitalRoomCount = 0;
-static HospitalBed hospitalBeds[HOSPITAL_MAX_BEDS];
-static int hospitalBedCount = 0;
+// Appends s (cut to maxLen-1 bytes, like the old fixed char fields).
+HospitalText hospital_text(const string &s, size_t maxLen)
+{
+    size_t n = min(s.size(), maxLen - 1);
+    if (n == 0) return 0;
+    HospitalText off = (HospitalText)hospitalCtx->arena.size();
+    hospitalCtx->arena.insert(hospitalCtx->arena.end(), s.begin(), s.begin() + n);
+    hospitalCtx->arena.push_back('\0');
+    return off;
+}
+inline const char *hospital_str(HospitalText t) { return &hospitalCtx->arena[t]; }
 
-static HospitalAppointment hospitalAppts[HOSPITAL_MAX_APPOINTS];
-static int hospitalApptCount = 0;
-static int hospitalNextApptID = 21000;
+// ---------- Bed allocation index ----------
+// Free beds are kept as bitsets over bed index: one for the whole hospital
+// (a room's beds are contiguous, so a room lookup scans only its own words)
+// and one per ward, where a ward is a room type such as ICU or General.
+// A summary word marks the non-empty 64-bed words, so the first free bed of
+// a ward is two count-trailing-zeros. Occupancy is total minus popcount.
+static_assert(HOSPITAL_BED_WORDS <= 64, "bed summary must fit one word");
 
-// ---------- Hash table for patients (by patient_id) ----------
-struct HospitalPatientHashEntry
+static void hospital_bedset_set(HospitalBedSet &s, int b)
 {
-    int key;
-    HospitalPatient val;
-    bool used;
-    bool deleted;
-};
-static HospitalPatientHashEntry hospitalPatientHash[HOSPITAL_HASH_SIZE];
-static int hospitalPatientHashCount = 0;
+    s.words[b >> 6] |= 1ULL << (b & 63);
+    s.summary |= 1ULL << (b >> 6);
+}
+static void hospital_bedset_clear(HospitalBedSet &s, int b)
+{
+    s.words[b >> 6] &= ~(1ULL << (b & 63));
+    if (!s.words[b >> 6]) s.summary &= ~(1ULL << (b >> 6));
+}
+static int hospital_bedset_first(const HospitalBedSet &s)
+{
+    if (!s.summary) return -1;
+    int w = __builtin_ctzll(s.summary);
+    return (w << 6) | __builtin_ctzll(s.words[w]);
+}
+// First set bit in [lo, hi), or -1; hi is clamped to the beds that exist.
+static int hospital_bedset_first_in(const HospitalBedSet &s, int lo, int hi)
+{
+    if (hi > (int)hospitalCtx->beds.size()) hi = hospitalCtx->beds.size();
+    for (int w = lo >> 6; w <= (hi - 1) >> 6 && lo < hi; ++w)
+    {
+        uint64_t m = s.words[w];
+        if (w == lo >> 6) m &= ~0ULL << (lo & 63);
+        if (m)
+        {
+            int b = (w << 6) | __builtin_ctzll(m);
+            return b < hi ? b : -1;
+        }
+    }
+    return -1;
+}
+static int hospital_bedset_count(const HospitalBedSet &s)
+{
+    int n = 0;
+    for (uint64_t m = s.summary; m; m &= m - 1)
+        n += __builtin_popcountll(s.words[__builtin_ctzll(m)]);
+    return n;
+}
+// Ward id for a room type (case-insensitive), creating it if asked; -1 if unknown/full.
+static int hospital_ward_id(const string &type, bool create)
+{
+    string key = type;
+    for (size_t i = 0; i < key.size(); ++i) key[i] = tolower((unsigned char)key[i]);
+    for (size_t w = 0; w < hospitalCtx->wardNames.size(); ++w)
+    {
+        string name = hospitalCtx->wardNames[w];
+        for (size_t i = 0; i < name.size(); ++i) name[i] = tolower((unsigned char)name[i]);
+        if (name == key) return w;
+    }
+    int w = hospitalCtx->wardNames.size();
+    if (!create || w >= HOSPITAL_MAX_WARDS) return -1;
+    hospitalCtx->wardNames.push_back(type);
+    return w;
+}
+static void hospital_bed_occupy(int b, int pid)
+{
+    HospitalBed &bd = hospitalCtx->beds[b];
+    bd.occupied = true;
+    bd.patientID = pid;
+    hospitalCtx->rooms[bd.roomIdx].occupied++;
+    hospital_bedset_clear(hospitalCtx->freeBeds, b);
+    if (bd.ward >= 0) hospital_bedset_clear(hospitalCtx->wardFree[bd.ward], b);
+    hospitalCtx->patientBed[pid] = b;
+}
+static void hospital_bed_release(int b)
+{
+    HospitalBed &bd = hospitalCtx->beds[b];
+    hospitalCtx->patientBed.erase(bd.patientID);
+    bd.occupied = false;
+    bd.patientID = -1;
+    hospitalCtx->rooms[bd.roomIdx].occupied--;
+    hospital_bedset_set(hospitalCtx->freeBeds, b);
+    if (bd.ward >= 0) hospital_bedset_set(hospitalCtx->wardFree[bd.ward], b);
+}
+
+// ---------- Hash index for patients (patient_id -> row) ----------
+// Slots hold row+1 into patients (0 = empty), so the table stays a
+// few bytes per patient and every lookup reads the one canonical record.
+// Linear probing over a power-of-two table, rehashed at 70% load.
 
 unsigned int hospital_hash_key_int(int key)
 {
-    return (unsigned int)(key * 2654435761u) % HOSPITAL_HASH_SIZE;
+    return (unsigned int)(key * 2654435761u) & (unsigned int)(hospitalCtx->patientHash.size() - 1);
 }
-void hospital_init_patient_hash()
+static void hospital_patient_hash_place(int row)
 {
-    for (int i = 0; i < HOSPITAL_HASH_SIZE; ++i)
+    int key = hospitalCtx->patients[row].patient_id;
+    unsigned int mask = (unsigned int)(hospitalCtx->patientHash.size() - 1);
+    unsigned int idx = hospital_hash_key_int(key);
+    while (hospitalCtx->patientHash[idx] && hospitalCtx->patients[hospitalCtx->patientHash[idx] - 1].patient_id != key)
+        idx = (idx + 1) & mask;
+    if (!hospitalCtx->patientHash[idx]) hospitalPatientHashCount++;
+    hospitalCtx->patientHash[idx] = row + 1; // a repeated ID points at the newest row
+}
+void hospital_patient_hash_insert(int row)
+{
+    if ((size_t)(hospitalPatientHashCount + 1) * 10 > hospitalCtx->patientHash.size() * 7)
     {
-        hospitalPatientHash[i].used = false;
-        hospitalPatientHash[i].deleted = false;
-        hospitalPatientHash[i].key = -1;
+        vector<int> old;
+        old.swap(hospitalCtx->patientHash);
+        hospitalCtx->patientHash.assign(old.size() * 2, 0);
+        hospitalPatientHashCount = 0;
+        for (size_t i = 0; i < old.size(); ++i)
+            if (old[i]) hospital_patient_hash_place(old[i] - 1);
     }
+    hospital_patient_hash_place(row);
+}
+// (Re)builds the index over whatever rows are already in the table.
+void hospital_init_patient_hash()
+{
+    hospitalCtx->patientHash.assign(HOSPITAL_HASH_MIN, 0);
     hospitalPatientHashCount = 0;
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); ++i)
+        hospital_patient_hash_insert(i);
 }
-bool hospital_patient_hash_insert(const HospitalPatient &p)
+// Returns the stored record (edits are seen by every caller) or NULL.
+HospitalPatient *hospital_patient_find(int key)
 {
-    if (hospitalPatientHashCount >= HOSPITAL_MAX_PATIENTS) return false;
-    unsigned int idx = hospital_hash_key_int(p.patient_id);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used && !hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key != p.patient_id)
+    unsigned int mask = (unsigned int)(hospitalCtx->patientHash.size() - 1);
+    unsigned int idx = hospital_hash_key_int(key);
+    while (hospitalCtx->patientHash[idx])
     {
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) return false;
+        HospitalPatient &p = hospitalCtx->patients[hospitalCtx->patientHash[idx] - 1];
+        if (p.patient_id == key) return &p;
+        idx = (idx + 1) & mask;
     }
-    hospitalPatientHash[idx].used = true;
-    hospitalPatientHash[idx].deleted = false;
-    hospitalPatientHash[idx].key = p.patient_id;
-    hospitalPatientHash[idx].val = p;
-    hospitalPatientHashCount++;
-    return true;
+    return NULL;
 }
-bool hospital_patient_hash_get(int key, HospitalPatient &out)
+// Appends to the canonical table and indexes the new row.
+void hospital_add_patient_row(const HospitalPatient &p)
 {
-    unsigned int idx = hospital_hash_key_int(key);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used)
+    hospitalCtx->patients.push_back(p);
+    hospital_patient_hash_insert((int)hospitalCtx->patients.size() - 1);
+}
+
+// ---------- Resource calendar (doctor / OT room / lab bench) ----------
+// Booked intervals per (resource, day), sorted by start minute. CSV data may
+// already overlap, so each slot also carries `reach`, the latest end among it
+// and every earlier slot of that day; reach never decreases, which lets both
+// the conflict check and the free-slot search start with one binary search.
+// Lab tests hold one bench per test type (interned to an id on first use).
+// Cancelled and still-waiting appointments hold nothing.
+#define HOSPITAL_RES_DOCTOR 0
+#define HOSPITAL_RES_OT 1
+#define HOSPITAL_RES_LAB 2
+#define HOSPITAL_DAY_OPEN (8 * 60)   // free-slot searches start here
+#define HOSPITAL_DAY_CLOSE (20 * 60) // ... and must finish by here
+#define HOSPITAL_SLOT_SEARCH_DAYS 30
+
+
+static long long hospital_res_key(int kind, int id, CityDate d)
+{
+    return ((long long)kind << 56) | ((long long)(id & 0xFFFFFF) << 32) | (unsigned)d;
+}
+static const char *hospital_res_name(long long key)
+{
+    int kind = (int)(key >> 56);
+    return kind == HOSPITAL_RES_DOCTOR ? "Doctor" : (kind == HOSPITAL_RES_OT ? "OT room" : "Lab");
+}
+static int hospital_lab_id(const char *testType, bool create)
+{
+    if (!testType[0]) return -1;
+    unordered_map<string, int>::iterator it = hospitalCtx->labIds.find(testType);
+    if (it != hospitalCtx->labIds.end()) return it->second;
+    if (!create) return -1;
+    int id = (int)hospitalCtx->labIds.size();
+    hospitalCtx->labIds[testType] = id;
+    return id;
+}
+// Minutes the appointment occupies its resources.
+int hospital_appt_length(const HospitalAppointment &a)
+{
+    return (a.type == 2 && a.durationMins > 0) ? a.durationMins : a.duration;
+}
+// Calendar keys the appointment needs on day d; returns how many.
+static int hospital_appt_resources(const HospitalAppointment &a, CityDate d, long long keys[3])
+{
+    int n = 0;
+    keys[n++] = hospital_res_key(HOSPITAL_RES_DOCTOR, a.doctorID, d);
+    if (a.type == 2 && a.OTroomID > 0) keys[n++] = hospital_res_key(HOSPITAL_RES_OT, a.OTroomID, d);
+    int lab = (a.type == 3 ? hospital_lab_id(hospital_str(a.testType), true) : -1);
+    if (lab >= 0) keys[n++] = hospital_res_key(HOSPITAL_RES_LAB, lab, d);
+    return n;
+}
+// First slot whose reach passes t (every earlier slot ends by t).
+static size_t hospital_slot_after(const vector<HospitalSlot> &v, int t)
+{
+    return upper_bound(v.begin(), v.end(), t, [](int x, const HospitalSlot &s) { return x < s.reach; }) - v.begin();
+}
+// Returns true if the appointment overlapped something already booked.
+bool hospital_calendar_add(const HospitalAppointment &a)
+{
+    int len = hospital_appt_length(a);
+    if (a.status == 2 || a.status == 3 || a.time < 0 || len <= 0 || a.date == CITY_NO_DATE) return false;
+    long long keys[3];
+    int nk = hospital_appt_resources(a, a.date, keys);
+    bool clash = false;
+    for (int k = 0; k < nk; ++k)
     {
-        if (!hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key == key)
+        vector<HospitalSlot> &v = hospitalCtx->calendar[keys[k]];
+        size_t i = hospital_slot_after(v, a.time);
+        if (i < v.size() && v[i].start < a.time + len) clash = true;
+        size_t pos = lower_bound(v.begin(), v.end(), a.time, [](const HospitalSlot &s, int x) { return s.start <= x; }) - v.begin();
+        HospitalSlot s = {a.time, a.time + len, a.apptID, 0};
+        v.insert(v.begin() + pos, s);
+        for (size_t j = pos; j < v.size(); ++j)
         {
-            out = hospitalPatientHash[idx].val;
-            return true;
+            int r = max(v[j].end, j ? v[j - 1].reach : 0);
+            if (j > pos && r == v[j].reach) break;
+            v[j].reach = r;
         }
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) break;
     }
-    return false;
+    return clash;
 }
-bool hospital_patient_hash_remove(int key)
+// Any booked slot overlapping [st,en) on this resource-day, else NULL.
+const HospitalSlot *hospital_calendar_conflict(long long key, int st, int en)
 {
-    unsigned int idx = hospital_hash_key_int(key);
-    unsigned int start = idx;
-    while (hospitalPatientHash[idx].used)
+    map<long long, vector<HospitalSlot> >::const_iterator it = hospitalCtx->calendar.find(key);
+    if (it == hospitalCtx->calendar.end()) return NULL;
+    const vector<HospitalSlot> &v = it->second;
+    size_t i = hospital_slot_after(v, st);
+    return (i < v.size() && v[i].start < en) ? &v[i] : NULL;
+}
+// Earliest t' >= t with [t', t'+len) free on this resource-day and ending by
+// `close`, or -1.
+int hospital_earliest_free(long long key, int t, int len, int close)
+{
+    map<long long, vector<HospitalSlot> >::const_iterator it = hospitalCtx->calendar.find(key);
+    if (it != hospitalCtx->calendar.end())
     {
-        if (!hospitalPatientHash[idx].deleted && hospitalPatientHash[idx].key == key)
-        {
-            hospitalPatientHash[idx].deleted = true;
-            hospitalPatientHashCount--;
-            return true;
-        }
-        idx = (idx + 1) % HOSPITAL_HASH_SIZE;
-        if (idx == start) break;
+        const vector<HospitalSlot> &v = it->second;
+        for (size_t i = hospital_slot_after(v, t); i < v.size() && v[i].start < t + len; ++i)
+            if (v[i].end > t) t = v[i].end;
     }
-    return false;
+    return t + len <= close ? t : -1;
 }
-
-// ---------- Date/time helpers ----------
-static string hospital_now_date()
+// Earliest start >= t at which every key is free for len minutes. Each pass
+// only moves t forward, so the loop settles on the first common gap.
+int hospital_common_free(const long long keys[], int nk, int t, int len, int close)
 {
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[32];
-    sprintf(buf, "%04d-%02d-%02d", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday);
-    return string(buf);
+    for (bool moved = true; moved;)
+    {
+        moved = false;
+        for (int k = 0; k < nk; ++k)
+        {
+            int t2 = hospital_earliest_free(keys[k], t, len, close);
+            if (t2 < 0) return -1;
+            if (t2 != t) { t = t2; moved = true; }
+        }
+    }
+    return t;
 }
-static string hospital_now_time()
+// Earliest (day, time) from `from`/`t` on where the appointment fits inside
+// clinic hours; returns false if nothing within HOSPITAL_SLOT_SEARCH_DAYS.
+bool hospital_find_slot(const HospitalAppointment &a, CityDate from, int t, CityDate &day, int &start)
 {
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    char buf[16];
-    sprintf(buf, "%02d:%02d", tm->tm_hour, tm->tm_min);
-    return string(buf);
+    int len = hospital_appt_length(a);
+    if (len <= 0) return false;
+    for (int d = 0; d < HOSPITAL_SLOT_SEARCH_DAYS; ++d, t = HOSPITAL_DAY_OPEN)
+    {
+        long long keys[3];
+        int nk = hospital_appt_resources(a, from + d, keys);
+        int s = hospital_common_free(keys, nk, max(t, HOSPITAL_DAY_OPEN), len, HOSPITAL_DAY_CLOSE);
+        if (s >= 0) { day = from + d; start = s; return true; }
+    }
+    return false;
 }
-
 // ---------- CSV loaders & generators ----------
 void hospitalLoadPatientsCSV(const string &fn)
 {
@@ -245,20 +490,17 @@ void hospitalLoadPatientsCSV(const string &fn)
         string cols[8];
         int n =hospitalSplitCSV(line, cols, 8);
         if (n < 2) continue;
-        if (hospitalPatientCount >= HOSPITAL_MAX_PATIENTS) break;
         HospitalPatient p;
         p.patient_id = hospitalToInt(cols[0]);
         if (p.patient_id == 0) p.patient_id = ++hospitalNextPatientID;
-        strncpy(p.name, cols[1].c_str(), sizeof(p.name) - 1); p.name[sizeof(p.name)-1]=0;
+        p.name = hospital_text(cols[1], 128);
         p.age = (n>=3? hospitalToInt(cols[2]):0);
-        strncpy(p.gender,(n>=4?cols[3].c_str():""),sizeof(p.gender)-1);
-        strncpy(p.contact,(n>=5?cols[4].c_str():""),sizeof(p.contact)-1);
-        strncpy(p.address,(n>=6?cols[5].c_str():""),sizeof(p.address)-1);
+        p.gender = (n>=4? hospital_text(cols[3], 16):0);
+        p.contact = (n>=5? hospital_text(cols[4], 32):0);
+        p.address = (n>=6? hospital_text(cols[5], 256):0);
         p.status = (n>=7? hospitalToInt(cols[6]):0);
-        strncpy(p.notes,(n>=8?cols[7].c_str():""),sizeof(p.notes)-1);
-        hospitalPatients[hospitalPatientCount] = p;
-        hospitalPatientCount++;
-        hospital_patient_hash_insert(p);
+        p.notes = (n>=8? hospital_text(cols[7], 512):0);
+        hospital_add_patient_row(p);
         loaded++;
     }
     cout << "Loaded " << loaded << " patients from " << fn << "\n";
@@ -268,6 +510,7 @@ void hospitalLoadStaffCSV(const string &fn)
 {
     ifstream in(fn.c_str());
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
+    hospitalCtx->staff.reserve(hospitalCtx->staff.size() + min(hospitalCountRows(in), HOSPITAL_MAX_STAFF));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -277,7 +520,7 @@ void hospitalLoadStaffCSV(const string &fn)
         string cols[8];
         int n = hospitalSplitCSV(line, cols, 8);
         if (n < 2) continue;
-        if (hospitalStaffCount >= HOSPITAL_MAX_STAFF) break;
+        if ((int)hospitalCtx->staff.size() >= HOSPITAL_MAX_STAFF) break;
         HospitalStaff s;
         s.id =  hospitalToInt(cols[0]); if (s.id == 0) s.id = ++hospitalNextStaffID;
         strncpy(s.name, cols[1].c_str(), sizeof(s.name)-1); s.name[sizeof(s.name)-1]=0;
@@ -287,7 +530,7 @@ void hospitalLoadStaffCSV(const string &fn)
         s.salary = (n>=6? hospitalToInt(cols[5]):0);
         strncpy(s.contact, (n>=7?cols[6].c_str():""), sizeof(s.contact)-1);
         strncpy(s.specialty, (n>=8?cols[7].c_str():""), sizeof(s.specialty)-1);
-        hospitalStaff[hospitalStaffCount++] = s;
+        hospitalCtx->staff.push_back(s);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -297,6 +540,7 @@ void hospitalLoadRoomsCSV(const string &fn)
 {
     ifstream in(fn.c_str());
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
+    hospitalCtx->rooms.reserve(hospitalCtx->rooms.size() + min(hospitalCountRows(in), HOSPITAL_MAX_ROOMS));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -306,23 +550,37 @@ void hospitalLoadRoomsCSV(const string &fn)
         string cols[6];
         int n = hospitalSplitCSV(line, cols, 6);
         if (n < 3) continue;
-        if (hospitalRoomCount >= HOSPITAL_MAX_ROOMS) break;
+        if ((int)hospitalCtx->rooms.size() >= HOSPITAL_MAX_ROOMS) break;
         HospitalRoom r;
         r.roomID =  hospitalToInt(cols[0]);
         strncpy(r.type, cols[1].c_str(), sizeof(r.type)-1); r.type[sizeof(r.type)-1]=0;
         r.capacity =  hospitalToInt(cols[2]);
         r.occupied = 0;
-        r.bedStartIdx = hospitalBedCount;
-        for (int b = 0; b < r.capacity && hospitalBedCount < HOSPITAL_MAX_BEDS; ++b)
+        r.bedStartIdx = hospitalCtx->beds.size();
+        r.ward = hospital_ward_id(r.type, true);
+        for (int b = 0; b < r.capacity && (int)hospitalCtx->beds.size() < HOSPITAL_MAX_BEDS; ++b)
         {
+            int idx = hospitalCtx->beds.size();
             HospitalBed bd;
-            bd.bedID = hospitalBedCount + 10000;
+            bd.bedID = idx + 10000;
             bd.roomID = r.roomID;
             bd.occupied = false;
             bd.patientID = -1;
-            hospitalBeds[hospitalBedCount++] = bd;
+            bd.roomIdx = hospitalCtx->rooms.size();
+            bd.ward = r.ward;
+            hospital_bedset_set(hospitalCtx->freeBeds, idx);
+            if (r.ward >= 0)
+            {
+                hospital_bedset_set(hospitalCtx->wardFree[r.ward], idx);
+                hospitalCtx->wardBeds[r.ward]++;
+            }
+            hospitalCtx->beds.push_back(bd);
         }
-        hospitalRooms[hospitalRoomCount++] = r;
+        r.bedCount = (int)hospitalCtx->beds.size() - r.bedStartIdx;
+        if (r.bedCount < r.capacity)
+            cout << "Bed limit reached: room " << r.roomID << " has " << r.bedCount << " of " << r.capacity << " beds\n";
+        hospitalCtx->roomIndex[r.roomID] = hospitalCtx->rooms.size();
+        hospitalCtx->rooms.push_back(r);
         loaded++;
     }
     cout << "Loaded " << loaded << " rooms from " << fn << "\n";
@@ -336,36 +594,38 @@ void hospitalLoadAppointmentsCSV(const string &fn)
     if (!in.is_open()) { cout << "Cannot open " << fn << "\n"; return; }
     string line;
     getline(in, line);
-    int loaded = 0;
+    int loaded = 0, clashes = 0;
     while (getline(in, line))
     {
         if (line.size() < 2) continue;
         string cols[20];
         int n = hospitalSplitCSV(line, cols, 20);
         if (n < 6) continue;
-        if (hospitalApptCount >= HOSPITAL_MAX_APPOINTS) break;
         HospitalAppointment a;
         a.apptID = hospitalToInt(cols[0]); if (a.apptID == 0) a.apptID = ++hospitalNextApptID;
         a.type =  hospitalToInt(cols[1]);
         a.patientID =  hospitalToInt(cols[2]);
         a.doctorID =  hospitalToInt(cols[3]);
-        strncpy(a.date, cols[4].c_str(), sizeof(a.date)-1); a.date[sizeof(a.date)-1]=0;
-        strncpy(a.time, cols[5].c_str(), sizeof(a.time)-1); a.time[sizeof(a.time)-1]=0;
+        a.date = cityDate(cols[4]);
+        a.time = cityTime(cols[5]);
         a.duration = (n>=7? hospitalToInt(cols[6]):15);
         a.status = (n>=8? hospitalToInt(cols[7]):0);
-        if (n >= 9) strncpy(a.remarks, cols[8].c_str(), sizeof(a.remarks)-1); else strncpy(a.remarks,"",sizeof(a.remarks)-1);
+        a.remarks = (n >= 9 ? hospital_text(cols[8], 256) : 0);
         // surgery fields
         a.OTroomID = (n>=10? hospitalToInt(cols[9]):-1);
         a.durationMins = (n>=11? hospitalToInt(cols[10]):0);
-        if (n >= 12) strncpy(a.anesthesiaType, cols[11].c_str(), sizeof(a.anesthesiaType)-1); else strncpy(a.anesthesiaType,"",sizeof(a.anesthesiaType)-1);
+        a.anesthesiaType = (n >= 12 ? hospital_text(cols[11], 32) : 0);
         // lab fields
-        if (n >= 13) strncpy(a.testType, cols[12].c_str(), sizeof(a.testType)-1); else strncpy(a.testType,"",sizeof(a.testType)-1);
-        if (n >= 14) strncpy(a.resultDate, cols[13].c_str(), sizeof(a.resultDate)-1); else strncpy(a.resultDate,"",sizeof(a.resultDate)-1);
-        if (n >= 15) strncpy(a.resultSummary, cols[14].c_str(), sizeof(a.resultSummary)-1); else strncpy(a.resultSummary,"",sizeof(a.resultSummary)-1);
-        hospitalAppts[hospitalApptCount++] = a;
+        a.testType = (n >= 13 ? hospital_text(cols[12], 64) : 0);
+        a.resultDate = (n >= 14 ? cityDate(cols[13]) : CITY_NO_DATE);
+        a.resultSummary = (n >= 15 ? hospital_text(cols[14], 256) : 0);
+        if (a.time < 0 && a.status == 0) a.status = 3; // no time yet: waiting list
+        hospitalCtx->appts.push_back(a);
+        if (hospital_calendar_add(a)) clashes++;
         loaded++;
     }
     cout << "Loaded " << loaded << " appointments from " << fn << "\n";
+    if (clashes) cout << "Warning: " << clashes << " loaded appointments overlap an earlier booking.\n";
 }
 
 // Lab CSV loader ONLY — used to update lab results (no interactive updating).
@@ -386,34 +646,34 @@ void hospitalLoadLabsCSV(const string &fn)
         int apptID =  hospitalToInt(cols[0]);
         int pid =  hospitalToInt(cols[1]);
         string testType = (n>=3?cols[2]:"");
-        string resDate = (n>=4?cols[3]:"");
+        CityDate resDate = (n>=4?cityDate(cols[3]):CITY_NO_DATE);
         string resSummary = (n>=5?cols[4]:"");
         // Prefer matching by apptID if provided (>0), else match by patientID + testType (first not-done)
         bool found = false;
         if (apptID > 0)
         {
-            for (int i = 0; i < hospitalApptCount; ++i)
+            for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
             {
-                if (hospitalAppts[i].apptID == apptID && hospitalAppts[i].type == 3)
+                if (hospitalCtx->appts[i].apptID == apptID && hospitalCtx->appts[i].type == 3)
                 {
-                    if (!testType.empty()) strncpy(hospitalAppts[i].testType, testType.c_str(), sizeof(hospitalAppts[i].testType)-1);
-                    if (!resDate.empty()) strncpy(hospitalAppts[i].resultDate, resDate.c_str(), sizeof(hospitalAppts[i].resultDate)-1);
-                    if (!resSummary.empty()) strncpy(hospitalAppts[i].resultSummary, resSummary.c_str(), sizeof(hospitalAppts[i].resultSummary)-1);
+                    if (!testType.empty()) hospitalCtx->appts[i].testType = hospital_text(testType, 64);
+                    if (resDate != CITY_NO_DATE) hospitalCtx->appts[i].resultDate = resDate;
+                    if (!resSummary.empty()) hospitalCtx->appts[i].resultSummary = hospital_text(resSummary, 256);
                     updated++; found = true; break;
                 }
             }
         }
         if (!found && pid > 0)
         {
-            for (int i = 0; i < hospitalApptCount; ++i)
+            for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
             {
-                if (hospitalAppts[i].patientID == pid && hospitalAppts[i].type == 3)
+                if (hospitalCtx->appts[i].patientID == pid && hospitalCtx->appts[i].type == 3)
                 {
                     // Use additional matching: testType if specified
-                    if (!testType.empty() && strlen(hospitalAppts[i].testType) > 0 && string(hospitalAppts[i].testType) != testType) continue;
-                    if (!testType.empty()) strncpy(hospitalAppts[i].testType, testType.c_str(), sizeof(hospitalAppts[i].testType)-1);
-                    if (!resDate.empty()) strncpy(hospitalAppts[i].resultDate, resDate.c_str(), sizeof(hospitalAppts[i].resultDate)-1);
-                    if (!resSummary.empty()) strncpy(hospitalAppts[i].resultSummary, resSummary.c_str(), sizeof(hospitalAppts[i].resultSummary)-1);
+                    if (!testType.empty() && hospitalCtx->appts[i].testType && testType != hospital_str(hospitalCtx->appts[i].testType)) continue;
+                    if (!testType.empty()) hospitalCtx->appts[i].testType = hospital_text(testType, 64);
+                    if (resDate != CITY_NO_DATE) hospitalCtx->appts[i].resultDate = resDate;
+                    if (!resSummary.empty()) hospitalCtx->appts[i].resultSummary = hospital_text(resSummary, 256);
                     updated++; found = true; break;
                 }
             }
@@ -430,34 +690,27 @@ int hospital_createApptID() { return ++hospitalNextApptID; }
 // Add a new patient (ER or OPD)
 void hospitalAddPatient()
 {
-    if (hospitalPatientCount >= HOSPITAL_MAX_PATIENTS)
-    {
-        cout << "Overflow: patients capacity reached!\n";
-        return;
-    }
     HospitalPatient p;
     p.patient_id = hospital_createPatientID();
     cout << "Enter name: ";
     string tmp;
     getline(cin, tmp);
-    strncpy(p.name, tmp.c_str(), sizeof(p.name) - 1); p.name[sizeof(p.name)-1]=0;
+    p.name = hospital_text(tmp, 128);
     cout << "Enter age: ";
     getline(cin, tmp);
     p.age =  hospitalToInt(tmp);
     cout << "Enter gender: ";
     getline(cin, tmp);
-    strncpy(p.gender, tmp.c_str(), sizeof(p.gender) - 1); p.gender[sizeof(p.gender)-1]=0;
+    p.gender = hospital_text(tmp, 16);
     cout << "Enter contact: ";
     getline(cin, tmp);
-    strncpy(p.contact, tmp.c_str(), sizeof(p.contact) - 1); p.contact[sizeof(p.contact)-1]=0;
+    p.contact = hospital_text(tmp, 32);
     cout << "Enter address: ";
     getline(cin, tmp);
-    strncpy(p.address, tmp.c_str(), sizeof(p.address) - 1); p.address[sizeof(p.address)-1]=0;
+    p.address = hospital_text(tmp, 256);
     p.status = 0;
-    strncpy(p.notes, "", sizeof(p.notes)-1);
-    hospitalPatients[hospitalPatientCount] = p;
-    hospitalPatientCount++;
-    hospital_patient_hash_insert(p);
+    p.notes = 0;
+    hospital_add_patient_row(p);
     cout << "Patient registered. ID: " << p.patient_id << "\n";
 }
 
@@ -468,30 +721,34 @@ void hospitalAdmitPatient()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    HospitalPatient p;
-    if (!hospital_patient_hash_get(pid, p)) { cout << "Patient not found.\n"; return; }
-    cout << "Enter roomID to admit into: ";
-    int rid;
-    if (!(cin >> rid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    unordered_map<int, int>::iterator cur = hospitalCtx->patientBed.find(pid);
+    if (cur != hospitalCtx->patientBed.end()) { cout << "Patient already in bed " << hospitalCtx->beds[cur->second].bedID << "\n"; return; }
+    cout << "Enter roomID or ward type (e.g. ICU) to admit into: ";
+    string target;
+    getline(cin, target);
     int bedIdx = -1;
-    for (int i = 0; i < hospitalBedCount; i++)
-        if (hospitalBeds[i].roomID == rid && !hospitalBeds[i].occupied)
-        {
-            bedIdx = i; break;
-        }
-    if (bedIdx == -1) { cout << "No free bed in room " << rid << "\n"; return; }
-    hospitalBeds[bedIdx].occupied = true;
-    hospitalBeds[bedIdx].patientID = pid;
-    for (int i = 0; i < hospitalPatientCount; i++)
-        if (hospitalPatients[i].patient_id == pid)
+    if (!target.empty() && isdigit((unsigned char)target[0]))
+    {
+        int rid = hospitalToInt(target);
+        unordered_map<int, int>::iterator rit = hospitalCtx->roomIndex.find(rid);
+        if (rit != hospitalCtx->roomIndex.end())
         {
-            hospitalPatients[i].status = 1; // admitted
-            hospital_patient_hash_remove(pid);
-            hospital_patient_hash_insert(hospitalPatients[i]);
-            break;
+            const HospitalRoom &r = hospitalCtx->rooms[rit->second];
+            bedIdx = hospital_bedset_first_in(hospitalCtx->freeBeds, r.bedStartIdx, r.bedStartIdx + r.bedCount);
         }
-    cout << "Admitted patient " << pid << " to bed " << hospitalBeds[bedIdx].bedID << "\n";
+        if (bedIdx == -1) { cout << "No free bed in room " << rid << "\n"; return; }
+    }
+    else
+    {
+        int w = hospital_ward_id(target, false);
+        if (w >= 0) bedIdx = hospital_bedset_first(hospitalCtx->wardFree[w]);
+        if (bedIdx == -1) { cout << "No free bed in ward " << target << "\n"; return; }
+    }
+    hospital_bed_occupy(bedIdx, pid);
+    p->status = 1; // admitted
+    cout << "Admitted patient " << pid << " to bed " << hospitalCtx->beds[bedIdx].bedID << " (room " << hospitalCtx->beds[bedIdx].roomID << ")\n";
 }
 
 // Discharge patient
@@ -501,33 +758,35 @@ void hospitalDischargePatient()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    for (int i = 0; i < hospitalPatientCount; i++)
+    HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    unordered_map<int, int>::iterator cur = hospitalCtx->patientBed.find(pid);
+    if (cur != hospitalCtx->patientBed.end()) hospital_bed_release(cur->second);
+    p->status = 3;
+    cout << "Patient " << pid << " discharged.\n";
+}
+
+// Ward occupancy from the free-bed bitsets
+void hospitalWardDashboard()
+{
+    if (hospitalCtx->beds.empty()) { cout << "No rooms loaded.\n"; return; }
+    cout << "\n========= WARD OCCUPANCY =========\n";
+    int totalBeds = hospitalCtx->beds.size();
+    int totalFree = hospital_bedset_count(hospitalCtx->freeBeds);
+    for (int w = 0; w < (int)hospitalCtx->wardNames.size(); ++w)
     {
-        if (hospitalPatients[i].patient_id == pid)
-        {
-            for (int b = 0; b < hospitalBedCount; b++)
-            {
-                if (hospitalBeds[b].patientID == pid)
-                {
-                    hospitalBeds[b].patientID = -1;
-                    hospitalBeds[b].occupied = false;
-                    break;
-                }
-            }
-            hospitalPatients[i].status = 3;
-            hospital_patient_hash_remove(pid);
-            hospital_patient_hash_insert(hospitalPatients[i]);
-            cout << "Patient " << pid << " discharged.\n";
-            return;
-        }
+        int beds = hospitalCtx->wardBeds[w];
+        int occ = beds - hospital_bedset_count(hospitalCtx->wardFree[w]);
+        cout << left << setw(12) << hospitalCtx->wardNames[w] << right << " Beds:" << setw(4) << beds << " | Occupied:" << setw(4) << occ
+             << " | Free:" << setw(4) << beds - occ << " | " << (beds ? occ * 100 / beds : 0) << "%\n";
     }
-    cout << "Patient not found.\n";
+    cout << "Total beds: " << totalBeds << " | Occupied: " << totalBeds - totalFree << " | Free: " << totalFree << "\n";
 }
 
 // Add staff
 void hospitalAddStaffInteractive()
 {
-    if (hospitalStaffCount >= HOSPITAL_MAX_STAFF) { cout << "Overflow: staff capacity reached!\n"; return; }
+    if ((int)hospitalCtx->staff.size() >= HOSPITAL_MAX_STAFF) { cout << "Overflow: staff capacity reached!\n"; return; }
     HospitalStaff s;
     s.id = hospital_createStaffID();
     cout << "Enter name: ";
@@ -542,16 +801,16 @@ void hospitalAddStaffInteractive()
     cout << "Enter salary: "; getline(cin, tmp); s.salary =  hospitalToInt(tmp);
     cout << "Enter contact: "; getline(cin, tmp); strncpy(s.contact, tmp.c_str(), sizeof(s.contact)-1);
     cout << "Enter specialty (if doctor): "; getline(cin, tmp); strncpy(s.specialty, tmp.c_str(), sizeof(s.specialty)-1);
-    hospitalStaff[hospitalStaffCount++] = s;
+    hospitalCtx->staff.push_back(s);
     cout << "Staff added ID " << s.id << "\n";
 }
 
 void hospitalListStaff()
 {
-    if (hospitalStaffCount == 0) { cout << "No staff.\n"; return; }
-    for (int i = 0; i < hospitalStaffCount; i++)
+    if (hospitalCtx->staff.empty()) { cout << "No staff.\n"; return; }
+    for (int i = 0; i < (int)hospitalCtx->staff.size(); i++)
     {
-        cout << hospitalStaff[i].id << " | " << hospitalStaff[i].name << " | " << hospitalStaff[i].role << " | Dept:" << hospitalStaff[i].department << " | Sal:" << hospitalStaff[i].salary << "\n";
+        cout << hospitalCtx->staff[i].id << " | " << hospitalCtx->staff[i].name << " | " << hospitalCtx->staff[i].role << " | Dept:" << hospitalCtx->staff[i].department << " | Sal:" << hospitalCtx->staff[i].salary << "\n";
     }
 }
 
@@ -564,13 +823,13 @@ void hospitalSearchPatientByName()
     if (pat.empty()) { cout << "Empty.\n"; return; }
     string patL = pat; for (size_t i = 0; i < patL.size(); ++i) patL[i] = tolower((unsigned char)patL[i]);
     bool found = false;
-    for (int i = 0; i < hospitalPatientCount; i++)
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); i++)
     {
-        string name = hospitalPatients[i].name;
+        string name = hospital_str(hospitalCtx->patients[i].name);
         string nameL = name; for (size_t k = 0; k < nameL.size(); ++k) nameL[k] = tolower((unsigned char)nameL[k]);
         if (nameL.find(patL) != string::npos)
         {
-            cout << "Found ID:" << hospitalPatients[i].patient_id << " | " << hospitalPatients[i].name << " | Age:" << hospitalPatients[i].age << " | Status:" << hospitalPatients[i].status << "\n";
+            cout << "Found ID:" << hospitalCtx->patients[i].patient_id << " | " << hospital_str(hospitalCtx->patients[i].name) << " | Age:" << hospitalCtx->patients[i].age << " | Status:" << hospitalCtx->patients[i].status << "\n";
             found = true;
         }
     }
@@ -584,15 +843,14 @@ void hospitalSearchPatientByIDInteractive()
     int pid;
     if (!(cin >> pid)) { cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n'); cout<<"Invalid.\n"; return; }
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    HospitalPatient p;
-    if (!hospital_patient_hash_get(pid, p)) { cout << "Patient not found.\n"; return; }
-    cout << "Patient: " << p.patient_id << " | " << p.name << " | Age:" << p.age << " | Gender:" << p.gender << " | Contact:" << p.contact << " | Status:" << p.status << "\n";
+    const HospitalPatient *p = hospital_patient_find(pid);
+    if (!p) { cout << "Patient not found.\n"; return; }
+    cout << "Patient: " << p->patient_id << " | " << hospital_str(p->name) << " | Age:" << p->age << " | Gender:" << hospital_str(p->gender) << " | Contact:" << hospital_str(p->contact) << " | Status:" << p->status << "\n";
 }
 
 // ---------- Merged Booking: Appointment / Surgery / Lab ----------
 void hospitalBookAppointmentInteractive()
 {
-    if (hospitalApptCount >= HOSPITAL_MAX_APPOINTS) { cout << "Overflow: appointments limit\n"; return; }
     HospitalAppointment a;
     a.apptID = hospital_createApptID();
     cout << "Select booking type: (1) General Checkup  (2) Surgery  (3) Lab Test\n";
@@ -604,77 +862,162 @@ void hospitalBookAppointmentInteractive()
     a.type = t;
     cout << "Enter patient ID: "; getline(cin, tmp); a.patientID =  hospitalToInt(tmp);
     cout << "Enter doctor ID: "; getline(cin, tmp); a.doctorID =  hospitalToInt(tmp);
-    cout << "Enter date (YYYY-MM-DD): "; getline(cin, tmp); strncpy(a.date, tmp.c_str(), sizeof(a.date)-1); a.date[sizeof(a.date)-1]=0;
-    cout << "Enter time (HH:MM): "; getline(cin, tmp); strncpy(a.time, tmp.c_str(), sizeof(a.time)-1); a.time[sizeof(a.time)-1]=0;
+    cout << "Enter date (YYYY-MM-DD): "; getline(cin, tmp); a.date = cityDate(tmp);
+    if (a.date == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    cout << "Enter time (HH:MM): "; getline(cin, tmp); a.time = cityTime(tmp);
+    if (a.time < 0) { cout << "Invalid time.\n"; return; }
     cout << "Enter duration minutes (typical): "; getline(cin, tmp); a.duration =  hospitalToInt(tmp);
     a.status = 0;
-    strncpy(a.remarks, "", sizeof(a.remarks)-1);
+    a.remarks = 0;
     // If surgery, collect optional surgery details
     if (a.type == 2)
     {
         cout << "Enter OT room ID (optional, -1 if none): "; getline(cin, tmp); a.OTroomID =  hospitalToInt(tmp);
         cout << "Enter expected surgery duration (minutes): "; getline(cin, tmp); a.durationMins =  hospitalToInt(tmp);
-        cout << "Enter anesthesia type: "; getline(cin, tmp); strncpy(a.anesthesiaType, tmp.c_str(), sizeof(a.anesthesiaType)-1); a.anesthesiaType[sizeof(a.anesthesiaType)-1]=0;
+        cout << "Enter anesthesia type: "; getline(cin, tmp); a.anesthesiaType = hospital_text(tmp, 32);
     }
     else
     {
-        a.OTroomID = -1; a.durationMins = 0; strncpy(a.anesthesiaType,"",sizeof(a.anesthesiaType)-1);
+        a.OTroomID = -1; a.durationMins = 0; a.anesthesiaType = 0;
     }
     // If lab, collect test type (results are loaded from CSV only later)
     if (a.type == 3)
     {
-        cout << "Enter test type: "; getline(cin, tmp); strncpy(a.testType, tmp.c_str(), sizeof(a.testType)-1); a.testType[sizeof(a.testType)-1]=0;
-        strncpy(a.resultDate, "", sizeof(a.resultDate)-1);
-        strncpy(a.resultSummary, "", sizeof(a.resultSummary)-1);
+        cout << "Enter test type: "; getline(cin, tmp); a.testType = hospital_text(tmp, 64);
+        a.resultDate = CITY_NO_DATE;
+        a.resultSummary = 0;
     }
     else
     {
-        strncpy(a.testType,"",sizeof(a.testType)-1);
-        strncpy(a.resultDate,"",sizeof(a.resultDate)-1);
-        strncpy(a.resultSummary,"",sizeof(a.resultSummary)-1);
+        a.testType = 0;
+        a.resultDate = CITY_NO_DATE;
+        a.resultSummary = 0;
+    }
+    // Doctor, OT room and lab bench must all be free for the whole slot
+    long long keys[3];
+    int nk = hospital_appt_resources(a, a.date, keys);
+    int len = hospital_appt_length(a);
+    for (int k = 0; k < nk && len > 0; ++k)
+    {
+        const HospitalSlot *c = hospital_calendar_conflict(keys[k], a.time, a.time + len);
+        if (!c) continue;
+        cout << "Conflict: " << hospital_res_name(keys[k]) << " busy " << cityFormatTime(c->start) << "-" << cityFormatTime(c->end) << " (appointment " << c->apptID << ").\n";
+        CityDate day;
+        int st;
+        bool found = hospital_find_slot(a, a.date, a.time, day, st);
+        if (found)
+            cout << "Earliest free slot: " << cityFormatDate(day) << " " << cityFormatTime(st) << ". Book it? (y = yes, w = waiting list, other = cancel): ";
+        else
+            cout << "No free slot in the next " << HOSPITAL_SLOT_SEARCH_DAYS << " days. (w = waiting list, other = cancel): ";
+        getline(cin, tmp);
+        char ans = tmp.empty() ? 0 : (char)tolower((unsigned char)tmp[0]);
+        if (ans == 'y' && found) { a.date = day; a.time = st; }
+        else if (ans == 'w') { a.time = -1; a.status = 3; }
+        else { cout << "Booking cancelled.\n"; return; }
+        break;
+    }
+    hospitalCtx->appts.push_back(a);
+    hospital_calendar_add(a);
+    if (a.status == 3)
+        cout << "Appointment " << a.apptID << " added to the waiting list for " << cityFormatDate(a.date) << "\n";
+    else
+        cout << "Appointment booked ID " << a.apptID << " (type " << a.type << ") at " << cityFormatDate(a.date) << " " << cityFormatTime(a.time) << "\n";
+}
+
+// Earliest free slot for one doctor
+void hospitalFindFreeSlotInteractive()
+{
+    HospitalAppointment a;
+    string tmp;
+    a.type = 1;
+    cout << "Enter doctor ID: "; getline(cin, tmp); a.doctorID = hospitalToInt(tmp);
+    cout << "Enter length (minutes): "; getline(cin, tmp); a.duration = hospitalToInt(tmp);
+    if (a.duration <= 0) { cout << "Invalid length.\n"; return; }
+    cout << "Not before date (YYYY-MM-DD): "; getline(cin, tmp);
+    CityDate from = cityDate(tmp);
+    if (from == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    cout << "Not before time (HH:MM, blank = opening): "; getline(cin, tmp);
+    int t = tmp.empty() ? HOSPITAL_DAY_OPEN : cityTime(tmp);
+    if (t < 0) { cout << "Invalid time.\n"; return; }
+    CityDate day;
+    int st;
+    if (hospital_find_slot(a, from, t, day, st))
+        cout << "Doctor " << a.doctorID << " is free " << cityFormatDate(day) << " " << cityFormatTime(st) << "-" << cityFormatTime(st + a.duration) << "\n";
+    else
+        cout << "No free slot in the next " << HOSPITAL_SLOT_SEARCH_DAYS << " days.\n";
+}
+
+// Pack one day's waiting list into free slots, longest appointments first
+// (they are the hardest to fit). Anything that does not fit stays waiting.
+void hospitalScheduleWaitingList()
+{
+    cout << "Enter date to schedule (YYYY-MM-DD): ";
+    string tmp;
+    getline(cin, tmp);
+    CityDate d = cityDate(tmp);
+    if (d == CITY_NO_DATE) { cout << "Invalid date.\n"; return; }
+    vector<int> wait;
+    for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
+        if (hospitalCtx->appts[i].status == 3 && hospitalCtx->appts[i].date == d) wait.push_back(i);
+    if (wait.empty()) { cout << "Nobody waiting for " << tmp << ".\n"; return; }
+    stable_sort(wait.begin(), wait.end(), [](int x, int y) { return hospital_appt_length(hospitalCtx->appts[x]) > hospital_appt_length(hospitalCtx->appts[y]); });
+    int placed = 0;
+    for (size_t w = 0; w < wait.size(); ++w)
+    {
+        HospitalAppointment &a = hospitalCtx->appts[wait[w]];
+        int len = hospital_appt_length(a);
+        if (len <= 0) continue;
+        long long keys[3];
+        int nk = hospital_appt_resources(a, d, keys);
+        int st = hospital_common_free(keys, nk, HOSPITAL_DAY_OPEN, len, HOSPITAL_DAY_CLOSE);
+        if (st < 0) continue;
+        a.time = st;
+        a.status = 0;
+        hospital_calendar_add(a);
+        cout << "  " << a.apptID << " -> " << cityFormatTime(st) << "-" << cityFormatTime(st + len) << " (Doctor " << a.doctorID << ")\n";
+        placed++;
     }
-    hospitalAppts[hospitalApptCount++] = a;
-    cout << "Appointment booked ID " << a.apptID << " (type " << a.type << ")\n";
+    cout << "Scheduled " << placed << " of " << wait.size() << " waiting appointments; " << (int)wait.size() - placed << " still waiting.\n";
 }
 
 // List appointments
 void hospitalListAppointments()
 {
-    if (hospitalApptCount == 0) { cout << "No appointments.\n"; return; }
+    if (hospitalCtx->appts.empty()) { cout << "No appointments.\n"; return; }
     cout << "Appointments:\n";
-    for (int i = 0; i < hospitalApptCount; ++i)
+    for (int i = 0; i < (int)hospitalCtx->appts.size(); ++i)
     {
-        HospitalAppointment &a = hospitalAppts[i];
+        HospitalAppointment &a = hospitalCtx->appts[i];
         string tstr = (a.type==1?"General":(a.type==2?"Surgery":"Lab"));
-        cout << a.apptID << " | " << tstr << " | Patient:" << a.patientID << " | Doctor:" << a.doctorID << " | " << a.date << " " << a.time << " | Dur:" << a.duration << " | Status:" << a.status;
+        cout << a.apptID << " | " << tstr << " | Patient:" << a.patientID << " | Doctor:" << a.doctorID << " | " << cityFormatDate(a.date) << " " << cityFormatTime(a.time) << " | Dur:" << a.duration << " | Status:" << a.status;
         if (a.type == 2)
-            cout << " | OT:" << a.OTroomID << " | SurgDur:" << a.durationMins << " | Anesth:" << a.anesthesiaType;
+            cout << " | OT:" << a.OTroomID << " | SurgDur:" << a.durationMins << " | Anesth:" << hospital_str(a.anesthesiaType);
         if (a.type == 3)
-            cout << " | Test:" << a.testType << " | ResultDate:" << a.resultDate << " | ResultSummary:" << a.resultSummary;
-        if (strlen(a.remarks) > 0) cout << " | Remarks:" << a.remarks;
+            cout << " | Test:" << hospital_str(a.testType) << " | ResultDate:" << cityFormatDate(a.resultDate) << " | ResultSummary:" << hospital_str(a.resultSummary);
+        if (a.remarks) cout << " | Remarks:" << hospital_str(a.remarks);
         cout << "\n";
     }
 }
 void hospitalShowAllPatients()
 {
-    if (hospitalPatientCount == 0)
+    if (hospitalCtx->patients.empty())
     {
         cout << "No patients found.\n";
         return;
     }
 
     cout << "\n=========== ALL PATIENTS ==========\n";
-    for (int i = 0; i < hospitalPatientCount; i++)
+    for (int i = 0; i < (int)hospitalCtx->patients.size(); i++)
     {
-        HospitalPatient &p = hospitalPatients[i];
+        HospitalPatient &p = hospitalCtx->patients[i];
         cout << "ID: " << p.patient_id
-             << " | Name: " << p.name
+             << " | Name: " << hospital_str(p.name)
              << " | Age: " << p.age
-             << " | Gender: " << p.gender
-             << " | Contact: " << p.contact
+             << " | Gender: " << hospital_str(p.gender)
+             << " | Contact: " << hospital_str(p.contact)
              << " | Status: " << p.status
-             << "\nAddress: " << p.address
-             << "\nNotes: " << p.notes
+             << "\nAddress: " << hospital_str(p.address)
+             << "\nNotes: " << hospital_str(p.notes)
              << "\n------------------------------------\n";
     }
 }
@@ -716,6 +1059,9 @@ void hospitalShowMenu()
     cout << "14. Load labs CSV (labs.csv)  (updates lab results only)\n";
     cout << "15. Load All CSV\n";
     cout << "16. Show All Patients\n";
+    cout << "17. Find Earliest Free Slot for Doctor\n";
+    cout << "18. Schedule Waiting List for a Day\n";
+    cout << "19. Ward Occupancy Dashboard\n";
     cout << " 0. Return to MAIN MENU\n";
     cout << "====================================\n";
     cout << "Enter choice: ";
@@ -723,8 +1069,11 @@ void hospitalShowMenu()
 
 void hospitalInitModule()
 {
+    if (hospitalCtx)
+        return; // state is kept across visits to the menu
+    hospitalCtx = new HospitalContext(); // bitsets and ward totals start zeroed
+    hospitalCtx->arena.push_back('\0');
     hospital_init_patient_hash();
-    // other arrays are default-initialized by static storage
 }
 
 // hospitalSystem (entry)
@@ -761,6 +1110,9 @@ void hospitalSystem()
         case 14: hospitalLoadLabsCSV("labs.csv"); break;
         case 15: hospitalLoadAllData();break;
         case 16: hospitalShowAllPatients();break;
+        case 17: hospitalFindFreeSlotInteractive(); break;
+        case 18: hospitalScheduleWaitingList(); break;
+        case 19: hospitalWardDashboard(); break;
 
         case 0: cout << "Returning to main menu...\n"; return;
         default: cout << "Invalid choice.\n";
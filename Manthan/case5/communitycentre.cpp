@@ -2,6 +2,12 @@
 #include <fstream>
 #include <string>
 #include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include "../city_date.h"
+#include "../city_dict.h"
 using namespace std;
 
 /* ===================== CONFIG ===================== */
@@ -17,6 +23,16 @@ using namespace std;
 static int toInt(const string &s){ try{return stoi(s);}catch(...){return 0;} }
 static double toDouble(const string &s){ try{return stod(s);}catch(...){return 0.0;} }
 
+/* data rows in a CSV (header excluded); rewinds the stream */
+static int communityCountRows(ifstream &in){
+    int rows=0;
+    string line;
+    while(getline(in,line)) rows++;
+    in.clear();
+    in.seekg(0);
+    return rows>0 ? rows-1 : 0;
+}
+
 static int splitCSV(const string &line, string out[], int maxCols){
     int col = 0;
     string cur = "";
@@ -32,35 +48,142 @@ static int splitCSV(const string &line, string out[], int maxCols){
     return col;
 }
 
-static bool timeOverlap(const string &d1,const string &s1,const string &e1,
-                        const string &d2,const string &s2,const string &e2){
-    if(d1 != d2) return false;
-    string a=d1+" "+s1, b=d1+" "+e1, c=d2+" "+s2, d=d2+" "+e2;
-    return (a < d && c < b);
+/* dates are day numbers, times minutes after midnight */
+static bool timeOverlap(CityDate d1,int s1,int e1,CityDate d2,int s2,int e2){
+    return (d1==d2) & (s1<e2) & (s2<e1);
 }
 
 /* ===================== STRUCTS ===================== */
-struct Member{ int id,age,active; string name,phone,email,mtype,join_date,address; };
-struct Staff{ int id,active; double salary; string name,role,phone,email,join_date; };
+struct Member{ int id,age,active; CityDate join_date; string name,phone,email,mtype,address; };
+struct Staff{ int id,active; double salary; CityDate join_date; string name,role,phone,email; };
 struct Facility{ int id,capacity,active; double price; string name,type,location,from,to; };
-struct Equipment{ int id,qty_total,qty_avail; string name,cond,last_maint; };
-struct Event{ int id,org_member,facility,expected; double revenue; string title,date,start,end,status; };
-struct Booking{ int id,event_id,member_id,facility_id; double total; string date,start,end,status; };
-struct Revenue{ int id,src_id; double amount; string src,date,desc; };
-struct Expense{ int id,related; double amount; string date,vendor,desc,type; };
-
-/* ===================== GLOBAL ARRAYS ===================== */
-static Member members[MAX_MEMBERS]; int memberCount=0;
-static Staff staffs[MAX_STAFF]; int staffCount=0;
-static Facility facilities[MAX_FACILITIES]; int facilityCount=0;
-static Equipment equipmentArr[MAX_EQUIPMENT]; int equipmentCount=0;
-static Event eventsArr[MAX_EVENTS]; int eventCount=0;
-static Booking bookings[MAX_BOOKINGS]; int bookingCount=0;
-static Revenue revenues[MAX_TXN]; int revenueCount=0;
-static Expense expenses[MAX_TXN]; int expenseCount=0;
+struct Equipment{ int id,qty_total,qty_avail; CityDate last_maint; string name,cond; };
+struct Event{ int id,org_member,facility,expected,start,end; CityDate date; double revenue; string title; CityCode status; };
+struct Booking{ int id,event_id,member_id,facility_id,start,end; CityDate date; double total; CityCode status; };
+struct Revenue{ int id,src_id; CityDate date; double amount; string src,desc; };
+struct Expense{ int id,related; CityDate date; double amount; string vendor,desc,type; };
+
+/* ===================== STATUS CODES =====================
+   Event and booking status are interned (city_dict.h); the seeded values
+   below have fixed codes, others from the CSVs are added as they appear. */
+static CityDict communityEventStatus = cityDictMake({"scheduled","approved","pending"});
+static CityDict communityBookingStatus = cityDictMake({"paid","partial","unpaid"});
+#define COMMUNITY_EVENT_SCHEDULED 0
+#define COMMUNITY_BOOKING_PAID 0
+
+/* ===================== MODULE CONTEXT =====================
+   Created by communityInitModule(); MAX_* cap what the add menus accept. */
+struct CommunityContext{
+    vector<Member> members;
+    vector<Staff> staffs;
+    vector<Facility> facilities;
+    vector<Equipment> equipmentArr;
+    vector<Event> eventsArr;
+    vector<Booking> bookings;
+    vector<Revenue> revenues;
+    vector<Expense> expenses;
+};
+static CommunityContext *communityCtx = NULL;
+
+/* ===================== BOOKING CALENDAR =====================
+   Accepted bookings per (facility, day), sorted by start minute.
+   Slots within one day never overlap (every insert is checked first),
+   so a conflict can only be with the neighbours of the insert point.
+   Slots carry the booking id, not the array index, because communityCtx->bookings[]
+   is re-ordered by the sort menu.
+   Bookings whose end is not after their start are empty and not indexed. */
+struct communitySlot{ int start,end,id; };
+static map<long long, vector<communitySlot> > communityCalendar;
+
+static long long communityDayKey(int fac,CityDate d){ return ((long long)fac<<32) | (unsigned)d; }
+
+static size_t communitySlotPos(const vector<communitySlot> &v,int st){
+    return lower_bound(v.begin(),v.end(),st,[](const communitySlot &a,int x){ return a.start<x; })-v.begin();
+}
+
+static void communityCalendarAdd(const Booking &b){
+    if(b.end<=b.start) return;
+    vector<communitySlot> &v=communityCalendar[communityDayKey(b.facility_id,b.date)];
+    communitySlot sl={b.start,b.end,b.id};
+    v.insert(v.begin()+communitySlotPos(v,b.start),sl);
+}
+
+/* ===================== DATE INDEXES =====================
+   Row indices of communityCtx->bookings[] and communityCtx->revenues[] ordered by date, so range
+   reports seek to the first day and stop after the last. Ties keep
+   insertion order. communityCtx->bookings[] is re-ordered by the sort menu, which
+   rebuilds its index. */
+struct communityDateRow{ CityDate date; int row; };
+static vector<communityDateRow> communityBookingsByDate, communityRevenueByDate;
+
+static bool communityDateLess(const communityDateRow &a,const communityDateRow &b){ return a.date<b.date; }
+
+static size_t communityDateSeek(const vector<communityDateRow> &v,CityDate d){
+    communityDateRow k={d,0};
+    return lower_bound(v.begin(),v.end(),k,communityDateLess)-v.begin();
+}
+
+static void communityDateIndexAdd(vector<communityDateRow> &v,CityDate d,int row){
+    communityDateRow k={d,row};
+    v.insert(upper_bound(v.begin(),v.end(),k,communityDateLess),k);
+}
+
+static void communityIndexBookingDates(){
+    int n=communityCtx->bookings.size();
+    communityBookingsByDate.resize(n);
+    for(int i=0;i<n;i++){ communityBookingsByDate[i].date=communityCtx->bookings[i].date; communityBookingsByDate[i].row=i; }
+    stable_sort(communityBookingsByDate.begin(),communityBookingsByDate.end(),communityDateLess);
+}
+
+static void communityIndexRevenueDates(){
+    int n=communityCtx->revenues.size();
+    communityRevenueByDate.resize(n);
+    for(int i=0;i<n;i++){ communityRevenueByDate[i].date=communityCtx->revenues[i].date; communityRevenueByDate[i].row=i; }
+    stable_sort(communityRevenueByDate.begin(),communityRevenueByDate.end(),communityDateLess);
+}
+
+/* ===================== EVENT LEDGER =====================
+   event_id -> its revenue and expense rows (indices into communityCtx->revenues[] /
+   communityCtx->expenses[], which are never re-ordered). Booking revenue is resolved
+   through booking_id -> event_id; rows for a booking not seen yet wait
+   in communityPendingRevenue until that booking is added. */
+struct communityEventLedger{ vector<int> rev,exp; };
+static unordered_map<int,int> communityBookingEvent;
+static unordered_map<int,communityEventLedger> communityLedger;
+static unordered_map<int,vector<int> > communityPendingRevenue;
+
+static void communityLedgerAddRevenue(int row){
+    Revenue &r=communityCtx->revenues[row];
+    if(r.src=="event"){ communityLedger[r.src_id].rev.push_back(row); return; }
+    if(r.src!="booking") return;
+    unordered_map<int,int>::const_iterator it=communityBookingEvent.find(r.src_id);
+    if(it!=communityBookingEvent.end()) communityLedger[it->second].rev.push_back(row);
+    else communityPendingRevenue[r.src_id].push_back(row);
+}
+
+static void communityLedgerAddExpense(int row){
+    communityLedger[communityCtx->expenses[row].related].exp.push_back(row);
+}
+
+static void communityLedgerAddBooking(const Booking &b){
+    communityBookingEvent[b.id]=b.event_id;
+    unordered_map<int,vector<int> >::iterator it=communityPendingRevenue.find(b.id);
+    if(it==communityPendingRevenue.end()) return;
+    vector<int> &rev=communityLedger[b.event_id].rev;
+    rev.insert(rev.end(),it->second.begin(),it->second.end());
+    communityPendingRevenue.erase(it);
+}
+
+static void communityRebuildLedger(){
+    communityBookingEvent.clear(); communityLedger.clear(); communityPendingRevenue.clear();
+    communityBookingEvent.reserve(communityCtx->bookings.size());
+    for(size_t i=0;i<communityCtx->bookings.size();i++) communityLedgerAddBooking(communityCtx->bookings[i]);
+    for(size_t i=0;i<communityCtx->revenues.size();i++) communityLedgerAddRevenue(i);
+    for(size_t i=0;i<communityCtx->expenses.size();i++) communityLedgerAddExpense(i);
+}
 
 /* ===================== FORWARD DEFS ===================== */
-bool communityCheckBookingOverlap(int fac,const string &d,const string &st,const string &en);
+bool communityCheckBookingOverlap(int fac,CityDate d,int st,int en);
 void communityBulkFindOverlaps();
 void communityMainMenu();
 
@@ -83,166 +206,177 @@ static void printHeader(const string cols[], const int w[], int n){
 
 /* ============================================================
    ======================= LOADERS =============================
-   (Each loader resets its own count)
+   (Each loader replaces its own table)
    ============================================================ */
 
 void communityLoadMembersCSV(const string &fn){
-    memberCount = 0;
+    communityCtx->members.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->members.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[9]; int n = splitCSV(line,c,9);
         if(n<2) continue;
-        Member &m = members[memberCount];
+        Member m;
         m.id=toInt(c[0]); m.name=c[1]; m.age=(n>2?toInt(c[2]):0);
         m.phone=c[3]; m.email=c[4]; m.mtype=c[5];
-        m.join_date=c[6]; m.address=c[7]; m.active=toInt(c[8]);
-        if(m.id!=0) memberCount++;
+        m.join_date=cityDate(c[6]); m.address=c[7]; m.active=toInt(c[8]);
+        if(m.id!=0) communityCtx->members.push_back(m);
     }
-    cout<<"Loaded "<<memberCount<<" members\n";
+    cout<<"Loaded "<<communityCtx->members.size()<<" members\n";
 }
 
 void communityLoadStaffCSV(const string &fn){
-    staffCount = 0;
+    communityCtx->staffs.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->staffs.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[8]; int n=splitCSV(line,c,8);
         if(n<2) continue;
-        Staff &s = staffs[staffCount];
+        Staff s;
         s.id=toInt(c[0]); s.name=c[1]; s.role=c[2];
         s.phone=c[3]; s.email=c[4];
-        s.salary=(n>5?toDouble(c[5]):0); s.join_date=c[6];
+        s.salary=(n>5?toDouble(c[5]):0); s.join_date=cityDate(c[6]);
         s.active=(n>7?toInt(c[7]):1);
-        if(s.id!=0) staffCount++;
+        if(s.id!=0) communityCtx->staffs.push_back(s);
     }
-    cout<<"Loaded "<<staffCount<<" staff\n";
+    cout<<"Loaded "<<communityCtx->staffs.size()<<" staff\n";
 }
 
 void communityLoadFacilitiesCSV(const string &fn){
-    facilityCount = 0;
+    communityCtx->facilities.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->facilities.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[9]; int n=splitCSV(line,c,9);
-        Facility &f=facilities[facilityCount];
+        Facility f;
         f.id=toInt(c[0]); f.name=c[1]; f.type=c[2];
         f.capacity=toInt(c[3]); f.price=toDouble(c[4]);
         f.location=c[5]; f.from=c[6]; f.to=c[7];
         f.active=(n>8?toInt(c[8]):1);
-        if(f.id!=0) facilityCount++;
+        if(f.id!=0) communityCtx->facilities.push_back(f);
     }
-    cout<<"Loaded "<<facilityCount<<" facilities\n";
+    cout<<"Loaded "<<communityCtx->facilities.size()<<" facilities\n";
 }
 
 void communityLoadEquipmentCSV(const string &fn){
-    equipmentCount = 0;
+    communityCtx->equipmentArr.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->equipmentArr.reserve(communityCountRows(in));
     string line; getline(in,line);
     while(getline(in,line)){
         string c[6]; int n=splitCSV(line,c,6);
-        Equipment &e = equipmentArr[equipmentCount];
+        Equipment e;
         e.id=toInt(c[0]); e.name=c[1];
         e.qty_total=toInt(c[2]);
         e.qty_avail=toInt(c[3]);
-        e.cond=c[4]; e.last_maint=c[5];
-        if(e.id!=0) equipmentCount++;
+        e.cond=c[4]; e.last_maint=cityDate(c[5]);
+        if(e.id!=0) communityCtx->equipmentArr.push_back(e);
     }
-    cout<<"Loaded "<<equipmentCount<<" equipment\n";
+    cout<<"Loaded "<<communityCtx->equipmentArr.size()<<" equipment\n";
 }
 
 void communityLoadEventsCSV(const string &fn){
-    eventCount=0;
+    communityCtx->eventsArr.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->eventsArr.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[10]; splitCSV(l,c,10);
-        Event &e = eventsArr[eventCount];
+        Event e;
         e.id=toInt(c[0]); e.title=c[1];
         e.org_member=toInt(c[2]); e.facility=toInt(c[3]);
-        e.date=c[4]; e.start=c[5]; e.end=c[6];
+        e.date=cityDate(c[4]); e.start=cityTime(c[5]); e.end=cityTime(c[6]);
         e.expected=toInt(c[7]); e.revenue=toDouble(c[8]);
-        e.status=c[9];
-        if(e.id!=0) eventCount++;
+        e.status=cityIntern(communityEventStatus,c[9]);
+        if(e.id!=0) communityCtx->eventsArr.push_back(e);
     }
-    cout<<"Loaded "<<eventCount<<" events\n";
+    cout<<"Loaded "<<communityCtx->eventsArr.size()<<" events\n";
 }
 
-bool communityCheckBookingOverlap(int fac,const string &d,const string &st,const string &en){
-    for(int i=0;i<bookingCount;i++){
-        Booking &b=bookings[i];
-        if(b.facility_id==fac && b.date==d){
-            if(timeOverlap(d,st,en,b.date,b.start,b.end))
-                return true;
-        }
-    }
+bool communityCheckBookingOverlap(int fac,CityDate d,int st,int en){
+    if(en<=st) return false;
+    map<long long, vector<communitySlot> >::const_iterator it=communityCalendar.find(communityDayKey(fac,d));
+    if(it==communityCalendar.end()) return false;
+    const vector<communitySlot> &v=it->second;
+    size_t i=communitySlotPos(v,st);
+    if(i<v.size() && timeOverlap(d,st,en,d,v[i].start,v[i].end)) return true;
+    if(i>0 && timeOverlap(d,st,en,d,v[i-1].start,v[i-1].end)) return true;
     return false;
 }
 
 void communityLoadBookingsCSV(const string &fn){
-    bookingCount=0;
+    communityCtx->bookings.clear();
+    communityCalendar.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->bookings.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[9]; splitCSV(l,c,9);
         Booking b;
         b.id=toInt(c[0]); b.event_id=toInt(c[1]);
         b.member_id=toInt(c[2]); b.facility_id=toInt(c[3]);
-        b.date=c[4]; b.start=c[5]; b.end=c[6];
-        b.total=toDouble(c[7]); b.status=c[8];
+        b.date=cityDate(c[4]); b.start=cityTime(c[5]); b.end=cityTime(c[6]);
+        b.total=toDouble(c[7]); b.status=cityIntern(communityBookingStatus,c[8]);
         if(b.id==0) continue;
 
         if(communityCheckBookingOverlap(b.facility_id,b.date,b.start,b.end)){
             cout<<"Skip overlap booking "<<b.id<<"\n"; 
             continue;
         }
-        bookings[bookingCount++] = b;
+        communityCalendarAdd(b);
+        communityCtx->bookings.push_back(b);
     }
-    cout<<"Loaded "<<bookingCount<<" bookings\n";
+    communityIndexBookingDates();
+    cout<<"Loaded "<<communityCtx->bookings.size()<<" bookings\n";
 }
 
 void communityLoadRevenueCSV(const string &fn){
-    revenueCount=0;
+    communityCtx->revenues.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->revenues.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[6]; splitCSV(l,c,6);
-        Revenue &r = revenues[revenueCount];
+        Revenue r;
         r.id=toInt(c[0]); r.src=c[1]; r.src_id=toInt(c[2]);
-        r.date=c[3]; r.amount=toDouble(c[4]); r.desc=c[5];
-        if(r.id!=0) revenueCount++;
+        r.date=cityDate(c[3]); r.amount=toDouble(c[4]); r.desc=c[5];
+        if(r.id!=0) communityCtx->revenues.push_back(r);
     }
-    cout<<"Loaded "<<revenueCount<<" revenue rows\n";
+    communityIndexRevenueDates();
+    cout<<"Loaded "<<communityCtx->revenues.size()<<" revenue rows\n";
 }
 
 void communityLoadExpensesCSV(const string &fn){
-    expenseCount=0;
+    communityCtx->expenses.clear();
     ifstream in(fn);
     if(!in){ cout<<"Cannot open "<<fn<<"\n"; return; }
+    communityCtx->expenses.reserve(communityCountRows(in));
     string l; getline(in,l);
     while(getline(in,l)){
         string c[7]; splitCSV(l,c,7);
-        Expense &e=expenses[expenseCount];
+        Expense e;
         e.id=toInt(c[0]); e.related=toInt(c[1]);
-        e.date=c[2]; e.amount=toDouble(c[3]);
+        e.date=cityDate(c[2]); e.amount=toDouble(c[3]);
         e.vendor=c[4]; e.desc=c[5]; e.type=c[6];
-        if(e.id!=0) expenseCount++;
+        if(e.id!=0) communityCtx->expenses.push_back(e);
     }
-    cout<<"Loaded "<<expenseCount<<" expenses\n";
+    cout<<"Loaded "<<communityCtx->expenses.size()<<" expenses\n";
 }
 
 /* Load ALL */
 void communityLoadAllCSVsFromFolder(const string &p){
     string x=p;
     if(!x.empty() && x.back()!='/' && x.back()!='\\') x.push_back('/');
-    memberCount=staffCount=facilityCount=equipmentCount=eventCount=bookingCount=revenueCount=expenseCount=0;
     communityLoadMembersCSV(x+"communityMembers.csv");
     communityLoadStaffCSV(x+"communityStaff.csv");
     communityLoadFacilitiesCSV(x+"communityFacilities.csv");
@@ -251,6 +385,7 @@ void communityLoadAllCSVsFromFolder(const string &p){
     communityLoadBookingsCSV(x+"communityBookings.csv");
     communityLoadRevenueCSV(x+"communityRevenue.csv");
     communityLoadExpensesCSV(x+"communityExpenses.csv");
+    communityRebuildLedger();
 }
 
 /* ============================================================
@@ -258,24 +393,26 @@ void communityLoadAllCSVsFromFolder(const string &p){
    ============================================================ */
 
 static void swapB(Booking &a,Booking &b){ Booking t=a; a=b; b=t; }
-static string bk(const Booking &b){ return b.date+" "+b.start; }
+static long long bk(const Booking &b){ return (long long)b.date*CITY_MINUTES_PER_DAY+b.start; }
 
 int partB(int l,int r){
-    string p=bk(bookings[l]);
+    long long p=bk(communityCtx->bookings[l]);
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && bk(bookings[i])<p);
-        do{j--;} while(j>=l && bk(bookings[j])>p);
+        do{i++;} while(i<=r && bk(communityCtx->bookings[i])<p);
+        do{j--;} while(j>=l && bk(communityCtx->bookings[j])>p);
         if(i>=j) break;
-        swapB(bookings[i],bookings[j]);
+        swapB(communityCtx->bookings[i],communityCtx->bookings[j]);
     }
-    swapB(bookings[l],bookings[j]);
+    swapB(communityCtx->bookings[l],communityCtx->bookings[j]);
     return j;
 }
 void qsortB(int l,int r){ if(l<r){ int s=partB(l,r); qsortB(l,s-1); qsortB(s+1,r);} }
 
 void communitySortBookings(){
-    if(bookingCount>1) qsortB(0,bookingCount-1);
+    int n=communityCtx->bookings.size();
+    if(n>1) qsortB(0,n-1);
+    communityIndexBookingDates();
     cout<<"Bookings sorted\n";
 }
 
@@ -283,44 +420,58 @@ void communitySortBookings(){
 static void swapF(Facility &a,Facility &b){ Facility t=a;a=b;b=t; }
 
 int partFP(int l,int r){
-    double p=facilities[l].price;
+    double p=communityCtx->facilities[l].price;
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && facilities[i].price<p);
-        do{j--;} while(j>=l && facilities[j].price>p);
+        do{i++;} while(i<=r && communityCtx->facilities[i].price<p);
+        do{j--;} while(j>=l && communityCtx->facilities[j].price>p);
         if(i>=j) break;
-        swapF(facilities[i],facilities[j]);
+        swapF(communityCtx->facilities[i],communityCtx->facilities[j]);
     }
-    swapF(facilities[l],facilities[j]);
+    swapF(communityCtx->facilities[l],communityCtx->facilities[j]);
     return j;
 }
 void qsortFP(int l,int r){ if(l<r){ int s=partFP(l,r); qsortFP(l,s-1); qsortFP(s+1,r);} }
-void communitySortFacilitiesByPrice(){ if(facilityCount>1) qsortFP(0,facilityCount-1); }
+void communitySortFacilitiesByPrice(){ int n=communityCtx->facilities.size(); if(n>1) qsortFP(0,n-1); }
 
 int partFC(int l,int r){
-    int p=facilities[l].capacity;
+    int p=communityCtx->facilities[l].capacity;
     int i=l,j=r+1;
     while(true){
-        do{i++;} while(i<=r && facilities[i].capacity<p);
-        do{j--;} while(j>=l && facilities[j].capacity>p);
+        do{i++;} while(i<=r && communityCtx->facilities[i].capacity<p);
+        do{j--;} while(j>=l && communityCtx->facilities[j].capacity>p);
         if(i>=j) break;
-        swapF(facilities[i],facilities[j]);
+        swapF(communityCtx->facilities[i],communityCtx->facilities[j]);
     }
-    swapF(facilities[l],facilities[j]);
+    swapF(communityCtx->facilities[l],communityCtx->facilities[j]);
     return j;
 }
 void qsortFC(int l,int r){ if(l<r){ int s=partFC(l,r); qsortFC(l,s-1); qsortFC(s+1,r);} }
-void communitySortFacilitiesByCapacity(){ if(facilityCount>1) qsortFC(0,facilityCount-1); }
+void communitySortFacilitiesByCapacity(){ int n=communityCtx->facilities.size(); if(n>1) qsortFC(0,n-1); }
 
+/* Sweep line over all bookings: order by (facility, day, start), then each
+   booking is paired with every later one that starts before it ends.
+   O(n log n + k) for k overlapping pairs; does not touch communityCtx->bookings[] order. */
 void communityBulkFindOverlaps(){
-    communitySortBookings();
-    for(int i=1;i<bookingCount;i++){
-        Booking &a=bookings[i-1], &b=bookings[i];
-        if(a.facility_id==b.facility_id && a.date==b.date){
-            if(timeOverlap(a.date,a.start,a.end,b.date,b.start,b.end))
-                cout<<"Overlap: "<<a.id<<" <-> "<<b.id<<" ("<<a.date<<")\n";
-        }
+    struct Iv{ long long key; int start,end,idx; };
+    vector<Iv> iv;
+    int n=communityCtx->bookings.size();
+    iv.reserve(n);
+    for(int i=0;i<n;i++){
+        Booking &b=communityCtx->bookings[i];
+        if(b.end<=b.start) continue;
+        Iv x={communityDayKey(b.facility_id,b.date),b.start,b.end,i};
+        iv.push_back(x);
     }
+    sort(iv.begin(),iv.end(),[](const Iv &a,const Iv &b){ return a.key!=b.key ? a.key<b.key : a.start<b.start; });
+    int found=0;
+    for(size_t i=0;i<iv.size();i++)
+        for(size_t j=i+1;j<iv.size() && iv[j].key==iv[i].key && iv[j].start<iv[i].end;j++){
+            Booking &a=communityCtx->bookings[iv[i].idx], &b=communityCtx->bookings[iv[j].idx];
+            cout<<"Overlap: "<<a.id<<" <-> "<<b.id<<" ("<<cityFormatDate(a.date)<<")\n";
+            found++;
+        }
+    cout<<found<<" overlapping pair(s)\n";
 }
 
 /* ============================================================
@@ -328,35 +479,39 @@ void communityBulkFindOverlaps(){
    ============================================================ */
 
 void addMember(){
-    if(memberCount>=MAX_MEMBERS){ cout<<"Full\n"; return; }
-    Member &m=members[memberCount];
+    if((int)communityCtx->members.size()>=MAX_MEMBERS){ cout<<"Full\n"; return; }
+    Member m;
     cout<<"ID: "; cin>>m.id; cin.ignore();
     cout<<"Name: "; getline(cin,m.name);
     cout<<"Age: "; cin>>m.age; cin.ignore();
     cout<<"Phone: "; getline(cin,m.phone);
     cout<<"Email: "; getline(cin,m.email);
     cout<<"Type: "; getline(cin,m.mtype);
-    cout<<"Join Date: "; getline(cin,m.join_date);
+    string jd;
+    cout<<"Join Date: "; getline(cin,jd); m.join_date=cityDate(jd);
     cout<<"Address: "; getline(cin,m.address);
-    m.active=1; memberCount++;
+    m.active=1;
+    communityCtx->members.push_back(m);
 }
 
 void addStaff(){
-    if(staffCount>=MAX_STAFF){ cout<<"Full\n"; return; }
-    Staff &s=staffs[staffCount];
+    if((int)communityCtx->staffs.size()>=MAX_STAFF){ cout<<"Full\n"; return; }
+    Staff s;
     cout<<"ID: "; cin>>s.id; cin.ignore();
     cout<<"Name: "; getline(cin,s.name);
     cout<<"Role: "; getline(cin,s.role);
     cout<<"Phone: "; getline(cin,s.phone);
     cout<<"Email: "; getline(cin,s.email);
     cout<<"Salary: "; cin>>s.salary; cin.ignore();
-    cout<<"Join Date: "; getline(cin,s.join_date);
-    s.active=1; staffCount++;
+    string jd;
+    cout<<"Join Date: "; getline(cin,jd); s.join_date=cityDate(jd);
+    s.active=1;
+    communityCtx->staffs.push_back(s);
 }
 
 void addFacility(){
-    if(facilityCount>=MAX_FACILITIES){ cout<<"Full\n"; return; }
-    Facility &f=facilities[facilityCount];
+    if((int)communityCtx->facilities.size()>=MAX_FACILITIES){ cout<<"Full\n"; return; }
+    Facility f;
     cout<<"ID: "; cin>>f.id; cin.ignore();
     cout<<"Name: "; getline(cin,f.name);
     cout<<"Type: "; getline(cin,f.type);
@@ -365,92 +520,113 @@ void addFacility(){
     cout<<"Location: "; getline(cin,f.location);
     cout<<"From: "; getline(cin,f.from);
     cout<<"To: "; getline(cin,f.to);
-    f.active=1; facilityCount++;
+    f.active=1;
+    communityCtx->facilities.push_back(f);
 }
 
 void addEquipment(){
-    if(equipmentCount>=MAX_EQUIPMENT){ cout<<"Full\n"; return; }
-    Equipment &e=equipmentArr[equipmentCount];
+    if((int)communityCtx->equipmentArr.size()>=MAX_EQUIPMENT){ cout<<"Full\n"; return; }
+    Equipment e;
     cout<<"ID: "; cin>>e.id; cin.ignore();
     cout<<"Name: "; getline(cin,e.name);
     cout<<"Total Qty: "; cin>>e.qty_total; cin.ignore();
     cout<<"Available Qty: "; cin>>e.qty_avail; cin.ignore();
     cout<<"Cond: "; getline(cin,e.cond);
-    cout<<"Last Maint: "; getline(cin,e.last_maint);
-    equipmentCount++;
+    string lm;
+    cout<<"Last Maint: "; getline(cin,lm); e.last_maint=cityDate(lm);
+    communityCtx->equipmentArr.push_back(e);
 }
 
 void addEvent(){
-    if(eventCount>=MAX_EVENTS){ cout<<"Full\n"; return; }
-    Event &ev=eventsArr[eventCount];
+    if((int)communityCtx->eventsArr.size()>=MAX_EVENTS){ cout<<"Full\n"; return; }
+    Event ev;
     cout<<"ID: "; cin>>ev.id; cin.ignore();
     cout<<"Title: "; getline(cin,ev.title);
     cout<<"Org Member: "; cin>>ev.org_member;
     cout<<"Facility: "; cin>>ev.facility; cin.ignore();
-    cout<<"Date: "; getline(cin,ev.date);
-    cout<<"Start: "; getline(cin,ev.start);
-    cout<<"End: "; getline(cin,ev.end);
+    string d,st,en;
+    cout<<"Date: "; getline(cin,d);
+    cout<<"Start: "; getline(cin,st);
+    cout<<"End: "; getline(cin,en);
+    ev.date=cityDate(d); ev.start=cityTime(st); ev.end=cityTime(en);
     cout<<"Expected: "; cin>>ev.expected;
     cout<<"Revenue Est: "; cin>>ev.revenue; cin.ignore();
-    ev.status="scheduled";
-    eventCount++;
+    ev.status=COMMUNITY_EVENT_SCHEDULED;
+    communityCtx->eventsArr.push_back(ev);
 }
 
 void addBooking(){
-    if(bookingCount>=MAX_BOOKINGS){ cout<<"Full\n"; return; }
+    if((int)communityCtx->bookings.size()>=MAX_BOOKINGS){ cout<<"Full\n"; return; }
     Booking b;
     cout<<"ID: "; cin>>b.id;
     cout<<"Event: "; cin>>b.event_id;
     cout<<"Member: "; cin>>b.member_id;
     cout<<"Facility: "; cin>>b.facility_id; cin.ignore();
-    cout<<"Date: "; getline(cin,b.date);
-    cout<<"Start: "; getline(cin,b.start);
-    cout<<"End: "; getline(cin,b.end);
+    string d,st,en;
+    cout<<"Date: "; getline(cin,d);
+    cout<<"Start: "; getline(cin,st);
+    cout<<"End: "; getline(cin,en);
+    b.date=cityDate(d); b.start=cityTime(st); b.end=cityTime(en);
+    if(b.date==CITY_NO_DATE || b.start<0 || b.end<0){
+        cout<<"Bad date/time\n"; return;
+    }
 
     if(communityCheckBookingOverlap(b.facility_id,b.date,b.start,b.end)){
         cout<<"Overlap rejected\n"; return;
     }
 
     cout<<"Total: "; cin>>b.total; cin.ignore();
-    cout<<"Status: "; getline(cin,b.status);
+    cout<<"Status: "; string status; getline(cin,status); b.status=cityIntern(communityBookingStatus,status);
 
-    bookings[bookingCount++] = b;
+    communityCalendarAdd(b);
+    communityLedgerAddBooking(b);
+    communityDateIndexAdd(communityBookingsByDate,b.date,communityCtx->bookings.size());
+    communityCtx->bookings.push_back(b);
 
-if(b.status == "paid" && revenueCount < MAX_TXN){
-    revenues[revenueCount].id = revenueCount;
-    revenues[revenueCount].src = "booking";
-    revenues[revenueCount].src_id = b.id;
-    revenues[revenueCount].date = b.date;
-    revenues[revenueCount].amount = b.total;
-    revenues[revenueCount].desc = "auto";
-    revenueCount++;
+if(b.status == COMMUNITY_BOOKING_PAID && communityCtx->revenues.size() < MAX_TXN){
+    int row = communityCtx->revenues.size();
+    Revenue r;
+    r.id = row;
+    r.src = "booking";
+    r.src_id = b.id;
+    r.date = b.date;
+    r.amount = b.total;
+    r.desc = "auto";
+    communityCtx->revenues.push_back(r);
+    communityLedgerAddRevenue(row);
+    communityDateIndexAdd(communityRevenueByDate,b.date,row);
 }
 
 }
 
 void addRevenue(){
-    if(revenueCount>=MAX_TXN){ cout<<"Full\n"; return; }
-    Revenue &r=revenues[revenueCount];
+    if((int)communityCtx->revenues.size()>=MAX_TXN){ cout<<"Full\n"; return; }
+    Revenue r;
     cout<<"ID: "; cin>>r.id; cin.ignore();
     cout<<"Source: "; getline(cin,r.src);
     cout<<"Source ID: "; cin>>r.src_id; cin.ignore();
-    cout<<"Date: "; getline(cin,r.date);
+    string d;
+    cout<<"Date: "; getline(cin,d); r.date=cityDate(d);
     cout<<"Amount: "; cin>>r.amount; cin.ignore();
     cout<<"Desc: "; getline(cin,r.desc);
-    revenueCount++;
+    communityCtx->revenues.push_back(r);
+    communityLedgerAddRevenue(communityCtx->revenues.size()-1);
+    communityDateIndexAdd(communityRevenueByDate,r.date,communityCtx->revenues.size()-1);
 }
 
 void addExpense(){
-    if(expenseCount>=MAX_TXN){ cout<<"Full\n"; return; }
-    Expense &e=expenses[expenseCount];
+    if((int)communityCtx->expenses.size()>=MAX_TXN){ cout<<"Full\n"; return; }
+    Expense e;
     cout<<"ID: "; cin>>e.id;
     cout<<"Related Event: "; cin>>e.related; cin.ignore();
-    cout<<"Date: "; getline(cin,e.date);
+    string d;
+    cout<<"Date: "; getline(cin,d); e.date=cityDate(d);
     cout<<"Amount: "; cin>>e.amount; cin.ignore();
     cout<<"Vendor: "; getline(cin,e.vendor);
     cout<<"Desc: "; getline(cin,e.desc);
     cout<<"Type: "; getline(cin,e.type);
-    expenseCount++;
+    communityCtx->expenses.push_back(e);
+    communityLedgerAddExpense(communityCtx->expenses.size()-1);
 }
 
 /* ============================================================
@@ -461,9 +637,9 @@ void listMembers(){
     const string c[]={"ID","Name","Phone","Email","Type","Join"};
     int w[]={5,16,12,20,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<memberCount;i++){
-        Member &m=members[i];
-        cout<<setw(w[0])<<m.id<<" | "<<setw(w[1])<<m.name<<" | "<<setw(w[2])<<m.phone<<" | "<<setw(w[3])<<m.email<<" | "<<setw(w[4])<<m.mtype<<" | "<<setw(w[5])<<m.join_date<<"\n";
+    for(size_t i=0;i<communityCtx->members.size();i++){
+        Member &m=communityCtx->members[i];
+        cout<<setw(w[0])<<m.id<<" | "<<setw(w[1])<<m.name<<" | "<<setw(w[2])<<m.phone<<" | "<<setw(w[3])<<m.email<<" | "<<setw(w[4])<<m.mtype<<" | "<<setw(w[5])<<cityFormatDate(m.join_date)<<"\n";
     }
 }
 
@@ -471,9 +647,9 @@ void listStaff(){
     const string c[]={"ID","Name","Role","Phone","Salary","Join"};
     int w[]={5,16,12,12,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<staffCount;i++){
-        Staff &s=staffs[i];
-        cout<<setw(w[0])<<s.id<<" | "<<setw(w[1])<<s.name<<" | "<<setw(w[2])<<s.role<<" | "<<setw(w[3])<<s.phone<<" | "<<setw(w[4])<<s.salary<<" | "<<setw(w[5])<<s.join_date<<"\n";
+    for(size_t i=0;i<communityCtx->staffs.size();i++){
+        Staff &s=communityCtx->staffs[i];
+        cout<<setw(w[0])<<s.id<<" | "<<setw(w[1])<<s.name<<" | "<<setw(w[2])<<s.role<<" | "<<setw(w[3])<<s.phone<<" | "<<setw(w[4])<<s.salary<<" | "<<setw(w[5])<<cityFormatDate(s.join_date)<<"\n";
     }
 }
 
@@ -481,8 +657,8 @@ void listFacilities(){
     const string c[]={"ID","Name","Type","Cap","Price","Location"};
     int w[]={5,16,10,6,10,14};
     printHeader(c,w,6);
-    for(int i=0;i<facilityCount;i++){
-        Facility &f=facilities[i];
+    for(size_t i=0;i<communityCtx->facilities.size();i++){
+        Facility &f=communityCtx->facilities[i];
         cout<<setw(w[0])<<f.id<<" | "<<setw(w[1])<<f.name<<" | "<<setw(w[2])<<f.type<<" | "<<setw(w[3])<<f.capacity<<" | "<<setw(w[4])<<f.price<<" | "<<setw(w[5])<<f.location<<"\n";
     }
 }
@@ -491,9 +667,9 @@ void listEquipment(){
     const string c[]={"ID","Name","Total","Avail","Cond","LastMaint"};
     int w[]={5,16,7,7,10,12};
     printHeader(c,w,6);
-    for(int i=0;i<equipmentCount;i++){
-        Equipment &e=equipmentArr[i];
-        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.name<<" | "<<setw(w[2])<<e.qty_total<<" | "<<setw(w[3])<<e.qty_avail<<" | "<<setw(w[4])<<e.cond<<" | "<<setw(w[5])<<e.last_maint<<"\n";
+    for(size_t i=0;i<communityCtx->equipmentArr.size();i++){
+        Equipment &e=communityCtx->equipmentArr[i];
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.name<<" | "<<setw(w[2])<<e.qty_total<<" | "<<setw(w[3])<<e.qty_avail<<" | "<<setw(w[4])<<e.cond<<" | "<<setw(w[5])<<cityFormatDate(e.last_maint)<<"\n";
     }
 }
 
@@ -501,10 +677,10 @@ void listEvents(){
     const string c[]={"ID","Title","Fac","Date","Start","End","Exp","Rev","Status"};
     int w[]={5,16,5,12,7,7,6,10,10};
     printHeader(c,w,9);
-    for(int i=0;i<eventCount;i++){
-        Event &e=eventsArr[i];
-        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<e.facility<<" | "<<setw(w[3])<<e.date<<" | "
-            <<setw(w[4])<<e.start<<" | "<<setw(w[5])<<e.end<<" | "<<setw(w[6])<<e.expected<<" | "<<setw(w[7])<<e.revenue<<" | "<<setw(w[8])<<e.status<<"\n";
+    for(size_t i=0;i<communityCtx->eventsArr.size();i++){
+        Event &e=communityCtx->eventsArr[i];
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<e.facility<<" | "<<setw(w[3])<<cityFormatDate(e.date)<<" | "
+            <<setw(w[4])<<cityFormatTime(e.start)<<" | "<<setw(w[5])<<cityFormatTime(e.end)<<" | "<<setw(w[6])<<e.expected<<" | "<<setw(w[7])<<e.revenue<<" | "<<setw(w[8])<<cityDictName(communityEventStatus,e.status)<<"\n";
     }
 }
 
@@ -512,10 +688,10 @@ void listBookings(){
     const string c[]={"ID","Event","Member","Facility","Date","Start","End","Amt","Status"};
     int w[]={5,7,7,8,12,7,7,10,10};
     printHeader(c,w,9);
-    for(int i=0;i<bookingCount;i++){
-        Booking &b=bookings[i];
+    for(size_t i=0;i<communityCtx->bookings.size();i++){
+        Booking &b=communityCtx->bookings[i];
         cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "<<setw(w[3])<<b.facility_id<<" | "
-            <<setw(w[4])<<b.date<<" | "<<setw(w[5])<<b.start<<" | "<<setw(w[6])<<b.end<<" | "<<setw(w[7])<<b.total<<" | "<<setw(w[8])<<b.status<<"\n";
+            <<setw(w[4])<<cityFormatDate(b.date)<<" | "<<setw(w[5])<<cityFormatTime(b.start)<<" | "<<setw(w[6])<<cityFormatTime(b.end)<<" | "<<setw(w[7])<<b.total<<" | "<<setw(w[8])<<cityDictName(communityBookingStatus,b.status)<<"\n";
     }
 }
 
@@ -523,40 +699,59 @@ void listBookings(){
    ======================== FINANCE ============================
    ============================================================ */
 
+static void eventTotals(int eid,double &R,double &E){
+    R=E=0;
+    unordered_map<int,communityEventLedger>::const_iterator it=communityLedger.find(eid);
+    if(it==communityLedger.end()) return;
+    for(size_t i=0;i<it->second.rev.size();i++) R+=communityCtx->revenues[it->second.rev[i]].amount;
+    for(size_t i=0;i<it->second.exp.size();i++) E+=communityCtx->expenses[it->second.exp[i]].amount;
+}
+
 void eventPnL(int eid){
-    double R=0,E=0;
-    for(int i=0;i<revenueCount;i++){
-        Revenue &r=revenues[i];
-        if(r.src=="booking"){
-            for(int j=0;j<bookingCount;j++)
-                if(bookings[j].id==r.src_id && bookings[j].event_id==eid)
-                    R+=r.amount;
-        }
-        else if(r.src=="event" && r.src_id==eid)
-            R+=r.amount;
-    }
-    for(int i=0;i<expenseCount;i++)
-        if(expenses[i].related==eid) E+=expenses[i].amount;
+    double R,E;
+    eventTotals(eid,R,E);
     cout<<"P&L for event "<<eid<<" = "<<(R-E)<<" (Rev: "<<R<<"  Exp: "<<E<<")\n";
 }
 
+/* every event in one pass over the ledger: O(events + revenue + expense rows) */
+void allEventsPnL(){
+    const string c[]={"ID","Title","Revenue","Expense","P&L"};
+    int w[]={5,16,12,12,12};
+    printHeader(c,w,5);
+    double TR=0,TE=0;
+    for(size_t i=0;i<communityCtx->eventsArr.size();i++){
+        Event &e=communityCtx->eventsArr[i];
+        double R,E;
+        eventTotals(e.id,R,E);
+        TR+=R; TE+=E;
+        cout<<setw(w[0])<<e.id<<" | "<<setw(w[1])<<e.title<<" | "<<setw(w[2])<<R<<" | "<<setw(w[3])<<E<<" | "<<setw(w[4])<<(R-E)<<"\n";
+    }
+    cout<<"Season total = "<<(TR-TE)<<" (Rev: "<<TR<<"  Exp: "<<TE<<")\n";
+}
+
 void monthlyRevenue(const string &m){
+    CityDate lo,hi;
+    if(!cityPrefixRange(m,lo,hi)){ cout<<"Bad month\n"; return; }
     double t=0; 
-    for(int i=0;i<revenueCount;i++)
-        if(revenues[i].date.rfind(m,0)==0) t+=revenues[i].amount;
+    const vector<communityDateRow> &v=communityRevenueByDate;
+    for(size_t i=communityDateSeek(v,lo);i<v.size() && v[i].date<hi;i++)
+        t+=communityCtx->revenues[v[i].row].amount;
     cout<<"Revenue for "<<m<<" = "<<t<<"\n";
 }
 
 void bookingsRange(const string &f,const string &t){
     const string c[]={"ID","Event","Mem","Fac","Date","Start","End","Amt"};
     int w[]={5,6,6,6,12,7,7,10};
+    /* "to" is inclusive, so a month or year prefix covers the whole period */
+    CityDate lo,hi,tlo,thi;
+    if(!cityPrefixRange(f,lo,hi) || !cityPrefixRange(t,tlo,thi)){ cout<<"Bad date\n"; return; }
     printHeader(c,w,8);
-    for(int i=0;i<bookingCount;i++){
-        Booking &b=bookings[i];
-        if(b.date>=f && b.date<=t)
-            cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "
-                <<setw(w[3])<<b.facility_id<<" | "<<setw(w[4])<<b.date<<" | "<<setw(w[5])<<b.start<<" | "
-                <<setw(w[6])<<b.end<<" | "<<setw(w[7])<<b.total<<"\n";
+    const vector<communityDateRow> &v=communityBookingsByDate;
+    for(size_t i=communityDateSeek(v,lo);i<v.size() && v[i].date<thi;i++){
+        Booking &b=communityCtx->bookings[v[i].row];
+        cout<<setw(w[0])<<b.id<<" | "<<setw(w[1])<<b.event_id<<" | "<<setw(w[2])<<b.member_id<<" | "
+            <<setw(w[3])<<b.facility_id<<" | "<<setw(w[4])<<cityFormatDate(b.date)<<" | "<<setw(w[5])<<cityFormatTime(b.start)<<" | "
+            <<setw(w[6])<<cityFormatTime(b.end)<<" | "<<setw(w[7])<<b.total<<"\n";
     }
 }
 
@@ -564,7 +759,13 @@ void bookingsRange(const string &f,const string &t){
    ========================= MAIN MENU =========================
    ============================================================ */
 
+void communityInitModule(){
+    if(communityCtx) return; // state is kept across visits to the menu
+    communityCtx = new CommunityContext();
+}
+
 void communitySystem(){
+    communityInitModule();
     while(true){
         cout<<"\n==== COMMUNITY CENTRE ====\n"
             <<"1. Members\n"
@@ -598,7 +799,7 @@ void communitySystem(){
             else if(s==3) listStaff();
             else if(s==4){
                 double total=0;
-                for(int i=0;i<staffCount;i++) total+=staffs[i].salary;
+                for(size_t i=0;i<communityCtx->staffs.size();i++) total+=communityCtx->staffs[i].salary;
                 cout<<"Total payroll = "<<total<<"\n";
             }
             break;
@@ -628,7 +829,7 @@ void communitySystem(){
             cout<<"1=LoadEvts 2=LoadBkng 3=AddEvt 4=AddBkng 5=ListEvts 6=ListBkng 7=Sort 8=Overlap\nChoice: ";
             int s; cin>>s; cin.ignore();
             if(s==1) communityLoadEventsCSV("communityEvents.csv");
-            else if(s==2) communityLoadBookingsCSV("communityBookings.csv");
+            else if(s==2){ communityLoadBookingsCSV("communityBookings.csv"); communityRebuildLedger(); }
             else if(s==3) addEvent();
             else if(s==4) addBooking();
             else if(s==5) listEvents();
@@ -639,11 +840,12 @@ void communitySystem(){
         }
 
         case 6:{
-            cout<<"1=AddRevenue 2=AddExpense 3=EventPnL\nChoice: ";
+            cout<<"1=AddRevenue 2=AddExpense 3=EventPnL 4=AllEventsPnL\nChoice: ";
             int s; cin>>s; cin.ignore();
             if(s==1) addRevenue();
             else if(s==2) addExpense();
             else if(s==3){ int id; cout<<"Event id: "; cin>>id; eventPnL(id); }
+            else if(s==4) allEventsPnL();
             break;
         }
 
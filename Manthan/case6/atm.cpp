@@ -3,20 +3,49 @@
 #include <sstream>
 #include <string>
 #include <limits>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <bitset>
+#include <unordered_map>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 #define ATM_MAX_ACCOUNTS 2000
-#define ATM_MAX_TRANSACTIONS 20000
 #define ATM_MAX_CASH 10
 #define ATM_MAX_RATES 50
+#define ATM_RATE_RETAIN 4 // replaced rate tables kept alive before one is freed
 #define ATM_PIN_ATTEMPT_LIMIT 3
 #define ATM_MAX_WITHDRAW_PER_TXN 20000
 #define ATM_MAX_DEPOSIT_PER_TXN 200000
 #define ATM_DAILY_LIMIT 50000
 #define ATM_INTL_FEE 0.02
+#define ATM_ACC_HASH_SIZE 4099 // prime, > 2 * ATM_MAX_ACCOUNTS
+#define ATM_NOTE_UNIT 50 // every denomination is a multiple of this
+#define ATM_PAY_UNITS (ATM_MAX_WITHDRAW_PER_TXN / ATM_NOTE_UNIT)
+#define ATM_DENOMS 5
+#define ATM_LEDGER_FILE "atm_ledger.bin"
 
 struct ATMAccount {
     string number, name, type, currency, cardCountry;
+    int cur=-1; // interned currency id, see atmInternCurrency
     int pin=0, locked=0, wrongPin=0;
     double balance=0, dayWithdraw=0, limit=0;
 };
@@ -30,6 +59,10 @@ struct ATMTransaction {
 struct ATMCash {
     string atmID, location;
     int n2000=0, n500=0, n200=0, n100=0, n50=0;
+    // bit k set = k*ATM_NOTE_UNIT is payable exactly from the notes on hand;
+    // clear payableReady whenever the counts are changed from outside dispense()
+    bitset<ATM_PAY_UNITS + 1> payable;
+    bool payableReady=false;
 };
 
 struct ATMRate {
@@ -37,26 +70,152 @@ struct ATMRate {
     double toINR=1.0;
 };
 
-ATMAccount ACC[ATM_MAX_ACCOUNTS];
-ATMTransaction TX[ATM_MAX_TRANSACTIONS];
-ATMCash CASH[ATM_MAX_CASH];
-ATMRate RATE[ATM_MAX_RATES];
+// Created by atmInitModule(); ATM_MAX_* cap the row counts. Accounts are only
+// added from the admin menu or a load, never while the stress test runs.
+struct ATMContext {
+    vector<ATMAccount> acc;
+    // one lock per account slot guards balance/dayWithdraw/locked while ATMs
+    // run concurrently; a deque so growing it never moves a mutex
+    deque<mutex> accLock;
+    // account number -> acc index + 1 (0 = empty), linear probing; accounts are never removed
+    vector<int> accHash;
+    vector<ATMCash> cash;
+};
+static ATMContext *atmCtx = NULL;
+
+vector<ATMTransaction> TX; // CSV history + everything logged since; never capped
 
-int accCnt = 0, txCnt = 0, cashCnt = 0, rateCnt = 0;
 bool dataLoaded = false;
 
+// guards TX
+static mutex atmTxLock;
+
+static unsigned atmHashStr(const string &s){
+    unsigned h = 2166136261u;
+    for(size_t i=0;i<s.size();i++){ h ^= (unsigned char)s[i]; h *= 16777619u; }
+    return h;
+}
+
+static void atmIndexAcc(int i){
+    unsigned k = atmHashStr(atmCtx->acc[i].number) % ATM_ACC_HASH_SIZE;
+    while(atmCtx->accHash[k] != 0){
+        if(atmCtx->acc[atmCtx->accHash[k]-1].number == atmCtx->acc[i].number) return; // keep first, like the old scan
+        k = (k + 1) % ATM_ACC_HASH_SIZE;
+    }
+    atmCtx->accHash[k] = i + 1;
+}
+
+static void atmRebuildAccIndex(){
+    atmCtx->accHash.assign(ATM_ACC_HASH_SIZE, 0);
+    for(size_t i=0;i<atmCtx->acc.size();i++) atmIndexAcc(i);
+}
+
+// appends a to the account table, growing the lock list to match; the caller indexes it
+static void atmAppendAcc(const ATMAccount &a){
+    atmCtx->acc.push_back(a);
+    if(atmCtx->accLock.size() < atmCtx->acc.size()) atmCtx->accLock.emplace_back();
+}
+
+// Lines in a CSV (header included); rewinds the stream.
+static int atmCountLines(ifstream &f){
+    int rows = 0;
+    string line;
+    while(getline(f,line)) rows++;
+    f.clear();
+    f.seekg(0);
+    return rows;
+}
+
 int findAcc(const string &a){
-    for(int i=0;i<accCnt;i++) if(ACC[i].number==a) return i;
+    unsigned k = atmHashStr(a) % ATM_ACC_HASH_SIZE;
+    while(atmCtx->accHash[k] != 0){
+        if(atmCtx->acc[atmCtx->accHash[k]-1].number == a) return atmCtx->accHash[k]-1;
+        k = (k + 1) % ATM_ACC_HASH_SIZE;
+    }
     return -1;
 }
-double getRate(const string &c){
-    for(int i=0;i<rateCnt;i++) if(RATE[i].code==c) return RATE[i].toINR;
-    return 1.0;
+// ---------- currencies & rates ----------
+// Currency codes are interned to ids 0..ATM_MAX_RATES-1 (admin/load time
+// only). Rates live in a flat table indexed by id and published through an
+// atomic pointer: a reload builds a new table and swaps it in, so the
+// transaction path reads rates without taking any lock. Publishers take
+// atmRateLock. A reader holds a table only for one conversion or one
+// settlement batch, so the last ATM_RATE_RETAIN replaced tables are kept
+// for readers still inside one and older ones are freed.
+struct ATMRateTable { double toINR[ATM_MAX_RATES]; };
+
+static unordered_map<string,int> atmCurrencyId;
+static vector<string> atmCurrencyCode;
+static atomic<const ATMRateTable*> atmRateTable(NULL); // NULL = every rate 1.0
+static mutex atmRateLock; // guards atmRetiredRates and serialises publishers
+static vector<const ATMRateTable*> atmRetiredRates;
+
+int atmFindCurrency(const string &code){
+    unordered_map<string,int>::const_iterator it = atmCurrencyId.find(code);
+    return it == atmCurrencyId.end() ? -1 : it->second;
+}
+
+// -1 once ATM_MAX_RATES codes exist; such currencies convert at 1.0
+int atmInternCurrency(const string &code){
+    int id = atmFindCurrency(code);
+    if(id != -1 || (int)atmCurrencyCode.size() >= ATM_MAX_RATES) return id;
+    id = (int)atmCurrencyCode.size();
+    atmCurrencyCode.push_back(code);
+    atmCurrencyId[code] = id;
+    return id;
+}
+
+static const int atmCurINR = atmInternCurrency("INR");
+
+ATMRateTable *atmCopyRates(){
+    ATMRateTable *t = new ATMRateTable;
+    const ATMRateTable *cur = atmRateTable.load(memory_order_acquire);
+    for(int i=0;i<ATM_MAX_RATES;i++) t->toINR[i] = cur ? cur->toINR[i] : 1.0;
+    return t;
+}
+
+// call with atmRateLock held
+static void atmSwapRates(const ATMRateTable *t){
+    const ATMRateTable *old = atmRateTable.exchange(t, memory_order_acq_rel);
+    if(!old) return;
+    atmRetiredRates.push_back(old);
+    if(atmRetiredRates.size() > ATM_RATE_RETAIN){
+        delete atmRetiredRates.front();
+        atmRetiredRates.erase(atmRetiredRates.begin());
+    }
 }
+
+void atmPublishRates(const ATMRateTable *t){
+    lock_guard<mutex> g(atmRateLock);
+    atmSwapRates(t);
+}
+
+// publish a copy of the live table with one rate changed
+void atmUpdateRate(int id, double toINR){
+    lock_guard<mutex> g(atmRateLock);
+    ATMRateTable *t = atmCopyRates();
+    t->toINR[id] = toINR;
+    atmSwapRates(t);
+}
+
+double atmRate(int cur){
+    const ATMRateTable *t = atmRateTable.load(memory_order_acquire);
+    return (t && cur >= 0) ? t->toINR[cur] : 1.0;
+}
+
+double getRate(const string &c){ return atmRate(atmFindCurrency(c)); }
 double toINR(double x,const string &c){ return x * getRate(c); }
 double fromINR(double x,const string &c){ double r = getRate(c); return (r==0? x : x / r); }
 double feeINR(double x){ return x * ATM_INTL_FEE; }
 
+// Batch conversion for settlement: out[i] = inr[i] in currency cur[i].
+// Rates are gathered first so the divide loop is branch-free and vectorises.
+void atmConvertFromINR(const double *inr, const int *cur, double *out, size_t n){
+    const ATMRateTable *t = atmRateTable.load(memory_order_acquire);
+    for(size_t i=0;i<n;i++) out[i] = (t && cur[i] >= 0) ? t->toINR[cur[i]] : 1.0;
+    for(size_t i=0;i<n;i++) out[i] = inr[i] / (out[i] == 0 ? 1.0 : out[i]);
+}
+
 // Safe stoi/stod that return false on invalid input
 bool safe_stoi(const string &s, int &out){
     if(s.empty()) return false;
@@ -81,7 +240,8 @@ void loadAccounts(){
     ifstream f("atm_accounts.csv");
     if(!f){ cout<<"Warning: atm_accounts.csv not found -> continuing with empty accounts.\n"; return; }
     string line;
-    accCnt = 0;
+    atmCtx->acc.clear();
+    atmCtx->acc.reserve(min(atmCountLines(f), ATM_MAX_ACCOUNTS));
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -93,7 +253,7 @@ void loadAccounts(){
         getline(ss,tmp,','); a.name = trim(tmp);
         getline(ss,tmp,','); if(!safe_stoi(trim(tmp), a.pin)) { continue; }
         getline(ss,tmp,','); a.type = trim(tmp);
-        getline(ss,tmp,','); a.currency = trim(tmp);
+        getline(ss,tmp,','); a.currency = trim(tmp); a.cur = atmInternCurrency(a.currency);
         getline(ss,tmp,','); if(!safe_stod(trim(tmp), a.balance)) { continue; }
         getline(ss,tmp,','); safe_stoi(trim(tmp), a.locked); // optional
         getline(ss,tmp,','); safe_stoi(trim(tmp), a.wrongPin);
@@ -102,17 +262,19 @@ void loadAccounts(){
         getline(ss,tmp,','); a.cardCountry = trim(tmp);
 
         if(a.number.empty()) continue;
-        ACC[accCnt++] = a;
-        if(accCnt >= ATM_MAX_ACCOUNTS) break;
+        atmAppendAcc(a);
+        if((int)atmCtx->acc.size() >= ATM_MAX_ACCOUNTS) break;
     }
     f.close();
+    atmRebuildAccIndex();
 }
 
 void loadCash(){
     ifstream f("atm_cash.csv");
     if(!f){ cout<<"Warning: atm_cash.csv not found -> continuing with empty cash.\n"; return; }
     string line;
-    cashCnt = 0;
+    atmCtx->cash.clear();
+    atmCtx->cash.reserve(min(atmCountLines(f), ATM_MAX_CASH));
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -125,8 +287,8 @@ void loadCash(){
         if(!getline(ss,tmp,',')) continue; if(!safe_stoi(trim(tmp), c.n100)) c.n100 = 0;
         if(!getline(ss,tmp,',')) continue; if(!safe_stoi(trim(tmp), c.n50)) c.n50 = 0;
         if(c.atmID.empty()) c.atmID = "ATM001";
-        CASH[cashCnt++] = c;
-        if(cashCnt >= ATM_MAX_CASH) break;
+        atmCtx->cash.push_back(c);
+        if((int)atmCtx->cash.size() >= ATM_MAX_CASH) break;
     }
     f.close();
 }
@@ -135,7 +297,8 @@ void loadRates(){
     ifstream f("atm_rates.csv");
     if(!f){ cout<<"Warning: atm_rates.csv not found -> continuing with default rates.\n"; return; }
     string line;
-    rateCnt = 0;
+    ATMRateTable *t = new ATMRateTable;
+    for(int i=0;i<ATM_MAX_RATES;i++) t->toINR[i] = 1.0;
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -144,17 +307,19 @@ void loadRates(){
         getline(ss,tmp,',');
         if(!safe_stod(trim(tmp), r.toINR)) continue;
         if(r.code.empty()) continue;
-        RATE[rateCnt++] = r;
-        if(rateCnt >= ATM_MAX_RATES) break;
+        int id = atmInternCurrency(r.code);
+        if(id == -1) break;
+        t->toINR[id] = r.toINR;
     }
     f.close();
+    atmPublishRates(t);
 }
 
 void loadTx(){
     ifstream f("atm_transactions.csv");
     if(!f){ cout<<"Warning: atm_transactions.csv not found -> starting with empty transactions.\n"; return; }
     string line;
-    txCnt = 0;
+    TX.clear();
     while(getline(f,line)){
         if(line.empty()) continue;
         stringstream ss(line);
@@ -174,73 +339,508 @@ void loadTx(){
         if(!safe_stod(trim(tmp), t.balAfter)) continue;
         getline(ss,t.remark,','); t.remark = trim(t.remark);
 
-        TX[txCnt++] = t;
-        if(txCnt >= ATM_MAX_TRANSACTIONS) break;
+        TX.push_back(t);
     }
     f.close();
 }
 
+// ---------- durable ledger ----------
+// Append-only file of fixed 128-byte records, each CRC32-checked. Sessions
+// enqueue a record (getting a sequence number) and then wait for it to be
+// durable; whichever waiter finds no flush running writes the whole pending
+// batch and fdatasyncs once, so concurrent sessions share one sync.
+struct ATMLedgerRec {
+    uint32_t crc;      // CRC32 of the bytes after this field
+    uint32_t size;     // sizeof(ATMLedgerRec), guards against format changes
+    uint64_t seq;
+    int64_t timeMs;    // unix epoch milliseconds
+    double amt, balAfter;
+    char acc[24], type[16], atmID[16], remark[32];
+};
+
+struct ATMLedger {
+    int fd = -1;
+    string path;
+    mutex m;
+    condition_variable cv;
+    vector<ATMLedgerRec> pending;      // enqueued, not yet durable (kept across failed flushes)
+    uint64_t nextSeq = 0, durableSeq = 0;
+    long long goodBytes = 0;           // file length up to the last durable record
+    int lastErr = 0;                   // errno of the last failed flush, 0 once one succeeds
+    bool flushing = false, failed = false; // failed = file state unknown, writes stopped
+    long long syncs = 0;
+};
+
+#define ATM_LEDGER_RETRIES 3 // flush attempts per waiter before it reports a delay
+
+// ---------- ledger file I/O (POSIX / Windows) ----------
+// Each call returns 0 or an errno value; interrupted calls and short writes
+// are retried here so callers only see real failures.
+#ifdef _WIN32
+static int atmFileOpen(const string &path, bool append){
+    int flags = _O_BINARY | (append ? (_O_WRONLY | _O_CREAT | _O_APPEND) : _O_RDWR);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+static void atmFileClose(int fd){ _close(fd); }
+static long long atmFileSize(int fd){ return _filelengthi64(fd); }
+static int atmFileWrite(int fd, const char *p, size_t left){
+    while(left > 0){
+        int w = _write(fd, p, (unsigned)min(left, (size_t)1 << 30));
+        if(w < 0) return errno;
+        p += w; left -= (size_t)w;
+    }
+    return 0;
+}
+static int atmFileSync(int fd){ return _commit(fd) == 0 ? 0 : errno; }
+static int atmFileTruncate(int fd, long long size){ return _chsize_s(fd, size); }
+#else
+static int atmFileOpen(const string &path, bool append){
+    int fd;
+    do fd = open(path.c_str(), append ? (O_WRONLY | O_CREAT | O_APPEND) : O_RDWR, 0644);
+    while(fd < 0 && errno == EINTR);
+    return fd;
+}
+static void atmFileClose(int fd){ close(fd); }
+static long long atmFileSize(int fd){
+    struct stat st;
+    return fstat(fd, &st) == 0 ? (long long)st.st_size : -1;
+}
+static int atmFileWrite(int fd, const char *p, size_t left){
+    while(left > 0){
+        ssize_t w = write(fd, p, left);
+        if(w < 0){
+            if(errno == EINTR || errno == EAGAIN) continue;
+            return errno;
+        }
+        p += w; left -= (size_t)w;
+    }
+    return 0;
+}
+static int atmFileSync(int fd){
+    while(fdatasync(fd) != 0)
+        if(errno != EINTR) return errno;
+    return 0;
+}
+static int atmFileTruncate(int fd, long long size){
+    while(ftruncate(fd, (off_t)size) != 0)
+        if(errno != EINTR) return errno;
+    return 0;
+}
+#endif
+
+static ATMLedger atmLedger;                      // the bank's ledger
+static ATMLedger *atmActiveLedger = &atmLedger;  // the stress test swaps in a scratch one
+
+static uint32_t atmCrc32(const void *data, size_t n){
+    static uint32_t table[256];
+    static bool ready = false;
+    if(!ready){
+        for(uint32_t i=0;i<256;i++){
+            uint32_t c = i;
+            for(int k=0;k<8;k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        ready = true;
+    }
+    const unsigned char *p = (const unsigned char *)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for(size_t i=0;i<n;i++) c = table[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+static uint32_t atmRecCrc(const ATMLedgerRec &r){
+    return atmCrc32((const char *)&r + sizeof(r.crc), sizeof(r) - sizeof(r.crc));
+}
+
+static int64_t atmNowMs(){
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static string atmFormatTime(int64_t ms){
+    time_t t = (time_t)(ms / 1000);
+    struct tm tmv;
+#ifdef _WIN32
+    localtime_s(&tmv, &t);
+#else
+    localtime_r(&t, &tmv);
+#endif
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tmv);
+    return string(buf);
+}
+
+static void atmCopyField(char *dst, size_t n, const string &src){
+    memset(dst, 0, n);
+    memcpy(dst, src.data(), min(n - 1, src.size()));
+}
+
+bool atmLedgerOpen(ATMLedger &L, const string &path, uint64_t lastSeq){
+    L.path = path;
+    L.fd = atmFileOpen(path, true);
+    L.nextSeq = L.durableSeq = lastSeq;
+    L.pending.clear();
+    L.goodBytes = L.fd >= 0 ? atmFileSize(L.fd) : 0;
+    L.failed = L.fd < 0 || L.goodBytes < 0;
+    return !L.failed;
+}
+
+bool atmLedgerWait(ATMLedger &L, uint64_t seq);
+
+// flushes anything still pending before closing
+void atmLedgerClose(ATMLedger &L){
+    if(L.fd >= 0 && L.nextSeq > L.durableSeq && !atmLedgerWait(L, L.nextSeq))
+        cout<<"Warning: "<<L.nextSeq - L.durableSeq<<" ledger records could not be written to "<<L.path<<".\n";
+    if(L.fd >= 0) atmFileClose(L.fd);
+    L.fd = -1;
+}
+
+// call with the record's account lock held so file order matches balance order
+uint64_t atmLedgerEnqueue(ATMLedger &L, ATMLedgerRec &r){
+    lock_guard<mutex> g(L.m);
+    r.size = sizeof(ATMLedgerRec);
+    r.seq = ++L.nextSeq;
+    r.crc = atmRecCrc(r);
+    L.pending.push_back(r);
+    return r.seq;
+}
+
+// Block until seq is on disk. A failed write or sync (disk full, I/O error)
+// cuts the file back to its last durable record and puts the batch back at
+// the head of pending, so it is retried by the next flush and never dropped.
+// Returns false if seq is still not durable after ATM_LEDGER_RETRIES
+// attempts, or once the file can no longer be trusted (failed).
+bool atmLedgerWait(ATMLedger &L, uint64_t seq){
+    unique_lock<mutex> lk(L.m);
+    int attempts = 0;
+    while(L.durableSeq < seq){
+        if(L.failed) return false;
+        if(L.flushing){ L.cv.wait(lk); continue; }
+        if(attempts++ == ATM_LEDGER_RETRIES) return false;
+        L.flushing = true;
+        vector<ATMLedgerRec> batch;
+        batch.swap(L.pending);
+        lk.unlock();
+        size_t bytes = batch.size() * sizeof(ATMLedgerRec);
+        int err = atmFileWrite(L.fd, (const char *)batch.data(), bytes);
+        if(err == 0) err = atmFileSync(L.fd);
+        bool lost = err != 0 && atmFileTruncate(L.fd, L.goodBytes) != 0;
+        lk.lock();
+        L.syncs++;
+        if(err == 0){
+            L.goodBytes += (long long)bytes;
+            L.durableSeq = batch.back().seq;
+            if(L.lastErr) cout<<"Ledger: writes to "<<L.path<<" recovered.\n";
+            L.lastErr = 0;
+        } else {
+            batch.insert(batch.end(), L.pending.begin(), L.pending.end());
+            L.pending.swap(batch);
+            if(lost) L.failed = true; // torn tail could not be removed
+            if(lost || err != L.lastErr)
+                cout<<"Ledger: write to "<<L.path<<" failed ("<<strerror(err)<<")"<<(lost ? "; ledger disabled.\n" : "; will retry.\n");
+            L.lastErr = err;
+        }
+        L.flushing = false;
+        L.cv.notify_all();
+    }
+    return true;
+}
+
+// Map the ledger read-only and hand every valid record to fn. A torn or
+// corrupt tail (crash mid-write) ends the replay and is cut off so new
+// records append after the last good one. Returns the last good sequence.
+template <class F>
+uint64_t atmLedgerReplay(const string &path, F fn){
+    int fd = atmFileOpen(path, false);
+    if(fd < 0) return 0;
+    long long size = atmFileSize(fd);
+    uint64_t last = 0;
+    if(size > 0){
+        size_t n = (size_t)size / sizeof(ATMLedgerRec);
+#ifdef _WIN32
+        // no mmap here: read the records into memory instead
+        vector<ATMLedgerRec> buf(n);
+        size_t got = 0, want = n * sizeof(ATMLedgerRec);
+        while(got < want){
+            int r = _read(fd, (char *)buf.data() + got, (unsigned)min(want - got, (size_t)1 << 30));
+            if(r <= 0) break;
+            got += (size_t)r;
+        }
+        n = got / sizeof(ATMLedgerRec);
+        const ATMLedgerRec *rec = buf.data();
+#else
+        void *map = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map == MAP_FAILED){ atmFileClose(fd); return 0; }
+        const ATMLedgerRec *rec = (const ATMLedgerRec *)map;
+#endif
+        size_t good = 0;
+        for(; good<n; good++){
+            if(rec[good].size != sizeof(ATMLedgerRec) || rec[good].crc != atmRecCrc(rec[good])) break;
+            fn(rec[good]);
+            last = rec[good].seq;
+        }
+#ifndef _WIN32
+        munmap(map, (size_t)size);
+#endif
+        if((long long)(good * sizeof(ATMLedgerRec)) != size){
+            cout<<"Ledger: dropped corrupt tail after record "<<good<<".\n";
+            if(atmFileTruncate(fd, (long long)(good * sizeof(ATMLedgerRec))) != 0) cout<<"Ledger: truncate failed.\n";
+        }
+    }
+    atmFileClose(fd);
+    return last;
+}
+
+static ATMTransaction atmTxFromRec(const ATMLedgerRec &r){
+    ATMTransaction t;
+    t.acc = r.acc; t.type = r.type; t.amt = r.amt; t.currency = "INR";
+    t.atmID = r.atmID; t.time = atmFormatTime(r.timeMs); t.balAfter = r.balAfter; t.remark = r.remark;
+    return t;
+}
+
+// Replay the ledger over the CSV snapshot: balances take each account's last
+// balAfter, today's withdrawals count against the daily limit again.
+void atmReplayLedger(){
+    string today = atmFormatTime(atmNowMs()).substr(0, 10);
+    long long n = 0;
+    uint64_t last = atmLedgerReplay(ATM_LEDGER_FILE, [&](const ATMLedgerRec &r){
+        ATMTransaction t = atmTxFromRec(r);
+        t.id = (int)TX.size() + 1;
+        TX.push_back(t);
+        n++;
+        int i = findAcc(t.acc);
+        if(i == -1) return;
+        atmCtx->acc[i].balance = r.balAfter;
+        if(t.type == "WITHDRAW" && t.time.compare(0, 10, today) == 0) atmCtx->acc[i].dayWithdraw += r.amt;
+    });
+    atmLedgerClose(atmLedger);
+    if(!atmLedgerOpen(atmLedger, ATM_LEDGER_FILE, last)) cout<<"Warning: cannot open "<<ATM_LEDGER_FILE<<" for append.\n";
+    if(n > 0) cout<<"Replayed "<<n<<" ledger records.\n";
+}
+
 void loadAll(){
     loadAccounts();
     loadCash();
     loadRates();
     loadTx();
+    atmReplayLedger();
     dataLoaded = true;
     cout<<"CSV LOAD COMPLETE. (manual load done)\n";
 }
 
+// Record one transaction in memory and on the active ledger. Call with the
+// account lock held; pass the result to atmLedgerWait once it is released.
+uint64_t atmLogTx(const string &acc,const string &type,double amt,const string &remark,const string &atmID,double balAfter){
+    ATMLedgerRec r;
+    memset(&r, 0, sizeof(r));
+    r.timeMs = atmNowMs();
+    r.amt = amt;
+    r.balAfter = balAfter;
+    atmCopyField(r.acc, sizeof(r.acc), acc);
+    atmCopyField(r.type, sizeof(r.type), type);
+    atmCopyField(r.atmID, sizeof(r.atmID), atmID);
+    atmCopyField(r.remark, sizeof(r.remark), remark);
+    if(atmActiveLedger == &atmLedger){
+        ATMTransaction t = atmTxFromRec(r);
+        lock_guard<mutex> g(atmTxLock);
+        t.id = (int)TX.size() + 1;
+        TX.push_back(t);
+    }
+    return atmLedgerEnqueue(*atmActiveLedger, r);
+}
+
+void atmCommitTx(uint64_t seq){
+    if(!atmLedgerWait(*atmActiveLedger, seq)){
+        if(atmActiveLedger->failed) cout<<"Warning: ledger unavailable; transaction kept in memory only.\n";
+        else cout<<"Warning: ledger write delayed; the transaction stays queued and is retried with the next one.\n";
+    }
+}
+
 void logTx(const string &acc,const string &type,double amt,const string &remark){
-    if(txCnt >= ATM_MAX_TRANSACTIONS) return;
-    ATMTransaction t;
-    t.id = txCnt + 1;
-    t.acc = acc;
-    t.type = type;
-    t.amt = amt;
-    t.currency = "INR";
-    t.atmID = (cashCnt>0 ? CASH[0].atmID : string("ATM001"));
-    t.time = "TODAY";
     int idx = findAcc(acc);
-    t.balAfter = (idx==-1? 0.0 : ACC[idx].balance);
-    t.remark = remark;
-    TX[txCnt++] = t;
+    uint64_t seq;
+    if(idx == -1) seq = atmLogTx(acc, type, amt, remark, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")), 0.0);
+    else {
+        lock_guard<mutex> g(atmCtx->accLock[idx]);
+        seq = atmLogTx(acc, type, amt, remark, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")), atmCtx->acc[idx].balance);
+    }
+    atmCommitTx(seq);
+}
+
+// ---------- exact note dispensing ----------
+static const int atmNoteValue[ATM_DENOMS] = {2000, 500, 200, 100, 50};
+
+static int &atmNotes(ATMCash &c, int d){
+    switch(d){
+        case 0: return c.n2000;
+        case 1: return c.n500;
+        case 2: return c.n200;
+        case 3: return c.n100;
+        default: return c.n50;
+    }
+}
+
+// Bounded-knapsack reachability: each cassette's count is split into
+// 1,2,4,... chunks so the bitset is shifted O(log count) times per note.
+void atmRefreshPayable(ATMCash &c){
+    bitset<ATM_PAY_UNITS + 1> r;
+    r[0] = 1;
+    for(int d=0;d<ATM_DENOMS;d++){
+        int u = atmNoteValue[d] / ATM_NOTE_UNIT;
+        int cnt = min(atmNotes(c,d), ATM_PAY_UNITS / u);
+        for(int k=1; cnt>0; k<<=1){
+            int t = min(k, cnt);
+            r |= r << (t * u);
+            cnt -= t;
+        }
+    }
+    c.payable = r;
+    c.payableReady = true;
+}
+
+bool atmCanDispense(ATMCash &c, int amt){
+    if(amt <= 0 || amt % ATM_NOTE_UNIT != 0 || amt > ATM_MAX_WITHDRAW_PER_TXN) return false;
+    if(!c.payableReady) atmRefreshPayable(c);
+    return c.payable[amt / ATM_NOTE_UNIT];
+}
+
+// Note mix for a payable amount. Taking a note from cassette d costs
+// 1/(notes left in d + 1), so the mix drains the fullest cassettes and
+// spares the nearly empty ones. Min-cost bounded knapsack; the cost is
+// linear in the note count, so each residue class is a sliding-window
+// minimum and the whole plan is O(ATM_DENOMS * units).
+static void atmPlanNotes(ATMCash &c, int units, int take[ATM_DENOMS]){
+    const double INF = 1e18;
+    double dpA[ATM_PAY_UNITS + 1], dpB[ATM_PAY_UNITS + 1];
+    double *dp = dpA, *nd = dpB;
+    int q[ATM_PAY_UNITS + 1];
+    int choice[ATM_DENOMS][ATM_PAY_UNITS + 1];
+    for(int v=0;v<=units;v++) dp[v] = INF;
+    dp[0] = 0;
+    for(int d=0;d<ATM_DENOMS;d++){
+        int u = atmNoteValue[d] / ATM_NOTE_UNIT;
+        int cnt = min(atmNotes(c,d), units / u);
+        double w = 1.0 / (atmNotes(c,d) + 1);
+        for(int r=0;r<u && r<=units;r++){
+            int head = 0, tail = 0;
+            for(int j=0; r + j*u <= units; j++){
+                double key = dp[r + j*u] - j*w;
+                while(tail > head && dp[r + q[tail-1]*u] - q[tail-1]*w >= key) tail--;
+                q[tail++] = j;
+                while(q[head] < j - cnt) head++;
+                int i = q[head];
+                int v = r + j*u;
+                nd[v] = (dp[r + i*u] >= INF) ? INF : dp[r + i*u] + (j - i) * w;
+                choice[d][v] = j - i;
+            }
+        }
+        swap(dp, nd);
+    }
+    for(int d=ATM_DENOMS-1, v=units; d>=0; d--){
+        take[d] = choice[d][v];
+        v -= take[d] * (atmNoteValue[d] / ATM_NOTE_UNIT);
+    }
 }
 
 bool dispense(int amt, ATMCash &c){
-    long long total = (long long)c.n2000*2000 + (long long)c.n500*500 + (long long)c.n200*200 + (long long)c.n100*100 + (long long)c.n50*50;
-    if(total < amt) return false;
-    int r = amt;
-    int a = min(c.n2000, r/2000); r -= a*2000;
-    int b = min(c.n500, r/500); r -= b*500;
-    int d = min(c.n200, r/200); r -= d*200;
-    int e = min(c.n100, r/100); r -= e*100;
-    int f = min(c.n50, r/50); r -= f*50;
-    if(r != 0) return false;
-    c.n2000 -= a; c.n500 -= b; c.n200 -= d; c.n100 -= e; c.n50 -= f;
+    if(amt == 0) return true;
+    if(!atmCanDispense(c, amt)) return false;
+    int take[ATM_DENOMS];
+    atmPlanNotes(c, amt / ATM_NOTE_UNIT, take);
+    for(int d=0;d<ATM_DENOMS;d++) atmNotes(c,d) -= take[d];
+    atmRefreshPayable(c);
     return true;
 }
 
+// Ledger operations shared by the interactive menu and the multi-ATM engine.
+// Each holds only the account's own lock; the ATMCash belongs to the calling ATM.
+enum { ATM_OK, ATM_ERR_LOCKED, ATM_ERR_DAILY, ATM_ERR_FUNDS, ATM_ERR_DISPENSE };
+
+// amount debited from the account for an INR withdrawal of amt
+double atmWithdrawCost(const ATMAccount &a, double amt){
+    if(a.cur == atmCurINR) return amt;
+    double r = atmRate(a.cur);
+    if(r == 0) r = 1.0;
+    return (amt + feeINR(amt)) / r;
+}
+
+int atmWithdrawOn(int i, double amt, ATMCash &c){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        ATMAccount &a = atmCtx->acc[i];
+        if(a.locked) return ATM_ERR_LOCKED;
+        if(a.dayWithdraw + amt > ATM_DAILY_LIMIT) return ATM_ERR_DAILY;
+        double required = atmWithdrawCost(a, amt);
+        if(required > a.balance) return ATM_ERR_FUNDS;
+        if(!dispense((int)amt, c)) return ATM_ERR_DISPENSE;
+        a.balance -= required;
+        a.dayWithdraw += amt;
+        seq = atmLogTx(a.number,"WITHDRAW",amt,"Cash Withdrawal",c.atmID,a.balance);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
+// admin balance edit, logged as an ADJUST of the difference
+int atmAdjustOn(int i, double nb, const string &atmID){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        double old = atmCtx->acc[i].balance;
+        atmCtx->acc[i].balance = nb;
+        seq = atmLogTx(atmCtx->acc[i].number,"ADJUST",nb-old,"Admin balance edit",atmID,nb);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
+// Fields the engine changes, read together under the account's lock for
+// the interactive menus.
+struct ATMAccView { double balance, dayWithdraw; int locked; };
+
+ATMAccView atmViewAcc(int i){
+    lock_guard<mutex> g(atmCtx->accLock[i]);
+    const ATMAccount &a = atmCtx->acc[i];
+    ATMAccView v = { a.balance, a.dayWithdraw, a.locked };
+    return v;
+}
+
+int atmDepositOn(int i, double amt, const string &atmID){
+    uint64_t seq;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        if(atmCtx->acc[i].locked) return ATM_ERR_LOCKED;
+        atmCtx->acc[i].balance += amt;
+        seq = atmLogTx(atmCtx->acc[i].number,"DEPOSIT",amt,"Cash Deposit",atmID,atmCtx->acc[i].balance);
+    }
+    atmCommitTx(seq);
+    return ATM_OK;
+}
+
 int login(){
     string a; int pin;
     cout<<"Enter Account Number: ";
     if(!(cin>>a)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); return -1; }
     int i = findAcc(a);
     if(i == -1){ cout<<"Not found.\n"; return -1; }
-    if(ACC[i].locked){ cout<<"Locked.\n"; return -1; }
+    if(atmViewAcc(i).locked){ cout<<"Locked.\n"; return -1; }
     cout<<"PIN: ";
     if(!(cin>>pin)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); return -1; }
-    if(pin != ACC[i].pin){
-        ACC[i].wrongPin++;
-        if(ACC[i].wrongPin >= ATM_PIN_ATTEMPT_LIMIT) ACC[i].locked = 1;
-        cout<<"Wrong PIN.\n";
-        return -1;
+    bool ok;
+    {
+        lock_guard<mutex> g(atmCtx->accLock[i]);
+        ATMAccount &a = atmCtx->acc[i];
+        ok = (pin == a.pin);
+        if(ok) a.wrongPin = 0;
+        else if(++a.wrongPin >= ATM_PIN_ATTEMPT_LIMIT) a.locked = 1;
     }
-    ACC[i].wrongPin = 0;
+    if(!ok){ cout<<"Wrong PIN.\n"; return -1; }
     return i;
 }
 
 void checkBal(int i){
-    cout<<"Balance: "<<ACC[i].balance<<" "<<ACC[i].currency<<"\n";
-    logTx(ACC[i].number,"BAL_CHECK",0,"Balance Inquiry");
+    cout<<"Balance: "<<atmViewAcc(i).balance<<" "<<atmCtx->acc[i].currency<<"\n";
+    logTx(atmCtx->acc[i].number,"BAL_CHECK",0,"Balance Inquiry");
 }
 
 void deposit(int i){
@@ -248,9 +848,8 @@ void deposit(int i){
     cout<<"Enter deposit amount: ";
     if(!(cin>>amt)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(amt <= 0 || amt > ATM_MAX_DEPOSIT_PER_TXN){ cout<<"Invalid deposit amount.\n"; return; }
-    ACC[i].balance += amt;
-    logTx(ACC[i].number,"DEPOSIT",amt,"Cash Deposit");
-    cout<<"Deposit successful. New balance: "<<ACC[i].balance<<"\n";
+    atmDepositOn(i, amt, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001")));
+    cout<<"Deposit successful. New balance: "<<atmViewAcc(i).balance<<"\n";
 }
 
 void withdraw(int i){
@@ -258,22 +857,19 @@ void withdraw(int i){
     cout<<"Enter withdrawal amount: ";
     if(!(cin>>amt)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(amt <= 0 || amt > ATM_MAX_WITHDRAW_PER_TXN){ cout<<"Invalid withdrawal amount.\n"; return; }
-    if(ACC[i].dayWithdraw + amt > ATM_DAILY_LIMIT){ cout<<"Daily withdrawal limit exceeded.\n"; return; }
-    double required = amt;
-    if(ACC[i].currency != "INR"){
-        double conv = fromINR(amt, ACC[i].currency);
-        double fee = feeINR(amt);
-        double feeConv = fromINR(fee, ACC[i].currency);
-        required = conv + feeConv;
-        cout<<"International conversion: "<<conv<<" "<<ACC[i].currency<<", fee: "<<feeConv<<" "<<ACC[i].currency<<"\n";
-    }
-    if(required > ACC[i].balance){ cout<<"Insufficient funds after conversion.\n"; return; }
-    if(cashCnt == 0){ cout<<"ATM cash not loaded.\n"; return; }
-    if(!dispense((int)amt, CASH[0])){ cout<<"ATM cannot dispense this amount exactly.\n"; return; }
-    ACC[i].balance -= required;
-    ACC[i].dayWithdraw += amt;
-    logTx(ACC[i].number,"WITHDRAW",amt,"Cash Withdrawal");
-    cout<<"Withdrawal successful. New balance: "<<ACC[i].balance<<"\n";
+    ATMAccView v = atmViewAcc(i);
+    if(v.dayWithdraw + amt > ATM_DAILY_LIMIT){ cout<<"Daily withdrawal limit exceeded.\n"; return; }
+    if(atmCtx->acc[i].currency != "INR"){
+        double conv = fromINR(amt, atmCtx->acc[i].currency);
+        double feeConv = fromINR(feeINR(amt), atmCtx->acc[i].currency);
+        cout<<"International conversion: "<<conv<<" "<<atmCtx->acc[i].currency<<", fee: "<<feeConv<<" "<<atmCtx->acc[i].currency<<"\n";
+    }
+    if(atmWithdrawCost(atmCtx->acc[i], amt) > v.balance){ cout<<"Insufficient funds after conversion.\n"; return; }
+    if(atmCtx->cash.empty()){ cout<<"ATM cash not loaded.\n"; return; }
+    int r = atmWithdrawOn(i, amt, atmCtx->cash[0]);
+    if(r == ATM_ERR_DISPENSE){ cout<<"ATM cannot dispense this amount exactly.\n"; return; }
+    if(r != ATM_OK){ cout<<"Withdrawal refused.\n"; return; }
+    cout<<"Withdrawal successful. New balance: "<<atmViewAcc(i).balance<<"\n";
 }
 
 bool adminLogin(){
@@ -283,20 +879,21 @@ bool adminLogin(){
 }
 
 void adminAddAcc(){
-    if(accCnt >= ATM_MAX_ACCOUNTS){ cout<<"Account storage full.\n"; return; }
+    if((int)atmCtx->acc.size() >= ATM_MAX_ACCOUNTS){ cout<<"Account storage full.\n"; return; }
     ATMAccount a;
     cout<<"Enter Account Number: "; cin>>a.number;
     if(findAcc(a.number) != -1){ cout<<"Account already exists.\n"; return; }
     cout<<"Customer Name: "; cin.ignore(); getline(cin, a.name);
     cout<<"PIN (numeric): "; cin>>a.pin;
     cout<<"Account Type (SAVINGS/CURRENT): "; cin>>a.type;
-    cout<<"Currency (INR/USD/EUR): "; cin>>a.currency;
+    cout<<"Currency (INR/USD/EUR): "; cin>>a.currency; a.cur = atmInternCurrency(a.currency);
     cout<<"Initial Balance: "; cin>>a.balance;
     if(a.balance < 0){ cout<<"Balance cannot be negative.\n"; return; }
     cout<<"Withdrawal Limit: "; cin>>a.limit;
     cout<<"Card Country Code: "; cin>>a.cardCountry;
     a.locked = 0; a.wrongPin = 0; a.dayWithdraw = 0;
-    ACC[accCnt++] = a;
+    atmAppendAcc(a);
+    atmIndexAcc(atmCtx->acc.size()-1);
     cout<<"Account created successfully.\n";
 }
 
@@ -309,13 +906,13 @@ void adminEditAcc(){
         cout<<"1.Change Name 2.Change PIN 3.Change Type 4.Change Balance 5.Unlock 6.Change Limit 7.Change Currency 0.Done\nChoice: ";
         if(!(cin>>ch)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
         switch(ch){
-            case 1: cin.ignore(); cout<<"New Name: "; getline(cin, ACC[i].name); break;
-            case 2: cout<<"New PIN: "; cin>>ACC[i].pin; break;
-            case 3: cout<<"New Type: "; cin>>ACC[i].type; break;
-            case 4: { double nb; cout<<"New Balance: "; cin>>nb; if(nb < 0) cout<<"Cannot set negative balance.\n"; else ACC[i].balance = nb; break; }
-            case 5: ACC[i].locked = 0; ACC[i].wrongPin = 0; cout<<"Account unlocked.\n"; break;
-            case 6: cout<<"New Withdrawal Limit: "; cin>>ACC[i].limit; break;
-            case 7: cout<<"New Currency: "; cin>>ACC[i].currency; break;
+            case 1: cin.ignore(); cout<<"New Name: "; getline(cin, atmCtx->acc[i].name); break;
+            case 2: cout<<"New PIN: "; cin>>atmCtx->acc[i].pin; break;
+            case 3: cout<<"New Type: "; cin>>atmCtx->acc[i].type; break;
+            case 4: { double nb; cout<<"New Balance: "; cin>>nb; if(nb < 0) cout<<"Cannot set negative balance.\n"; else atmAdjustOn(i, nb, (!atmCtx->cash.empty() ? atmCtx->cash[0].atmID : string("ATM001"))); break; }
+            case 5: { lock_guard<mutex> g(atmCtx->accLock[i]); atmCtx->acc[i].locked = 0; atmCtx->acc[i].wrongPin = 0; } cout<<"Account unlocked.\n"; break;
+            case 6: cout<<"New Withdrawal Limit: "; cin>>atmCtx->acc[i].limit; break;
+            case 7: cout<<"New Currency: "; cin>>atmCtx->acc[i].currency; atmCtx->acc[i].cur = atmInternCurrency(atmCtx->acc[i].currency); break;
             case 0: break;
             default: cout<<"Invalid option.\n";
         }
@@ -323,17 +920,18 @@ void adminEditAcc(){
 }
 
 void adminCash(){
-    if(cashCnt == 0){
-        CASH[0].atmID = "ATM001";
-        CASH[0].location = "MAIN";
-        CASH[0].n2000 = CASH[0].n500 = CASH[0].n200 = CASH[0].n100 = CASH[0].n50 = 0;
-        cashCnt = 1;
+    if(atmCtx->cash.empty()){
+        ATMCash c; // note counts start at 0
+        c.atmID = "ATM001";
+        c.location = "MAIN";
+        atmCtx->cash.push_back(c);
     }
     int a,b,d,e,f;
     cout<<"Enter counts to ADD for 2000 500 200 100 50 (space separated): ";
     if(!(cin>>a>>b>>d>>e>>f)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; return; }
     if(a<0||b<0||d<0||e<0||f<0){ cout<<"Cannot add negative notes.\n"; return; }
-    CASH[0].n2000 += a; CASH[0].n500 += b; CASH[0].n200 += d; CASH[0].n100 += e; CASH[0].n50 += f;
+    atmCtx->cash[0].n2000 += a; atmCtx->cash[0].n500 += b; atmCtx->cash[0].n200 += d; atmCtx->cash[0].n100 += e; atmCtx->cash[0].n50 += f;
+    atmCtx->cash[0].payableReady = false;
     cout<<"ATM cash updated.\n";
 }
 
@@ -342,10 +940,131 @@ void adminAddRate(){
     cout<<"Enter currency code (e.g. USD): "; cin>>r.code;
     cout<<"Enter rate to INR (e.g. 83): "; cin>>r.toINR;
     if(r.toINR <= 0){ cout<<"Invalid rate.\n"; return; }
-    RATE[rateCnt++] = r;
+    int id = atmInternCurrency(r.code);
+    if(id == -1){ cout<<"Rate table full.\n"; return; }
+    atmUpdateRate(id, r.toINR);
     cout<<"Rate added.\n";
 }
 
+// End-of-day settlement: today's withdrawals, converted in one batch into
+// each account's currency and totalled per currency.
+void atmSettlement(){
+    string today = atmFormatTime(atmNowMs()).substr(0, 10);
+    vector<double> inr;
+    vector<int> cur;
+    {
+        lock_guard<mutex> g(atmTxLock);
+        for(size_t k=0;k<TX.size();k++){
+            if(TX[k].type != "WITHDRAW" || TX[k].time.compare(0, 10, today) != 0) continue;
+            int i = findAcc(TX[k].acc);
+            inr.push_back(TX[k].amt);
+            cur.push_back(i == -1 ? atmCurINR : atmCtx->acc[i].cur);
+        }
+    }
+    vector<double> local(inr.size());
+    atmConvertFromINR(inr.data(), cur.data(), local.data(), inr.size());
+    vector<double> totLocal(atmCurrencyCode.size(), 0.0), totINR(atmCurrencyCode.size(), 0.0);
+    vector<int> cnt(atmCurrencyCode.size(), 0);
+    for(size_t k=0;k<inr.size();k++){
+        int c = cur[k] < 0 ? atmCurINR : cur[k];
+        totLocal[c] += local[k]; totINR[c] += inr[k]; cnt[c]++;
+    }
+    cout<<"Settlement for "<<today<<" ("<<inr.size()<<" withdrawals)\n";
+    for(size_t c=0;c<atmCurrencyCode.size();c++)
+        if(cnt[c] > 0)
+            cout<<atmCurrencyCode[c]<<" | "<<cnt[c]<<" txns | "<<totLocal[c]<<" "<<atmCurrencyCode[c]<<" | "<<totINR[c]<<" INR\n";
+}
+
+// Stress driver: nAtms simulated ATMs, each with its own ATMCash and worker
+// thread, replay random withdrawals/deposits against a hot set of shared
+// accounts. Afterwards every account must equal start + its deposits - its
+// debits, stay non-negative and within the daily limit. Records go to a
+// scratch ledger that is replayed and checked, then deleted; accounts are
+// restored when the run ends.
+void atmStressTest(int nAtms, int opsPerAtm, int hotAccounts){
+    int accCnt = atmCtx->acc.size();
+    if(accCnt == 0 || nAtms <= 0 || opsPerAtm <= 0){ cout<<"Nothing to run (load accounts first).\n"; return; }
+    if(hotAccounts <= 0 || hotAccounts > accCnt) hotAccounts = accCnt;
+    vector<ATMAccount> saved(atmCtx->acc);
+    ATMLedger scratch;
+    string scratchPath = string(ATM_LEDGER_FILE) + ".stress";
+    remove(scratchPath.c_str());
+    if(!atmLedgerOpen(scratch, scratchPath, 0)){ cout<<"Cannot create "<<scratchPath<<"\n"; return; }
+    atmActiveLedger = &scratch;
+
+    vector<ATMCash> atms(nAtms);
+    for(int k=0;k<nAtms;k++){
+        atms[k].atmID = "SIM" + to_string(k+1);
+        atms[k].location = "STRESS";
+        atms[k].n2000 = atms[k].n500 = atms[k].n200 = atms[k].n100 = atms[k].n50 = 1000000;
+    }
+    // per-ATM tallies, merged after the run: net change and INR dispensed
+    vector<vector<double> > delta(nAtms, vector<double>(hotAccounts, 0.0));
+    vector<long long> dispensed(nAtms, 0);
+    atomic<long long> ok(0), refused(0);
+
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> workers;
+    for(int k=0;k<nAtms;k++){
+        workers.push_back(thread([&, k](){
+            unsigned rng = 2463534242u ^ (unsigned)(k * 2654435761u);
+            for(int n=0;n<opsPerAtm;n++){
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                int i = (int)(rng % (unsigned)hotAccounts);
+                double amt = 100.0 * (1 + (int)((rng >> 8) % 50u));
+                int r;
+                if((rng >> 20) % 10u < 7){
+                    double cost = atmWithdrawCost(atmCtx->acc[i], amt);
+                    r = atmWithdrawOn(i, amt, atms[k]);
+                    if(r == ATM_OK){ delta[k][i] -= cost; dispensed[k] += (long long)amt; }
+                } else {
+                    r = atmDepositOn(i, amt, atms[k].atmID);
+                    if(r == ATM_OK) delta[k][i] += amt;
+                }
+                if(r == ATM_OK) ok.fetch_add(1, memory_order_relaxed);
+                else refused.fetch_add(1, memory_order_relaxed);
+            }
+        }));
+    }
+    for(size_t k=0;k<workers.size();k++) workers[k].join();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    atmActiveLedger = &atmLedger;
+    atmLedgerClose(scratch);
+
+    // replaying the scratch ledger must reproduce every final balance
+    vector<double> replayed(hotAccounts, 0.0);
+    vector<char> seen(hotAccounts, 0);
+    long long records = 0;
+    atmLedgerReplay(scratchPath, [&](const ATMLedgerRec &r){
+        records++;
+        int i = findAcc(r.acc);
+        if(i >= 0 && i < hotAccounts){ replayed[i] = r.balAfter; seen[i] = 1; }
+    });
+    remove(scratchPath.c_str());
+    int badReplay = 0;
+    for(int i=0;i<hotAccounts;i++)
+        if(seen[i] && fabs(replayed[i] - atmCtx->acc[i].balance) > 1e-6 * (1 + fabs(atmCtx->acc[i].balance))) badReplay++;
+
+    int badBalance = 0, badLimit = 0, badCash = 0;
+    for(int i=0;i<hotAccounts;i++){
+        double expect = saved[i].balance;
+        for(int k=0;k<nAtms;k++) expect += delta[k][i];
+        if(fabs(atmCtx->acc[i].balance - expect) > 1e-6 * (1 + fabs(expect)) || atmCtx->acc[i].balance < -1e-9) badBalance++;
+        if(atmCtx->acc[i].dayWithdraw > ATM_DAILY_LIMIT) badLimit++;
+    }
+    for(int k=0;k<nAtms;k++){
+        long long left = (long long)atms[k].n2000*2000 + (long long)atms[k].n500*500 + (long long)atms[k].n200*200 + (long long)atms[k].n100*100 + (long long)atms[k].n50*50;
+        if(left + dispensed[k] != 1000000LL * 2850) badCash++;
+    }
+    cout<<"ATMs="<<nAtms<<" accounts="<<hotAccounts<<" ok="<<ok.load()<<" refused="<<refused.load()<<"\n";
+    cout<<"Elapsed "<<secs<<"s, "<<(secs > 0 ? (ok.load() + refused.load()) / secs : 0)<<" TPS\n";
+    cout<<"Balance mismatches="<<badBalance<<" daily-limit violations="<<badLimit<<" cash mismatches="<<badCash<<"\n";
+    cout<<"Ledger: "<<records<<" records ("<<(secs > 0 ? records / secs : 0)<<"/s), "<<scratch.syncs<<" syncs, "
+        <<(records != ok.load() ? "RECORD COUNT MISMATCH, " : "")<<"replay mismatches="<<badReplay<<"\n";
+
+    for(int i=0;i<accCnt;i++) atmCtx->acc[i] = saved[i];
+}
+
 void userMenu(int idx){
     while(true){
         int c;
@@ -362,7 +1081,7 @@ void userMenu(int idx){
 void adminMenu(){
     while(true){
         int c;
-        cout<<"1.Add Account 2.Edit Account 3.Add/Refill Cash 4.Add Rate 5.List Accounts 0.Exit\nChoice: ";
+        cout<<"1.Add Account 2.Edit Account 3.Add/Refill Cash 4.Add Rate 5.List Accounts 6.Stress Test 7.Settlement 8.Reload Rates 0.Exit\nChoice: ";
         if(!(cin>>c)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
         if(c==0){ cout<<"Exiting admin menu.\n"; return; }
         if(c==1) adminAddAcc();
@@ -370,14 +1089,29 @@ void adminMenu(){
         else if(c==3) adminCash();
         else if(c==4) adminAddRate();
         else if(c==5){
-            for(int i=0;i<accCnt;i++){
-                cout<<ACC[i].number<<" | "<<ACC[i].name<<" | "<<ACC[i].balance<<" "<<ACC[i].currency<<" | "<<(ACC[i].locked?"LOCKED":"OK")<<"\n";
+            for(size_t i=0;i<atmCtx->acc.size();i++){
+                ATMAccView v = atmViewAcc(i);
+                cout<<atmCtx->acc[i].number<<" | "<<atmCtx->acc[i].name<<" | "<<v.balance<<" "<<atmCtx->acc[i].currency<<" | "<<(v.locked?"LOCKED":"OK")<<"\n";
             }
-        } else cout<<"Invalid option.\n";
+        } else if(c==6){
+            int n, ops, hot;
+            cout<<"ATMs, operations per ATM, hot accounts: ";
+            if(!(cin>>n>>ops>>hot)){ cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); cout<<"Invalid input.\n"; continue; }
+            atmStressTest(n, ops, hot);
+        } else if(c==7) atmSettlement();
+        else if(c==8){ loadRates(); cout<<"Rates reloaded.\n"; }
+        else cout<<"Invalid option.\n";
     }
 }
 
+void atmInitModule(){
+    if(atmCtx) return; // state is kept across visits to the menu
+    atmCtx = new ATMContext();
+    atmCtx->accHash.assign(ATM_ACC_HASH_SIZE, 0);
+}
+
 void atmSystem(){
+    atmInitModule();
     while(true){
         int c;
         cout<<"\nATM SYSTEM - Choose an option\n1.User Login 2.Admin Login 3.Load CSV (Manual) 0.Exit\nChoice: ";
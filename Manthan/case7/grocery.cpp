@@ -1,9 +1,19 @@
-// grocery_module.cpp — compact, array-based, load-only, limits preserved, no STL
+// grocery_module.cpp — compact, column-based (SoA) tables that grow with the data
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <cstring>
 #include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <unordered_map>
+#include <cctype>
+#include "../city_date.h"
 using namespace std;
 
 /* EXTERN HELPERS (must exist in mega-project) */
@@ -12,12 +22,12 @@ static int grocery_toInt(const string &s);
 static double grocery_toDouble(const string &s);
 
 /* LIMITS */
-#define GROCERY_MAX_ITEMS 2000
-#define GROCERY_MAX_TRANSACTIONS 2000
-#define GROCERY_MAX_STAFF 2000
-#define GROCERY_MAX_ATTENDANCE 2000
 #define GROCERY_MAX_QUEUE 2000
-#define GROCERY_HASH_SIZE 4096
+#define GROCERY_MAX_LANES 64
+#define GROCERY_MAX_CART_LINES 100
+#define GROCERY_LOG_RESERVE_MAX (1 << 20) // log lines reserved ahead of a lane run
+#define GROCERY_HASH_MIN_SIZE 16 // power of two
+#define GROCERY_HASH_MAX_LOAD 70 // percent; table doubles past this
 int grocery_splitCSV(const string &line, string out[], int maxcols)
 {
     int cnt = 0;
@@ -59,7 +69,7 @@ struct groceryItem
     int reorder_level;
     string supplier_name;
     int perishable;
-    string expiry_date;
+    CityDate expiry_date;
 };
 
 struct groceryStaff
@@ -74,7 +84,7 @@ struct groceryStaff
 struct groceryTransaction
 {
     int txn_id;
-    string datetime;
+    CityDateTime datetime;
     int item_id;
     int qty;
     double unit_price;
@@ -86,128 +96,740 @@ struct groceryAttendance
 {
     int attendance_id;
     int staff_id;
-    string date;
+    CityDate date;
     string clock_in;
     string clock_out;
     double hours_worked;
 };
 
-/* GLOBALS */
-groceryItem groceryItems[GROCERY_MAX_ITEMS];
-int groceryItemCount = 0;
+/* TABLES (structure-of-arrays, grow on demand) */
+template <class T>
+static void groceryPermuteColumn(vector<T> &col, const vector<int> &order)
+{
+    vector<T> out;
+    out.reserve(col.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        out.push_back(std::move(col[order[i]]));
+    col.swap(out);
+}
 
-groceryStaff groceryStaffs[GROCERY_MAX_STAFF];
-int groceryStaffCount = 0;
+struct groceryItemTable
+{
+    vector<int> item_id;
+    vector<string> name;
+    vector<string> category;
+    vector<double> price;
+    /* stock lives in groceryCheckout.stock, row for row */
+    vector<int> reorder_level;
+    vector<string> supplier_name;
+    vector<int> perishable;
+    vector<CityDate> expiry_date;
+
+    int count() const { return (int)item_id.size(); }
+    void reserve(size_t n)
+    {
+        item_id.reserve(n);
+        name.reserve(n);
+        category.reserve(n);
+        price.reserve(n);
+        reorder_level.reserve(n);
+        supplier_name.reserve(n);
+        perishable.reserve(n);
+        expiry_date.reserve(n);
+    }
+    void push(const groceryItem &it)
+    {
+        item_id.push_back(it.item_id);
+        name.push_back(it.name);
+        category.push_back(it.category);
+        price.push_back(it.price);
+        reorder_level.push_back(it.reorder_level);
+        supplier_name.push_back(it.supplier_name);
+        perishable.push_back(it.perishable);
+        expiry_date.push_back(it.expiry_date);
+    }
+    void erase(int i)
+    {
+        item_id.erase(item_id.begin() + i);
+        name.erase(name.begin() + i);
+        category.erase(category.begin() + i);
+        price.erase(price.begin() + i);
+        reorder_level.erase(reorder_level.begin() + i);
+        supplier_name.erase(supplier_name.begin() + i);
+        perishable.erase(perishable.begin() + i);
+        expiry_date.erase(expiry_date.begin() + i);
+    }
+    /* reorder rows so that new row i is old row order[i] */
+    void permute(const vector<int> &order)
+    {
+        groceryPermuteColumn(item_id, order);
+        groceryPermuteColumn(name, order);
+        groceryPermuteColumn(category, order);
+        groceryPermuteColumn(price, order);
+        groceryPermuteColumn(reorder_level, order);
+        groceryPermuteColumn(supplier_name, order);
+        groceryPermuteColumn(perishable, order);
+        groceryPermuteColumn(expiry_date, order);
+    }
+};
 
-groceryTransaction groceryTransactions[GROCERY_MAX_TRANSACTIONS];
-int groceryTransactionCount = 0;
+struct groceryStaffTable
+{
+    vector<int> staff_id;
+    vector<string> name;
+    vector<string> role;
+    vector<double> salary;
+    vector<int> is_active;
+
+    int count() const { return (int)staff_id.size(); }
+    void reserve(size_t n)
+    {
+        staff_id.reserve(n);
+        name.reserve(n);
+        role.reserve(n);
+        salary.reserve(n);
+        is_active.reserve(n);
+    }
+    void push(const groceryStaff &s)
+    {
+        staff_id.push_back(s.staff_id);
+        name.push_back(s.name);
+        role.push_back(s.role);
+        salary.push_back(s.salary);
+        is_active.push_back(s.is_active);
+    }
+};
 
-groceryAttendance groceryAttendances[GROCERY_MAX_ATTENDANCE];
-int groceryAttendanceCount = 0;
+struct groceryTransactionTable
+{
+    vector<int> txn_id;
+    vector<CityDateTime> datetime;
+    vector<int> item_id;
+    vector<int> qty;
+    vector<double> unit_price;
+    vector<double> line_total;
+    vector<string> cashier_name;
+
+    int count() const { return (int)txn_id.size(); }
+    void reserve(size_t n)
+    {
+        txn_id.reserve(n);
+        datetime.reserve(n);
+        item_id.reserve(n);
+        qty.reserve(n);
+        unit_price.reserve(n);
+        line_total.reserve(n);
+        cashier_name.reserve(n);
+    }
+    void push(const groceryTransaction &t)
+    {
+        txn_id.push_back(t.txn_id);
+        datetime.push_back(t.datetime);
+        item_id.push_back(t.item_id);
+        qty.push_back(t.qty);
+        unit_price.push_back(t.unit_price);
+        line_total.push_back(t.line_total);
+        cashier_name.push_back(t.cashier_name);
+    }
+};
+
+struct groceryAttendanceTable
+{
+    vector<int> attendance_id;
+    vector<int> staff_id;
+    vector<CityDate> date;
+    vector<string> clock_in;
+    vector<string> clock_out;
+    vector<double> hours_worked;
+
+    int count() const { return (int)attendance_id.size(); }
+    void reserve(size_t n)
+    {
+        attendance_id.reserve(n);
+        staff_id.reserve(n);
+        date.reserve(n);
+        clock_in.reserve(n);
+        clock_out.reserve(n);
+        hours_worked.reserve(n);
+    }
+    void push(const groceryAttendance &a)
+    {
+        attendance_id.push_back(a.attendance_id);
+        staff_id.push_back(a.staff_id);
+        date.push_back(a.date);
+        clock_in.push_back(a.clock_in);
+        clock_out.push_back(a.clock_out);
+        hours_worked.push_back(a.hours_worked);
+    }
+};
 
-/* HASH TABLE (open addressing, linear probing) */
-int groceryHashKeys[GROCERY_HASH_SIZE]; // 0 = empty (assumes no item has id 0)
-int groceryHashIdx[GROCERY_HASH_SIZE];  // index in groceryItems or -1
+/* GLOBALS */
+groceryItemTable groceryItems;
+groceryStaffTable groceryStaffs;
+groceryTransactionTable groceryTransactions;
+groceryAttendanceTable groceryAttendances;
+
+/* CHECKOUT ENGINE
+   Owns the live stock of every item row as atomic counters, so any number
+   of lanes can commit carts at once. A cart takes all of its lines or none
+   (a failed line puts the earlier ones back). Between open() and close(),
+   committed carts go through a lock-free MPSC queue to one writer thread,
+   which is the only code that appends to groceryTransactions. Item rows are
+   added, removed and reordered only while the engine is closed. */
+struct groceryCartLine
+{
+    int item_idx;
+    int qty;
+};
 
-void groceryInitHash()
+struct groceryCartRecord
 {
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
+    int txn_id;
+    CityDateTime datetime;
+    string cashier;
+    vector<groceryCartLine> lines;
+};
+
+/* Vyukov-style MPSC queue: producers swap the head, the single consumer
+   follows next pointers from a dummy tail node. */
+struct groceryTxnQueue
+{
+    struct Node
     {
-        groceryHashKeys[i] = 0;
-        groceryHashIdx[i] = -1;
+        atomic<Node *> next;
+        groceryCartRecord rec;
+        Node() : next(nullptr) {}
+    };
+    atomic<Node *> head;
+    Node *tail;
+
+    groceryTxnQueue()
+    {
+        Node *stub = new Node();
+        head.store(stub);
+        tail = stub;
+    }
+    ~groceryTxnQueue()
+    {
+        groceryCartRecord tmp;
+        while (pop(tmp))
+        {
+        }
+        delete tail;
+    }
+    void push(groceryCartRecord &&rec)
+    {
+        Node *n = new Node();
+        n->rec = std::move(rec);
+        Node *prev = head.exchange(n, memory_order_acq_rel);
+        prev->next.store(n); // seq_cst: pairs with the writer's sleep check
+    }
+    bool ready() const // consumer thread only
+    {
+        return tail->next.load() != nullptr;
+    }
+    bool pop(groceryCartRecord &out) // consumer thread only
+    {
+        Node *next = tail->next.load(memory_order_acquire);
+        if (!next)
+            return false;
+        out = std::move(next->rec);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+
+/* one stock counter; copyable so the column can grow and be reordered */
+struct groceryStockCell
+{
+    atomic<int> qty;
+    groceryStockCell(int q = 0) : qty(q) {}
+    groceryStockCell(const groceryStockCell &o) : qty(o.qty.load(memory_order_relaxed)) {}
+    groceryStockCell &operator=(const groceryStockCell &o)
+    {
+        qty.store(o.qty.load(memory_order_relaxed), memory_order_relaxed);
+        return *this;
+    }
+};
+
+struct groceryCheckoutEngine
+{
+    vector<groceryStockCell> stock; // by item row, same order as groceryItems
+    vector<long long> sold;         // units written per item row since open()
+    long long linesWritten;
+    groceryTxnQueue queue;
+    thread writer;
+    mutex m;
+    condition_variable wake;
+    atomic<bool> writerWaiting;
+    bool closing;
+
+    groceryCheckoutEngine() : linesWritten(0), writerWaiting(false), closing(false) {}
+
+    /* item rows (engine closed) */
+    void reserve(size_t n) { stock.reserve(n); }
+    void addRow(int qty) { stock.push_back(groceryStockCell(qty)); }
+    void eraseRow(int i) { stock.erase(stock.begin() + i); }
+    void permute(const vector<int> &order) { groceryPermuteColumn(stock, order); }
+
+    int level(int idx) const { return stock[idx].qty.load(memory_order_acquire); }
+    void put(int idx, int qty) { stock[idx].qty.fetch_add(qty, memory_order_acq_rel); }
+
+    /* take qty from one item; never lets the counter go below zero */
+    bool take(int idx, int qty)
+    {
+        atomic<int> &s = stock[idx].qty;
+        int cur = s.load(memory_order_relaxed);
+        while (cur >= qty)
+        {
+            if (s.compare_exchange_weak(cur, cur - qty, memory_order_acq_rel, memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    /* book a sale recorded outside the engine (CSV, manual entry); floors at zero */
+    void deduct(int idx, int qty)
+    {
+        atomic<int> &s = stock[idx].qty;
+        int cur = s.load(memory_order_relaxed);
+        while (!s.compare_exchange_weak(cur, max(cur - qty, 0), memory_order_acq_rel, memory_order_relaxed))
+        {
+        }
+    }
+
+    /* all lines or none */
+    bool commit(const vector<groceryCartLine> &lines)
+    {
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            if (!take(lines[i].item_idx, lines[i].qty))
+            {
+                for (size_t j = 0; j < i; ++j)
+                    put(lines[j].item_idx, lines[j].qty);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* hand a committed cart to the writer; any thread, engine open */
+    void submit(groceryCartRecord &&rec)
+    {
+        queue.push(std::move(rec));
+        if (writerWaiting.load())
+        {
+            lock_guard<mutex> g(m);
+            wake.notify_one();
+        }
     }
-}
 
-static inline int groceryHashFunc(int key)
+    void open()
+    {
+        sold.assign(stock.size(), 0);
+        linesWritten = 0;
+        closing = false;
+        writer = thread(&groceryCheckoutEngine::writeLoop, this);
+    }
+
+    /* drain the queue and stop the writer; call once no lane will submit again */
+    void close()
+    {
+        {
+            lock_guard<mutex> g(m);
+            closing = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    void writeLoop()
+    {
+        groceryCartRecord rec;
+        while (true)
+        {
+            if (queue.pop(rec))
+            {
+                write(rec);
+                continue;
+            }
+            /* advertise the sleep before the last look at the queue, so a
+               push that misses the flag is seen here instead */
+            unique_lock<mutex> lk(m);
+            writerWaiting.store(true);
+            while (!queue.ready() && !closing)
+                wake.wait(lk);
+            writerWaiting.store(false);
+            if (!queue.ready())
+                return; // closing and drained
+        }
+    }
+
+    void write(const groceryCartRecord &rec)
+    {
+        for (size_t k = 0; k < rec.lines.size(); ++k)
+        {
+            int idx = rec.lines[k].item_idx;
+            groceryTransaction t;
+            t.txn_id = rec.txn_id;
+            t.datetime = rec.datetime;
+            t.item_id = groceryItems.item_id[idx];
+            t.qty = rec.lines[k].qty;
+            t.unit_price = groceryItems.price[idx];
+            t.line_total = t.qty * t.unit_price;
+            t.cashier_name = rec.cashier;
+            groceryTransactions.push(t);
+            sold[idx] += t.qty;
+        }
+        linesWritten += (long long)rec.lines.size();
+    }
+};
+
+groceryCheckoutEngine groceryCheckout;
+
+/* HASH TABLE (open addressing, linear probing, power-of-two, grows past load factor) */
+vector<int> groceryHashKeys; // 0 = empty (assumes no item has id 0)
+vector<int> groceryHashIdx;  // index in groceryItems or -1
+int groceryHashUsed = 0;
+
+static inline int groceryHashFunc(int key, int mask)
 {
     unsigned int k = (unsigned int)key;
     k ^= (k >> 16);
     k *= 0x7feb352dU;
     k ^= (k >> 15);
-    return (int)(k & (GROCERY_HASH_SIZE - 1));
+    return (int)(k & (unsigned int)mask);
+}
+
+/* place without growing; table must have a free slot */
+static void groceryHashPlace(int key, int idx)
+{
+    int mask = (int)groceryHashIdx.size() - 1;
+    int pos = groceryHashFunc(key, mask);
+    while (groceryHashIdx[pos] != -1 && groceryHashKeys[pos] != key)
+        pos = (pos + 1) & mask;
+    if (groceryHashIdx[pos] == -1)
+        groceryHashUsed++;
+    groceryHashKeys[pos] = key;
+    groceryHashIdx[pos] = idx;
+}
+
+/* size the table for n keys and re-insert the current ones */
+void groceryHashReserve(int n)
+{
+    size_t cap = GROCERY_HASH_MIN_SIZE;
+    while ((size_t)n * 100 >= cap * GROCERY_HASH_MAX_LOAD)
+        cap <<= 1;
+    if (cap <= groceryHashIdx.size())
+        return;
+    vector<int> oldKeys, oldIdx;
+    oldKeys.swap(groceryHashKeys);
+    oldIdx.swap(groceryHashIdx);
+    groceryHashKeys.assign(cap, 0);
+    groceryHashIdx.assign(cap, -1);
+    groceryHashUsed = 0;
+    for (size_t i = 0; i < oldIdx.size(); ++i)
+        if (oldIdx[i] != -1)
+            groceryHashPlace(oldKeys[i], oldIdx[i]);
+}
+
+void groceryInitHash()
+{
+    groceryHashKeys.assign(GROCERY_HASH_MIN_SIZE, 0);
+    groceryHashIdx.assign(GROCERY_HASH_MIN_SIZE, -1);
+    groceryHashUsed = 0;
 }
 
 void groceryHashInsert(int key, int idx)
 {
-    int h = groceryHashFunc(key);
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
-    {
-        int pos = (h + i) & (GROCERY_HASH_SIZE - 1);
-        if (groceryHashIdx[pos] == -1 || groceryHashKeys[pos] == key)
-        {
-            groceryHashKeys[pos] = key;
-            groceryHashIdx[pos] = idx;
-            return;
-        }
-    }
+    if (groceryHashIdx.empty())
+        groceryInitHash();
+    groceryHashReserve(groceryHashUsed + 1);
+    groceryHashPlace(key, idx);
 }
 
 int groceryHashFind(int key)
 {
-    int h = groceryHashFunc(key);
-    for (int i = 0; i < GROCERY_HASH_SIZE; ++i)
+    if (groceryHashIdx.empty())
+        return -1;
+    int mask = (int)groceryHashIdx.size() - 1;
+    int pos = groceryHashFunc(key, mask);
+    while (groceryHashIdx[pos] != -1)
     {
-        int pos = (h + i) & (GROCERY_HASH_SIZE - 1);
-        if (groceryHashIdx[pos] == -1)
-            return -1;
         if (groceryHashKeys[pos] == key)
             return groceryHashIdx[pos];
+        pos = (pos + 1) & mask;
     }
     return -1;
 }
 
-/* QUICK SORT (by stock_qty) - first-element pivot */
-void swapItem(groceryItem &a, groceryItem &b)
+void groceryRebuildHash()
+{
+    groceryInitHash();
+    groceryHashReserve(groceryItems.count());
+    for (int i = 0; i < groceryItems.count(); ++i)
+        groceryHashPlace(groceryItems.item_id[i], i);
+}
+
+/* QUICK SORT (by stock_qty) - first-element pivot, sorts a row-index array */
+void swapIdx(int &a, int &b)
 {
-    groceryItem t = a;
+    int t = a;
     a = b;
     b = t;
 }
 
-int partitionByStock(groceryItem A[], int l, int r)
+int partitionByStock(int A[], const int stock[], int l, int r)
 {
-    int p = A[l].stock_qty;
+    int p = stock[A[l]];
     int i = l, j = r + 1;
     while (1)
     {
-        while (++i <= r && A[i].stock_qty < p)
+        while (++i <= r && stock[A[i]] < p)
         {
         }
-        while (--j >= l && A[j].stock_qty > p)
+        while (--j >= l && stock[A[j]] > p)
         {
         }
         if (i >= j)
             break;
-        swapItem(A[i], A[j]);
+        swapIdx(A[i], A[j]);
     }
-    swapItem(A[l], A[j]);
+    swapIdx(A[l], A[j]);
     return j;
 }
 
-void quickSortByStock(groceryItem A[], int l, int r)
+void quickSortByStock(int A[], const int stock[], int l, int r)
 {
     if (l < r)
     {
-        int s = partitionByStock(A, l, r);
-        quickSortByStock(A, l, s - 1);
-        quickSortByStock(A, s + 1, r);
+        int s = partitionByStock(A, stock, l, r);
+        quickSortByStock(A, stock, l, s - 1);
+        quickSortByStock(A, stock, s + 1, r);
     }
 }
 
-/* NAME SEARCH: use simple substring (string::find) to keep code small and reliable */
-int groceryFindItemByName(const string &pattern)
+void grocerySortItemsByStock()
 {
-    if (pattern.empty())
-        return -1;
-    for (int i = 0; i < groceryItemCount; ++i)
+    int n = groceryItems.count();
+    if (n == 0)
+        return;
+    vector<int> order(n), levels(n);
+    for (int i = 0; i < n; ++i)
     {
-        if (groceryItems[i].name.find(pattern) != string::npos)
-            return i;
+        order[i] = i;
+        levels[i] = groceryCheckout.level(i);
     }
-    return -1;
+    quickSortByStock(&order[0], &levels[0], 0, n - 1);
+    groceryItems.permute(order);
+    groceryCheckout.permute(order);
+    groceryRebuildHash();
+}
+
+/* NAME INDEX
+   Case-folded keys (the full name plus every later word of it) kept in a
+   sorted vector for exact and prefix lookups, and a SymSpell-style deletion
+   dictionary (each key with one character removed) for edit-distance-1
+   matches. Entries hold item ids, so row moves (remove, sort) never stale it. */
+struct groceryNameKey
+{
+    string key;
+    int item_id;
+    bool operator<(const groceryNameKey &o) const
+    {
+        return key < o.key || (key == o.key && item_id < o.item_id);
+    }
+};
+
+vector<groceryNameKey> groceryNameKeys;
+unordered_map<string, vector<int>> groceryNameDeletes;
+
+static string groceryFold(const string &s)
+{
+    string out = s;
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = (char)tolower((unsigned char)out[i]);
+    return out;
+}
+
+/* full folded name, then each word after the first */
+static vector<string> groceryNameKeysOf(const string &name)
+{
+    vector<string> keys;
+    string f = groceryFold(name);
+    if (f.empty())
+        return keys;
+    keys.push_back(f);
+    for (size_t i = 1; i < f.size(); ++i)
+        if (f[i - 1] == ' ' && f[i] != ' ')
+            keys.push_back(f.substr(i));
+    return keys;
+}
+
+static void groceryNameDeletesAdd(const string &key, int id)
+{
+    for (size_t i = 0; i < key.size(); ++i)
+        groceryNameDeletes[key.substr(0, i) + key.substr(i + 1)].push_back(id);
+}
+
+static void groceryNameDeletesRemove(const string &key, int id)
+{
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        unordered_map<string, vector<int>>::iterator e = groceryNameDeletes.find(key.substr(0, i) + key.substr(i + 1));
+        if (e == groceryNameDeletes.end())
+            continue;
+        vector<int> &ids = e->second;
+        for (size_t j = 0; j < ids.size(); ++j)
+            if (ids[j] == id)
+            {
+                ids[j] = ids.back();
+                ids.pop_back();
+                break;
+            }
+        if (ids.empty())
+            groceryNameDeletes.erase(e);
+    }
+}
+
+void groceryNameIndexBuild()
+{
+    groceryNameKeys.clear();
+    groceryNameDeletes.clear();
+    groceryNameKeys.reserve(groceryItems.count() * 2);
+    for (int i = 0; i < groceryItems.count(); ++i)
+    {
+        vector<string> keys = groceryNameKeysOf(groceryItems.name[i]);
+        for (size_t k = 0; k < keys.size(); ++k)
+        {
+            groceryNameKey nk = {keys[k], groceryItems.item_id[i]};
+            groceryNameKeys.push_back(nk);
+            groceryNameDeletesAdd(keys[k], nk.item_id);
+        }
+    }
+    sort(groceryNameKeys.begin(), groceryNameKeys.end());
+}
+
+void groceryNameIndexAdd(int item_id, const string &name)
+{
+    vector<string> keys = groceryNameKeysOf(name);
+    for (size_t k = 0; k < keys.size(); ++k)
+    {
+        groceryNameKey nk = {keys[k], item_id};
+        groceryNameKeys.insert(lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), nk), nk);
+        groceryNameDeletesAdd(keys[k], item_id);
+    }
+}
+
+void groceryNameIndexRemove(int item_id, const string &name)
+{
+    vector<string> keys = groceryNameKeysOf(name);
+    for (size_t k = 0; k < keys.size(); ++k)
+    {
+        groceryNameKey nk = {keys[k], item_id};
+        vector<groceryNameKey>::iterator p = lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), nk);
+        if (p != groceryNameKeys.end() && p->key == nk.key && p->item_id == item_id)
+            groceryNameKeys.erase(p);
+        groceryNameDeletesRemove(keys[k], item_id);
+    }
+}
+
+/* [lo,hi) range of groceryNameKeys whose key starts with the folded prefix */
+static void groceryNamePrefixRange(const string &folded, int &lo, int &hi)
+{
+    groceryNameKey from = {folded, -2147483647 - 1};
+    vector<groceryNameKey>::iterator a = lower_bound(groceryNameKeys.begin(), groceryNameKeys.end(), from);
+    vector<groceryNameKey>::iterator b = a;
+    while (b != groceryNameKeys.end() && b->key.compare(0, folded.size(), folded) == 0)
+        b++;
+    lo = (int)(a - groceryNameKeys.begin());
+    hi = (int)(b - groceryNameKeys.begin());
+}
+
+/* Levenshtein distance <= 1 */
+static bool groceryWithinOneEdit(const string &a, const string &b)
+{
+    size_t n = a.size(), m = b.size();
+    if (n > m + 1 || m > n + 1)
+        return false;
+    size_t i = 0;
+    while (i < n && i < m && a[i] == b[i])
+        i++;
+    if (n == m)
+        return a.compare(i + (i < n), string::npos, b, i + (i < m), string::npos) == 0;
+    if (n > m)
+        return a.compare(i + 1, string::npos, b, i, string::npos) == 0;
+    return a.compare(i, string::npos, b, i + 1, string::npos) == 0;
+}
+
+static void groceryNameCollect(const string &key, const string &q, vector<int> &ids)
+{
+    int lo, hi;
+    groceryNamePrefixRange(key, lo, hi);
+    for (int i = lo; i < hi && groceryNameKeys[i].key == key; ++i)
+        if (groceryWithinOneEdit(groceryNameKeys[i].key, q))
+            ids.push_back(groceryNameKeys[i].item_id);
+    unordered_map<string, vector<int>>::const_iterator e = groceryNameDeletes.find(key);
+    if (e == groceryNameDeletes.end())
+        return;
+    for (size_t j = 0; j < e->second.size(); ++j)
+    {
+        int idx = groceryHashFind(e->second[j]);
+        if (idx == -1)
+            continue;
+        vector<string> keys = groceryNameKeysOf(groceryItems.name[idx]);
+        for (size_t k = 0; k < keys.size(); ++k)
+            if (groceryWithinOneEdit(keys[k], q))
+            {
+                ids.push_back(e->second[j]);
+                break;
+            }
+    }
+}
+
+/* item ids whose name (or a word of it) is within one edit of the query */
+void groceryNameFuzzy(const string &query, vector<int> &ids)
+{
+    ids.clear();
+    string q = groceryFold(query);
+    if (q.empty())
+        return;
+    groceryNameCollect(q, q, ids);
+    for (size_t i = 0; i < q.size(); ++i)
+        groceryNameCollect(q.substr(0, i) + q.substr(i + 1), q, ids);
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+}
+
+/* NAME SEARCH: exact, then prefix, then one-typo match; returns row index */
+int groceryFindItemByName(const string &pattern)
+{
+    string q = groceryFold(pattern);
+    if (q.empty())
+        return -1;
+    int lo, hi;
+    groceryNamePrefixRange(q, lo, hi);
+    if (lo < hi)
+        return groceryHashFind(groceryNameKeys[lo].item_id); // exact key sorts first in its prefix range
+    vector<int> ids;
+    groceryNameFuzzy(q, ids);
+    return ids.empty() ? -1 : groceryHashFind(ids[0]);
 }
 
 /* CSV LOADERS (LOAD ONLY) */
+/* count data rows (header excluded) and rewind, so each loader can reserve once */
+static int groceryCountRows(ifstream &in)
+{
+    int rows = 0;
+    string line;
+    while (getline(in, line))
+        rows++;
+    in.clear();
+    in.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 /* Items CSV columns:
    item_id,name,category,price,stock_qty,reorder_level,supplier_name,perishable,expiry_date
 */
@@ -219,6 +841,10 @@ void groceryLoadItemsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    int rows = groceryCountRows(in);
+    groceryItems.reserve(groceryItems.count() + rows);
+    groceryCheckout.reserve(groceryItems.count() + rows);
+    groceryHashReserve(groceryItems.count() + rows);
     string line;
     getline(in, line); // skip header if present
     int loaded = 0;
@@ -230,12 +856,7 @@ void groceryLoadItemsCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 9);
         if (n < 2)
             continue;
-        if (groceryItemCount >= GROCERY_MAX_ITEMS)
-        {
-            cout << "Items capacity reached\n";
-            break;
-        }
-        groceryItem &it = groceryItems[groceryItemCount];
+        groceryItem it;
         it.item_id = grocery_toInt(cols[0]);
         it.name = cols[1];
         it.category = (n > 2) ? cols[2] : "";
@@ -244,13 +865,17 @@ void groceryLoadItemsCSV(const string &fn)
         it.reorder_level = (n > 5) ? grocery_toInt(cols[5]) : 0;
         it.supplier_name = (n > 6) ? cols[6] : "";
         it.perishable = (n > 7) ? grocery_toInt(cols[7]) : 0;
-        it.expiry_date = (n > 8) ? cols[8] : "";
+        it.expiry_date = (n > 8) ? cityDate(cols[8]) : CITY_NO_DATE;
         if (it.item_id == 0 || it.name.empty())
             continue; // skip invalid
-        groceryHashInsert(it.item_id, groceryItemCount);
-        groceryItemCount++;
+        if (groceryHashFind(it.item_id) != -1)
+            continue; // id already loaded
+        groceryHashInsert(it.item_id, groceryItems.count());
+        groceryItems.push(it);
+        groceryCheckout.addRow(it.stock_qty);
         loaded++;
     }
+    groceryNameIndexBuild();
     cout << "Loaded " << loaded << " items from " << fn << "\n";
     in.close();
 }
@@ -264,6 +889,7 @@ void groceryLoadStaffCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryStaffs.reserve(groceryStaffs.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -275,20 +901,15 @@ void groceryLoadStaffCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 3);
         if (n < 1)
             continue;
-        if (groceryStaffCount >= GROCERY_MAX_STAFF)
-        {
-            cout << "Staff capacity reached\n";
-            break;
-        }
-        groceryStaff &s = groceryStaffs[groceryStaffCount];
-        s.staff_id = groceryStaffCount + 1;
+        groceryStaff s;
+        s.staff_id = groceryStaffs.count() + 1;
         s.name = cols[0];
         s.role = (n > 1) ? cols[1] : "";
         s.salary = (n > 2) ? grocery_toDouble(cols[2]) : 0.0;
         s.is_active = 1;
         if (s.name.empty())
             continue;
-        groceryStaffCount++;
+        groceryStaffs.push(s);
         loaded++;
     }
     cout << "Loaded " << loaded << " staff from " << fn << "\n";
@@ -306,6 +927,7 @@ void groceryLoadTransactionsCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryTransactions.reserve(groceryTransactions.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -317,14 +939,9 @@ void groceryLoadTransactionsCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 7);
         if (n < 2)
             continue;
-        if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-        {
-            cout << "Transactions capacity reached\n";
-            break;
-        }
-        groceryTransaction &t = groceryTransactions[groceryTransactionCount];
+        groceryTransaction t;
         t.txn_id = grocery_toInt(cols[0]);
-        t.datetime = (n > 1) ? cols[1] : "";
+        t.datetime = (n > 1) ? cityDateTime(cols[1]) : CITY_NO_DATE;
         t.item_id = (n > 2) ? grocery_toInt(cols[2]) : 0;
         t.qty = (n > 3) ? grocery_toInt(cols[3]) : 0;
         t.unit_price = (n > 4) ? grocery_toDouble(cols[4]) : 0.0;
@@ -332,16 +949,12 @@ void groceryLoadTransactionsCSV(const string &fn)
         t.cashier_name = (n > 6) ? cols[6] : "";
         if (t.txn_id == 0)
             continue;
-        groceryTransactionCount++;
+        groceryTransactions.push(t);
         loaded++;
         // deduct stock if item exists
         int idx = groceryHashFind(t.item_id);
         if (idx != -1)
-        {
-            groceryItems[idx].stock_qty -= t.qty;
-            if (groceryItems[idx].stock_qty < 0)
-                groceryItems[idx].stock_qty = 0;
-        }
+            groceryCheckout.deduct(idx, t.qty);
     }
     cout << "Loaded " << loaded << " transactions from " << fn << "\n";
     in.close();
@@ -358,6 +971,7 @@ void groceryLoadAttendanceCSV(const string &fn)
         cout << "Cannot open " << fn << "\n";
         return;
     }
+    groceryAttendances.reserve(groceryAttendances.count() + groceryCountRows(in));
     string line;
     getline(in, line);
     int loaded = 0;
@@ -369,21 +983,16 @@ void groceryLoadAttendanceCSV(const string &fn)
         int n = grocery_splitCSV(line, cols, 6);
         if (n < 2)
             continue;
-        if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-        {
-            cout << "Attendance capacity reached\n";
-            break;
-        }
-        groceryAttendance &a = groceryAttendances[groceryAttendanceCount];
+        groceryAttendance a;
         a.attendance_id = grocery_toInt(cols[0]);
         a.staff_id = (n > 1) ? grocery_toInt(cols[1]) : 0;
-        a.date = (n > 2) ? cols[2] : "";
+        a.date = (n > 2) ? cityDate(cols[2]) : CITY_NO_DATE;
         a.clock_in = (n > 3) ? cols[3] : "";
         a.clock_out = (n > 4) ? cols[4] : "";
         a.hours_worked = (n > 5) ? grocery_toDouble(cols[5]) : 0.0;
         if (a.attendance_id == 0)
             continue;
-        groceryAttendanceCount++;
+        groceryAttendances.push(a);
         loaded++;
     }
     cout << "Loaded " << loaded << " attendance rows from " << fn << "\n";
@@ -393,12 +1002,7 @@ void groceryLoadAttendanceCSV(const string &fn)
 /* MANUAL OPERATIONS */
 void groceryAddItemManual()
 {
-    if (groceryItemCount >= GROCERY_MAX_ITEMS)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryItem &it = groceryItems[groceryItemCount];
+    groceryItem it;
     cout << "Enter item_id: ";
     cin >> it.item_id;
     cin.ignore();
@@ -421,14 +1025,23 @@ void groceryAddItemManual()
     cin >> it.perishable;
     cin.ignore();
     cout << "Expiry date (YYYY-MM-DD or empty): ";
-    getline(cin, it.expiry_date);
+    string expiry;
+    getline(cin, expiry);
+    it.expiry_date = cityDate(expiry);
     if (it.item_id == 0 || it.name.empty())
     {
         cout << "Invalid item, not added.\n";
         return;
     }
-    groceryHashInsert(it.item_id, groceryItemCount);
-    groceryItemCount++;
+    if (groceryHashFind(it.item_id) != -1)
+    {
+        cout << "Item id " << it.item_id << " already exists, not added.\n";
+        return;
+    }
+    groceryHashInsert(it.item_id, groceryItems.count());
+    groceryItems.push(it);
+    groceryCheckout.addRow(it.stock_qty);
+    groceryNameIndexAdd(it.item_id, it.name);
     cout << "Item added.\n";
 }
 
@@ -448,8 +1061,8 @@ void groceryRestockItem()
     cin >> add;
     cin.ignore();
     if (add > 0)
-        groceryItems[idx].stock_qty += add;
-    cout << "New stock: " << groceryItems[idx].stock_qty << "\n";
+        groceryCheckout.put(idx, add);
+    cout << "New stock: " << groceryCheckout.level(idx) << "\n";
 }
 
 void groceryRemoveItem()
@@ -464,57 +1077,61 @@ void groceryRemoveItem()
         cout << "Not found.\n";
         return;
     }
-    for (int i = idx + 1; i < groceryItemCount; ++i)
-        groceryItems[i - 1] = groceryItems[i];
-    groceryItemCount--;
-    groceryInitHash();
-    for (int i = 0; i < groceryItemCount; ++i)
-        groceryHashInsert(groceryItems[i].item_id, i);
+    groceryNameIndexRemove(id, groceryItems.name[idx]);
+    groceryItems.erase(idx);
+    groceryCheckout.eraseRow(idx);
+    groceryRebuildHash();
     cout << "Removed.\n";
 }
 
 void groceryListItems()
 {
-    cout << "Items (" << groceryItemCount << "):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-    {
-        groceryItem &it = groceryItems[i];
-        cout << it.item_id << "," << it.name << "," << it.category << "," << it.price << "," << it.stock_qty << "\n";
-    }
+    const groceryItemTable &it = groceryItems;
+    cout << "Items (" << it.count() << "):\n";
+    for (int i = 0; i < it.count(); ++i)
+        cout << it.item_id[i] << "," << it.name[i] << "," << it.category[i] << "," << it.price[i] << "," << groceryCheckout.level(i) << "\n";
 }
 
 void grocerySearchItemInteractive()
 {
-    cout << "Enter substring: ";
+    cout << "Enter name or prefix: ";
     string pat;
     getline(cin, pat);
+    int lo, hi;
+    groceryNamePrefixRange(groceryFold(pat), lo, hi);
+    vector<int> ids;
+    for (int i = lo; i < hi; ++i)
+        ids.push_back(groceryNameKeys[i].item_id);
+    if (ids.empty())
+        groceryNameFuzzy(pat, ids);
+    else
+    {
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    }
     cout << "Matches:\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-        if (groceryItems[i].name.find(pat) != string::npos)
-            cout << groceryItems[i].item_id << "," << groceryItems[i].name << "," << groceryItems[i].stock_qty << "," << groceryItems[i].price << "\n";
+    for (size_t k = 0; k < ids.size(); ++k)
+    {
+        int i = groceryHashFind(ids[k]);
+        if (i != -1)
+            cout << groceryItems.item_id[i] << "," << groceryItems.name[i] << "," << groceryCheckout.level(i) << "," << groceryItems.price[i] << "\n";
+    }
 }
 
 void groceryLowStockReport()
 {
     cout << "Low stock (<= reorder):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
-    {
-        groceryItem &it = groceryItems[i];
-        if (it.stock_qty <= it.reorder_level)
-            cout << it.item_id << "," << it.name << "," << it.stock_qty << "," << it.reorder_level << "\n";
-    }
+    const groceryItemTable &it = groceryItems;
+    for (int i = 0; i < it.count(); ++i)
+        if (groceryCheckout.level(i) <= it.reorder_level[i])
+            cout << it.item_id[i] << "," << it.name[i] << "," << groceryCheckout.level(i) << "," << it.reorder_level[i] << "\n";
 }
 
 /* STAFF */
 void groceryAddStaffManual()
 {
-    if (groceryStaffCount >= GROCERY_MAX_STAFF)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryStaff &s = groceryStaffs[groceryStaffCount];
-    s.staff_id = groceryStaffCount + 1;
+    groceryStaff s;
+    s.staff_id = groceryStaffs.count() + 1;
     cout << "Enter name: ";
     getline(cin, s.name);
     cout << "Enter role: ";
@@ -528,7 +1145,7 @@ void groceryAddStaffManual()
         cout << "Invalid.\n";
         return;
     }
-    groceryStaffCount++;
+    groceryStaffs.push(s);
     cout << "Staff added id=" << s.staff_id << "\n";
 }
 
@@ -538,10 +1155,10 @@ void groceryFireStaff()
     int id;
     cin >> id;
     cin.ignore();
-    for (int i = 0; i < groceryStaffCount; ++i)
-        if (groceryStaffs[i].staff_id == id)
+    for (int i = 0; i < groceryStaffs.count(); ++i)
+        if (groceryStaffs.staff_id[i] == id)
         {
-            groceryStaffs[i].is_active = 0;
+            groceryStaffs.is_active[i] = 0;
             cout << "Marked inactive\n";
             return;
         }
@@ -550,38 +1167,33 @@ void groceryFireStaff()
 
 void groceryListStaff()
 {
-    cout << "Staff (" << groceryStaffCount << "):\n";
-    for (int i = 0; i < groceryStaffCount; ++i)
-    {
-        groceryStaff &s = groceryStaffs[i];
-        cout << s.staff_id << "," << s.name << "," << s.role << "," << s.salary << "," << s.is_active << "\n";
-    }
+    const groceryStaffTable &s = groceryStaffs;
+    cout << "Staff (" << s.count() << "):\n";
+    for (int i = 0; i < s.count(); ++i)
+        cout << s.staff_id[i] << "," << s.name[i] << "," << s.role[i] << "," << s.salary[i] << "," << s.is_active[i] << "\n";
 }
 
 void grocerySalaryReport()
 {
     double tot = 0.0;
-    for (int i = 0; i < groceryStaffCount; ++i)
-        tot += groceryStaffs[i].salary;
+    for (int i = 0; i < groceryStaffs.count(); ++i)
+        tot += groceryStaffs.salary[i];
     cout << "Total payroll = " << tot << "\n";
 }
 
 /* ATTENDANCE */
 void groceryAddAttendanceManual()
 {
-    if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryAttendance &a = groceryAttendances[groceryAttendanceCount];
+    groceryAttendance a;
     cout << "Enter attendance_id: ";
     cin >> a.attendance_id;
     cout << "Enter staff_id: ";
     cin >> a.staff_id;
     cin.ignore();
     cout << "Date (YYYY-MM-DD): ";
-    getline(cin, a.date);
+    string date;
+    getline(cin, date);
+    a.date = cityDate(date);
     cout << "Clock in (HH:MM): ";
     getline(cin, a.clock_in);
     cout << "Clock out (HH:MM or empty): ";
@@ -596,28 +1208,26 @@ void groceryAddAttendanceManual()
         double hrs = (h2 + m2 / 60.0) - (h1 + m1 / 60.0);
         a.hours_worked = hrs < 0 ? 0.0 : hrs;
     }
-    groceryAttendanceCount++;
+    groceryAttendances.push(a);
     cout << "Attendance added.\n";
 }
 
 void groceryClockIn()
 {
-    if (groceryAttendanceCount >= GROCERY_MAX_ATTENDANCE)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryAttendance &a = groceryAttendances[groceryAttendanceCount++];
-    a.attendance_id = groceryAttendanceCount;
+    groceryAttendance a;
+    a.attendance_id = groceryAttendances.count() + 1;
     cout << "Staff_id: ";
     cin >> a.staff_id;
     cin.ignore();
     cout << "Date: ";
-    getline(cin, a.date);
+    string date;
+    getline(cin, date);
+    a.date = cityDate(date);
     cout << "Clock in: ";
     getline(cin, a.clock_in);
     a.clock_out = "";
     a.hours_worked = 0.0;
+    groceryAttendances.push(a);
     cout << "Clock-in recorded.\n";
 }
 
@@ -628,23 +1238,24 @@ void groceryClockOut()
     cin >> sid;
     cin.ignore();
     cout << "Date: ";
-    string date;
-    getline(cin, date);
+    string dateText;
+    getline(cin, dateText);
+    CityDate date = cityDate(dateText);
     cout << "Clock out (HH:MM): ";
     string co;
     getline(cin, co);
-    for (int i = groceryAttendanceCount - 1; i >= 0; --i)
+    groceryAttendanceTable &a = groceryAttendances;
+    for (int i = a.count() - 1; i >= 0; --i)
     {
-        groceryAttendance &a = groceryAttendances[i];
-        if (a.staff_id == sid && a.date == date && a.clock_out.empty())
+        if (a.staff_id[i] == sid && a.date[i] == date && a.clock_out[i].empty())
         {
-            a.clock_out = co;
+            a.clock_out[i] = co;
             int h1 = 0, m1 = 0, h2 = 0, m2 = 0;
-            sscanf(a.clock_in.c_str(), "%d:%d", &h1, &m1);
+            sscanf(a.clock_in[i].c_str(), "%d:%d", &h1, &m1);
             sscanf(co.c_str(), "%d:%d", &h2, &m2);
             double hrs = (h2 + m2 / 60.0) - (h1 + m1 / 60.0);
-            a.hours_worked = hrs < 0 ? 0.0 : hrs;
-            cout << "Clock-out recorded. Hours = " << a.hours_worked << "\n";
+            a.hours_worked[i] = hrs < 0 ? 0.0 : hrs;
+            cout << "Clock-out recorded. Hours = " << a.hours_worked[i] << "\n";
             return;
         }
     }
@@ -653,28 +1264,23 @@ void groceryClockOut()
 
 void groceryViewAttendance()
 {
-    cout << "Attendance (" << groceryAttendanceCount << "):\n";
-    for (int i = 0; i < groceryAttendanceCount; ++i)
-    {
-        groceryAttendance &a = groceryAttendances[i];
-        cout << a.attendance_id << "," << a.staff_id << "," << a.date << "," << a.clock_in << "," << a.clock_out << "," << a.hours_worked << "\n";
-    }
+    const groceryAttendanceTable &a = groceryAttendances;
+    cout << "Attendance (" << a.count() << "):\n";
+    for (int i = 0; i < a.count(); ++i)
+        cout << a.attendance_id[i] << "," << a.staff_id[i] << "," << cityFormatDate(a.date[i]) << "," << a.clock_in[i] << "," << a.clock_out[i] << "," << a.hours_worked[i] << "\n";
 }
 
 /* TRANSACTIONS / POS (cart-mode) */
 void groceryAddTransactionManual()
 {
-    if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-    {
-        cout << "Overflow\n";
-        return;
-    }
-    groceryTransaction &t = groceryTransactions[groceryTransactionCount];
+    groceryTransaction t;
     cout << "txn_id: ";
     cin >> t.txn_id;
     cin.ignore();
-    cout << "datetime: ";
-    getline(cin, t.datetime);
+    cout << "datetime (YYYY-MM-DD HH:MM): ";
+    string datetime;
+    getline(cin, datetime);
+    t.datetime = cityDateTime(datetime);
     cout << "item_id: ";
     cin >> t.item_id;
     cin.ignore();
@@ -687,14 +1293,10 @@ void groceryAddTransactionManual()
     t.line_total = t.qty * t.unit_price;
     cout << "cashier_name: ";
     getline(cin, t.cashier_name);
-    groceryTransactionCount++;
+    groceryTransactions.push(t);
     int idx = groceryHashFind(t.item_id);
     if (idx != -1)
-    {
-        groceryItems[idx].stock_qty -= t.qty;
-        if (groceryItems[idx].stock_qty < 0)
-            groceryItems[idx].stock_qty = 0;
-    }
+        groceryCheckout.deduct(idx, t.qty);
     cout << "Transaction added.\n";
 }
 
@@ -704,9 +1306,10 @@ void groceryStartSale()
     int txn_base;
     cin >> txn_base;
     cin.ignore();
-    cout << "datetime: ";
-    string datetime;
-    getline(cin, datetime);
+    cout << "datetime (YYYY-MM-DD HH:MM): ";
+    string datetimeText;
+    getline(cin, datetimeText);
+    CityDateTime datetime = cityDateTime(datetimeText);
     cout << "cashier: ";
     string cashier;
     getline(cin, cashier);
@@ -719,14 +1322,15 @@ void groceryStartSale()
         cout << "No items.\n";
         return;
     }
+    /* the cart is built here and committed whole through the checkout engine,
+       the same path the lanes use */
+    groceryCartRecord cart;
+    cart.txn_id = txn_base;
+    cart.datetime = datetime;
+    cart.cashier = cashier;
     double sale_total = 0.0;
     for (int i = 0; i < n; ++i)
     {
-        if (groceryTransactionCount >= GROCERY_MAX_TRANSACTIONS)
-        {
-            cout << "Transactions full\n";
-            break;
-        }
         cout << "Item " << (i + 1) << " id OR name: ";
         string ident;
         getline(cin, ident);
@@ -736,8 +1340,8 @@ void groceryStartSale()
             cout << "Not found. Skip.\n";
             continue;
         }
-        groceryItem &it = groceryItems[idx];
-        cout << "Found: " << it.item_id << "," << it.name << "," << it.price << ", stock=" << it.stock_qty << "\n";
+        groceryItemTable &it = groceryItems;
+        cout << "Found: " << it.item_id[idx] << "," << it.name[idx] << "," << it.price[idx] << ", stock=" << groceryCheckout.level(idx) << "\n";
         cout << "qty: ";
         int q;
         cin >> q;
@@ -747,30 +1351,42 @@ void groceryStartSale()
             cout << "Skip.\n";
             continue;
         }
-        if (it.stock_qty < q)
+        int avail = groceryCheckout.level(idx);
+        for (size_t k = 0; k < cart.lines.size(); ++k)
+            if (cart.lines[k].item_idx == idx)
+                avail -= cart.lines[k].qty;
+        if (avail < q)
         {
-            cout << "Insufficient stock avail=" << it.stock_qty << ". Proceed? (1=yes): ";
+            if (avail <= 0)
+            {
+                cout << "Out of stock. Skip.\n";
+                continue;
+            }
+            cout << "Insufficient stock avail=" << avail << ". Sell " << avail << " instead? (1=yes): ";
             int p;
             cin >> p;
             cin.ignore();
             if (!p)
                 continue;
+            q = avail;
         }
-        groceryTransaction gt;
-        gt.txn_id = txn_base;
-        gt.datetime = datetime;
-        gt.item_id = it.item_id;
-        gt.qty = q;
-        gt.unit_price = it.price;
-        gt.line_total = q * it.price;
-        gt.cashier_name = cashier;
-        if (groceryTransactionCount < GROCERY_MAX_TRANSACTIONS)
-            groceryTransactions[groceryTransactionCount++] = gt;
-        it.stock_qty -= q;
-        if (it.stock_qty < 0)
-            it.stock_qty = 0;
-        sale_total += gt.line_total;
-        cout << "Added: " << gt.item_id << "," << gt.qty << "," << gt.line_total << "\n";
+        groceryCartLine ln;
+        ln.item_idx = idx;
+        ln.qty = q;
+        cart.lines.push_back(ln);
+        sale_total += q * it.price[idx];
+        cout << "Added: " << it.item_id[idx] << "," << q << "," << q * it.price[idx] << "\n";
+    }
+    if (!cart.lines.empty())
+    {
+        if (!groceryCheckout.commit(cart.lines))
+        {
+            cout << "Stock changed during the sale; nothing sold.\n";
+            return;
+        }
+        groceryCheckout.open();
+        groceryCheckout.submit(std::move(cart));
+        groceryCheckout.close();
     }
     cout << "Sale complete. Total=" << sale_total << "\n";
 }
@@ -810,9 +1426,9 @@ void grocerySimulateQueue()
             {
                 int tid = q[front++ % GROCERY_MAX_QUEUE];
                 cout << "Processing " << tid << "\n";
-                for (int i = 0; i < groceryTransactionCount; ++i)
-                    if (groceryTransactions[i].txn_id == tid)
-                        cout << "Line: " << groceryTransactions[i].item_id << "," << groceryTransactions[i].qty << "," << groceryTransactions[i].line_total << "\n";
+                for (int i = 0; i < groceryTransactions.count(); ++i)
+                    if (groceryTransactions.txn_id[i] == tid)
+                        cout << "Line: " << groceryTransactions.item_id[i] << "," << groceryTransactions.qty[i] << "," << groceryTransactions.line_total[i] << "\n";
             }
         }
         else if (c == 3)
@@ -827,65 +1443,167 @@ void grocerySimulateQueue()
     }
 }
 
-void groceryViewTransactions()
+/* drive nLanes threads through groceryCheckout, each committing cartsPerLane random carts of up to maxLines lines */
+void groceryCheckoutLoadTest(int nLanes, int cartsPerLane, int maxLines)
 {
-    cout << "Transactions (" << groceryTransactionCount << "):\n";
-    for (int i = 0; i < groceryTransactionCount; ++i)
+    int nItems = groceryItems.count();
+    if (nItems == 0 || nLanes <= 0 || cartsPerLane <= 0 || maxLines <= 0)
+    {
+        cout << "Nothing to run (load items first).\n";
+        return;
+    }
+    if (nLanes > GROCERY_MAX_LANES || maxLines > GROCERY_MAX_CART_LINES)
+    {
+        cout << "At most " << GROCERY_MAX_LANES << " lanes and " << GROCERY_MAX_CART_LINES << " lines per cart.\n";
+        return;
+    }
+    vector<long long> before(nItems);
+    for (int i = 0; i < nItems; ++i)
+        before[i] = groceryCheckout.level(i);
+
+    int txnBase = 0;
+    for (int i = 0; i < groceryTransactions.count(); ++i)
+        if (groceryTransactions.txn_id[i] > txnBase)
+            txnBase = groceryTransactions.txn_id[i];
+    atomic<int> nextTxn(txnBase + 1);
+    atomic<long long> committed(0), rejected(0);
+    CityDateTime datetime = cityNow();
+    double expectLines = (double)nLanes * cartsPerLane * (maxLines + 1) / 2;
+    groceryTransactions.reserve(groceryTransactions.count() + (size_t)min(expectLines, (double)GROCERY_LOG_RESERVE_MAX));
+
+    groceryCheckout.open();
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> lanes;
+    for (int l = 0; l < nLanes; ++l)
+    {
+        lanes.push_back(thread([&, l]() {
+            string cashier = "Lane " + to_string(l + 1);
+            unsigned int rng = 2463534242u ^ (unsigned int)(l * 2654435761u);
+            for (int c = 0; c < cartsPerLane; ++c)
+            {
+                groceryCartRecord rec;
+                rec.datetime = datetime;
+                rec.cashier = cashier;
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                int n = 1 + (int)(rng % (unsigned int)maxLines);
+                for (int k = 0; k < n; ++k)
+                {
+                    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                    groceryCartLine ln;
+                    ln.item_idx = (int)(rng % (unsigned int)nItems);
+                    ln.qty = 1 + (int)((rng >> 16) % 3u);
+                    rec.lines.push_back(ln);
+                }
+                if (!groceryCheckout.commit(rec.lines))
+                {
+                    rejected.fetch_add(1, memory_order_relaxed);
+                    continue;
+                }
+                rec.txn_id = nextTxn.fetch_add(1, memory_order_relaxed);
+                committed.fetch_add(1, memory_order_relaxed);
+                groceryCheckout.submit(std::move(rec));
+            }
+        }));
+    }
+    for (size_t l = 0; l < lanes.size(); ++l)
+        lanes[l].join();
+    groceryCheckout.close();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    /* oversell check: no counter below zero, and every unit taken was written to the log */
+    long long violations = 0;
+    for (int i = 0; i < nItems; ++i)
     {
-        groceryTransaction &t = groceryTransactions[i];
-        cout << t.txn_id << "," << t.datetime << "," << t.item_id << "," << t.qty << "," << t.unit_price << "," << t.line_total << "," << t.cashier_name << "\n";
+        int after = groceryCheckout.level(i);
+        if (after < 0 || before[i] - groceryCheckout.sold[i] != after)
+            violations++;
     }
+
+    cout << "Lanes=" << nLanes << " committed=" << committed.load() << " rejected(out of stock)=" << rejected.load()
+         << " lines=" << groceryCheckout.linesWritten << "\n";
+    cout << "Elapsed " << secs << "s, " << (secs > 0 ? committed.load() / secs : 0.0) << " sales/sec\n";
+    cout << "Oversell violations: " << violations << "\n";
+}
+
+void groceryViewTransactions()
+{
+    const groceryTransactionTable &t = groceryTransactions;
+    cout << "Transactions (" << t.count() << "):\n";
+    for (int i = 0; i < t.count(); ++i)
+        cout << t.txn_id[i] << "," << cityFormatDateTime(t.datetime[i]) << "," << t.item_id[i] << "," << t.qty[i] << "," << t.unit_price[i] << "," << t.line_total[i] << "," << t.cashier_name[i] << "\n";
 }
 
 void groceryItemSalesReport()
 {
     cout << "Item sales (id,name,total_qty,total_revenue):\n";
-    for (int i = 0; i < groceryItemCount; ++i)
+    /* one pass over transactions, bucketed by item row through the id hash */
+    vector<int> totq(groceryItems.count(), 0);
+    vector<double> totr(groceryItems.count(), 0.0);
+    const groceryTransactionTable &t = groceryTransactions;
+    for (int j = 0; j < t.count(); ++j)
     {
-        int id = groceryItems[i].item_id;
-        int totq = 0;
-        double totr = 0.0;
-        for (int j = 0; j < groceryTransactionCount; ++j)
-            if (groceryTransactions[j].item_id == id)
-            {
-                totq += groceryTransactions[j].qty;
-                totr += groceryTransactions[j].line_total;
-            }
-        if (totq > 0)
-            cout << id << "," << groceryItems[i].name << "," << totq << "," << totr << "\n";
+        int idx = groceryHashFind(t.item_id[j]);
+        if (idx == -1)
+            continue;
+        totq[idx] += t.qty[j];
+        totr[idx] += t.line_total[j];
     }
+    for (int i = 0; i < groceryItems.count(); ++i)
+        if (totq[i] > 0)
+            cout << groceryItems.item_id[i] << "," << groceryItems.name[i] << "," << totq[i] << "," << totr[i] << "\n";
 }
 
-void groceryDailySales(const string &datePrefix)
+/* revenue of transactions in [from,to) minutes; plain integer compares so the loop vectorises */
+static double grocerySalesBetween(CityDateTime from, CityDateTime to)
 {
+    const CityDateTime *dt = groceryTransactions.datetime.data();
+    const double *amt = groceryTransactions.line_total.data();
+    int n = groceryTransactions.count();
     double total = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
-        if (groceryTransactions[i].datetime.rfind(datePrefix, 0) == 0)
-            total += groceryTransactions[i].line_total;
-    cout << "Sales " << datePrefix << " = " << total << "\n";
+    for (int i = 0; i < n; ++i)
+        total += (dt[i] >= from && dt[i] < to) ? amt[i] : 0.0;
+    return total;
+}
+
+/* "YYYY", "YYYY-MM" or "YYYY-MM-DD" -> minute range; false if not a date prefix */
+static bool groceryPrefixMinutes(const string &prefix, CityDateTime &from, CityDateTime &to)
+{
+    CityDate lo, hi;
+    return cityPrefixRange(prefix, lo, hi) && cityDayMinutes(lo, from) && cityDayMinutes(hi, to);
+}
+
+void groceryDailySales(const string &datePrefix)
+{
+    CityDateTime from, to;
+    if (!groceryPrefixMinutes(datePrefix, from, to))
+    {
+        cout << "Invalid date.\n";
+        return;
+    }
+    cout << "Sales " << datePrefix << " = " << grocerySalesBetween(from, to) << "\n";
 }
 
 void groceryMonthlySales(const string &monthPrefix)
 {
-    double total = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
-        if (groceryTransactions[i].datetime.rfind(monthPrefix, 0) == 0)
-            total += groceryTransactions[i].line_total;
-    cout << "Monthly " << monthPrefix << " = " << total << "\n";
+    CityDateTime from, to;
+    if (!groceryPrefixMinutes(monthPrefix, from, to))
+    {
+        cout << "Invalid month.\n";
+        return;
+    }
+    cout << "Monthly " << monthPrefix << " = " << grocerySalesBetween(from, to) << "\n";
 }
 
 void groceryProfitReport(const string &datePrefix)
 {
-    double revenue = 0.0, cogs = 0.0;
-    for (int i = 0; i < groceryTransactionCount; ++i)
+    CityDateTime from = INT32_MIN, to = INT32_MAX;
+    if (!datePrefix.empty() && !groceryPrefixMinutes(datePrefix, from, to))
     {
-        groceryTransaction &t = groceryTransactions[i];
-        if (datePrefix.empty() || t.datetime.rfind(datePrefix, 0) == 0)
-        {
-            revenue += t.line_total;
-            cogs += t.line_total * 0.7;
-        }
+        cout << "Invalid date prefix.\n";
+        return;
     }
+    double revenue = grocerySalesBetween(from, to);
+    double cogs = revenue * 0.7;
     cout << "Profit (" << (datePrefix.empty() ? "ALL" : datePrefix) << ") rev=" << revenue << " cogs=" << cogs << " profit=" << revenue - cogs << "\n";
 }
 
@@ -901,8 +1619,8 @@ void groceryLoadAllCSVsFromFolder()
 /* MAIN MENU */
 void grocerySystem()
 {
-    groceryInitHash();
-
+    /* the item hash is built by the first insert and kept in step with the
+       rows after that, so re-entering the menu must not reset it */
     while (true)
     {
         cout << "\n--- Grocery Store Menu ---\n";
@@ -957,8 +1675,7 @@ void grocerySystem()
                 groceryLowStockReport();
                 break;
             case 8:
-                if (groceryItemCount > 0)
-                    quickSortByStock(groceryItems, 0, groceryItemCount - 1);
+                grocerySortItemsByStock();
                 cout << "Sorted by stock.\n";
                 break;
             default:
@@ -971,7 +1688,7 @@ void grocerySystem()
         case 2:
         {
             cout << "1:LoadTransactionsCSV 2:AddTransactionManual 3:StartSale "
-                    "4:SimulateQueue 5:ViewTransactions 6:ItemSalesReport\nChoice: ";
+                    "4:SimulateQueue 5:ViewTransactions 6:ItemSalesReport 7:LaneLoadTest\nChoice: ";
             int s;
             cin >> s;
             cin.ignore();
@@ -998,6 +1715,19 @@ void grocerySystem()
             case 6:
                 groceryItemSalesReport();
                 break;
+            case 7:
+            {
+                int lanes, carts, lines;
+                cout << "Lanes: ";
+                cin >> lanes;
+                cout << "Carts per lane: ";
+                cin >> carts;
+                cout << "Max lines per cart: ";
+                cin >> lines;
+                cin.ignore();
+                groceryCheckoutLoadTest(lanes, carts, lines);
+                break;
+            }
             default:
                 cout << "Invalid\n";
             }
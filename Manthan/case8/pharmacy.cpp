@@ -9,6 +9,8 @@
 #include <cstring>
 #include <cstdlib>
 #include <ctime>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 // ---------- LIMITS ----------
@@ -43,14 +45,15 @@ struct PharmacySale
     char date[15];
 };
 
-// ---------- GLOBAL STORAGE ----------
-PharmacyMedicine pharmacyMeds[PHARMACY_MAX_MEDICINES];
-PharmacySupplier pharmacySuppliers[PHARMACY_MAX_SUPPLIERS];
-PharmacySale pharmacySales[PHARMACY_MAX_SALES];
-
-int pharmacyMedCount = 0;
-int pharmacySupplierCount = 0;
-int pharmacySaleCount = 0;
+// ---------- MODULE CONTEXT ----------
+// Created by pharmacyInitModule(); PHARMACY_MAX_* cap the row counts.
+struct PharmacyContext
+{
+    vector<PharmacyMedicine> meds;
+    vector<PharmacySupplier> suppliers;
+    vector<PharmacySale> sales;
+};
+static PharmacyContext *pharmacyCtx = NULL;
 
 // ---------- CSV SPLIT ----------
 int pharmacySplitCSV(const string &line, string out[], int maxCols)
@@ -63,6 +66,18 @@ int pharmacySplitCSV(const string &line, string out[], int maxCols)
     return count;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int pharmacyCountRows(ifstream &fin)
+{
+    int rows = 0;
+    string line;
+    while (getline(fin, line))
+        rows++;
+    fin.clear();
+    fin.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------- LOAD CSV ----------
 void pharmacyLoadMedicinesCSV(const string &file)
 {
@@ -73,33 +88,35 @@ void pharmacyLoadMedicinesCSV(const string &file)
         return;
     }
 
+    pharmacyCtx->meds.reserve(pharmacyCtx->meds.size() + min(pharmacyCountRows(fin), PHARMACY_MAX_MEDICINES));
     string line, col[6];
     getline(fin, line);
     while (getline(fin, line))
     {
-        if (pharmacyMedCount >= PHARMACY_MAX_MEDICINES)
+        if (pharmacyCtx->meds.size() >= PHARMACY_MAX_MEDICINES)
             break;
         int n = pharmacySplitCSV(line, col, 6);
         if (n < 6)
             continue;
 
-        PharmacyMedicine &m = pharmacyMeds[pharmacyMedCount++];
+        PharmacyMedicine m = {};
         m.id = stoi(col[0]);
         strncpy(m.name, col[1].c_str(), 49);
         strncpy(m.category, col[2].c_str(), 29);
         m.stock = stoi(col[3]);
         m.price = stod(col[4]);
         strncpy(m.expiry, col[5].c_str(), 14);
+        pharmacyCtx->meds.push_back(m);
     }
     fin.close();
-    cout << "Loaded Medicines: " << pharmacyMedCount << "\n";
+    cout << "Loaded Medicines: " << pharmacyCtx->meds.size() << "\n";
 }
 
 // ---------- UTIL ----------
 int pharmacyFindMedicine(int id)
 {
-    for (int i = 0; i < pharmacyMedCount; i++)
-        if (pharmacyMeds[i].id == id)
+    for (int i = 0; i < (int)pharmacyCtx->meds.size(); i++)
+        if (pharmacyCtx->meds[i].id == id)
             return i;
     return -1;
 }
@@ -107,13 +124,13 @@ int pharmacyFindMedicine(int id)
 // ---------- MANUAL ADD MEDICINE ----------
 void pharmacyAddMedicineManual()
 {
-    if (pharmacyMedCount >= PHARMACY_MAX_MEDICINES)
+    if (pharmacyCtx->meds.size() >= PHARMACY_MAX_MEDICINES)
     {
         cout << "Medicine storage full\n";
         return;
     }
 
-    PharmacyMedicine &m = pharmacyMeds[pharmacyMedCount++];
+    PharmacyMedicine m = {};
 
     cout << "Medicine ID: ";
     cin >> m.id;
@@ -134,6 +151,7 @@ void pharmacyAddMedicineManual()
     cout << "Expiry (MM/YYYY): ";
     cin >> m.expiry;
 
+    pharmacyCtx->meds.push_back(m);
     cout << "Medicine added successfully\n";
 }
 
@@ -141,9 +159,9 @@ void pharmacyAddMedicineManual()
 void pharmacyListMedicines()
 {
     cout << "\nID   Name            Stock   Price\n";
-    for (int i = 0; i < pharmacyMedCount; i++)
+    for (size_t i = 0; i < pharmacyCtx->meds.size(); i++)
     {
-        PharmacyMedicine &m = pharmacyMeds[i];
+        PharmacyMedicine &m = pharmacyCtx->meds[i];
         cout << m.id << "  " << m.name
              << "  " << m.stock
              << "  " << m.price << "\n";
@@ -167,28 +185,36 @@ void pharmacyManualSale()
     cout << "Quantity to sell: ";
     cin >> qty;
 
-    PharmacyMedicine &m = pharmacyMeds[idx];
+    PharmacyMedicine &m = pharmacyCtx->meds[idx];
     if (qty <= 0 || qty > m.stock)
     {
         cout << "Invalid quantity / insufficient stock\n";
         return;
     }
 
+    if (pharmacyCtx->sales.size() >= PHARMACY_MAX_SALES)
+    {
+        cout << "Sales log full\n";
+        return;
+    }
+
     m.stock -= qty;
 
-    PharmacySale &s = pharmacySales[pharmacySaleCount++];
-    s.saleID = pharmacySaleCount;
+    PharmacySale s = {};
+    s.saleID = pharmacyCtx->sales.size() + 1;
     s.medID = id;
     s.qty = qty;
     s.total = qty * m.price;
     strcpy(s.date, "2025");
+    pharmacyCtx->sales.push_back(s);
 
     cout << "Sale completed | Bill: " << s.total << "\n";
 }
 
 // ---------- AUTO SIMULATE SALES ----------
 void pharmacyAutoSimulateSales() {
-    if (pharmacyMedCount == 0) {
+    int medCount = pharmacyCtx->meds.size();
+    if (medCount == 0) {
         cout << "No medicines available\n";
         return;
     }
@@ -203,15 +229,19 @@ void pharmacyAutoSimulateSales() {
 
     int completed = 0;
 
-    for (int i = 0; i < customers && pharmacySaleCount < PHARMACY_MAX_SALES; i++) {
+    for (int i = 0; i < customers; i++) {
+        if (pharmacyCtx->sales.size() >= PHARMACY_MAX_SALES) {
+            cout << "Sales log full\n";
+            break;
+        }
 
         // Try limited attempts to find in-stock medicine
         int attempts = 0;
         int idx = -1;
 
-        while (attempts < pharmacyMedCount) {
-            int r = rand() % pharmacyMedCount;
-            if (pharmacyMeds[r].stock > 0) {
+        while (attempts < medCount) {
+            int r = rand() % medCount;
+            if (pharmacyCtx->meds[r].stock > 0) {
                 idx = r;
                 break;
             }
@@ -223,19 +253,20 @@ void pharmacyAutoSimulateSales() {
             break;
         }
 
-        PharmacyMedicine &m = pharmacyMeds[idx];
+        PharmacyMedicine &m = pharmacyCtx->meds[idx];
 
         int qty = (rand() % 5) + 1;  // 1–5 units
         if (qty > m.stock) qty = m.stock;
 
         m.stock -= qty;
 
-        PharmacySale &s = pharmacySales[pharmacySaleCount++];
-        s.saleID = pharmacySaleCount;
+        PharmacySale s = {};
+        s.saleID = pharmacyCtx->sales.size() + 1;
         s.medID = m.id;
         s.qty = qty;
         s.total = qty * m.price;
         strcpy(s.date, "2025");
+        pharmacyCtx->sales.push_back(s);
 
         cout << "Customer " << (i + 1)
              << " bought " << qty
@@ -256,10 +287,10 @@ void pharmacyAutoSimulateSales() {
 void pharmacyLowStockReport()
 {
     cout << "\n--- LOW STOCK (<10) ---\n";
-    for (int i = 0; i < pharmacyMedCount; i++)
-        if (pharmacyMeds[i].stock < 10)
-            cout << pharmacyMeds[i].name
-                 << " | Stock: " << pharmacyMeds[i].stock << "\n";
+    for (size_t i = 0; i < pharmacyCtx->meds.size(); i++)
+        if (pharmacyCtx->meds[i].stock < 10)
+            cout << pharmacyCtx->meds[i].name
+                 << " | Stock: " << pharmacyCtx->meds[i].stock << "\n";
 }
 void pharmacyLoadSuppliersCSV(const string &file)
 {
@@ -270,34 +301,36 @@ void pharmacyLoadSuppliersCSV(const string &file)
         return;
     }
 
+    pharmacyCtx->suppliers.reserve(pharmacyCtx->suppliers.size() + min(pharmacyCountRows(fin), PHARMACY_MAX_SUPPLIERS));
     string line, col[3];
     getline(fin, line); // header
 
     while (getline(fin, line))
     {
-        if (pharmacySupplierCount >= PHARMACY_MAX_SUPPLIERS)
+        if (pharmacyCtx->suppliers.size() >= PHARMACY_MAX_SUPPLIERS)
             break;
         int n = pharmacySplitCSV(line, col, 3);
         if (n < 3)
             continue;
 
-        PharmacySupplier &s = pharmacySuppliers[pharmacySupplierCount++];
+        PharmacySupplier s = {};
         s.id = stoi(col[0]);
         strncpy(s.name, col[1].c_str(), 49);
         strncpy(s.contact, col[2].c_str(), 29);
+        pharmacyCtx->suppliers.push_back(s);
     }
     fin.close();
 
-    cout << "Loaded Suppliers: " << pharmacySupplierCount << "\n";
+    cout << "Loaded Suppliers: " << pharmacyCtx->suppliers.size() << "\n";
 }
 void pharmacyListSuppliers()
 {
     cout << "\nID   Supplier Name        Contact\n";
-    for (int i = 0; i < pharmacySupplierCount; i++)
+    for (size_t i = 0; i < pharmacyCtx->suppliers.size(); i++)
     {
-        cout << pharmacySuppliers[i].id << "   "
-             << pharmacySuppliers[i].name << "   "
-             << pharmacySuppliers[i].contact << "\n";
+        cout << pharmacyCtx->suppliers[i].id << "   "
+             << pharmacyCtx->suppliers[i].name << "   "
+             << pharmacyCtx->suppliers[i].contact << "\n";
     }
 }
 
@@ -309,8 +342,16 @@ void pharmacyLoadAll()
 }
 
 // ---------- MENU ----------
+void pharmacyInitModule()
+{
+    if (pharmacyCtx)
+        return; // state is kept across visits to the menu
+    pharmacyCtx = new PharmacyContext();
+}
+
 void pharmacySystem()
 {
+    pharmacyInitModule();
     int ch, n;
     while (1)
     {
@@ -3,6 +3,8 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 // ---------------- CONFIG ----------------
@@ -42,11 +44,16 @@ struct FPOrderItem {
     int qty;
 };
 
-// ---------------- GLOBAL STORAGE ----------------
-FPVendor vendors[FP_MAX_VENDORS]; int vendorCount = 0;
-FPItem items[FP_MAX_ITEMS]; int itemCount = 0;
-FPOrder orders[FP_MAX_ORDERS]; int orderCount = 0;
-FPOrderItem orderItems[FP_MAX_ORDERITEMS]; int orderItemCount = 0;
+// ---------------- MODULE CONTEXT ----------------
+// Created by foodPharmaInitModule(); FP_MAX_* cap the row counts.
+struct FPContext {
+    vector<FPVendor> vendors;
+    vector<FPItem> items;
+    vector<FPOrder> orders;
+    vector<FPOrderItem> orderItems;
+};
+FPContext *fpCtx = NULL;
+
 int foodPharmaDijkstra(int src, int dest);
 
 
@@ -62,6 +69,16 @@ int foodPharmaSplitCSV(const string &line, string out[], int max) {
     return i;
 }
 
+// Data rows in a CSV (header excluded); rewinds the stream.
+int foodPharmaCountRows(ifstream &fin) {
+    int rows = 0;
+    string line;
+    while (getline(fin, line)) rows++;
+    fin.clear();
+    fin.seekg(0);
+    return rows > 0 ? rows - 1 : 0;
+}
+
 // ---------------- GRAPH LOADER ----------------
 bool foodPharmaLoadGraph(const string &file) {
     ifstream fin(file);
@@ -86,19 +103,20 @@ bool foodPharmaLoadOrders(const string &file) {
     if (!fin) return false;
 
     string line, c[6];
-    orderCount = 0;
+    fpCtx->orders.clear();
+    fpCtx->orders.reserve(min(foodPharmaCountRows(fin), FP_MAX_ORDERS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->orders.size() < FP_MAX_ORDERS) {
         foodPharmaSplitCSV(line, c, 6);
-        orders[orderCount].id = stoi(c[0]);
-        strncpy(orders[orderCount].customer, c[1].c_str(), 49);
-        strncpy(orders[orderCount].address, c[2].c_str(), 99);
-        orders[orderCount].locationNode = stoi(c[3]);
-        strncpy(orders[orderCount].status, c[4].c_str(), 19);
-        orders[orderCount].distance =
-            foodPharmaDijkstra(0, orders[orderCount].locationNode);
-        orderCount++;
+        FPOrder o = {};
+        o.id = stoi(c[0]);
+        strncpy(o.customer, c[1].c_str(), 49);
+        strncpy(o.address, c[2].c_str(), 99);
+        o.locationNode = stoi(c[3]);
+        strncpy(o.status, c[4].c_str(), 19);
+        o.distance = foodPharmaDijkstra(0, o.locationNode);
+        fpCtx->orders.push_back(o);
     }
     return true;
 }
@@ -107,15 +125,17 @@ bool foodPharmaLoadOrderItems(const string &file) {
     if (!fin) return false;
 
     string line, c[4];
-    orderItemCount = 0;
+    fpCtx->orderItems.clear();
+    fpCtx->orderItems.reserve(min(foodPharmaCountRows(fin), FP_MAX_ORDERITEMS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->orderItems.size() < FP_MAX_ORDERITEMS) {
         foodPharmaSplitCSV(line, c, 4);
-        orderItems[orderItemCount].orderId = stoi(c[0]);
-        orderItems[orderItemCount].itemId = stoi(c[1]);
-        orderItems[orderItemCount].qty = stoi(c[2]);
-        orderItemCount++;
+        FPOrderItem oi = {};
+        oi.orderId = stoi(c[0]);
+        oi.itemId = stoi(c[1]);
+        oi.qty = stoi(c[2]);
+        fpCtx->orderItems.push_back(oi);
     }
     return true;
 }
@@ -151,15 +171,17 @@ bool foodPharmaLoadVendors(const string &file) {
     if (!fin) return false;
 
     string line, c[5];
-    vendorCount = 0;
+    fpCtx->vendors.clear();
+    fpCtx->vendors.reserve(min(foodPharmaCountRows(fin), FP_MAX_VENDORS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->vendors.size() < FP_MAX_VENDORS) {
         foodPharmaSplitCSV(line, c, 5);
-        vendors[vendorCount].id = stoi(c[0]);
-        strncpy(vendors[vendorCount].name, c[1].c_str(), 49);
-        strncpy(vendors[vendorCount].type, c[2].c_str(), 9);
-        vendorCount++;
+        FPVendor v = {};
+        v.id = stoi(c[0]);
+        strncpy(v.name, c[1].c_str(), 49);
+        strncpy(v.type, c[2].c_str(), 9);
+        fpCtx->vendors.push_back(v);
     }
     return true;
 }
@@ -170,16 +192,18 @@ bool foodPharmaLoadItems(const string &file) {
     if (!fin) return false;
 
     string line, c[6];
-    itemCount = 0;
+    fpCtx->items.clear();
+    fpCtx->items.reserve(min(foodPharmaCountRows(fin), FP_MAX_ITEMS));
     getline(fin, line);
 
-    while (getline(fin, line)) {
+    while (getline(fin, line) && fpCtx->items.size() < FP_MAX_ITEMS) {
         foodPharmaSplitCSV(line, c, 6);
-        items[itemCount].id = stoi(c[0]);
-        items[itemCount].vendorId = stoi(c[1]);
-        strncpy(items[itemCount].name, c[2].c_str(), 49);
-        items[itemCount].price = stod(c[3]);
-        itemCount++;
+        FPItem it = {};
+        it.id = stoi(c[0]);
+        it.vendorId = stoi(c[1]);
+        strncpy(it.name, c[2].c_str(), 49);
+        it.price = stod(c[3]);
+        fpCtx->items.push_back(it);
     }
     return true;
 }
@@ -189,12 +213,12 @@ void foodPharmaLoadALL() {
     cout << "\n--- LOADING FOODPHARMA CSV DATA ---\n";
 
     if (foodPharmaLoadVendors("foodpharma_vendors.csv"))
-        cout << " Vendors loaded: " << vendorCount << "\n";
+        cout << " Vendors loaded: " << fpCtx->vendors.size() << "\n";
     else
         cout << " Vendors CSV missing\n";
 
     if (foodPharmaLoadItems("foodpharma_items.csv"))
-        cout << " Items loaded: " << itemCount << "\n";
+        cout << " Items loaded: " << fpCtx->items.size() << "\n";
     else
         cout << " Items CSV missing\n";
 
@@ -204,12 +228,12 @@ void foodPharmaLoadALL() {
         cout << " Graph CSV missing\n";
 
     if (foodPharmaLoadOrders("foodpharma_orders.csv"))
-        cout << " Orders loaded: " << orderCount << "\n";
+        cout << " Orders loaded: " << fpCtx->orders.size() << "\n";
     else
         cout << " Orders CSV not found (optional)\n";
 
     if (foodPharmaLoadOrderItems("foodpharma_orderitems.csv"))
-        cout << " Order items loaded: " << orderItemCount << "\n";
+        cout << " Order items loaded: " << fpCtx->orderItems.size() << "\n";
     else
         cout << " Order items CSV not found (optional)\n";
 
@@ -220,43 +244,55 @@ void foodPharmaLoadALL() {
 // ---------------- SHOW FUNCTIONS ----------------
 void foodPharmaShowVendors() {
     cout << "\n--- VENDORS ---\n";
-    for (int i = 0; i < vendorCount; i++)
-        cout << vendors[i].id << " | " << vendors[i].name
-             << " | " << vendors[i].type << "\n";
+    for (size_t i = 0; i < fpCtx->vendors.size(); i++)
+        cout << fpCtx->vendors[i].id << " | " << fpCtx->vendors[i].name
+             << " | " << fpCtx->vendors[i].type << "\n";
 }
 
 void foodPharmaShowItems() {
     cout << "\n--- ITEMS ---\n";
-    for (int i = 0; i < itemCount; i++)
-        cout << items[i].id << " | Vendor " << items[i].vendorId
-             << " | " << items[i].name
-             << " | Rs" << items[i].price << "\n";
+    for (size_t i = 0; i < fpCtx->items.size(); i++)
+        cout << fpCtx->items[i].id << " | Vendor " << fpCtx->items[i].vendorId
+             << " | " << fpCtx->items[i].name
+             << " | Rs" << fpCtx->items[i].price << "\n";
 }
 
 // ---------------- MANUAL ADD ----------------
 void foodPharmaAddVendor() {
-    FPVendor &v = vendors[vendorCount];
+    if (fpCtx->vendors.size() >= FP_MAX_VENDORS) {
+        cout << "Vendor storage full\n";
+        return;
+    }
+    FPVendor v = {};
     cout << "Vendor ID: "; cin >> v.id;
     cin.ignore();
     cout << "Name: "; cin.getline(v.name, 50);
     cout << "Type (FOOD/PHARMA): "; cin.getline(v.type, 10);
-    vendorCount++;
+    fpCtx->vendors.push_back(v);
 }
 
 void foodPharmaAddItem() {
-    FPItem &i = items[itemCount];
+    if (fpCtx->items.size() >= FP_MAX_ITEMS) {
+        cout << "Item storage full\n";
+        return;
+    }
+    FPItem i = {};
     cout << "Item ID: "; cin >> i.id;
     cout << "Vendor ID: "; cin >> i.vendorId;
     cin.ignore();
     cout << "Name: "; cin.getline(i.name, 50);
     cout << "Price: "; cin >> i.price;
-    itemCount++;
+    fpCtx->items.push_back(i);
 }
 
 // ---------------- ORDER FUNCTIONS ----------------
 void foodPharmaCreateOrder() {
-    FPOrder &o = orders[orderCount];
-    o.id = orderCount + 1;
+    if (fpCtx->orders.size() >= FP_MAX_ORDERS) {
+        cout << "Order storage full\n";
+        return;
+    }
+    FPOrder o = {};
+    o.id = fpCtx->orders.size() + 1;
 
     cin.ignore();
     cout << "Customer Name: "; cin.getline(o.customer, 50);
@@ -268,14 +304,18 @@ void foodPharmaCreateOrder() {
 
     int more = 1;
     while (more) {
-        FPOrderItem &oi = orderItems[orderItemCount];
+        if (fpCtx->orderItems.size() >= FP_MAX_ORDERITEMS) {
+            cout << "Order item storage full\n";
+            break;
+        }
+        FPOrderItem oi = {};
         oi.orderId = o.id;
         cout << "Item ID: "; cin >> oi.itemId;
         cout << "Qty: "; cin >> oi.qty;
-        orderItemCount++;
+        fpCtx->orderItems.push_back(oi);
         cout << "Add more items? (1/0): "; cin >> more;
     }
-    orderCount++;
+    fpCtx->orders.push_back(o);
 }
 
 void foodPharmaCompleteOrder() {
@@ -283,9 +323,9 @@ void foodPharmaCompleteOrder() {
     cout << "Enter Order ID to complete: ";
     cin >> oid;
 
-    for (int i = 0; i < orderCount; i++) {
-        if (orders[i].id == oid) {
-            strcpy(orders[i].status, "COMPLETED");
+    for (size_t i = 0; i < fpCtx->orders.size(); i++) {
+        if (fpCtx->orders[i].id == oid) {
+            strcpy(fpCtx->orders[i].status, "COMPLETED");
             cout << "Order marked COMPLETED\n";
             return;
         }
@@ -294,16 +334,18 @@ void foodPharmaCompleteOrder() {
 }
 
 void foodPharmaRemoveCompletedOrders() {
-    for (int i = 0; i < orderCount; i++) {
-        if (strcmp(orders[i].status, "COMPLETED") == 0) {
+    for (int i = 0; i < (int)fpCtx->orders.size(); i++) {
+        if (strcmp(fpCtx->orders[i].status, "COMPLETED") == 0) {
             // remove order items
-            for (int j = 0; j < orderItemCount; j++) {
-                if (orderItems[j].orderId == orders[i].id) {
-                    orderItems[j] = orderItems[--orderItemCount];
+            for (int j = 0; j < (int)fpCtx->orderItems.size(); j++) {
+                if (fpCtx->orderItems[j].orderId == fpCtx->orders[i].id) {
+                    fpCtx->orderItems[j] = fpCtx->orderItems.back();
+                    fpCtx->orderItems.pop_back();
                     j--;
                 }
             }
-            orders[i] = orders[--orderCount];
+            fpCtx->orders[i] = fpCtx->orders.back();
+            fpCtx->orders.pop_back();
             i--;
         }
     }
@@ -312,14 +354,20 @@ void foodPharmaRemoveCompletedOrders() {
 
 // ---------------- DISPLAY ORDERS ----------------
 void foodPharmaShowOrders() {
-    for (int i = 0; i < orderCount; i++)
-        cout << orders[i].id << " | " << orders[i].customer
-             << " | " << orders[i].status
-             << " | Dist: " << orders[i].distance << "\n";
+    for (size_t i = 0; i < fpCtx->orders.size(); i++)
+        cout << fpCtx->orders[i].id << " | " << fpCtx->orders[i].customer
+             << " | " << fpCtx->orders[i].status
+             << " | Dist: " << fpCtx->orders[i].distance << "\n";
 }
 
 // ---------------- MENU ----------------
+void foodPharmaInitModule() {
+    if (fpCtx) return; // state is kept across visits to the menu
+    fpCtx = new FPContext();
+}
+
 void foodpharmaSystem() {
+    foodPharmaInitModule();
     int ch; string path;
     do {
         cout << "\n--- FOOD & PHARMACY DELIVERY ---\n";
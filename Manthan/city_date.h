@@ -0,0 +1,205 @@
+// city_date.h — packed calendar dates shared by the Manthan modules
+// CityDate     = days since 1970-01-01 (proleptic Gregorian)
+// CityDateTime = minutes since 1970-01-01 00:00 (local time, no zone)
+// Both are plain int32 so range filters are integer compares; text is only
+// produced when a value is printed.
+#ifndef CITY_DATE_H
+#define CITY_DATE_H
+
+#include <string>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+
+typedef int32_t CityDate;
+typedef int32_t CityDateTime;
+
+#define CITY_NO_DATE INT32_MIN // unparsable / empty date or datetime
+#define CITY_MINUTES_PER_DAY 1440
+
+/* ---------- civil <-> day number ---------- */
+/* Every 4-digit year fits a CityDate, but minutes overflow int32 after
+   about 6053, so day -> minute conversions are checked. */
+inline CityDate cityDaysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline void cityCivilFromDays(CityDate z, int &y, int &m, int &d)
+{
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = yoe + era * 400 + (m <= 2);
+}
+
+inline int cityMonthDays(int y, int m)
+{
+    static const unsigned char len[16] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 0, 0, 0};
+    int leap = (y % 4 == 0) & ((y % 100 != 0) | (y % 400 == 0));
+    return len[m & 15] + ((m == 2) & leap);
+}
+
+/* midnight of day d in minutes; false if it does not fit a CityDateTime */
+inline bool cityDayMinutes(CityDate d, CityDateTime &out)
+{
+    int64_t m = (int64_t)d * CITY_MINUTES_PER_DAY;
+    if (m <= INT32_MIN || m > INT32_MAX)
+        return false;
+    out = (CityDateTime)m;
+    return true;
+}
+
+/* ---------- parsing ----------
+   The digit and range checks are folded into one flag so a well-formed
+   column parses without data-dependent branches. */
+inline bool cityParseDate(const char *s, size_t n, CityDate &out)
+{
+    if (n < 10)
+        return false;
+    unsigned c0 = (unsigned)(s[0] - '0'), c1 = (unsigned)(s[1] - '0'), c2 = (unsigned)(s[2] - '0'), c3 = (unsigned)(s[3] - '0');
+    unsigned c5 = (unsigned)(s[5] - '0'), c6 = (unsigned)(s[6] - '0'), c8 = (unsigned)(s[8] - '0'), c9 = (unsigned)(s[9] - '0');
+    unsigned bad = (c0 > 9) | (c1 > 9) | (c2 > 9) | (c3 > 9) | (c5 > 9) | (c6 > 9) | (c8 > 9) | (c9 > 9) | (s[4] != '-') | (s[7] != '-');
+    int y = (int)(c0 * 1000 + c1 * 100 + c2 * 10 + c3);
+    int m = (int)(c5 * 10 + c6);
+    int d = (int)(c8 * 10 + c9);
+    bad |= ((unsigned)(m - 1) > 11u) | ((unsigned)(d - 1) >= (unsigned)cityMonthDays(y, m));
+    out = cityDaysFromCivil(y, m, d);
+    return !bad;
+}
+
+/* "HH:MM" -> minutes after midnight */
+inline bool cityParseTime(const char *s, size_t n, int &out)
+{
+    if (n < 5)
+        return false;
+    unsigned h0 = (unsigned)(s[0] - '0'), h1 = (unsigned)(s[1] - '0'), m0 = (unsigned)(s[3] - '0'), m1 = (unsigned)(s[4] - '0');
+    unsigned bad = (h0 > 9) | (h1 > 9) | (m0 > 5) | (m1 > 9) | (s[2] != ':');
+    int hh = (int)(h0 * 10 + h1);
+    bad |= (hh > 23);
+    out = hh * 60 + (int)(m0 * 10 + m1);
+    return !bad;
+}
+
+/* "YYYY-MM-DD", "YYYY-MM-DD HH:MM" or with 'T' / trailing ":SS" */
+inline bool cityParseDateTime(const char *s, size_t n, CityDateTime &out)
+{
+    CityDate d;
+    if (!cityParseDate(s, n, d))
+        return false;
+    int mins = 0;
+    if (n > 10 && !((s[10] == ' ' || s[10] == 'T') && cityParseTime(s + 11, n - 11, mins)))
+        return false;
+    int64_t t = (int64_t)d * CITY_MINUTES_PER_DAY + mins;
+    if (t <= INT32_MIN || t > INT32_MAX)
+        return false;
+    out = (CityDateTime)t;
+    return true;
+}
+
+inline CityDate cityDate(const std::string &s)
+{
+    CityDate d;
+    return cityParseDate(s.data(), s.size(), d) ? d : CITY_NO_DATE;
+}
+
+inline CityDateTime cityDateTime(const std::string &s)
+{
+    CityDateTime t;
+    return cityParseDateTime(s.data(), s.size(), t) ? t : CITY_NO_DATE;
+}
+
+/* minutes after midnight, or -1 */
+inline int cityTime(const std::string &s)
+{
+    int t;
+    return cityParseTime(s.data(), s.size(), t) ? t : -1;
+}
+
+/* "YYYY", "YYYY-MM" or "YYYY-MM-DD" -> half-open day range [lo,hi) */
+inline bool cityPrefixRange(const std::string &p, CityDate &lo, CityDate &hi)
+{
+    int y = 0, m = 1;
+    if (p.size() == 10)
+    {
+        if (!cityParseDate(p.data(), p.size(), lo))
+            return false;
+        hi = lo + 1;
+        return true;
+    }
+    if (p.size() != 4 && p.size() != 7)
+        return false;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+        y = y * 10 + (p[i] - '0');
+    }
+    if (p.size() == 4)
+    {
+        lo = cityDaysFromCivil(y, 1, 1);
+        hi = cityDaysFromCivil(y + 1, 1, 1);
+        return true;
+    }
+    if (p[4] != '-' || p[5] < '0' || p[5] > '9' || p[6] < '0' || p[6] > '9')
+        return false;
+    m = (p[5] - '0') * 10 + (p[6] - '0');
+    if (m < 1 || m > 12)
+        return false;
+    lo = cityDaysFromCivil(y, m, 1);
+    hi = lo + cityMonthDays(y, m);
+    return true;
+}
+
+/* ---------- formatting ---------- */
+inline std::string cityFormatDate(CityDate d)
+{
+    if (d == CITY_NO_DATE)
+        return "";
+    int y, m, dd;
+    cityCivilFromDays(d, y, m, dd);
+    char b[11] = {(char)('0' + y / 1000 % 10), (char)('0' + y / 100 % 10), (char)('0' + y / 10 % 10), (char)('0' + y % 10), '-',
+                  (char)('0' + m / 10), (char)('0' + m % 10), '-', (char)('0' + dd / 10), (char)('0' + dd % 10), 0};
+    return std::string(b, 10);
+}
+
+inline std::string cityFormatTime(int mins)
+{
+    if (mins < 0)
+        return "";
+    char b[5] = {(char)('0' + mins / 600), (char)('0' + mins / 60 % 10), ':', (char)('0' + mins % 60 / 10), (char)('0' + mins % 10)};
+    return std::string(b, 5);
+}
+
+inline std::string cityFormatDateTime(CityDateTime t)
+{
+    if (t == CITY_NO_DATE)
+        return "";
+    CityDate d = (t >= 0 ? t : t - (CITY_MINUTES_PER_DAY - 1)) / CITY_MINUTES_PER_DAY;
+    return cityFormatDate(d) + " " + cityFormatTime(t - d * CITY_MINUTES_PER_DAY);
+}
+
+/* ---------- clock ---------- */
+inline CityDateTime cityNow()
+{
+    time_t t = time(NULL);
+    struct tm *tm = localtime(&t);
+    return cityDaysFromCivil(tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday) * CITY_MINUTES_PER_DAY + tm->tm_hour * 60 + tm->tm_min;
+}
+
+inline CityDate cityToday()
+{
+    return cityNow() / CITY_MINUTES_PER_DAY;
+}
+
+#endif
@@ -0,0 +1,76 @@
+// city_dict.h — interned codes for low-cardinality text columns
+// A CityDict maps each distinct value of a column (status, seat type, ...)
+// to a two-byte code. Records keep the code, filters compare codes, and the
+// text is only looked up when a row is printed or written back to CSV.
+// A dictionary is built from the values the code branches on, so those get
+// fixed codes that can be named as constants; any other value read from a
+// CSV is appended on first sight and round-trips unchanged.
+// Codes are two bytes, not one: a byte would leave room for only 255 values
+// before later ones are stored empty, and the code field sits in padding in
+// every record that carries one, so only a per-seat array pays for the width.
+#ifndef CITY_DICT_H
+#define CITY_DICT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <initializer_list>
+#include <cstdint>
+#include <iostream>
+
+typedef uint16_t CityCode;
+
+#define CITY_NO_CODE 65535 // dictionary full; prints as ""
+
+struct CityDict
+{
+    std::vector<std::string> names;
+    std::unordered_map<std::string, CityCode> codes;
+    bool overflowed = false; // a value was refused because the dictionary was full
+};
+
+/* seeds get codes 0,1,2,... in the order given */
+inline CityDict cityDictMake(std::initializer_list<const char *> seeds)
+{
+    CityDict d;
+    for (const char *s : seeds)
+    {
+        d.codes[s] = (CityCode)d.names.size();
+        d.names.push_back(s);
+    }
+    return d;
+}
+
+inline CityCode cityIntern(CityDict &d, const std::string &s)
+{
+    std::unordered_map<std::string, CityCode>::const_iterator it = d.codes.find(s);
+    if (it != d.codes.end())
+        return it->second;
+    if (d.names.size() >= CITY_NO_CODE)
+    {
+        if (!d.overflowed)
+            std::cerr << "city_dict: more than " << CITY_NO_CODE << " distinct values, \"" << s
+                      << "\" and any later new value will be stored empty\n";
+        d.overflowed = true;
+        return CITY_NO_CODE;
+    }
+    CityCode c = (CityCode)d.names.size();
+    d.codes[s] = c;
+    d.names.push_back(s);
+    return c;
+}
+
+/* code of s, or CITY_NO_CODE when s was never interned (nothing matches it) */
+inline CityCode cityDictFind(const CityDict &d, const std::string &s)
+{
+    std::unordered_map<std::string, CityCode>::const_iterator it = d.codes.find(s);
+    return it == d.codes.end() ? (CityCode)CITY_NO_CODE : it->second;
+}
+
+inline const std::string &cityDictName(const CityDict &d, CityCode c)
+{
+    static const std::string none;
+    return c < d.names.size() ? d.names[c] : none;
+}
+
+#endif
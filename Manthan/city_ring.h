@@ -0,0 +1,27 @@
+// city_ring.h — growth for vector-backed ring buffers
+// Module queues keep their entries in a vector used as a ring (front, rear
+// and a live count). The vector starts empty and is only grown when the ring
+// is full, so a queue that is never used allocates nothing.
+#ifndef CITY_RING_H
+#define CITY_RING_H
+
+#include <vector>
+#include <algorithm>
+
+/* ring is full (count == ring.size()): unroll it into one twice as large,
+   at least 16 and at most cap slots, with the oldest entry in slot 0 */
+template <class T>
+inline void cityRingGrow(std::vector<T> &ring, int &front, int &rear, int count, int cap)
+{
+    int slots = std::min(std::max(16, count * 2), cap);
+    std::vector<T> grown;
+    grown.reserve(slots);
+    for (int i = 0; i < count; ++i)
+        grown.push_back(ring[(front + i) % ring.size()]);
+    grown.resize(slots);
+    ring.swap(grown);
+    front = 0;
+    rear = count - 1;
+}
+
+#endif
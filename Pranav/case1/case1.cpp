@@ -2,87 +2,221 @@
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
-#include <queue>
+#include <set>
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <climits>
+#include "../../Manthan/city_dict.h"
+#include "../../Manthan/city_date.h"
 using namespace std;
 
+// User types with a discount; any other type read from the CSV is interned
+// after these and pays the base rate.
+enum UserType { USER_STUDENT, USER_FREELANCER, USER_STARTUP };
+
+// Desks are sold by the hour; a date-only booking starts at opening time
+const int HUB_OPEN_HOUR = 9;
+
+// Desks in use per hour, as a sparse segment tree over hours since
+// 1970-01-01. Hours nobody booked have no nodes and read as zero, so years
+// of bookings cost O(log n) nodes each rather than a slot per hour.
+class HourCalendar {
+private:
+    static const int SLOT_BITS = 21; // 2^21 hours, about 239 years
+    struct Node {
+        int add;        // added to every hour under this node
+        int peak;       // max desks in use under this node, including add
+        int child[2];   // 0 = none (the root is never a child)
+    };
+    vector<Node> nodes;
+    
+    int child(int n, int side) {
+        if(!nodes[n].child[side]) {
+            nodes[n].child[side] = (int)nodes.size();
+            nodes.push_back(Node{0, 0, {0, 0}});
+        }
+        return nodes[n].child[side];
+    }
+    
+    int peakOf(int n) const { return n ? nodes[n].peak : 0; }
+    
+    void add(int n, int lo, int hi, int from, int to, int desks) {
+        if(from <= lo && hi <= to) {
+            nodes[n].add += desks;
+            nodes[n].peak += desks;
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        if(from < mid) add(child(n, 0), lo, mid, from, to, desks);
+        if(to > mid) add(child(n, 1), mid, hi, from, to, desks);
+        nodes[n].peak = nodes[n].add + max(peakOf(nodes[n].child[0]), peakOf(nodes[n].child[1]));
+    }
+    
+    int peak(int n, int lo, int hi, int from, int to) const {
+        if(from <= lo && hi <= to) return nodes[n].peak;
+        int mid = lo + (hi - lo) / 2, best = INT_MIN;
+        for(int side = 0; side < 2; side++) {
+            int clo = side ? mid : lo, chi = side ? hi : mid, c = nodes[n].child[side];
+            if(from < chi && to > clo) best = max(best, c ? peak(c, clo, chi, from, to) : 0);
+        }
+        return nodes[n].add + best;
+    }
+    
+public:
+    static const int SLOTS = 1 << SLOT_BITS;
+    
+    HourCalendar() : nodes(1, Node{0, 0, {0, 0}}) {}
+    
+    // Hours [start, start+hours) gain desks (negative to release)
+    void addDesks(int start, int hours, int desks) { add(0, 0, SLOTS, start, start + hours, desks); }
+    
+    // Most desks in use at any hour of [start, start+hours)
+    int peakDesks(int start, int hours) const { return peak(0, 0, SLOTS, start, start + hours); }
+    
+    int peakDesks() const { return nodes[0].peak; }
+};
+
 // Structure for workspace booking
 struct Booking {
     string bookingID;
     string userName;
-    string userType;
+    CityCode userType;
     string date;
     int duration;
     double price;
     int priority; // 1=urgent, 2=normal, 3=flexible
-    
-    bool operator<(const Booking& other) const {
-        return priority > other.priority; // Min heap based on priority
+    int startHour; // hours since 1970-01-01
+    unsigned seq; // arrival order, breaks priority ties
+};
+
+// Orders the priority index: most urgent first, then first come first served
+struct BookingPriorityOrder {
+    bool operator()(const Booking* a, const Booking* b) const {
+        if(a->priority != b->priority) return a->priority < b->priority;
+        return a->seq < b->seq;
     }
 };
 
 class CoWorkingHub {
 private:
     unordered_map<string, Booking> bookingMap; // bookingID -> Booking
-    priority_queue<Booking> bookingQueue;
-    int totalSpaces;
-    int availableSpaces;
+    // Points into bookingMap (its nodes never move), so the index holds no
+    // copies and the top-k view is a walk from begin()
+    set<const Booking*, BookingPriorityOrder> priorityIndex;
+    unsigned nextSeq;
+    HourCalendar deskCalendar;
+    int totalSpaces; // desks available in every hour
+    int rejectedBookings;
+    CityDict userTypes;
     
 public:
-    CoWorkingHub(int spaces) : totalSpaces(spaces), availableSpaces(spaces) {}
+    CoWorkingHub(int spaces) : nextSeq(0), totalSpaces(spaces), rejectedBookings(0),
+        userTypes(cityDictMake({"student", "freelancer", "startup"})) {}
     
-    double calculatePrice(string userType, int duration) {
+    double calculatePrice(CityCode userType, int duration) {
+        static const double discount[] = {0.5, 0.7, 0.8}; // indexed by UserType
         double basePrice = 100.0; // per hour
-        if(userType == "student") return basePrice * duration * 0.5;
-        else if(userType == "freelancer") return basePrice * duration * 0.7;
-        else if(userType == "startup") return basePrice * duration * 0.8;
+        if(userType <= USER_STARTUP) return basePrice * duration * discount[userType];
         return basePrice * duration;
     }
     
+    // "YYYY-MM-DD" (from opening time) or "YYYY-MM-DD HH:MM" -> hour slot, or -1
+    static int parseStartHour(const string& date) {
+        CityDateTime t = cityDateTime(date);
+        if(t == CITY_NO_DATE || t < 0) return -1;
+        if(date.size() == 10) return t / 60 + HUB_OPEN_HOUR;
+        return t / 60;
+    }
+    
+    bool canBook(int startHour, int hours, int desks = 1) const {
+        if(startHour < 0 || hours <= 0 || hours > HourCalendar::SLOTS - startHour) return false;
+        return deskCalendar.peakDesks(startHour, hours) + desks <= totalSpaces;
+    }
+    
+    bool canBook(const string& date, int hours, int desks = 1) const {
+        return canBook(parseStartHour(date), hours, desks);
+    }
+    
     bool addBooking(string id, string name, string type, string date, 
                     int duration, int priority) {
-        if(availableSpaces > 0) {
-            Booking b;
-            b.bookingID = id;
-            b.userName = name;
-            b.userType = type;
-            b.date = date;
-            b.duration = duration;
-            b.price = calculatePrice(type, duration);
-            b.priority = priority;
-            
-            bookingMap[id] = b;
-            bookingQueue.push(b);
-            availableSpaces--;
-            return true;
+        int startHour = parseStartHour(date);
+        auto existing = bookingMap.find(id);
+        // a rebooking gives up its old hours before the new ones are checked
+        if(existing != bookingMap.end())
+            deskCalendar.addDesks(existing->second.startHour, existing->second.duration, -1);
+        if(!canBook(startHour, duration)) {
+            if(existing != bookingMap.end())
+                deskCalendar.addDesks(existing->second.startHour, existing->second.duration, 1);
+            rejectedBookings++;
+            return false;
         }
-        return false;
+        
+        Booking& b = existing != bookingMap.end() ? existing->second : bookingMap[id];
+        if(existing != bookingMap.end()) priorityIndex.erase(&b);
+        
+        b.bookingID = id;
+        b.userName = name;
+        b.userType = cityIntern(userTypes, type);
+        b.date = date;
+        b.duration = duration;
+        b.price = calculatePrice(b.userType, duration);
+        b.priority = priority;
+        b.startHour = startHour;
+        b.seq = nextSeq++;
+        priorityIndex.insert(&b);
+        deskCalendar.addDesks(startHour, duration, 1);
+        return true;
+    }
+    
+    bool cancelBooking(const string& id) {
+        auto it = bookingMap.find(id);
+        if(it == bookingMap.end()) return false;
+        priorityIndex.erase(&it->second);
+        deskCalendar.addDesks(it->second.startHour, it->second.duration, -1);
+        bookingMap.erase(it);
+        return true;
+    }
+    
+    // Moves a booking within the priority index; it keeps its arrival order
+    bool reprioritiseBooking(const string& id, int priority) {
+        auto it = bookingMap.find(id);
+        if(it == bookingMap.end()) return false;
+        priorityIndex.erase(&it->second);
+        it->second.priority = priority;
+        priorityIndex.insert(&it->second);
+        return true;
+    }
+    
+    const Booking* findBooking(const string& id) const {
+        auto it = bookingMap.find(id);
+        return it != bookingMap.end() ? &it->second : nullptr;
+    }
+    
+    // Calls visit(booking) for the k most urgent bookings in order; O(k)
+    template<class Visit>
+    void forEachTopBooking(int k, Visit visit) const {
+        for(auto it = priorityIndex.begin(); it != priorityIndex.end() && k > 0; ++it, --k)
+            visit(**it);
     }
     
     void processHighPriorityBookings() {
         cout << "\n========== High Priority Bookings ==========\n";
-        int count = 0;
-        priority_queue<Booking> tempQueue = bookingQueue;
-        
-        while(!tempQueue.empty() && count < 10) {
-            Booking b = tempQueue.top();
-            tempQueue.pop();
+        forEachTopBooking(10, [&](const Booking& b) {
             cout << "ID: " << b.bookingID << " | User: " << b.userName 
-                 << " | Type: " << b.userType << " | Priority: " << b.priority
+                 << " | Type: " << cityDictName(userTypes, b.userType) << " | Priority: " << b.priority
                  << " | Price: Rs." << fixed << setprecision(2) << b.price << endl;
-            count++;
-        }
+        });
     }
     
-    void searchBooking(string id) {
-        if(bookingMap.find(id) != bookingMap.end()) {
-            Booking b = bookingMap[id];
+    void searchBooking(const string& id) const {
+        const Booking* found = findBooking(id);
+        if(found) {
+            const Booking& b = *found;
             cout << "\n========== Booking Found ==========\n";
             cout << "Booking ID: " << b.bookingID << endl;
             cout << "User Name: " << b.userName << endl;
-            cout << "User Type: " << b.userType << endl;
+            cout << "User Type: " << cityDictName(userTypes, b.userType) << endl;
             cout << "Date: " << b.date << endl;
             cout << "Duration: " << b.duration << " hours" << endl;
             cout << "Price: Rs." << fixed << setprecision(2) << b.price << endl;
@@ -95,9 +229,9 @@ public:
     void displayStatistics() {
         cout << "\n========== Hub Statistics ==========\n";
         cout << "Total Spaces: " << totalSpaces << endl;
-        cout << "Available Spaces: " << availableSpaces << endl;
-        cout << "Booked Spaces: " << (totalSpaces - availableSpaces) << endl;
+        cout << "Peak Spaces in Use: " << deskCalendar.peakDesks() << endl;
         cout << "Total Bookings: " << bookingMap.size() << endl;
+        cout << "Rejected Bookings: " << rejectedBookings << endl;
     }
     
     void loadFromCSV(string filename) {
@@ -113,7 +247,7 @@ public:
         while(getline(file, line)) {
             stringstream ss(line);
             string id, name, type, date;
-            int duration, priority;
+            int duration = 0, priority = 0;
             
             getline(ss, id, ',');
             getline(ss, name, ',');
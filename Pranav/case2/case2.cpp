@@ -1,7 +1,8 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <queue>
+#include <vector>
+#include <unordered_map>
 #include <string>
 using namespace std;
 
@@ -19,61 +20,202 @@ struct Member {
           enrollmentDate(date), sessionsAttended(0), next(nullptr) {}
 };
 
-// Class booking structure for queue
+// Seats per class session unless setClassCapacity() says otherwise
+const int CLASS_DEFAULT_CAPACITY = 25;
+
+// One member's place in a class session. Bookings live in a pool and are
+// chained into their session's roster or waitlist by index, so moving a
+// member between lists or cancelling never allocates.
 struct ClassBooking {
     string memberID;
+    string date;
+    int session;
+    int prev, next;  // neighbours in the roster/waitlist, -1 = none
+    bool waitlisted;
+};
+
+// A (className, timeSlot) pair with its roster and FIFO waitlist
+struct ClassSession {
     string className;
     string timeSlot;
-    string date;
+    int capacity;
+    int enrolled;
+    int waiting;
+    int rosterHead, rosterTail;
+    int waitHead, waitTail;
 };
 
 class WellnessCenter {
 private:
     Member* head; // Linked list head
-    queue<ClassBooking> waitingQueue;
+    Member* tail; // so loading appends in O(1)
     int totalMembers;
+    vector<ClassSession> sessions;
+    unordered_map<string, int> sessionIndex;   // className|timeSlot -> session
+    vector<ClassBooking> bookingPool;
+    int freeBooking;                           // free list through next
+    unordered_map<string, int> bookingIndex;   // memberID|session -> booking
+    
+    int findSession(const string& className, const string& timeSlot) const {
+        auto it = sessionIndex.find(className + "|" + timeSlot);
+        return it != sessionIndex.end() ? it->second : -1;
+    }
+    
+    int sessionFor(const string& className, const string& timeSlot) {
+        auto ins = sessionIndex.insert({className + "|" + timeSlot, (int)sessions.size()});
+        if(ins.second)
+            sessions.push_back(ClassSession{className, timeSlot, CLASS_DEFAULT_CAPACITY,
+                                            0, 0, -1, -1, -1, -1});
+        return ins.first->second;
+    }
+    
+    static string bookingKey(const string& memberID, int session) {
+        return memberID + "|" + to_string(session);
+    }
+    
+    int allocBooking() {
+        if(freeBooking != -1) {
+            int b = freeBooking;
+            freeBooking = bookingPool[b].next;
+            return b;
+        }
+        bookingPool.push_back(ClassBooking());
+        return (int)bookingPool.size() - 1;
+    }
+    
+    void pushBack(int& first, int& last, int b) {
+        bookingPool[b].prev = last;
+        bookingPool[b].next = -1;
+        if(last != -1) bookingPool[last].next = b;
+        else first = b;
+        last = b;
+    }
+    
+    void unlink(int& first, int& last, int b) {
+        ClassBooking& bk = bookingPool[b];
+        if(bk.prev != -1) bookingPool[bk.prev].next = bk.next;
+        else first = bk.next;
+        if(bk.next != -1) bookingPool[bk.next].prev = bk.prev;
+        else last = bk.prev;
+    }
+    
+    // Moves waitlisted members into free seats, oldest first
+    int promoteWaitlisted(int session, bool report) {
+        ClassSession& cs = sessions[session];
+        int promoted = 0;
+        while(cs.enrolled < cs.capacity && cs.waitHead != -1) {
+            int b = cs.waitHead;
+            unlink(cs.waitHead, cs.waitTail, b);
+            pushBack(cs.rosterHead, cs.rosterTail, b);
+            bookingPool[b].waitlisted = false;
+            cs.waiting--;
+            cs.enrolled++;
+            promoted++;
+            if(report)
+                cout << "Promoted: Member " << bookingPool[b].memberID
+                     << " | Class: " << cs.className << " | Time: " << cs.timeSlot << endl;
+        }
+        return promoted;
+    }
+    
+    void clearAll() {
+        while(head != nullptr) {
+            Member* next = head->next;
+            delete head;
+            head = next;
+        }
+        tail = nullptr;
+        totalMembers = 0;
+        sessions.clear();
+        sessionIndex.clear();
+        bookingPool.clear();
+        bookingIndex.clear();
+        freeBooking = -1;
+    }
     
 public:
-    WellnessCenter() : head(nullptr), totalMembers(0) {}
+    WellnessCenter() : head(nullptr), tail(nullptr), totalMembers(0), freeBooking(-1) {}
+    
+    ~WellnessCenter() { clearAll(); }
     
     // Add member to linked list
     void addMember(string id, string name, string type, string date) {
         Member* newMember = new Member(id, name, type, date);
         
-        if(head == nullptr) {
-            head = newMember;
-        } else {
-            Member* temp = head;
-            while(temp->next != nullptr) {
-                temp = temp->next;
-            }
-            temp->next = newMember;
-        }
+        if(head == nullptr) head = newMember;
+        else tail->next = newMember;
+        tail = newMember;
         totalMembers++;
     }
     
-    // Add class booking to queue
-    void addToWaitingQueue(string memberID, string className, 
-                           string timeSlot, string date) {
-        ClassBooking booking = {memberID, className, timeSlot, date};
-        waitingQueue.push(booking);
+    // Books a seat, or joins the waitlist when the session is full.
+    // Returns true if the member got a seat.
+    bool bookClass(const string& memberID, const string& className,
+                   const string& timeSlot, const string& date) {
+        int session = sessionFor(className, timeSlot);
+        auto ins = bookingIndex.insert({bookingKey(memberID, session), -1});
+        if(!ins.second) return !bookingPool[ins.first->second].waitlisted;
+        
+        int b = allocBooking();
+        ins.first->second = b;
+        ClassSession& cs = sessions[session];
+        ClassBooking& bk = bookingPool[b];
+        bk.memberID = memberID;
+        bk.date = date;
+        bk.session = session;
+        bk.waitlisted = cs.enrolled >= cs.capacity;
+        if(bk.waitlisted) {
+            pushBack(cs.waitHead, cs.waitTail, b);
+            cs.waiting++;
+        } else {
+            pushBack(cs.rosterHead, cs.rosterTail, b);
+            cs.enrolled++;
+        }
+        return !bk.waitlisted;
     }
     
-    // Process waiting queue
-    void processWaitingQueue(int count) {
-        cout << "\n========== Processing Waiting Queue ==========\n";
-        int processed = 0;
+    // Frees the member's seat (or waitlist place); a freed seat goes to the
+    // head of that session's waitlist
+    bool cancelBooking(const string& memberID, const string& className, const string& timeSlot) {
+        int session = findSession(className, timeSlot);
+        if(session == -1) return false;
+        auto it = bookingIndex.find(bookingKey(memberID, session));
+        if(it == bookingIndex.end()) return false;
         
-        while(!waitingQueue.empty() && processed < count) {
-            ClassBooking booking = waitingQueue.front();
-            waitingQueue.pop();
-            
-            cout << "Processed: Member " << booking.memberID 
-                 << " | Class: " << booking.className
-                 << " | Time: " << booking.timeSlot << endl;
-            processed++;
+        int b = it->second;
+        ClassSession& cs = sessions[session];
+        bookingIndex.erase(it);
+        if(bookingPool[b].waitlisted) {
+            unlink(cs.waitHead, cs.waitTail, b);
+            cs.waiting--;
+        } else {
+            unlink(cs.rosterHead, cs.rosterTail, b);
+            cs.enrolled--;
+        }
+        bookingPool[b].next = freeBooking;
+        freeBooking = b;
+        
+        cout << "Cancelled: Member " << memberID << " | Class: " << className
+             << " | Time: " << timeSlot << endl;
+        promoteWaitlisted(session, true);
+        return true;
+    }
+    
+    void setClassCapacity(const string& className, const string& timeSlot, int capacity) {
+        int session = sessionFor(className, timeSlot);
+        sessions[session].capacity = capacity; // shrinking never drops enrolled members
+        promoteWaitlisted(session, true);
+    }
+    
+    void displayClassSessions(int count) {
+        cout << "\n========== Class Sessions ==========\n";
+        for(int i = 0; i < (int)sessions.size() && i < count; i++) {
+            const ClassSession& cs = sessions[i];
+            cout << cs.className << " @ " << cs.timeSlot << " | Enrolled: " << cs.enrolled
+                 << "/" << cs.capacity << " | Waitlist: " << cs.waiting;
+            if(cs.waitHead != -1) cout << " | Next: " << bookingPool[cs.waitHead].memberID;
+            cout << endl;
         }
-        cout << "Total processed: " << processed << endl;
     }
     
     // Search member in linked list
@@ -108,17 +250,21 @@ public:
         }
     }
     
+    // Bulk mode: rebuilds members and every roster in one pass over the
+    // file; rows are booked in file order, so waitlists stay FIFO
     void loadFromCSV(string filename) {
         ifstream file(filename);
         if(!file.is_open()) {
             cout << "Error: Could not open " << filename << endl;
             return;
         }
+        clearAll();
         
         string line;
         getline(file, line); // Skip header
         
         while(getline(file, line)) {
+            if(!line.empty() && line.back() == '\r') line.pop_back();
             stringstream ss(line);
             string id, name, type, date, className, timeSlot;
             
@@ -130,7 +276,7 @@ public:
             getline(ss, timeSlot, ',');
             
             addMember(id, name, type, date);
-            addToWaitingQueue(id, className, timeSlot, date);
+            bookClass(id, className, timeSlot, date);
         }
         
         file.close();
@@ -138,9 +284,16 @@ public:
     }
     
     void displayStatistics() {
+        int enrolled = 0, waiting = 0;
+        for(const ClassSession& cs : sessions) {
+            enrolled += cs.enrolled;
+            waiting += cs.waiting;
+        }
         cout << "\n========== Center Statistics ==========\n";
         cout << "Total Members: " << totalMembers << endl;
-        cout << "Waiting Queue Size: " << waitingQueue.size() << endl;
+        cout << "Class Sessions: " << sessions.size() << endl;
+        cout << "Enrolled Seats: " << enrolled << endl;
+        cout << "Waitlisted: " << waiting << endl;
     }
 };
 
@@ -153,7 +306,11 @@ int main() {
     center.loadFromCSV("case2.csv");
     center.displayStatistics();
     center.displayAllMembers();
-    center.processWaitingQueue(15);
+    center.displayClassSessions(15);
+    
+    // Cancellation example: the freed seat goes to the first waitlisted member
+    cout << "\nCancelling M0001 from Cardio @ 18:30:" << endl;
+    center.cancelBooking("M0001", "Cardio", "18:30");
     
     // Search example
     cout << "\nSearching for member M001:" << endl;
@@ -1,7 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <stack>
+#include <vector>
 #include <unordered_map>
 #include <string>
 #include <iomanip>
@@ -16,16 +16,59 @@ struct Order {
     string timestamp;
 };
 
+// Orders kept for the recent-orders view and undo
+const int RECENT_ORDER_SLOTS = 64;
+
 class EcoFoodCourt {
 private:
-    stack<Order> orderHistory;  // Stack for order tracking
+    // Order number seq lives in slot seq % RECENT_ORDER_SLOTS; only the
+    // newest recentCount orders are still in the ring
+    vector<Order> recentOrders;
+    long long orderCount;   // live orders = next sequence number
+    int recentCount;
     unordered_map<string, int> inventory;  // Hash map for inventory
     unordered_map<string, double> itemPrices;
     double totalRevenue;
     double totalWaste;
+    ofstream journal;       // append-only order/undo log, once opened
+    
+    // Places the order in memory only; callers decide whether to journal it
+    bool applyOrder(const string& orderID, const string& customerName, const string& item,
+                    int quantity, const string& timestamp) {
+        auto stock = inventory.find(item);
+        auto price = itemPrices.find(item);
+        if(stock == inventory.end() || price == itemPrices.end() || stock->second < quantity)
+            return false;
+        
+        Order& order = recentOrders[orderCount % RECENT_ORDER_SLOTS];
+        order.orderID = orderID;
+        order.customerName = customerName;
+        order.itemName = item;
+        order.quantity = quantity;
+        order.price = price->second * quantity;
+        order.timestamp = timestamp;
+        
+        orderCount++;
+        if(recentCount < RECENT_ORDER_SLOTS) recentCount++;
+        stock->second -= quantity;
+        totalRevenue += order.price;
+        return true;
+    }
+    
+    // Reverts the newest order; null when there is none left in the ring
+    const Order* applyUndo() {
+        if(recentCount == 0) return nullptr;
+        orderCount--;
+        recentCount--;
+        const Order& last = recentOrders[orderCount % RECENT_ORDER_SLOTS];
+        inventory.find(last.itemName)->second += last.quantity; // placed orders name a stocked item
+        totalRevenue -= last.price;
+        return &last;
+    }
     
 public:
-    EcoFoodCourt() : totalRevenue(0.0), totalWaste(0.0) {
+    EcoFoodCourt() : recentOrders(RECENT_ORDER_SLOTS), orderCount(0), recentCount(0),
+                     totalRevenue(0.0), totalWaste(0.0) {
         initializePrices();
     }
     
@@ -41,47 +84,87 @@ public:
         inventory[item] += quantity;
     }
     
+    // Replays an existing journal, then logs every later order and undo to
+    // it so they survive a restart. Call after loading the base CSV. Every
+    // replayed order must apply and every undo must revert the order it
+    // names; if not, the base CSV has changed under the journal, so replay
+    // stops there and the journal is left untouched.
+    bool openJournal(string filename) {
+        ifstream in(filename);
+        string line;
+        int lineNo = 0, replayed = 0;
+        while(getline(in, line)) {
+            lineNo++;
+            if(!line.empty() && line.back() == '\r') line.pop_back();
+            stringstream ss(line);
+            string kind, orderID, customerName, item, qty, timestamp;
+            getline(ss, kind, ',');
+            getline(ss, orderID, ',');
+            bool applied = false;
+            if(kind == "O") {
+                getline(ss, customerName, ',');
+                getline(ss, item, ',');
+                getline(ss, qty, ',');
+                getline(ss, timestamp);
+                applied = applyOrder(orderID, customerName, item, atoi(qty.c_str()), timestamp);
+            } else if(kind == "U") {
+                const Order* last = orderBySeq(orderCount - 1);
+                applied = last != nullptr && last->orderID == orderID && applyUndo() != nullptr;
+            } else if(line.empty()) {
+                continue;
+            }
+            if(!applied) {
+                cout << "Error: " << filename << " line " << lineNo << " (" << line
+                     << ") does not match the loaded orders; replayed " << replayed
+                     << " entries and stopped. Journal not reopened." << endl;
+                return false;
+            }
+            replayed++;
+        }
+        in.close();
+        
+        journal.open(filename, ios::app);
+        if(!journal.is_open()) {
+            cout << "Error: Could not open " << filename << endl;
+            return false;
+        }
+        if(replayed > 0) cout << "Replayed " << replayed << " journal entries from " << filename << endl;
+        return true;
+    }
+    
     bool placeOrder(string orderID, string customerName, string item, 
                     int quantity, string timestamp) {
-        if(inventory[item] >= quantity) {
-            Order order;
-            order.orderID = orderID;
-            order.customerName = customerName;
-            order.itemName = item;
-            order.quantity = quantity;
-            order.price = itemPrices[item] * quantity;
-            order.timestamp = timestamp;
-            
-            orderHistory.push(order);
-            inventory[item] -= quantity;
-            totalRevenue += order.price;
-            return true;
-        }
-        return false;
+        if(!applyOrder(orderID, customerName, item, quantity, timestamp)) return false;
+        if(journal.is_open())
+            journal << "O," << orderID << "," << customerName << "," << item << ","
+                    << quantity << "," << timestamp << endl;
+        return true;
+    }
+    
+    // Order number seq (0 = first), or null once it has left the ring
+    const Order* orderBySeq(long long seq) const {
+        if(seq < 0 || seq >= orderCount || seq < orderCount - recentCount) return nullptr;
+        return &recentOrders[seq % RECENT_ORDER_SLOTS];
     }
     
     void viewRecentOrders(int count) {
         cout << "\n========== Recent Orders ==========\n";
-        stack<Order> temp = orderHistory;
-        int shown = 0;
-        
-        while(!temp.empty() && shown < count) {
-            Order o = temp.top();
-            temp.pop();
-            cout << "Order: " << o.orderID << " | Customer: " << o.customerName
-                 << " | Item: " << o.itemName << " | Qty: " << o.quantity
-                 << " | Price: Rs." << fixed << setprecision(2) << o.price << endl;
-            shown++;
+        for(long long seq = orderCount - 1; seq >= orderCount - count; seq--) {
+            const Order* o = orderBySeq(seq);
+            if(o == nullptr) break;
+            cout << "Order: " << o->orderID << " | Customer: " << o->customerName
+                 << " | Item: " << o->itemName << " | Qty: " << o->quantity
+                 << " | Price: Rs." << fixed << setprecision(2) << o->price << endl;
         }
     }
     
     void undoLastOrder() {
-        if(!orderHistory.empty()) {
-            Order lastOrder = orderHistory.top();
-            orderHistory.pop();
-            inventory[lastOrder.itemName] += lastOrder.quantity;
-            totalRevenue -= lastOrder.price;
-            cout << "Order " << lastOrder.orderID << " cancelled successfully!" << endl;
+        const Order* lastOrder = applyUndo();
+        if(lastOrder != nullptr) {
+            if(journal.is_open()) journal << "U," << lastOrder->orderID << endl;
+            cout << "Order " << lastOrder->orderID << " cancelled successfully!" << endl;
+        } else if(orderCount > 0) {
+            cout << "Only the last " << RECENT_ORDER_SLOTS << " orders can be undone!" << endl;
         } else {
             cout << "No orders to undo!" << endl;
         }
@@ -103,11 +186,11 @@ public:
     
     void displayStatistics() {
         cout << "\n========== Food Court Statistics ==========\n";
-        cout << "Total Orders: " << orderHistory.size() << endl;
+        cout << "Total Orders: " << orderCount << endl;
         cout << "Total Revenue: Rs." << fixed << setprecision(2) << totalRevenue << endl;
         cout << "Total Waste: " << totalWaste << " kg" << endl;
-        cout << "Avg Order Value: Rs." << (orderHistory.size() > 0 ? 
-              totalRevenue / orderHistory.size() : 0) << endl;
+        cout << "Avg Order Value: Rs." << (orderCount > 0 ? 
+              totalRevenue / orderCount : 0) << endl;
     }
     
     void loadFromCSV(string filename) {
@@ -154,6 +237,7 @@ int main() {
     cout << "Loading data from case3.csv...\n";
     
     foodCourt.loadFromCSV("case3.csv");
+    foodCourt.openJournal("case3_journal.csv");
     foodCourt.displayStatistics();
     foodCourt.checkInventory();
     foodCourt.viewRecentOrders(10);
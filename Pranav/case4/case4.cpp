@@ -4,10 +4,25 @@
 #include <queue>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <iomanip>
+#include "../../Manthan/city_date.h"
 using namespace std;
 
+// How the waiting line picks the next vehicle when a port frees up
+enum QueueDiscipline {
+    QUEUE_PRIORITY, // emergency first, then fewest units (the original greedy rule)
+    QUEUE_SJF,      // shortest charge first
+    QUEUE_EDF       // earliest deadline first
+};
+
+const char* const DISCIPLINE_NAMES[] = {"Priority", "Shortest Job First", "Earliest Deadline First"};
+
+// Longest a vehicle of each priority should wait before it starts charging;
+// used as its EDF deadline and to count missed deadlines
+const int MAX_WAIT_MINUTES[] = {30, 120, 480}; // indexed by priority-1
+
 struct ChargingRequest {
     string vehicleNo;
     string ownerName;
@@ -17,30 +32,70 @@ struct ChargingRequest {
     int priority; // 1=emergency, 2=normal, 3=flexible
     int unitsNeeded;
     double estimatedCost;
-    
-    bool operator<(const ChargingRequest& other) const {
-        // Greedy: Prioritize by emergency, then by units needed (smallest first)
-        if(priority != other.priority) return priority > other.priority;
-        return unitsNeeded > other.unitsNeeded;
+    CityDateTime arrival;   // minutes since 1970-01-01
+    int chargeMinutes;      // from unitsNeeded and port power
+
+    CityDateTime deadline() const {
+        return arrival + MAX_WAIT_MINUTES[min(max(priority, 1), 3) - 1];
     }
 };
 
+// The few fields the simulator touches, packed so a year of arrivals sorts
+// and streams through cache quickly
+struct SimJob {
+    CityDateTime arrival;
+    CityDateTime deadline;
+    int chargeMinutes;
+    int priority;
+    int unitsNeeded;
+    double cost;
+};
+
+struct SimulationReport {
+    QueueDiscipline discipline;
+    int served;
+    double revenue;
+    double carbonSaved;     // kg CO2
+    double avgWait;         // minutes
+    int p50Wait, p90Wait, p99Wait, maxWait;
+    int missedDeadlines;
+    double utilisation;     // busy port-minutes / available port-minutes
+};
+
 class EVChargingStation {
 private:
-    priority_queue<ChargingRequest> chargingQueue;
-    vector<ChargingRequest> completedCharges;
+    vector<ChargingRequest> requests;
+    vector<SimJob> jobs;    // requests in arrival order, rebuilt after adds
+    bool jobsStale;
     int totalPorts;
-    int availablePorts;
+    double portPowerKW;
     double costPerKWh;
-    double totalRevenue;
-    double carbonSaved; // kg CO2
-    
+    int skippedRows;
+
+    // "YYYY-MM-DD H:MM" or "YYYY-MM-DD HH:MM" -> minutes, or CITY_NO_DATE
+    static CityDateTime parseArrival(const string& text) {
+        size_t space = text.find(' ');
+        if(space == string::npos) return CITY_NO_DATE;
+        string clock = text.substr(space + 1);
+        if(clock.size() == 4) clock = "0" + clock;
+        return cityDateTime(text.substr(0, space) + " " + clock);
+    }
+
+    static int percentile(vector<int>& values, int pct) {
+        if(values.empty()) return 0;
+        size_t k = (values.size() - 1) * pct / 100;
+        nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    }
+
 public:
-    EVChargingStation(int ports, double cost) 
-        : totalPorts(ports), availablePorts(ports), 
-          costPerKWh(cost), totalRevenue(0.0), carbonSaved(0.0) {}
-    
-    void addChargingRequest(string vehicleNo, string owner, int capacity, 
+    EVChargingStation(int ports, double cost, double powerKW = 50.0)
+        : jobsStale(false), totalPorts(ports), portPowerKW(powerKW),
+          costPerKWh(cost), skippedRows(0) {}
+
+    void setPorts(int ports) { totalPorts = ports; }
+
+    bool addChargingRequest(string vehicleNo, string owner, int capacity,
                             int current, string time, int priority) {
         ChargingRequest req;
         req.vehicleNo = vehicleNo;
@@ -49,61 +104,136 @@ public:
         req.currentCharge = current;
         req.arrivalTime = time;
         req.priority = priority;
-        req.unitsNeeded = capacity - current;
+        req.unitsNeeded = max(capacity - current, 0);
         req.estimatedCost = req.unitsNeeded * costPerKWh;
-        
-        chargingQueue.push(req);
+        req.arrival = parseArrival(time);
+        req.chargeMinutes = max(1, (int)((req.unitsNeeded * 60.0 + portPowerKW - 1) / portPowerKW));
+        if(req.arrival == CITY_NO_DATE) {
+            skippedRows++;
+            return false;
+        }
+
+        requests.push_back(req);
+        jobsStale = true;
+        return true;
     }
-    
-    void processChargingQueue() {
-        cout << "\n========== Processing Charging Requests (Greedy) ==========\n";
-        int processed = 0;
-        
-        while(!chargingQueue.empty() && availablePorts > 0 && processed < 20) {
-            ChargingRequest req = chargingQueue.top();
-            chargingQueue.pop();
-            
-            cout << "Charging: " << req.vehicleNo << " | Owner: " << req.ownerName
-                 << " | Units: " << req.unitsNeeded << " kWh"
-                 << " | Priority: " << req.priority
-                 << " | Cost: Rs." << fixed << setprecision(2) << req.estimatedCost << endl;
-            
-            completedCharges.push_back(req);
-            totalRevenue += req.estimatedCost;
-            carbonSaved += req.unitsNeeded * 0.92; // 0.92 kg CO2 per kWh saved
-            availablePorts--;
-            processed++;
+
+    // Event-driven run over every loaded request. Arrivals are read in time
+    // order and port finish times sit in a min-heap of at most totalPorts
+    // entries, so a run is O(n log n) and can be repeated for another
+    // discipline or port count.
+    SimulationReport simulate(QueueDiscipline discipline) {
+        if(jobsStale) {
+            jobs.clear();
+            jobs.reserve(requests.size());
+            for(const ChargingRequest& r : requests)
+                jobs.push_back(SimJob{r.arrival, r.deadline(), r.chargeMinutes, r.priority,
+                                      r.unitsNeeded, r.estimatedCost});
+            stable_sort(jobs.begin(), jobs.end(),
+                        [](const SimJob& a, const SimJob& b) { return a.arrival < b.arrival; });
+            jobsStale = false;
+        }
+
+        // Waiting line ordered by (key, tie-break, arrival index)
+        typedef pair<pair<long long, long long>, int> WaitKey;
+        priority_queue<WaitKey, vector<WaitKey>, greater<WaitKey>> waiting;
+        priority_queue<CityDateTime, vector<CityDateTime>, greater<CityDateTime>> portFreeAt;
+
+        SimulationReport report = {discipline, 0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0.0};
+        if(totalPorts <= 0) return report;
+        vector<int> waits;
+        waits.reserve(jobs.size());
+        long long busyMinutes = 0, totalWait = 0;
+        CityDateTime lastFinish = jobs.empty() ? 0 : jobs.front().arrival;
+        size_t next = 0;
+        int freePorts = totalPorts;
+
+        while(next < jobs.size() || !waiting.empty()) {
+            // jump to the next arrival or port release, releases first
+            CityDateTime now;
+            if(next < jobs.size() && (portFreeAt.empty() || jobs[next].arrival < portFreeAt.top()))
+                now = jobs[next].arrival;
+            else
+                now = portFreeAt.top();
+            while(!portFreeAt.empty() && portFreeAt.top() <= now) {
+                portFreeAt.pop();
+                freePorts++;
+            }
+            for(; next < jobs.size() && jobs[next].arrival == now; next++) {
+                const SimJob& r = jobs[next];
+                if(discipline == QUEUE_PRIORITY)
+                    waiting.push({{r.priority, r.unitsNeeded}, (int)next});
+                else if(discipline == QUEUE_SJF)
+                    waiting.push({{r.chargeMinutes, r.arrival}, (int)next});
+                else
+                    waiting.push({{r.deadline, r.arrival}, (int)next});
+            }
+
+            for(; freePorts > 0 && !waiting.empty(); freePorts--) {
+                const SimJob& r = jobs[waiting.top().second];
+                waiting.pop();
+                int wait = now - r.arrival;
+                waits.push_back(wait);
+                totalWait += wait;
+                if(now > r.deadline) report.missedDeadlines++;
+
+                CityDateTime done = now + r.chargeMinutes;
+                portFreeAt.push(done);
+                lastFinish = max(lastFinish, done);
+                busyMinutes += r.chargeMinutes;
+                report.served++;
+                report.revenue += r.cost;
+                report.carbonSaved += r.unitsNeeded * 0.92; // 0.92 kg CO2 per kWh saved
+            }
         }
-        
-        availablePorts = totalPorts; // Reset for next batch
+
+        if(report.served > 0) {
+            long long span = lastFinish - jobs.front().arrival;
+            report.avgWait = (double)totalWait / report.served;
+            report.utilisation = span > 0 ? (double)busyMinutes / ((double)span * totalPorts) : 0.0;
+            report.maxWait = *max_element(waits.begin(), waits.end());
+            report.p50Wait = percentile(waits, 50);
+            report.p90Wait = percentile(waits, 90);
+            report.p99Wait = percentile(waits, 99);
+        }
+        return report;
+    }
+
+    void printReport(const SimulationReport& r) {
+        cout << "\n========== Simulation: " << DISCIPLINE_NAMES[r.discipline] << " ==========\n";
+        cout << "Ports: " << totalPorts << " x " << fixed << setprecision(1) << portPowerKW << " kW" << endl;
+        cout << "Vehicles Served: " << r.served << endl;
+        cout << "Wait (min): avg " << setprecision(2) << r.avgWait << " | p50 " << r.p50Wait
+             << " | p90 " << r.p90Wait << " | p99 " << r.p99Wait << " | max " << r.maxWait << endl;
+        cout << "Missed Deadlines: " << r.missedDeadlines << endl;
+        cout << "Port Utilisation: " << setprecision(2) << r.utilisation * 100 << "%" << endl;
+        cout << "Total Revenue: Rs." << r.revenue << endl;
+        cout << "Carbon Saved: " << r.carbonSaved << " kg CO2" << endl;
+        cout << "Avg Charge Cost: Rs." << (r.served > 0 ? r.revenue / r.served : 0) << endl;
     }
-    
+
     void displayStatistics() {
         cout << "\n========== Charging Station Statistics ==========\n";
         cout << "Total Ports: " << totalPorts << endl;
-        cout << "Vehicles in Queue: " << chargingQueue.size() << endl;
-        cout << "Completed Charges: " << completedCharges.size() << endl;
-        cout << "Total Revenue: Rs." << fixed << setprecision(2) << totalRevenue << endl;
-        cout << "Carbon Saved: " << carbonSaved << " kg CO2" << endl;
-        cout << "Avg Charge Cost: Rs." << (completedCharges.size() > 0 ? 
-              totalRevenue / completedCharges.size() : 0) << endl;
+        cout << "Requests Loaded: " << requests.size() << endl;
+        cout << "Rows Skipped (bad arrival time): " << skippedRows << endl;
     }
-    
+
     void loadFromCSV(string filename) {
         ifstream file(filename);
         if(!file.is_open()) {
             cout << "Error: Could not open " << filename << endl;
             return;
         }
-        
+
         string line;
         getline(file, line); // Skip header
-        
+
         while(getline(file, line)) {
             stringstream ss(line);
             string vehicleNo, owner, time;
-            int capacity, current, priority;
-            
+            int capacity = 0, current = 0, priority = 2;
+
             getline(ss, vehicleNo, ',');
             getline(ss, owner, ',');
             ss >> capacity;
@@ -112,10 +242,10 @@ public:
             ss.ignore();
             getline(ss, time, ',');
             ss >> priority;
-            
+
             addChargingRequest(vehicleNo, owner, capacity, current, time, priority);
         }
-        
+
         file.close();
         cout << "Data loaded successfully from " << filename << endl;
     }
@@ -123,13 +253,20 @@ public:
 
 int main() {
     EVChargingStation station(10, 8.0);
-    
+
     cout << "========== EV Charging Station System ==========\n";
     cout << "Loading data from case4.csv...\n";
-    
+
     station.loadFromCSV("case4.csv");
-    station.processChargingQueue();
     station.displayStatistics();
-    
+
+    station.printReport(station.simulate(QUEUE_PRIORITY));
+    station.printReport(station.simulate(QUEUE_SJF));
+    station.printReport(station.simulate(QUEUE_EDF));
+
+    // Sizing example: the same arrivals through a single port
+    station.setPorts(1);
+    station.printReport(station.simulate(QUEUE_EDF));
+
     return 0;
 }
@@ -2,95 +2,246 @@
 #include <fstream>
 #include <sstream>
 #include <queue>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
 #include <iomanip>
+#include "../../Manthan/city_dict.h"
+#include "../../Manthan/city_date.h"
 using namespace std;
 
+// Devices with their own rate card; any other type read from the CSV is
+// interned after these and gets the default cost and turnaround.
+enum DeviceType { DEVICE_LAPTOP, DEVICE_MOBILE, DEVICE_TABLET, DEVICE_SMARTWATCH };
+enum JobStatus { JOB_PENDING, JOB_IN_PROGRESS, JOB_COMPLETED };
+
 struct RepairJob {
     string jobID;
     string customerName;
-    string deviceType;
+    CityCode deviceType;
     string issue;
     string submissionDate;
     double estimatedCost;
     int estimatedDays;
-    string status; // pending, in-progress, completed
+    CityCode status; // JobStatus
+    int technician;          // index into technicians, -1 = not scheduled
+    CityDate projectedDone;  // CITY_NO_DATE until scheduled
+    int seq;                 // arrival order, breaks scheduling ties
+};
+
+struct Technician {
+    string techID;
+    string name;
+    uint64_t skills;   // bit per device type code
+    bool available;
+    CityDate busyUntil; // day their last completed repair was done, or CITY_NO_DATE
+};
+
+// Scheduling weight: the revenue a job brings in, so with equal repair time
+// the more valuable job goes first
+inline double jobWeight(const RepairJob* j) { return j->estimatedCost; }
+
+// Heap entry for Smith's rule: highest weight per repair day on top, which
+// minimises total weighted completion time on each technician. The ratio is
+// stored so heap moves never touch the job record.
+struct QueuedJob {
+    double ratio;
+    int seq;
+    RepairJob* job;
+    
+    bool operator<(const QueuedJob& other) const {
+        if(ratio != other.ratio) return ratio < other.ratio;
+        return seq > other.seq;
+    }
 };
 
 class TechRepairShop {
 private:
-    queue<RepairJob> repairQueue;
     unordered_map<string, RepairJob> jobDatabase; // jobID -> RepairJob
+    vector<RepairJob*> openJobs;  // not yet completed, in arrival order
+    vector<RepairJob*> schedule;  // scheduled open jobs by projected completion
+    vector<Technician> technicians;
+    CityDate planningDay;         // schedules start from this day
+    int unassignedJobs;           // open jobs no available technician can repair
     unordered_map<string, int> deviceCount; // Device type counter
     double totalRevenue;
     double eWasteCollected;
+    CityDict deviceTypes;
+    CityDict jobStatuses;
     
 public:
-    TechRepairShop() : totalRevenue(0.0), eWasteCollected(0.0) {}
+    TechRepairShop() : planningDay(cityToday()), unassignedJobs(0), totalRevenue(0.0), eWasteCollected(0.0),
+        deviceTypes(cityDictMake({"Laptop", "Mobile", "Tablet", "Smartwatch"})),
+        jobStatuses(cityDictMake({"pending", "in-progress", "completed"})) {}
     
-    double calculateCost(string deviceType) {
-        if(deviceType == "Laptop") return 1500.0;
-        else if(deviceType == "Mobile") return 800.0;
-        else if(deviceType == "Tablet") return 1000.0;
-        else if(deviceType == "Smartwatch") return 600.0;
+    double calculateCost(CityCode deviceType) {
+        static const double cost[] = {1500.0, 800.0, 1000.0, 600.0}; // indexed by DeviceType
+        if(deviceType <= DEVICE_SMARTWATCH) return cost[deviceType];
         return 500.0;
     }
     
-    int estimateRepairDays(string deviceType) {
-        if(deviceType == "Laptop") return 5;
-        else if(deviceType == "Mobile") return 3;
-        else if(deviceType == "Tablet") return 4;
+    int estimateRepairDays(CityCode deviceType) {
+        static const int days[] = {5, 3, 4, 2};
+        if(deviceType <= DEVICE_SMARTWATCH) return days[deviceType];
         return 2;
     }
     
+    void addTechnician(string techID, string name, const vector<string>& skills) {
+        Technician t = {techID, name, 0, true, CITY_NO_DATE};
+        for(const string& device : skills) {
+            CityCode code = cityIntern(deviceTypes, device);
+            if(code < 64) t.skills |= 1ULL << code;
+        }
+        technicians.push_back(t);
+    }
+    
+    void setPlanningDay(CityDate day) { planningDay = day; }
+    
     void addRepairJob(string jobID, string customer, string device, 
                       string issue, string date) {
-        RepairJob job;
+        auto ins = jobDatabase.insert({jobID, RepairJob()});
+        RepairJob& job = ins.first->second;
+        if(ins.second) {
+            job.seq = (int)jobDatabase.size();
+            openJobs.push_back(&job);
+        } else {
+            // resubmitted: it counts once under its new device type, and a
+            // job that was already completed is open again
+            auto old = deviceCount.find(cityDictName(deviceTypes, job.deviceType));
+            if(old != deviceCount.end() && --old->second == 0) deviceCount.erase(old);
+            if(job.status == JOB_COMPLETED) openJobs.push_back(&job);
+        }
         job.jobID = jobID;
         job.customerName = customer;
-        job.deviceType = device;
+        job.deviceType = cityIntern(deviceTypes, device);
         job.issue = issue;
         job.submissionDate = date;
-        job.estimatedCost = calculateCost(device);
-        job.estimatedDays = estimateRepairDays(device);
-        job.status = "pending";
+        job.estimatedCost = calculateCost(job.deviceType);
+        job.estimatedDays = estimateRepairDays(job.deviceType);
+        job.status = JOB_PENDING;
+        job.technician = -1;
+        job.projectedDone = CITY_NO_DATE;
         
-        repairQueue.push(job);
-        jobDatabase[jobID] = job;
         deviceCount[device]++;
     }
     
+    // List scheduling over every open job: whichever available technician
+    // frees up first takes the best-ratio job among the device types they
+    // can repair. One heap per device type plus a heap of technician free
+    // days keeps a full reschedule at O(n log n).
+    void rescheduleJobs() {
+        vector<vector<QueuedJob>> bySkill(deviceTypes.names.size());
+        for(RepairJob* job : openJobs) {
+            job->technician = -1;
+            job->projectedDone = CITY_NO_DATE;
+            job->status = JOB_PENDING;
+            bySkill[job->deviceType].push_back(QueuedJob{jobWeight(job) / job->estimatedDays, job->seq, job});
+        }
+        for(auto& heap : bySkill) make_heap(heap.begin(), heap.end());
+        
+        typedef pair<CityDate, int> FreeAt; // (day free, technician)
+        priority_queue<FreeAt, vector<FreeAt>, greater<FreeAt>> freeAt;
+        for(int t = 0; t < (int)technicians.size(); t++)
+            if(technicians[t].available) freeAt.push({max(planningDay, technicians[t].busyUntil), t});
+        
+        schedule.clear();
+        while(!freeAt.empty()) {
+            FreeAt next = freeAt.top();
+            freeAt.pop();
+            const Technician& tech = technicians[next.second];
+            
+            int best = -1;
+            for(int d = 0; d < (int)bySkill.size() && d < 64; d++) {
+                if(!(tech.skills >> d & 1) || bySkill[d].empty()) continue;
+                if(best == -1 || bySkill[best].front() < bySkill[d].front()) best = d;
+            }
+            if(best == -1) continue; // nothing left this technician can repair
+            
+            pop_heap(bySkill[best].begin(), bySkill[best].end());
+            RepairJob* job = bySkill[best].back().job;
+            bySkill[best].pop_back();
+            job->technician = next.second;
+            job->projectedDone = next.first + job->estimatedDays;
+            job->status = next.first == planningDay ? JOB_IN_PROGRESS : JOB_PENDING;
+            schedule.push_back(job);
+            freeAt.push({job->projectedDone, next.second});
+        }
+        
+        unassignedJobs = (int)(openJobs.size() - schedule.size());
+        stable_sort(schedule.begin(), schedule.end(), [](const RepairJob* a, const RepairJob* b) {
+            return a->projectedDone < b->projectedDone;
+        });
+    }
+    
+    // The technician is taken off the rota and everything is rescheduled
+    bool technicianUnavailable(string techID) {
+        for(Technician& t : technicians) {
+            if(t.techID != techID) continue;
+            t.available = false;
+            rescheduleJobs();
+            return true;
+        }
+        return false;
+    }
+    
+    // Completes the next count jobs in schedule order and replans the rest
     void processRepairs(int count) {
         cout << "\n========== Processing Repair Jobs ==========\n";
         int processed = 0;
         
-        while(!repairQueue.empty() && processed < count) {
-            RepairJob job = repairQueue.front();
-            repairQueue.pop();
-            
-            job.status = "completed";
-            jobDatabase[job.jobID] = job;
+        for(; processed < count && processed < (int)schedule.size(); processed++) {
+            RepairJob& job = *schedule[processed];
+            job.status = JOB_COMPLETED;
+            // the technician's time on it is spent, so replanning starts after it
+            Technician& tech = technicians[job.technician];
+            tech.busyUntil = max(tech.busyUntil, job.projectedDone);
             totalRevenue += job.estimatedCost;
             
             cout << "Job: " << job.jobID << " | Customer: " << job.customerName
-                 << " | Device: " << job.deviceType
+                 << " | Device: " << cityDictName(deviceTypes, job.deviceType)
+                 << " | Technician: " << technicians[job.technician].name
                  << " | Cost: Rs." << fixed << setprecision(2) << job.estimatedCost << endl;
-            processed++;
         }
+        
+        size_t kept = 0;
+        for(RepairJob* job : openJobs)
+            if(job->status != JOB_COMPLETED) openJobs[kept++] = job;
+        openJobs.resize(kept);
+        rescheduleJobs();
+    }
+    
+    void displaySchedule(int count) {
+        cout << "\n========== Projected Completion ==========\n";
+        for(int i = 0; i < count && i < (int)schedule.size(); i++) {
+            const RepairJob& job = *schedule[i];
+            cout << "Job: " << job.jobID << " | Device: " << cityDictName(deviceTypes, job.deviceType)
+                 << " | Technician: " << technicians[job.technician].name
+                 << " | Done by: " << cityFormatDate(job.projectedDone) << endl;
+        }
+        if(!schedule.empty())
+            cout << "Last job done by: " << cityFormatDate(schedule.back()->projectedDone) << endl;
+        if(unassignedJobs > 0)
+            cout << "Unassigned (no available technician with the skill): " << unassignedJobs << endl;
     }
     
     void searchJob(string jobID) {
-        if(jobDatabase.find(jobID) != jobDatabase.end()) {
-            RepairJob job = jobDatabase[jobID];
+        auto it = jobDatabase.find(jobID);
+        if(it != jobDatabase.end()) {
+            const RepairJob& job = it->second;
             cout << "\n========== Job Details ==========\n";
             cout << "Job ID: " << job.jobID << endl;
             cout << "Customer: " << job.customerName << endl;
-            cout << "Device: " << job.deviceType << endl;
+            cout << "Device: " << cityDictName(deviceTypes, job.deviceType) << endl;
             cout << "Issue: " << job.issue << endl;
-            cout << "Status: " << job.status << endl;
+            cout << "Status: " << cityDictName(jobStatuses, job.status) << endl;
             cout << "Cost: Rs." << fixed << setprecision(2) << job.estimatedCost << endl;
             cout << "Est. Days: " << job.estimatedDays << endl;
+            if(job.technician != -1)
+                cout << "Technician: " << technicians[job.technician].name
+                     << " | Done by: " << cityFormatDate(job.projectedDone) << endl;
         } else {
             cout << "Job not found!" << endl;
         }
@@ -109,7 +260,8 @@ public:
     
     void displayStatistics() {
         cout << "\n========== Shop Statistics ==========\n";
-        cout << "Jobs in Queue: " << repairQueue.size() << endl;
+        cout << "Technicians: " << technicians.size() << endl;
+        cout << "Jobs in Queue: " << openJobs.size() << endl;
         cout << "Total Jobs: " << jobDatabase.size() << endl;
         cout << "Total Revenue: Rs." << fixed << setprecision(2) << totalRevenue << endl;
         cout << "E-Waste Collected: " << eWasteCollected << " kg" << endl;
@@ -149,9 +301,22 @@ int main() {
     cout << "========== Tech Repair Shop System ==========\n";
     cout << "Loading data from case5.csv...\n";
     
+    shop.addTechnician("T1", "Ravi", {"Laptop", "Desktop"});
+    shop.addTechnician("T2", "Meena", {"Mobile", "Tablet", "Smartwatch"});
+    shop.addTechnician("T3", "Imran", {"Laptop", "Mobile", "Tablet"});
+    shop.addTechnician("T4", "Priya", {"Smartwatch", "Mobile", "Desktop"});
+    
     shop.loadFromCSV("case5.csv");
+    shop.setPlanningDay(cityDate("2025-01-01"));
+    shop.rescheduleJobs();
     shop.displayStatistics();
+    shop.displaySchedule(10);
     shop.processRepairs(15);
+    
+    // T3 calls in sick: the open jobs are spread over the other three
+    cout << "\nTechnician T3 unavailable, rescheduling..." << endl;
+    shop.technicianUnavailable("T3");
+    shop.displaySchedule(10);
     shop.displayDeviceStatistics();
     shop.trackEWaste(12.5);
     
@@ -2,10 +2,11 @@
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
-#include <vector>
+#include <set>
 #include <algorithm>
 #include <string>
 #include <iomanip>
+#include "../../Manthan/city_date.h"
 using namespace std;
 
 struct Medicine {
@@ -15,12 +16,38 @@ struct Medicine {
     int quantity;
     string expiryDate;
     string category;
+    CityDate expiry; // CITY_NO_DATE if expiryDate does not parse
+};
+
+// Index orders. Ties fall back to the ID so every medicine has one place;
+// the double/CityDate overloads let lower_bound search by key alone.
+struct PriceOrder {
+    typedef void is_transparent;
+    bool operator()(const Medicine* a, const Medicine* b) const {
+        if(a->price != b->price) return a->price < b->price;
+        return a->medicineID < b->medicineID;
+    }
+    bool operator()(const Medicine* a, double price) const { return a->price < price; }
+    bool operator()(double price, const Medicine* b) const { return price < b->price; }
+};
+
+struct ExpiryOrder {
+    typedef void is_transparent;
+    bool operator()(const Medicine* a, const Medicine* b) const {
+        if(a->expiry != b->expiry) return a->expiry < b->expiry;
+        return a->medicineID < b->medicineID;
+    }
+    bool operator()(const Medicine* a, CityDate day) const { return a->expiry < day; }
+    bool operator()(CityDate day, const Medicine* b) const { return day < b->expiry; }
 };
 
 class Pharmacy {
 private:
     unordered_map<string, Medicine> medicineMap; // ID -> Medicine
-    vector<Medicine> sortedMedicines; // For binary search
+    // Both indexes point into medicineMap (its nodes never move), so stock
+    // changes show up in queries without any re-sorting
+    set<const Medicine*, PriceOrder> priceIndex;
+    set<const Medicine*, ExpiryOrder> expiryIndex;
     double totalRevenue;
     int totalSales;
     
@@ -29,53 +56,82 @@ public:
     
     void addMedicine(string id, string name, double price, 
                      int quantity, string expiry, string category) {
-        Medicine med;
+        auto ins = medicineMap.insert({id, Medicine()});
+        Medicine& med = ins.first->second;
+        if(!ins.second) { // restocked under the same ID: keys may change
+            priceIndex.erase(&med);
+            expiryIndex.erase(&med);
+        }
         med.medicineID = id;
         med.name = name;
         med.price = price;
         med.quantity = quantity;
         med.expiryDate = expiry;
         med.category = category;
+        med.expiry = cityDate(expiry);
         
-        medicineMap[id] = med;
-        sortedMedicines.push_back(med);
+        priceIndex.insert(&med);
+        expiryIndex.insert(&med);
     }
     
-    void sortMedicinesByPrice() {
-        sort(sortedMedicines.begin(), sortedMedicines.end(), 
-             [](const Medicine& a, const Medicine& b) {
-                 return a.price < b.price;
-             });
-        cout << "Medicines sorted by price!" << endl;
+    bool updatePrice(string id, double price) {
+        auto it = medicineMap.find(id);
+        if(it == medicineMap.end()) return false;
+        priceIndex.erase(&it->second);
+        it->second.price = price;
+        priceIndex.insert(&it->second);
+        return true;
     }
     
-    Medicine* binarySearchByPrice(double targetPrice) {
-        int left = 0, right = sortedMedicines.size() - 1;
-        Medicine* closest = nullptr;
-        double minDiff = 1e9;
-        
-        while(left <= right) {
-            int mid = left + (right - left) / 2;
-            double diff = abs(sortedMedicines[mid].price - targetPrice);
-            
-            if(diff < minDiff) {
-                minDiff = diff;
-                closest = &sortedMedicines[mid];
-            }
-            
-            if(sortedMedicines[mid].price < targetPrice) {
-                left = mid + 1;
-            } else {
-                right = mid - 1;
-            }
-        }
-        
-        return closest;
+    // Medicine whose price is closest to targetPrice (the cheaper one on a tie)
+    const Medicine* binarySearchByPrice(double targetPrice) const {
+        auto above = priceIndex.lower_bound(targetPrice);
+        if(above == priceIndex.begin()) return above != priceIndex.end() ? *above : nullptr;
+        auto below = prev(above);
+        if(above == priceIndex.end()) return *below;
+        return (*above)->price - targetPrice < targetPrice - (*below)->price ? *above : *below;
+    }
+    
+    // Calls visit(medicine) for lo <= price <= hi, cheapest first
+    template<class Visit>
+    void forEachInPriceRange(double lo, double hi, Visit visit) const {
+        for(auto it = priceIndex.lower_bound(lo); it != priceIndex.end() && (*it)->price <= hi; ++it)
+            visit(**it);
+    }
+    
+    // Calls visit(medicine) for expiry dates from today through today+days,
+    // soonest first
+    template<class Visit>
+    void forEachExpiringWithin(CityDate today, int days, Visit visit) const {
+        for(auto it = expiryIndex.lower_bound(today); it != expiryIndex.end() && (*it)->expiry <= today + days; ++it)
+            visit(**it);
+    }
+    
+    void displayPriceRange(double lo, double hi) const {
+        cout << "\n========== Medicines Rs." << fixed << setprecision(2) << lo << " - Rs." << hi << " ==========\n";
+        int count = 0;
+        forEachInPriceRange(lo, hi, [&](const Medicine& m) {
+            cout << m.medicineID << " | " << m.name << " | Rs." << m.price << " | Stock: " << m.quantity << endl;
+            count++;
+        });
+        cout << count << " medicines in range" << endl;
+    }
+    
+    void displayExpiring(int days) const {
+        CityDate today = cityToday();
+        cout << "\n========== Expiring Within " << days << " Days ==========\n";
+        int count = 0;
+        forEachExpiringWithin(today, days, [&](const Medicine& m) {
+            cout << m.medicineID << " | " << m.name << " | Expires: " << m.expiryDate
+                 << " | Stock: " << m.quantity << endl;
+            count++;
+        });
+        cout << count << " medicines expiring" << endl;
     }
     
     bool dispenseMedicine(string id, int quantity) {
         if(medicineMap.find(id) != medicineMap.end()) {
-            Medicine& med = medicineMap[id];
+            Medicine& med = medicineMap.find(id)->second;
             if(med.quantity >= quantity) {
                 med.quantity -= quantity;
                 double bill = med.price * quantity;
@@ -152,15 +208,16 @@ int main() {
     
     pharmacy.loadFromCSV("case6.csv");
     pharmacy.displayStatistics();
-    pharmacy.sortMedicinesByPrice();
     
-    // Binary search example
+    // Nearest-price example
     cout << "\nSearching for medicine around Rs.50:" << endl;
-    Medicine* found = pharmacy.binarySearchByPrice(50.0);
+    const Medicine* found = pharmacy.binarySearchByPrice(50.0);
     if(found) {
         cout << "Found: " << found->name << " at Rs." << found->price << endl;
     }
     
+    pharmacy.displayPriceRange(49.0, 51.0);
+    pharmacy.displayExpiring(30);
     pharmacy.displayLowStock();
     
     return 0;
@@ -5,12 +5,17 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include "../../Manthan/city_dict.h"
 using namespace std;
 
+// Premium room types; any other type read from the CSV is interned after
+// these and priced as a standard room.
+enum RoomType { ROOM_DELUXE, ROOM_SUITE };
+
 struct Booking {
     string bookingID;
     string guestName;
-    string roomType;
+    CityCode roomType;
     string checkIn;
     string checkOut;
     int nights;
@@ -32,15 +37,17 @@ private:
     int availableRooms;
     double solarEnergyUsage; // percentage
     double totalRevenue;
+    CityDict roomTypes;
     
 public:
     EcoGuestHouse(int rooms) : totalRooms(rooms), availableRooms(rooms), 
-                                solarEnergyUsage(75.0), totalRevenue(0.0) {}
+                                solarEnergyUsage(75.0), totalRevenue(0.0),
+                                roomTypes(cityDictMake({"Deluxe", "Suite"})) {}
     
-    double calculateCost(string roomType, int nights) {
+    double calculateCost(CityCode roomType, int nights) {
+        static const double premium[] = {1500.0, 2000.0}; // indexed by RoomType
         double basePrice = 1000.0;
-        if(roomType == "Deluxe") basePrice = 1500.0;
-        else if(roomType == "Suite") basePrice = 2000.0;
+        if(roomType <= ROOM_SUITE) basePrice = premium[roomType];
         
         double total = basePrice * nights;
         return total * 0.9; // 10% eco discount
@@ -51,11 +58,11 @@ public:
         Booking booking;
         booking.bookingID = id;
         booking.guestName = guest;
-        booking.roomType = type;
+        booking.roomType = cityIntern(roomTypes, type);
         booking.checkIn = checkIn;
         booking.checkOut = checkOut;
         booking.nights = nights;
-        booking.totalCost = calculateCost(type, nights);
+        booking.totalCost = calculateCost(booking.roomType, nights);
         booking.priority = priority;
         
         bookingQueue.push(booking);
@@ -74,7 +81,7 @@ public:
             totalRevenue += b.totalCost;
             
             cout << "Confirmed: " << b.bookingID << " | Guest: " << b.guestName
-                 << " | Room: " << b.roomType << " | Nights: " << b.nights
+                 << " | Room: " << cityDictName(roomTypes, b.roomType) << " | Nights: " << b.nights
                  << " | Cost: Rs." << fixed << setprecision(2) << b.totalCost
                  << " | Priority: " << b.priority << endl;
             processed++;